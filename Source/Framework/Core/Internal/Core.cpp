@@ -27,6 +27,64 @@ void DataBlob::free()
   m_size = 0;
 }
 
+MappedFile::MappedFile()
+  : m_file(INVALID_HANDLE_VALUE)
+  , m_mapping(0)
+  , m_data(0)
+  , m_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool MappedFile::open(const String& fileName)
+{
+  close();
+
+  m_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+  if (m_file == INVALID_HANDLE_VALUE)
+    return false;
+
+  // empty files can't be mapped, larger ones don't fit the 32 bit address space anyway
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0 || size.HighPart != 0)
+  {
+    close();
+    return false;
+  }
+
+  m_mapping = CreateFileMapping(m_file, 0, PAGE_READONLY, 0, 0, 0);
+  if (m_mapping)
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+
+  if (!m_data)
+  {
+    close();
+    return false;
+  }
+
+  m_size = size.LowPart;
+  return true;
+}
+
+void MappedFile::close()
+{
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping)
+    CloseHandle(m_mapping);
+  if (m_file != INVALID_HANDLE_VALUE)
+    CloseHandle(m_file);
+
+  m_file = INVALID_HANDLE_VALUE;
+  m_mapping = 0;
+  m_data = 0;
+  m_size = 0;
+}
+
 long fileSize(FILE* fp)
 {
   long size = 0;
@@ -107,4 +165,16 @@ uint32 readUInt32(const ubyte*& ptr)
   ubyte b3 = *ptr++;
   ubyte b4 = *ptr++;
   return (b4 << 24) | (b3 << 16) | (b2 << 8) | b1;
+}
+
+double getHighResolutionTime()
+{
+  static LARGE_INTEGER frequency = {0};
+  if (frequency.QuadPart == 0)
+    QueryPerformanceFrequency(&frequency);
+
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+
+  return (double)counter.QuadPart / (double)frequency.QuadPart;
 }
\ No newline at end of file
@@ -0,0 +1,656 @@
+#include "Core.h"
+#include "NumberParser.h"
+
+#include <intrin.h>
+
+namespace
+{
+  // outside of this range a float is either zero or infinite, even for 19 digit mantissas
+  const int MinPowerOfTen = -65;
+  const int MaxPowerOfTen = 38;
+
+  const uint32 MaxMantissaDigits = 19;
+  const uint64 MinNineteenDigitMantissa = 1000000000000000000ull;
+
+  // digits beyond that can only break ties, they just mark the value as inexact
+  const uint32 MaxExactDigits = 800;
+
+  const uint32 FloatMantissaBits = 23;
+  const int FloatMinExponent = -127;
+  const int FloatInfiniteExponent = 0xFF;
+
+  // 5^q as 128 bit mantissas truncated from the exact value for q in [MinPowerOfTen, MaxPowerOfTen]
+  const uint64 PowersOfFive[][2] =
+  {
+    { 0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull },  // 5^-65
+    { 0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull },  // 5^-64
+    { 0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull },  // 5^-63
+    { 0x83a3eeeef9153e89ull, 0x1953cf68300424acull },  // 5^-62
+    { 0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull },  // 5^-61
+    { 0xcdb02555653131b6ull, 0x3792f412cb06794dull },  // 5^-60
+    { 0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull },  // 5^-59
+    { 0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull },  // 5^-58
+    { 0xc8de047564d20a8bull, 0xf245825a5a445275ull },  // 5^-57
+    { 0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull },  // 5^-56
+    { 0x9ced737bb6c4183dull, 0x55464dd69685606bull },  // 5^-55
+    { 0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull },  // 5^-54
+    { 0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull },  // 5^-53
+    { 0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull },  // 5^-52
+    { 0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull },  // 5^-51
+    { 0xef73d256a5c0f77cull, 0x963e66858f6d4440ull },  // 5^-50
+    { 0x95a8637627989aadull, 0xdde7001379a44aa8ull },  // 5^-49
+    { 0xbb127c53b17ec159ull, 0x5560c018580d5d52ull },  // 5^-48
+    { 0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull },  // 5^-47
+    { 0x9226712162ab070dull, 0xcab3961304ca70e8ull },  // 5^-46
+    { 0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull },  // 5^-45
+    { 0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull },  // 5^-44
+    { 0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull },  // 5^-43
+    { 0xb267ed1940f1c61cull, 0x55f038b237591ed3ull },  // 5^-42
+    { 0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull },  // 5^-41
+    { 0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull },  // 5^-40
+    { 0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull },  // 5^-39
+    { 0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull },  // 5^-38
+    { 0x881cea14545c7575ull, 0x7e50d64177da2e54ull },  // 5^-37
+    { 0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull },  // 5^-36
+    { 0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull },  // 5^-35
+    { 0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull },  // 5^-34
+    { 0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull },  // 5^-33
+    { 0xcfb11ead453994baull, 0x67de18eda5814af2ull },  // 5^-32
+    { 0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull },  // 5^-31
+    { 0xa2425ff75e14fc31ull, 0xa1258379a94d028dull },  // 5^-30
+    { 0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull },  // 5^-29
+    { 0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull },  // 5^-28
+    { 0x9e74d1b791e07e48ull, 0x775ea264cf55347eull },  // 5^-27
+    { 0xc612062576589ddaull, 0x95364afe032a819eull },  // 5^-26
+    { 0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull },  // 5^-25
+    { 0x9abe14cd44753b52ull, 0xc4926a9672793543ull },  // 5^-24
+    { 0xc16d9a0095928a27ull, 0x75b7053c0f178294ull },  // 5^-23
+    { 0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull },  // 5^-22
+    { 0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull },  // 5^-21
+    { 0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull },  // 5^-20
+    { 0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull },  // 5^-19
+    { 0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull },  // 5^-18
+    { 0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull },  // 5^-17
+    { 0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull },  // 5^-16
+    { 0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull },  // 5^-15
+    { 0xb424dc35095cd80full, 0x538484c19ef38c95ull },  // 5^-14
+    { 0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull },  // 5^-13
+    { 0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull },  // 5^-12
+    { 0xafebff0bcb24aafeull, 0xf78f69a51539d749ull },  // 5^-11
+    { 0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull },  // 5^-10
+    { 0x89705f4136b4a597ull, 0x31680a88f8953031ull },  // 5^-9
+    { 0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull },  // 5^-8
+    { 0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull },  // 5^-7
+    { 0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull },  // 5^-6
+    { 0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull },  // 5^-5
+    { 0xd1b71758e219652bull, 0xd3c36113404ea4a9ull },  // 5^-4
+    { 0x83126e978d4fdf3bull, 0x645a1cac083126eaull },  // 5^-3
+    { 0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull },  // 5^-2
+    { 0xccccccccccccccccull, 0xcccccccccccccccdull },  // 5^-1
+    { 0x8000000000000000ull, 0x0000000000000000ull },  // 5^0
+    { 0xa000000000000000ull, 0x0000000000000000ull },  // 5^1
+    { 0xc800000000000000ull, 0x0000000000000000ull },  // 5^2
+    { 0xfa00000000000000ull, 0x0000000000000000ull },  // 5^3
+    { 0x9c40000000000000ull, 0x0000000000000000ull },  // 5^4
+    { 0xc350000000000000ull, 0x0000000000000000ull },  // 5^5
+    { 0xf424000000000000ull, 0x0000000000000000ull },  // 5^6
+    { 0x9896800000000000ull, 0x0000000000000000ull },  // 5^7
+    { 0xbebc200000000000ull, 0x0000000000000000ull },  // 5^8
+    { 0xee6b280000000000ull, 0x0000000000000000ull },  // 5^9
+    { 0x9502f90000000000ull, 0x0000000000000000ull },  // 5^10
+    { 0xba43b74000000000ull, 0x0000000000000000ull },  // 5^11
+    { 0xe8d4a51000000000ull, 0x0000000000000000ull },  // 5^12
+    { 0x9184e72a00000000ull, 0x0000000000000000ull },  // 5^13
+    { 0xb5e620f480000000ull, 0x0000000000000000ull },  // 5^14
+    { 0xe35fa931a0000000ull, 0x0000000000000000ull },  // 5^15
+    { 0x8e1bc9bf04000000ull, 0x0000000000000000ull },  // 5^16
+    { 0xb1a2bc2ec5000000ull, 0x0000000000000000ull },  // 5^17
+    { 0xde0b6b3a76400000ull, 0x0000000000000000ull },  // 5^18
+    { 0x8ac7230489e80000ull, 0x0000000000000000ull },  // 5^19
+    { 0xad78ebc5ac620000ull, 0x0000000000000000ull },  // 5^20
+    { 0xd8d726b7177a8000ull, 0x0000000000000000ull },  // 5^21
+    { 0x878678326eac9000ull, 0x0000000000000000ull },  // 5^22
+    { 0xa968163f0a57b400ull, 0x0000000000000000ull },  // 5^23
+    { 0xd3c21bcecceda100ull, 0x0000000000000000ull },  // 5^24
+    { 0x84595161401484a0ull, 0x0000000000000000ull },  // 5^25
+    { 0xa56fa5b99019a5c8ull, 0x0000000000000000ull },  // 5^26
+    { 0xcecb8f27f4200f3aull, 0x0000000000000000ull },  // 5^27
+    { 0x813f3978f8940984ull, 0x4000000000000000ull },  // 5^28
+    { 0xa18f07d736b90be5ull, 0x5000000000000000ull },  // 5^29
+    { 0xc9f2c9cd04674edeull, 0xa400000000000000ull },  // 5^30
+    { 0xfc6f7c4045812296ull, 0x4d00000000000000ull },  // 5^31
+    { 0x9dc5ada82b70b59dull, 0xf020000000000000ull },  // 5^32
+    { 0xc5371912364ce305ull, 0x6c28000000000000ull },  // 5^33
+    { 0xf684df56c3e01bc6ull, 0xc732000000000000ull },  // 5^34
+    { 0x9a130b963a6c115cull, 0x3c7f400000000000ull },  // 5^35
+    { 0xc097ce7bc90715b3ull, 0x4b9f100000000000ull },  // 5^36
+    { 0xf0bdc21abb48db20ull, 0x1e86d40000000000ull },  // 5^37
+    { 0x96769950b50d88f4ull, 0x1314448000000000ull }   // 5^38
+  };
+
+  // everything up to 1e10 is exact in a float
+  const float ExactPowersOfTen[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+  inline bool isDigit(char c)
+  {
+    return (uint32)(c - '0') < 10;
+  }
+
+  inline uint64 readEightBytes(const char* p)
+  {
+    uint64 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  inline bool isEightDigits(uint64 value)
+  {
+    return ((value + 0x4646464646464646ull) | (value - 0x3030303030303030ull)) & 0x8080808080808080ull ? false : true;
+  }
+
+  // swar conversion, the first character is in the lowest byte
+  inline uint32 parseEightDigits(uint64 value)
+  {
+    value -= 0x3030303030303030ull;
+    value = value * 10 + (value >> 8);
+    value = ((value & 0x000000FF000000FFull) * 0x000F424000000064ull + ((value >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull) >> 32;
+    return (uint32)value;
+  }
+
+  // accumulates all digits, the result wraps around for more than 19 of them
+  inline const char* parseDigits(const char* p, const char* end, uint64& value)
+  {
+    while (end - p >= 8 && isEightDigits(readEightBytes(p)))
+    {
+      value = value * 100000000 + parseEightDigits(readEightBytes(p));
+      p += 8;
+    }
+
+    while (p < end && isDigit(*p))
+      value = value * 10 + (*p++ - '0');
+
+    return p;
+  }
+
+  inline uint32 countLeadingZeros(uint64 value)
+  {
+    unsigned long index;
+    if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+      return 31 - index;
+    _BitScanReverse(&index, (unsigned long)value);
+    return 63 - index;
+  }
+
+  // no 128 bit multiplication intrinsic on x86
+  inline void multiply(uint64 a, uint64 b, uint64& high, uint64& low)
+  {
+    const uint64 aLow = (uint32)a;
+    const uint64 aHigh = a >> 32;
+    const uint64 bLow = (uint32)b;
+    const uint64 bHigh = b >> 32;
+
+    const uint64 lowLow = aLow * bLow;
+    const uint64 highLow = aHigh * bLow;
+    const uint64 lowHigh = aLow * bHigh;
+    const uint64 cross = (lowLow >> 32) + (uint32)highLow + lowHigh;
+
+    high = aHigh * bHigh + (highLow >> 32) + (cross >> 32);
+    low = (cross << 32) | (uint32)lowLow;
+  }
+
+  inline float makeFloat(uint32 mantissa, int exponent, bool negative)
+  {
+    const uint32 bits = mantissa | ((uint32)exponent << FloatMantissaBits) | (negative ? 0x80000000 : 0);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // eisel-lemire: w * 5^q is approximated with the 128 bit table, which is always accurate
+  // enough for an exactly rounded float as long as w holds all digits. returns the biased
+  // exponent and the mantissa without the hidden bit
+  void computeFloat(uint64 w, int q, uint32& mantissa, int& exponent)
+  {
+    mantissa = 0;
+    exponent = 0;
+    if (w == 0 || q < MinPowerOfTen)
+      return;
+
+    if (q > MaxPowerOfTen)
+    {
+      exponent = FloatInfiniteExponent;
+      return;
+    }
+
+    const uint32 leadingZeros = countLeadingZeros(w);
+    w <<= leadingZeros;
+
+    // the lower half is only needed if the upper one might carry into the kept bits
+    const uint64* power = PowersOfFive[q - MinPowerOfTen];
+    const uint64 precisionMask = 0xFFFFFFFFFFFFFFFFull >> (FloatMantissaBits + 3);
+    uint64 high, low;
+    multiply(w, power[0], high, low);
+    if ((high & precisionMask) == precisionMask)
+    {
+      uint64 secondHigh, secondLow;
+      multiply(w, power[1], secondHigh, secondLow);
+      low += secondHigh;
+      if (secondHigh > low)
+        ++high;
+    }
+
+    const uint32 upperBit = (uint32)(high >> 63);
+    const uint32 shift = upperBit + 64 - FloatMantissaBits - 3;
+    uint64 result = high >> shift;
+
+    // floor(log2(10^q)) + 63
+    exponent = ((((152170 + 65536) * q) >> 16) + 63) + (int)upperBit - (int)leadingZeros - FloatMinExponent;
+
+    if (exponent <= 0)
+    {
+      // subnormal
+      if (-exponent + 1 >= 64)
+      {
+        exponent = 0;
+        return;
+      }
+
+      result >>= -exponent + 1;
+      result += result & 1;
+      result >>= 1;
+      exponent = result < (1ull << FloatMantissaBits) ? 0 : 1;
+      mantissa = (uint32)result & ((1 << FloatMantissaBits) - 1);
+      return;
+    }
+
+    // exactly halfway, only possible for small q. round to even instead of up
+    if (low <= 1 && q >= -17 && q <= 10 && (result & 3) == 1 && (result << shift) == high)
+      result &= ~1ull;
+
+    result += result & 1;
+    result >>= 1;
+    if (result >= (2ull << FloatMantissaBits))
+    {
+      result = 1ull << FloatMantissaBits;
+      ++exponent;
+    }
+
+    mantissa = (uint32)result & ((1 << FloatMantissaBits) - 1);
+    if (exponent >= FloatInfiniteExponent)
+    {
+      exponent = FloatInfiniteExponent;
+      mantissa = 0;
+    }
+  }
+
+  // just enough for comparing the exact decimal against a float midpoint
+  class BigInteger
+  {
+  public:
+    BigInteger() : m_numLimbs(0) {}
+
+    void multiplyAdd(uint32 factor, uint32 addend)
+    {
+      uint64 carry = addend;
+      for (uint32 i = 0; i < m_numLimbs; ++i)
+      {
+        carry += (uint64)m_limbs[i] * factor;
+        m_limbs[i] = (uint32)carry;
+        carry >>= 32;
+      }
+
+      if (carry)
+        m_limbs[m_numLimbs++] = (uint32)carry;
+    }
+
+    void multiplyPowerOfFive(uint32 exponent)
+    {
+      static const uint32 SmallPowers[] = { 1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125 };
+      for (; exponent >= 13; exponent -= 13)
+        multiplyAdd(SmallPowers[13], 0);
+      multiplyAdd(SmallPowers[exponent], 0);
+    }
+
+    void shiftLeft(uint32 bits)
+    {
+      if (m_numLimbs == 0)
+        return;
+
+      const uint32 limbShift = bits / 32;
+      const uint32 bitShift = bits % 32;
+
+      const uint32 numLimbs = m_numLimbs + limbShift + 1;
+      for (uint32 i = numLimbs; i-- > 0; )
+      {
+        const int source = (int)i - (int)limbShift;
+        const uint32 upper = source >= 0 && source < (int)m_numLimbs ? m_limbs[source] << bitShift : 0;
+        const uint32 lower = bitShift && source >= 1 && source <= (int)m_numLimbs ? m_limbs[source - 1] >> (32 - bitShift) : 0;
+        m_limbs[i] = upper | lower;
+      }
+
+      m_numLimbs = numLimbs;
+      while (m_numLimbs > 0 && m_limbs[m_numLimbs - 1] == 0)
+        --m_numLimbs;
+    }
+
+    int compare(const BigInteger& other) const
+    {
+      if (m_numLimbs != other.m_numLimbs)
+        return m_numLimbs < other.m_numLimbs ? -1 : 1;
+
+      for (uint32 i = m_numLimbs; i-- > 0; )
+      {
+        if (m_limbs[i] != other.m_limbs[i])
+          return m_limbs[i] < other.m_limbs[i] ? -1 : 1;
+      }
+
+      return 0;
+    }
+
+  private:
+    // 800 digits, 5^847 and the shifts for the midpoint exponent need less than 3000 bits
+    uint32 m_limbs[160];
+    uint32 m_numLimbs;
+  };
+
+  struct DecimalDigits
+  {
+    const char* integerBegin;
+    const char* integerEnd;
+    const char* fractionBegin;
+    const char* fractionEnd;
+    int explicitExponent;
+  };
+
+  // sign of (digits - midpoint), the midpoint of two adjacent floats is exact in a double
+  int compareToMidpoint(const DecimalDigits& digits, double midpoint)
+  {
+    BigInteger decimal;
+    uint32 numDigits = 0;
+    int exponent = digits.explicitExponent - (int)(digits.fractionEnd - digits.fractionBegin);
+    bool inexact = false;
+
+    const char* ranges[2][2] = { { digits.integerBegin, digits.integerEnd }, { digits.fractionBegin, digits.fractionEnd } };
+    for (uint32 range = 0; range < 2; ++range)
+    {
+      for (const char* p = ranges[range][0]; p < ranges[range][1]; ++p)
+      {
+        const uint32 digit = *p - '0';
+        if (numDigits == 0 && digit == 0)
+          continue;
+
+        if (numDigits < MaxExactDigits)
+        {
+          decimal.multiplyAdd(10, digit);
+          ++numDigits;
+        }
+        else
+        {
+          inexact |= digit != 0;
+          ++exponent;
+        }
+      }
+    }
+
+    int binaryExponent;
+    const uint64 mantissa = (uint64)ldexp(frexp(midpoint, &binaryExponent), 53);
+    binaryExponent -= 53;
+
+    BigInteger binary;
+    binary.multiplyAdd(1, (uint32)(mantissa >> 32));
+    binary.shiftLeft(32);
+    binary.multiplyAdd(1, (uint32)mantissa);
+
+    // digits * 5^e * 2^e against mantissa * 2^b, the powers of two are moved to one side
+    if (exponent >= 0)
+      decimal.multiplyPowerOfFive(exponent);
+    else
+      binary.multiplyPowerOfFive(-exponent);
+
+    binaryExponent -= exponent;
+    if (binaryExponent >= 0)
+      binary.shiftLeft(binaryExponent);
+    else
+      decimal.shiftLeft(-binaryExponent);
+
+    const int result = decimal.compare(binary);
+    return result == 0 && inexact ? 1 : result;
+  }
+
+  inline float nextFloat(float value, int direction)
+  {
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits += direction;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // walks from the approximation to the exactly rounded float by comparing the decimal
+  // digits against the midpoints to the neighbours. only used for more than 19 digits
+  float roundDecimal(const DecimalDigits& digits, float approximation)
+  {
+    float value = approximation;
+    for (;;)
+    {
+      uint32 bits;
+      memcpy(&bits, &value, sizeof(bits));
+      const bool even = (bits & 1) == 0;
+
+      // the float above FLT_MAX would be 2^128
+      if (bits < 0x7F800000)
+      {
+        const double above = bits == 0x7F7FFFFF ? ldexp(1.0, 128) : (double)nextFloat(value, 1);
+        const int comparison = compareToMidpoint(digits, ((double)value + above) * 0.5);
+        if (comparison > 0 || (comparison == 0 && !even))
+        {
+          value = nextFloat(value, 1);
+          continue;
+        }
+      }
+
+      if (bits > 0)
+      {
+        const double below = bits == 0x7F800000 ? ldexp(1.0, 128) : (double)value;
+        const int comparison = compareToMidpoint(digits, ((double)nextFloat(value, -1) + below) * 0.5);
+        if (comparison < 0 || (comparison == 0 && !even))
+        {
+          value = nextFloat(value, -1);
+          continue;
+        }
+      }
+
+      return value;
+    }
+  }
+
+  inline bool matchesKeyword(const char* p, const char* end, const char* keyword)
+  {
+    for (; *keyword; ++p, ++keyword)
+    {
+      if (p == end || (*p | 0x20) != *keyword)
+        return false;
+    }
+
+    return true;
+  }
+
+  // digits without sign, fails for more than 10 significant digits or more than 2^32-1
+  const char* parseUnsigned(const char* begin, const char* end, uint64& value)
+  {
+    const char* p = begin;
+    while (p < end && *p == '0')
+      ++p;
+
+    const char* significant = p;
+    uint64 result = 0;
+    if (end - p >= 8 && isEightDigits(readEightBytes(p)))
+    {
+      result = parseEightDigits(readEightBytes(p));
+      p += 8;
+    }
+
+    while (p < end && isDigit(*p) && p - significant < 11)
+      result = result * 10 + (*p++ - '0');
+
+    if (p == begin || p - significant > 10 || (p < end && isDigit(*p)) || result > 0xFFFFFFFFull)
+      return begin;
+
+    value = result;
+    return p;
+  }
+}
+
+const char* parseFloat(const char* begin, const char* end, float& value)
+{
+  const char* p = begin;
+  const bool negative = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+'))
+    ++p;
+
+  DecimalDigits digits;
+  uint64 mantissa = 0;
+  digits.integerBegin = p;
+  p = parseDigits(p, end, mantissa);
+  digits.integerEnd = p;
+
+  digits.fractionBegin = digits.fractionEnd = p;
+  if (p < end && *p == '.')
+  {
+    digits.fractionBegin = ++p;
+    p = parseDigits(p, end, mantissa);
+    digits.fractionEnd = p;
+  }
+
+  uint32 numDigits = (uint32)((digits.integerEnd - digits.integerBegin) + (digits.fractionEnd - digits.fractionBegin));
+  if (numDigits == 0)
+  {
+    p = digits.integerBegin;
+    if (matchesKeyword(p, end, "nan"))
+    {
+      value = makeFloat(0x400000, FloatInfiniteExponent, negative);
+      return p + 3;
+    }
+
+    if (matchesKeyword(p, end, "inf"))
+    {
+      value = makeFloat(0, FloatInfiniteExponent, negative);
+      return matchesKeyword(p, end, "infinity") ? p + 8 : p + 3;
+    }
+
+    return begin;
+  }
+
+  // an exponent without digits isn't part of the number
+  digits.explicitExponent = 0;
+  if (p < end && (*p | 0x20) == 'e')
+  {
+    const char* exponentBegin = p + 1;
+    const bool negativeExponent = exponentBegin < end && *exponentBegin == '-';
+    if (exponentBegin < end && (*exponentBegin == '-' || *exponentBegin == '+'))
+      ++exponentBegin;
+
+    if (exponentBegin < end && isDigit(*exponentBegin))
+    {
+      int exponent = 0;
+      for (p = exponentBegin; p < end && isDigit(*p); ++p)
+      {
+        if (exponent < 100000)
+          exponent = exponent * 10 + (*p - '0');
+      }
+
+      digits.explicitExponent = negativeExponent ? -exponent : exponent;
+    }
+  }
+
+  int exponent = digits.explicitExponent - (int)(digits.fractionEnd - digits.fractionBegin);
+
+  // the mantissa wrapped around, start over with the first 19 significant digits
+  bool truncated = false;
+  if (numDigits > MaxMantissaDigits)
+  {
+    for (const char* q = digits.integerBegin; q < digits.fractionEnd && (*q == '0' || *q == '.'); ++q)
+      numDigits -= *q == '0';
+
+    if (numDigits > MaxMantissaDigits)
+    {
+      truncated = true;
+      mantissa = 0;
+
+      const char* q = digits.integerBegin;
+      for (; mantissa < MinNineteenDigitMantissa && q < digits.integerEnd; ++q)
+        mantissa = mantissa * 10 + (*q - '0');
+
+      if (mantissa >= MinNineteenDigitMantissa)
+      {
+        exponent = (int)(digits.integerEnd - q) + digits.explicitExponent;
+      }
+      else
+      {
+        for (q = digits.fractionBegin; mantissa < MinNineteenDigitMantissa && q < digits.fractionEnd; ++q)
+          mantissa = mantissa * 10 + (*q - '0');
+        exponent = (int)(digits.fractionBegin - q) + digits.explicitExponent;
+      }
+    }
+  }
+
+  // clinger's fast path, both operands and therefore the result are exactly rounded
+  if (!truncated && mantissa <= (1 << 24) && exponent >= -10 && exponent <= 10)
+  {
+    const float result = exponent < 0 ? (float)mantissa / ExactPowersOfTen[-exponent] : (float)mantissa * ExactPowersOfTen[exponent];
+    value = negative ? -result : result;
+    return p;
+  }
+
+  uint32 resultMantissa;
+  int resultExponent;
+  computeFloat(mantissa, exponent, resultMantissa, resultExponent);
+
+  // the dropped digits lie between w and w + 1, which is only ambiguous if they round differently
+  if (truncated && exponent >= MinPowerOfTen && exponent <= MaxPowerOfTen)
+  {
+    uint32 upperMantissa;
+    int upperExponent;
+    computeFloat(mantissa + 1, exponent, upperMantissa, upperExponent);
+    if (upperMantissa != resultMantissa || upperExponent != resultExponent)
+    {
+      const float result = roundDecimal(digits, makeFloat(resultMantissa, resultExponent, false));
+      value = negative ? -result : result;
+      return p;
+    }
+  }
+
+  value = makeFloat(resultMantissa, resultExponent, negative);
+  return p;
+}
+
+const char* parseUInt(const char* begin, const char* end, uint32& value)
+{
+  const char* p = begin;
+  if (p < end && *p == '+')
+    ++p;
+
+  uint64 result;
+  const char* last = parseUnsigned(p, end, result);
+  if (last == p)
+    return begin;
+
+  value = (uint32)result;
+  return last;
+}
+
+const char* parseInt(const char* begin, const char* end, int& value)
+{
+  const char* p = begin;
+  const bool negative = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+'))
+    ++p;
+
+  uint64 result;
+  const char* last = parseUnsigned(p, end, result);
+  if (last == p || result > (negative ? 0x80000000ull : 0x7FFFFFFFull))
+    return begin;
+
+  value = negative ? (int)(0 - (uint32)result) : (int)result;
+  return last;
+}
\ No newline at end of file
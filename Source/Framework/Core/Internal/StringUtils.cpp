@@ -46,4 +46,18 @@ String PathUtils::getPath(const String& path, bool stripDevice)
   }
 
   return fileName;
+}
+
+String PathUtils::normalize(const String& path)
+{
+  String result = path;
+  for (String::size_type i = 0; i < result.length(); ++i)
+  {
+    if (result[i] == '\\')
+      result[i] = '/';
+    else
+      result[i] = (char)tolower((ubyte)result[i]);
+  }
+
+  return result;
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "Core.h"
+#include "TaskScheduler.h"
+#include "Threading.h"
+
+#include <deque>
+
+namespace
+{
+  struct PendingTask
+  {
+    TaskFunction function;
+    TaskCounter* counter;
+  };
+
+  struct SchedulerState
+  {
+    SchedulerState()
+      : semaphore(0)
+      , shutdown(0)
+    {
+    }
+
+    CriticalSection queueLock;
+    std::deque<PendingTask> queue;
+    std::vector<HANDLE> workers;
+    HANDLE semaphore;
+    volatile long shutdown;
+  };
+
+  SchedulerState& getSchedulerState()
+  {
+    static SchedulerState state;
+    return state;
+  }
+}
+
+static DWORD WINAPI workerMain(void* param)
+{
+  SchedulerState& state = getSchedulerState();
+
+  while (true)
+  {
+    WaitForSingleObject(state.semaphore, INFINITE);
+
+    if (state.shutdown)
+      break;
+
+    TaskScheduler::executePendingTask();
+  }
+
+  return 0;
+}
+
+void TaskScheduler::init(uint32 numWorkers)
+{
+  SchedulerState& state = getSchedulerState();
+  if (!state.workers.empty())
+    return;
+
+  // leave one core to the main thread
+  if (numWorkers == 0)
+    numWorkers = max<uint32>(getNumHardwareThreads(), 2) - 1;
+
+  state.shutdown = 0;
+  state.semaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+
+  for (uint32 i = 0; i < numWorkers; ++i)
+  {
+    HANDLE thread = CreateThread(NULL, 0, &workerMain, 0, 0, NULL);
+    if (thread)
+      state.workers.push_back(thread);
+  }
+}
+
+void TaskScheduler::shutdown()
+{
+  SchedulerState& state = getSchedulerState();
+  if (state.workers.empty())
+    return;
+
+  // drain the queue, nobody else waits for these tasks anymore
+  while (executePendingTask())
+    ;
+
+  atomicExchange(&state.shutdown, 1);
+  ReleaseSemaphore(state.semaphore, (LONG)state.workers.size(), NULL);
+  WaitForMultipleObjects((DWORD)state.workers.size(), &state.workers[0], TRUE, INFINITE);
+
+  for (uint32 i = 0; i < state.workers.size(); ++i)
+    CloseHandle(state.workers[i]);
+
+  state.workers.clear();
+
+  CloseHandle(state.semaphore);
+  state.semaphore = 0;
+}
+
+uint32 TaskScheduler::getNumWorkers()
+{
+  return getSchedulerState().workers.size();
+}
+
+void TaskScheduler::submit(const TaskFunction& task, TaskCounter* counter)
+{
+  SchedulerState& state = getSchedulerState();
+
+  if (state.workers.empty())
+  {
+    task();
+    return;
+  }
+
+  if (counter)
+    atomicIncrement(&counter->m_pending);
+
+  PendingTask pendingTask;
+  pendingTask.function = task;
+  pendingTask.counter = counter;
+
+  {
+    ScopedLock lock(state.queueLock);
+    state.queue.push_back(pendingTask);
+  }
+
+  ReleaseSemaphore(state.semaphore, 1, NULL);
+}
+
+bool TaskScheduler::executePendingTask()
+{
+  SchedulerState& state = getSchedulerState();
+
+  PendingTask pendingTask;
+  {
+    ScopedLock lock(state.queueLock);
+    if (state.queue.empty())
+      return false;
+
+    pendingTask = state.queue.front();
+    state.queue.pop_front();
+  }
+
+  pendingTask.function();
+
+  if (pendingTask.counter)
+    atomicDecrement(&pendingTask.counter->m_pending);
+
+  return true;
+}
+
+void TaskScheduler::wait(const TaskCounter& counter)
+{
+  while (!counter.isDone())
+  {
+    if (!executePendingTask())
+      Sleep(0);
+  }
+}
+
+void TaskScheduler::parallelFor(uint32 count, uint32 grainSize, const RangeTaskFunction& func)
+{
+  const uint32 numWorkers = getNumWorkers();
+  grainSize = max<uint32>(grainSize, 1);
+
+  if (numWorkers == 0 || count <= grainSize)
+  {
+    func(0, count);
+    return;
+  }
+
+  // a few ranges per thread to even out unbalanced work
+  uint32 numRanges = (count + grainSize - 1) / grainSize;
+  numRanges = min(numRanges, (numWorkers + 1) * 4);
+  const uint32 rangeSize = (count + numRanges - 1) / numRanges;
+
+  TaskCounter counter;
+  for (uint32 begin = rangeSize; begin < count; begin += rangeSize)
+  {
+    const uint32 end = min(begin + rangeSize, count);
+    submit([&func, begin, end]() { func(begin, end); }, &counter);
+  }
+
+  // the calling thread takes the first range itself
+  func(0, min(rangeSize, count));
+
+  wait(counter);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "Core.h"
+#include "Threading.h"
+
+long atomicExchange(long volatile* value, long exchange)
+{
+  return InterlockedExchange(value, exchange);
+}
+
+long atomicCompareExchange(long volatile* value, long exchange, long comparand)
+{
+  return InterlockedCompareExchange(value, exchange, comparand);
+}
+
+long atomicAdd(long volatile* value, long amount)
+{
+  return InterlockedExchangeAdd(value, amount) + amount;
+}
+
+uint32 getNumHardwareThreads()
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return max<uint32>(info.dwNumberOfProcessors, 1);
+}
+
+CriticalSection::CriticalSection()
+{
+  InitializeCriticalSectionAndSpinCount(&m_criticalSection, 4000);
+}
+
+CriticalSection::~CriticalSection()
+{
+  DeleteCriticalSection(&m_criticalSection);
+}
+
+void CriticalSection::lock()
+{
+  EnterCriticalSection(&m_criticalSection);
+}
+
+void CriticalSection::unlock()
+{
+  LeaveCriticalSection(&m_criticalSection);
+}
+
+bool CriticalSection::tryLock()
+{
+  return TryEnterCriticalSection(&m_criticalSection) != FALSE;
+}
+
+Event::Event(bool manualReset)
+  : m_handle(CreateEvent(NULL, manualReset ? TRUE : FALSE, FALSE, NULL))
+{
+}
+
+Event::~Event()
+{
+  CloseHandle(m_handle);
+}
+
+void Event::signal()
+{
+  SetEvent(m_handle);
+}
+
+void Event::reset()
+{
+  ResetEvent(m_handle);
+}
+
+bool Event::wait(uint32 timeoutMs)
+{
+  return WaitForSingleObject(m_handle, timeoutMs) == WAIT_OBJECT_0;
+}
\ No newline at end of file
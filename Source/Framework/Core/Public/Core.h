@@ -15,6 +15,12 @@
 
 #define SUPPORT_GPU_DEBUG_MARKERS
 
+// sse math kernels, comment out to fall back to the scalar reference implementation
+#define SUPPORT_SIMD_MATH
+
+// 256 bit kernels, requires /arch:AVX (enabled automatically if the compiler targets avx)
+//#define SUPPORT_AVX_MATH
+
 // windows/dx
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -34,6 +40,7 @@ typedef std::string String;
 typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef unsigned int uint32;
+typedef unsigned long long uint64;
 typedef unsigned char ubyte;
 
 template<typename T>
@@ -55,6 +62,29 @@ private:
   int m_size;
 };
 
+// read only view of a whole file, pages are read on first access. the view starts at an
+// allocation granularity boundary, so aligned offsets in the file are aligned in memory
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open(const String& fileName);
+  void close();
+  const void* getPtr() const { return m_data; }
+  uint32 getSize() const { return m_size; }
+
+private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  HANDLE m_file;
+  HANDLE m_mapping;
+  const void* m_data;
+  uint32 m_size;
+};
+
 long fileSize(FILE* fp);
 String getCurrentDirectory();
 void setCurrentDirectory(const String& path);
@@ -63,6 +93,9 @@ bool readAllFile(const String& fileName, String& result);
 uint16 readUInt16(const ubyte*& ptr);
 uint32 readUInt32(const ubyte*& ptr);
 
+// monotonic high resolution time in seconds
+double getHighResolutionTime();
+
 #define VALIDATE(x) { \
   if (FAILED((x))) { MessageBox(NULL, #x " failed...", "Error", MB_OK); exit(0); } }
 
@@ -70,8 +103,8 @@ uint32 readUInt32(const ubyte*& ptr);
 
 #define ASSERT(x, msg)
 
-#define RENDER_DEVICE g_Game->getRenderSystem()->getDevicePtr()
-#define RENDER_CONTEXT g_Game->getRenderSystem()->getDeviceContextPtr()
+#define RENDER_DEVICE g_Game->getRenderSystemPtr()->getDevicePtr()
+#define RENDER_CONTEXT g_Game->getRenderSystemPtr()->getDeviceContextPtr()
 
 struct ID3D11Device;
 struct ID3D11DeviceContext;
@@ -104,6 +137,8 @@ class VertexShader;
 
 #include "Vector.h"
 #include "Matrix.h"
+#include "Quaternion.h"
+#include "AffineTransform.h"
 #include "MathUtil.h"
 #include "Point.h"
 #include "Ptr.h"
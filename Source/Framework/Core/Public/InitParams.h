@@ -9,6 +9,12 @@ struct InitParams
   int msaaSamples;
   bool srgbTarget;
   bool fullscreen;
+  bool vsync;
+
+  // simulation step in seconds, 0 ticks once per frame with the frame delta
+  float fixedTimeStep;
+  // upper bound of fixed steps per frame, the rest of the frame time is dropped
+  int maxSubSteps;
 };
 
 #endif // __InitParams_h_
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef __NumberParser_h_
+#define __NumberParser_h_
+
+// locale independent number parsing for text assets. the functions work in place on
+// [begin, end) without the need for a terminator or a copy. they return the position after
+// the number, or begin if there is none (value is left untouched then). leading whitespace
+// isn't skipped.
+
+// [+-]digits[.digits][(e|E)[+-]digits], [+-]inf, [+-]infinity and [+-]nan (any case).
+// exactly rounded to nearest even, values out of range become infinity or zero
+const char* parseFloat(const char* begin, const char* end, float& value);
+
+// [+-]digits, fails on overflow
+const char* parseInt(const char* begin, const char* end, int& value);
+const char* parseUInt(const char* begin, const char* end, uint32& value);
+
+#endif // __NumberParser_h_
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef __NumberParserBenchmark_h_
+#define __NumberParserBenchmark_h_
+
+#include "NumberParserTest.h"
+
+namespace NumberParserBenchmark
+{
+
+  // floats as they appear in obj files and a few long ones, compared with the crt
+  static void RunNumberParserBenchmarks(uint32 count = 1000000, uint32 repetitions = 3)
+  {
+    printf("\nStarting Number Parser Benchmarks...\n");
+
+    String floats;
+    String ints;
+    uint32 seed = 12345;
+    char buffer[64];
+    for (uint32 i = 0; i < count; ++i)
+    {
+      if (i % 8 == 0)
+        sprintf_s(buffer, "%.9g ", NumberParserTest::AsFloat(NumberParserTest::RandomBits(seed) & 0xbfffffff));
+      else
+        sprintf_s(buffer, "%f ", (float)(NumberParserTest::RandomBits(seed) % 200000) / 1000.0f - 100.0f);
+      floats += buffer;
+
+      const uint32 shift = NumberParserTest::RandomBits(seed) % 32;
+      sprintf_s(buffer, "%d ", (int)NumberParserTest::RandomBits(seed) >> shift);
+      ints += buffer;
+    }
+
+    const double floatMegaBytes = floats.size() / (1024.0 * 1024.0);
+    const double intMegaBytes = ints.size() / (1024.0 * 1024.0);
+    double best[4] = { 1e10, 1e10, 1e10, 1e10 };
+    float floatSink = 0.0f;
+    int intSink = 0;
+
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      // the crt functions need the terminator, which the strings have
+      double start = getHighResolutionTime();
+      for (const char* p = floats.c_str(); *p; ++p)
+      {
+        char* last;
+        floatSink += (float)strtod(p, &last);
+        p = last;
+      }
+      best[0] = min(best[0], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      for (const char* p = floats.c_str(), *end = p + floats.size(); p < end; ++p)
+      {
+        float value = 0.0f;
+        p = parseFloat(p, end, value);
+        floatSink += value;
+      }
+      best[1] = min(best[1], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      for (const char* p = ints.c_str(); *p; ++p)
+      {
+        char* last;
+        intSink += (int)strtol(p, &last, 10);
+        p = last;
+      }
+      best[2] = min(best[2], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      for (const char* p = ints.c_str(), *end = p + ints.size(); p < end; ++p)
+      {
+        int value = 0;
+        p = parseInt(p, end, value);
+        intSink += value;
+      }
+      best[3] = min(best[3], getHighResolutionTime() - start);
+    }
+
+    printf("strtod     %8.2f MB/s %8.2f M/s\n", floatMegaBytes / best[0], count / best[0] * 1e-6);
+    printf("parseFloat %8.2f MB/s %8.2f M/s %6.2fx\n", floatMegaBytes / best[1], count / best[1] * 1e-6, best[0] / best[1]);
+    printf("strtol     %8.2f MB/s %8.2f M/s\n", intMegaBytes / best[2], count / best[2] * 1e-6);
+    printf("parseInt   %8.2f MB/s %8.2f M/s %6.2fx\n", intMegaBytes / best[3], count / best[3] * 1e-6, best[2] / best[3]);
+    printf("(checksum %f %d)\n", floatSink, intSink);
+  }
+
+}
+
+#endif // __NumberParserBenchmark_h_
\ No newline at end of file
@@ -0,0 +1,153 @@
+#ifndef __NumberParserTest_h_
+#define __NumberParserTest_h_
+
+#include "NumberParser.h"
+
+namespace NumberParserTest
+{
+
+#define RUN_TEST(test) { \
+    if ((test) == false) \
+      printf("WARNING: " #test " failed...\n"); \
+    else \
+      printf(#test " succeeded...\n"); }
+
+  static uint32 RandomBits(uint32& seed)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return seed;
+  }
+
+  static float AsFloat(uint32 bits)
+  {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static bool Parses(const char* text, uint32 expectedBits, uint32 expectedLength)
+  {
+    float value = 0.0f;
+    const char* end = text + strlen(text);
+    const char* last = parseFloat(text, end, value);
+    return last == text + expectedLength && memcmp(&value, &expectedBits, sizeof(value)) == 0;
+  }
+
+  static bool Parses(const char* text, uint32 expectedBits)
+  {
+    return Parses(text, expectedBits, (uint32)strlen(text));
+  }
+
+  static void TestNumberParser()
+  {
+    printf("\nStarting Number Parser Tests...\n");
+
+    printf("Test 1 (syntax)\n");
+    {
+      RUN_TEST(Parses("0", 0x00000000) && Parses("-0", 0x80000000) && Parses("+5", 0x40a00000));
+      RUN_TEST(Parses(".5", 0x3f000000) && Parses("-.5", 0xbf000000) && Parses("1.", 0x3f800000));
+      RUN_TEST(Parses("1e3", 0x447a0000) && Parses("1E+3", 0x447a0000) && Parses("1000e-3", 0x3f800000));
+      RUN_TEST(Parses("-inf", 0xff800000) && Parses("Infinity", 0x7f800000) && Parses("NaN", 0x7fc00000));
+
+      // an incomplete exponent isn't consumed
+      RUN_TEST(Parses("2e", 0x40000000, 1) && Parses("2e+", 0x40000000, 1) && Parses("2.5/7", 0x40200000, 3));
+
+      float value = 42.0f;
+      const char* invalid[] = { "", ".", "-", "e5", "+.e1", "x1" };
+      bool untouched = true;
+      for (uint32 i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+        untouched &= parseFloat(invalid[i], invalid[i] + strlen(invalid[i]), value) == invalid[i] && value == 42.0f;
+      RUN_TEST(untouched);
+
+      // nothing behind the end is read
+      const char* digits = "12345678";
+      RUN_TEST(parseFloat(digits, digits + 3, value) == digits + 3 && value == 123.0f);
+    }
+
+    printf("\nTest 2 (rounding)\n");
+    {
+      RUN_TEST(Parses("0.1", 0x3dcccccd) && Parses("16777217", 0x4b800000) && Parses("3.4028235e38", 0x7f7fffff));
+      RUN_TEST(Parses("1.4e-45", 0x00000001) && Parses("1.1754942e-38", 0x007fffff) && Parses("1e-50", 0x00000000) && Parses("1e39", 0x7f800000));
+
+      // exact midpoints round to even
+      RUN_TEST(Parses("1.000000059604644775390625", 0x3f800000) && Parses("1.000000178813934326171875", 0x3f800002));
+      RUN_TEST(Parses("3.40282356779733661637539395458142568448e38", 0x7f800000));
+
+      // the dropped digits decide, converting via double rounds these the wrong way
+      RUN_TEST(Parses("1.000000059604644775390625000000001", 0x3f800001));
+      RUN_TEST(Parses("1.00000017881393432617187499999999", 0x3f800001));
+      RUN_TEST(Parses("3.40282356779733661637539395458142568447e38", 0x7f7fffff));
+      RUN_TEST(Parses("7.006492321624085354618647916449580656401e-46", 0x00000000));
+      RUN_TEST(Parses("7.0064923216240853546186479164495806564014e-46", 0x00000001));
+      RUN_TEST(Parses("00000000000000000000000000000001.500000000000000000000000000000", 0x3fc00000));
+    }
+
+    printf("\nTest 3 (random)\n");
+    {
+      // the shortest representations and 9 digits identify a float uniquely
+      uint32 seed = 12345;
+      char buffer[64];
+      bool roundTrip = true;
+      for (uint32 i = 0; i < 1000000; ++i)
+      {
+        const uint32 bits = RandomBits(seed);
+        const float value = AsFloat(bits);
+        if (value != value)
+          continue;
+
+        sprintf_s(buffer, "%.9g", value);
+        roundTrip &= Parses(buffer, bits);
+      }
+      RUN_TEST(roundTrip);
+
+      // few digits never hit the double rounding problem, strtod is the reference
+      bool matchesStrtod = true;
+      for (uint32 i = 0; i < 1000000; ++i)
+      {
+        const int mantissa = (int)(RandomBits(seed) >> 8) - (1 << 23);
+        const int exponent = (int)(RandomBits(seed) % 90) - 45;
+        sprintf_s(buffer, "%de%d", mantissa, exponent);
+
+        const float reference = (float)strtod(buffer, 0);
+        float value;
+        matchesStrtod &= parseFloat(buffer, buffer + strlen(buffer), value) == buffer + strlen(buffer) && value == reference;
+      }
+      RUN_TEST(matchesStrtod);
+    }
+
+    printf("\nTest 4 (integers)\n");
+    {
+      int value = 7;
+      uint32 unsignedValue = 7;
+      const char* text = "-2147483648 2147483647 2147483648 4294967295 4294967296 0000000000001234567890 -12x";
+      const char* end = text + strlen(text);
+
+      RUN_TEST(parseInt(text, end, value) == text + 11 && value == -2147483647 - 1);
+      RUN_TEST(parseInt(text + 12, end, value) == text + 22 && value == 2147483647);
+      RUN_TEST(parseInt(text + 23, end, value) == text + 23 && value == 2147483647);
+      RUN_TEST(parseUInt(text + 23, end, unsignedValue) == text + 33 && unsignedValue == 2147483648u);
+      RUN_TEST(parseUInt(text + 34, end, unsignedValue) == text + 44 && unsignedValue == 4294967295u);
+      RUN_TEST(parseUInt(text + 45, end, unsignedValue) == text + 45 && unsignedValue == 4294967295u);
+      RUN_TEST(parseUInt(text + 56, end, unsignedValue) == text + 78 && unsignedValue == 1234567890u);
+      RUN_TEST(parseInt(text + 79, end, value) == text + 82 && value == -12);
+      RUN_TEST(parseUInt(text + 79, end, unsignedValue) == text + 79);
+
+      uint32 seed = 12345;
+      char buffer[16];
+      bool matchesAtoi = true;
+      for (uint32 i = 0; i < 1000000; ++i)
+      {
+        const uint32 shift = RandomBits(seed) % 32;
+        const int reference = (int)RandomBits(seed) >> shift;
+        sprintf_s(buffer, "%d", reference);
+        matchesAtoi &= parseInt(buffer, buffer + strlen(buffer), value) == buffer + strlen(buffer) && value == reference;
+      }
+      RUN_TEST(matchesAtoi);
+    }
+  }
+
+#undef RUN_TEST
+
+}
+
+#endif // __NumberParserTest_h_
\ No newline at end of file
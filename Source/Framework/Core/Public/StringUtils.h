@@ -36,6 +36,7 @@ public:
   static String getExtension(const String& path);
   static String getFilename(const String& path, bool stripExtension);
   static String getPath(const String& path, bool stripDevice);
+  static String normalize(const String& path);
 };
 
 #endif // __StringUtils_h_
\ No newline at end of file
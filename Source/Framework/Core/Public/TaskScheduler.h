@@ -0,0 +1,46 @@
+#ifndef __TaskScheduler_h_
+#define __TaskScheduler_h_
+
+#include <functional>
+
+typedef std::function<void()> TaskFunction;
+typedef std::function<void(uint32 begin, uint32 end)> RangeTaskFunction;
+
+// counts the outstanding tasks of a group, see TaskScheduler::wait
+class TaskCounter
+{
+public:
+  TaskCounter() : m_pending(0) {}
+
+  bool isDone() const { return m_pending == 0; }
+
+private:
+  friend class TaskScheduler;
+
+  TaskCounter(const TaskCounter&);
+  TaskCounter& operator=(const TaskCounter&);
+
+  volatile long m_pending;
+};
+
+// fixed pool of worker threads executing tasks from a shared queue. without
+// a call to init (e.g. in tools) all tasks are executed inline by submit.
+class TaskScheduler
+{
+public:
+  static void init(uint32 numWorkers = 0);
+  static void shutdown();
+
+  static uint32 getNumWorkers();
+
+  static void submit(const TaskFunction& task, TaskCounter* counter = 0);
+  static bool executePendingTask();
+
+  // the waiting thread helps executing queued tasks until the counter drops to zero
+  static void wait(const TaskCounter& counter);
+
+  // splits [0, count) into ranges of at least grainSize elements and blocks until all are done
+  static void parallelFor(uint32 count, uint32 grainSize, const RangeTaskFunction& func);
+};
+
+#endif // __TaskScheduler_h_
\ No newline at end of file
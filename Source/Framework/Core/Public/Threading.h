@@ -0,0 +1,65 @@
+#ifndef __Threading_h_
+#define __Threading_h_
+
+long atomicExchange(long volatile* value, long exchange);
+long atomicCompareExchange(long volatile* value, long exchange, long comparand);
+long atomicAdd(long volatile* value, long amount);
+
+uint32 getNumHardwareThreads();
+
+class CriticalSection
+{
+public:
+  CriticalSection();
+  ~CriticalSection();
+
+  void lock();
+  void unlock();
+  bool tryLock();
+
+private:
+  CriticalSection(const CriticalSection&);
+  CriticalSection& operator=(const CriticalSection&);
+
+  CRITICAL_SECTION m_criticalSection;
+};
+
+class ScopedLock
+{
+public:
+  explicit ScopedLock(CriticalSection& criticalSection)
+    : m_criticalSection(criticalSection)
+  {
+    m_criticalSection.lock();
+  }
+
+  ~ScopedLock()
+  {
+    m_criticalSection.unlock();
+  }
+
+private:
+  ScopedLock(const ScopedLock&);
+  ScopedLock& operator=(const ScopedLock&);
+
+  CriticalSection& m_criticalSection;
+};
+
+class Event
+{
+public:
+  explicit Event(bool manualReset = true);
+  ~Event();
+
+  void signal();
+  void reset();
+  bool wait(uint32 timeoutMs = INFINITE);
+
+private:
+  Event(const Event&);
+  Event& operator=(const Event&);
+
+  HANDLE m_handle;
+};
+
+#endif // __Threading_h_
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "Core.h"
+#include "FrameClock.h"
+
+const float FrameTimeHistogram::BucketWidthMs = 0.1f;
+
+FrameTimeHistogram::FrameTimeHistogram()
+{
+  reset();
+}
+
+void FrameTimeHistogram::reset()
+{
+  memset(m_samples, 0, sizeof(m_samples));
+  memset(m_buckets, 0, sizeof(m_buckets));
+  m_nextSample = 0;
+  m_numSamples = 0;
+  m_sum = 0;
+}
+
+uint32 FrameTimeHistogram::getBucket(float frameTimeMs)
+{
+  // the last bucket collects everything above the covered range
+  const uint32 bucket = (uint32)max(frameTimeMs / BucketWidthMs, 0.0f);
+  return min(bucket, NumBuckets - 1);
+}
+
+void FrameTimeHistogram::addSample(float frameTimeMs)
+{
+  // the oldest sample drops out of the window
+  if (m_numSamples == WindowSize)
+  {
+    const float oldest = m_samples[m_nextSample];
+    --m_buckets[getBucket(oldest)];
+    m_sum -= oldest;
+  }
+  else
+  {
+    ++m_numSamples;
+  }
+
+  m_samples[m_nextSample] = frameTimeMs;
+  ++m_buckets[getBucket(frameTimeMs)];
+  m_sum += frameTimeMs;
+
+  m_nextSample = (m_nextSample + 1) % WindowSize;
+}
+
+float FrameTimeHistogram::getPercentile(float p) const
+{
+  if (m_numSamples == 0)
+    return 0.0f;
+
+  const float rank = clamp(p, 0.0f, 1.0f) * m_numSamples;
+
+  uint32 count = 0;
+  for (uint32 i = 0; i < NumBuckets - 1; ++i)
+  {
+    if (m_buckets[i] == 0)
+      continue;
+
+    if (count + m_buckets[i] >= rank)
+    {
+      // assume the samples are spread evenly over the bucket
+      const float fraction = (rank - count) / m_buckets[i];
+      return min((i + fraction) * BucketWidthMs, getMax());
+    }
+
+    count += m_buckets[i];
+  }
+
+  return getMax();
+}
+
+float FrameTimeHistogram::getAverage() const
+{
+  return m_numSamples ? (float)(m_sum / m_numSamples) : 0.0f;
+}
+
+float FrameTimeHistogram::getMax() const
+{
+  float maxSample = 0.0f;
+  for (uint32 i = 0; i < m_numSamples; ++i)
+    maxSample = max(maxSample, m_samples[i]);
+
+  return maxSample;
+}
+
+FrameClock::FrameClock()
+  : m_timeScale(1.0f)
+  , m_smoothing(0.1f)
+  , m_maxDeltaTime(0.25f)
+  , m_paused(false)
+{
+  reset();
+}
+
+void FrameClock::reset()
+{
+  m_lastTime = getHighResolutionTime();
+  m_realTime = 0;
+  m_gameTime = 0;
+  m_realDeltaTime = 0;
+  m_smoothedDeltaTime = 0;
+  m_deltaTime = 0;
+  m_unsmoothedDeltaTime = 0;
+  m_frameIndex = 0;
+  m_histogram.reset();
+}
+
+void FrameClock::tick()
+{
+  const double now = getHighResolutionTime();
+  m_realDeltaTime = (float)(now - m_lastTime);
+  m_lastTime = now;
+
+  m_realTime += m_realDeltaTime;
+  m_histogram.addSample(m_realDeltaTime * 1000.0f);
+
+  const float clampedDeltaTime = min(m_realDeltaTime, m_maxDeltaTime);
+
+  // the first frame has nothing to smooth against
+  if (m_frameIndex == 0)
+    m_smoothedDeltaTime = clampedDeltaTime;
+  else
+    m_smoothedDeltaTime += (clampedDeltaTime - m_smoothedDeltaTime) * m_smoothing;
+
+  m_deltaTime = m_paused ? 0.0f : m_smoothedDeltaTime * m_timeScale;
+  m_unsmoothedDeltaTime = m_paused ? 0.0f : clampedDeltaTime * m_timeScale;
+  // the smoothed delta would let the game time drift from the real time
+  m_gameTime += m_unsmoothedDeltaTime;
+
+  ++m_frameIndex;
+}
\ No newline at end of file
@@ -8,9 +8,18 @@
 #include "GameClient.h"
 #include "StringUtils.h"
 #include "SystemTextures.h"
+#include "TaskScheduler.h"
+#include "InitGraph.h"
 
 // unit tests
 #include "PtrTest.h"
+#include "NumberParserTest.h"
+#include "NumberParserBenchmark.h"
+#include "MathBenchmark.h"
+#include "MathTest.h"
+#include "MeshTest.h"
+#include "MeshBenchmark.h"
+#include "ResourceManagerTest.h"
 
 #include <Windows.h>
 #include <windowsx.h>
@@ -18,6 +27,9 @@
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 
 Game::Game()
+  : m_fixedTimeStep(0)
+  , m_maxSubSteps(1)
+  , m_timeAccumulator(0)
 {
 }
 
@@ -40,42 +52,117 @@ bool Game::init(InitParams& params)
 
   // run unit tests
   //PtrTest::TestSharedPointer<PT_FAST>();
+  //MathBenchmark::RunMatrixBenchmarks();
+  //MathBenchmark::RunBatchBenchmarks();
+  //MathBenchmark::RunInverseBenchmarks();
+  //MathBenchmark::RunTransformBenchmarks();
+  //MathTest::TestMatrixInverse();
+  //MathTest::TestTransforms();
+  //MathBenchmark::RunCullingBenchmarks();
+  //MathTest::TestFrustumCulling();
+  //MathTest::TestBounds();
+  //MathTest::TestHalfFloat();
+  //MathBenchmark::RunHalfFloatBenchmarks();
+  //MathTest::TestBatchNormalize();
+  //MathTest::TestSinCos();
+  //MathBenchmark::RunNormalizeBenchmarks();
+  //MathTest::TestVector3Stream();
+  //MathTest::TestVertexEncoding();
+  //MathBenchmark::RunVertexEncodingBenchmarks();
+  //NumberParserTest::TestNumberParser();
+  //NumberParserBenchmark::RunNumberParserBenchmarks();
+  //MeshTest::TestObjParser();
+  //MeshTest::TestMeshFile();
+  //MeshTest::TestVertexWelding();
+  //MeshTest::TestVertexCacheOptimizer();
+  //MeshTest::TestOverdrawOptimizer();
+  //MeshTest::TestMeshSimplifier();
+  //MeshTest::TestMeshlets();
+  //MeshTest::TestVertexPacking();
+  //ResourceManagerTest::TestResourceManager();
+
+  TaskScheduler::init();
+
+  // benchmarks depending on the worker threads
+  //MeshBenchmark::RunObjParserBenchmarks();
+  //MeshBenchmark::RunMeshLoadBenchmarks();
+  //MeshBenchmark::RunWeldBenchmarks();
+  //MeshBenchmark::RunVertexCacheBenchmarks();
+  //MeshBenchmark::RunOverdrawBenchmarks();
+  //MeshBenchmark::RunSimplifierBenchmarks();
+  //MeshBenchmark::RunMeshletBenchmarks();
+
+  m_fixedTimeStep = max(params.fixedTimeStep, 0.0f);
+  m_maxSubSteps = max(params.maxSubSteps, 1);
 
   if (!initGame(params))
     return false;
 
-  // init subsystems
+  // init subsystems, independent steps run in parallel
   m_inputSystem = new InputSystem();
-  if (!m_inputSystem->init())
-    return false;
+  m_renderSystem = new RenderSystem();
+#if defined (_DEBUG)
+  m_debugGeomRenderer = new DebugGeometryRenderer();
+#endif // _DEBUG
 
-  if (!createRenderWindow(params))
-    return false;
+  InitGraph graph;
 
-  m_renderSystem = new RenderSystem();
-  if (!m_renderSystem->init(m_windowHandle, params))
-    return false;
+  graph.addStep("InputSystem", [this]() { return m_inputSystem->init(); });
+
+  // window messages are dispatched to the creating thread
+  uint32 renderWindow = graph.addStep("RenderWindow", [this, &params]() {
+    return createRenderWindow(params);
+  }, ISF_MAIN_THREAD);
+
+  uint32 renderSystem = graph.addStep("RenderSystem", [this, &params]() {
+    return m_renderSystem->init(m_windowHandle, params);
+  }, ISF_MAIN_THREAD);
+  graph.addDependency(renderSystem, renderWindow);
 
 #if defined (_DEBUG)
-  m_debugGeomRenderer = new DebugGeometryRenderer();
-  m_debugGeomRenderer->init();
+  uint32 debugShaders = graph.addStep("DebugGeometryShaders", [this]() {
+    return m_debugGeomRenderer->compileShaders();
+  });
+
+  uint32 debugGeometry = graph.addStep("DebugGeometryRenderer", [this]() {
+    m_debugGeomRenderer->init();
+    return true;
+  });
+  graph.addDependency(debugGeometry, renderSystem);
+  graph.addDependency(debugGeometry, debugShaders);
 #endif // _DEBUG
 
-  SystemTextures::init();
+  uint32 systemTextures = graph.addStep("SystemTextures", []() {
+    SystemTextures::init();
+    return true;
+  });
+  graph.addDependency(systemTextures, renderSystem);
 
-  m_client->initResources();
+  uint32 clientResources = graph.addStep("ClientResources", [this]() {
+    m_client->initResources();
+    return true;
+  });
+  graph.addDependency(clientResources, renderSystem);
+  graph.addDependency(clientResources, systemTextures);
 
-  return true;
+  const bool succeeded = graph.run();
+  graph.printReport();
+
+  return succeeded;
 }
 
 void Game::shutdown()
 {
+  TaskScheduler::shutdown();
 }
 
 void Game::run()
 {
   MSG msg;
 
+  // don't account the startup time to the first frame
+  m_frameClock.reset();
+
   while (true)
   {
     if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
@@ -88,16 +175,20 @@ void Game::run()
     }
     else
     {
-      m_inputSystem->tick(0);
+      m_frameClock.tick();
+      const float deltaT = m_frameClock.getDeltaTime();
+
+      m_inputSystem->tick(deltaT);
+      m_client->handleUserInput(deltaT);
 
 #if defined (_DEBUG)
       m_debugGeomRenderer->prepareDebugRendering();
 #endif // _DEBUG
 
-      m_client->tick(0);
+      const float interpolationAlpha = tickSimulation(deltaT);
 
       m_renderSystem->beginFrame();
-      m_client->render(0);
+      m_client->render(deltaT, interpolationAlpha);
 
 #if defined (_DEBUG)
       SceneView view;
@@ -110,6 +201,33 @@ void Game::run()
   }
 }
 
+float Game::tickSimulation(float deltaT)
+{
+  if (m_fixedTimeStep <= 0.0f)
+  {
+    m_client->tick(deltaT);
+    return 1.0f;
+  }
+
+  // the smoothed delta would let the accumulator drift from real time
+  m_timeAccumulator += m_frameClock.getUnsmoothedDeltaTime();
+
+  uint32 numSteps = 0;
+  while (m_timeAccumulator >= m_fixedTimeStep && numSteps < m_maxSubSteps)
+  {
+    m_client->tick(m_fixedTimeStep);
+    m_timeAccumulator -= m_fixedTimeStep;
+    ++numSteps;
+  }
+
+  // can't keep up, drop the backlog instead of spending even more time on the
+  // next frame catching up (spiral of death)
+  if (m_timeAccumulator >= m_fixedTimeStep)
+    m_timeAccumulator = fmodf(m_timeAccumulator, m_fixedTimeStep);
+
+  return m_timeAccumulator / m_fixedTimeStep;
+}
+
 bool Game::createRenderWindow(const InitParams& params)
 {
   WNDCLASS wc = {0};
@@ -186,6 +304,9 @@ int main()
   params.fullscreen = false;
   params.msaaSamples = 4;
   params.srgbTarget = true;
+  params.vsync = true;
+  params.fixedTimeStep = 0.0f;
+  params.maxSubSteps = 5;
 
   if (!g_Game->init(params))
     return 0;
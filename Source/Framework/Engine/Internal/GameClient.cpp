@@ -11,11 +11,11 @@ class DefaultGameMode : public GameMode
 {
 public:
   DefaultGameMode();
-  void tick(float time, GameClient& client);
+  void tick(float deltaT, GameClient& client);
+  virtual void handleUserInput(float deltaT);
   void getCurrentView(SceneView& view);
 
 protected:
-  virtual void handleUserInput();
 
   // this is only for testing
   Matrix4 m_viewMatrix;
@@ -34,20 +34,23 @@ DefaultGameMode::DefaultGameMode()
   makePerspectiveProjMatrix(m_projectionMatrix, 60.0f * DEG2RAD, (float)1024.0f / 768.0f, 10.0f, 50000.0f);
 }
 
-void DefaultGameMode::tick(float time, GameClient& client)
+void DefaultGameMode::tick(float deltaT, GameClient& client)
 {
-  handleUserInput();
 }
 
-void DefaultGameMode::handleUserInput()
+void DefaultGameMode::handleUserInput(float deltaT)
 {
   WeakPtr<InputSystem> inputSystem = g_Game->getInputSystem();
 
   const Point& mouseMoveDelta = inputSystem->getMouseMovement();
 
+  // mouse deltas already accumulate over the frame, only key movement scales with time
   static const float CameraMoveSpeed = 10.0f;
+  static const float CameraKeyMoveSpeed = 600.0f; // units per second
   static const float MouseMoveSpeed = 1.0f / 5.0f;
 
+  const float keyMoveDistance = CameraKeyMoveSpeed * deltaT;
+
   float angularMovementX = mouseMoveDelta.x * MouseMoveSpeed;
   float angularMovementY = mouseMoveDelta.y * MouseMoveSpeed;
   float moveSpeedForward = 0.0f;
@@ -83,21 +86,21 @@ void DefaultGameMode::handleUserInput()
     // move camera forward/backward
     if (inputSystem->isKeyDown(Keys::W))
     {
-      moveSpeedForward += CameraMoveSpeed;
+      moveSpeedForward += keyMoveDistance;
     }
     else if (inputSystem->isKeyDown(Keys::S))
     {
-      moveSpeedForward -= CameraMoveSpeed;
+      moveSpeedForward -= keyMoveDistance;
     }
 
     // strafe camera left/right
     if (inputSystem->isKeyDown(Keys::A))
     {
-      moveSpeedStrafe -= CameraMoveSpeed;
+      moveSpeedStrafe -= keyMoveDistance;
     }
     else if (inputSystem->isKeyDown(Keys::D))
     {
-      moveSpeedStrafe += CameraMoveSpeed;
+      moveSpeedStrafe += keyMoveDistance;
     }
   }
 
@@ -106,12 +109,14 @@ void DefaultGameMode::handleUserInput()
   m_viewPitch = clamp(m_viewPitch, -85.0f, 85.0f);
 
   // FIXME: only update then needed ------------->
-  Matrix4 rotatePitch, rotateYaw;
+  Quaternion rotatePitch, rotateYaw;
 
-  makeRotateX(rotatePitch, m_viewPitch * DEG2RAD);
-  makeRotateY(rotateYaw, m_viewYaw * DEG2RAD);
+  makeQuaternion(rotatePitch, Vector3(1, 0, 0), m_viewPitch * DEG2RAD);
+  makeQuaternion(rotateYaw, Vector3(0, 1, 0), m_viewYaw * DEG2RAD);
 
-  Matrix4 orientation = rotatePitch * rotateYaw;
+  // the rows of the orientation are the camera axes in world space
+  AffineTransform orientation;
+  makeAffineTransform(orientation, rotatePitch * rotateYaw, Vector3(0, 0, 0));
   Vector3 cameraForward = Vector3(orientation[8], orientation[9], orientation[10]);
   Vector3 cameraUp = Vector3(orientation[4], orientation[5], orientation[6]);
   Vector3 cameraRight = Vector3(orientation[0], orientation[1], orientation[2]);
@@ -121,9 +126,11 @@ void DefaultGameMode::handleUserInput()
     cameraRight * moveSpeedStrafe +
     cameraUp * moveSpeedUp;
 
-  Vector3 target = m_viewPos + cameraForward;
+  // same as a look at along the forward axis, there is no roll
+  AffineTransform translation = AffineTransform::Identity;
+  translation.setTranslation(-m_viewPos);
 
-  makeLookAt(m_viewMatrix, m_viewPos, target, Vector3(0, 1, 0));
+  makeMatrix(m_viewMatrix, orientation * translation);
   // <-------------
 }
 
@@ -134,7 +141,7 @@ void DefaultGameMode::getCurrentView(SceneView& view)
   view.m_worldPosition = m_viewPos;
 }
 
-void GameMode::tick(float time, GameClient& client)
+void GameMode::tick(float deltaT, GameClient& client)
 {
 
 }
@@ -156,15 +163,20 @@ GameClient::~GameClient()
 
 }
 
-void GameClient::tick(float time)
+void GameClient::handleUserInput(float deltaT)
+{
+  m_currentGameMode->handleUserInput(deltaT);
+}
+
+void GameClient::tick(float deltaT)
 {
-  m_currentGameMode->tick(time, *this);
-  tickIntern(time);
+  m_currentGameMode->tick(deltaT, *this);
+  tickIntern(deltaT);
 }
 
-void GameClient::render(float time)
+void GameClient::render(float deltaT, float interpolationAlpha)
 {
-  renderIntern(time);
+  renderIntern(deltaT, interpolationAlpha);
 }
 
 void GameClient::pushGameMode(WeakPtr<GameMode> gameMode)
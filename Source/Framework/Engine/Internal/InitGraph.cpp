@@ -0,0 +1,196 @@
+#include "Core.h"
+#include "InitGraph.h"
+#include "TaskScheduler.h"
+#include "Threading.h"
+
+#include <Windows.h>
+
+InitGraph::InitGraph()
+  : m_startTime(0)
+  , m_totalTimeMs(0)
+  , m_failed(0)
+{
+}
+
+InitGraph::~InitGraph()
+{
+  for (uint32 i = 0; i < m_steps.size(); ++i)
+    delete m_steps[i];
+}
+
+uint32 InitGraph::addStep(const String& name, const InitStepFunction& function, uint32 flags)
+{
+  InitStep* step = new InitStep();
+  step->name = name;
+  step->function = function;
+  step->flags = flags;
+  step->state = SS_PENDING;
+  step->succeeded = false;
+  step->startMs = 0;
+  step->durationMs = 0;
+
+  m_steps.push_back(step);
+  return m_steps.size() - 1;
+}
+
+void InitGraph::addDependency(uint32 step, uint32 dependsOn)
+{
+  if (step < m_steps.size() && dependsOn < m_steps.size() && step != dependsOn)
+    m_steps[step]->dependencies.push_back(dependsOn);
+}
+
+bool InitGraph::canStart(const InitStep& step) const
+{
+  for (uint32 i = 0; i < step.dependencies.size(); ++i)
+  {
+    const InitStep* dependency = m_steps[step.dependencies[i]];
+    if (dependency->state != SS_DONE || !dependency->succeeded)
+      return false;
+  }
+
+  return true;
+}
+
+void InitGraph::executeStep(InitStep& step)
+{
+  const double start = getHighResolutionTime();
+  step.succeeded = step.function();
+  const double end = getHighResolutionTime();
+
+  step.startMs = (start - m_startTime) * 1000.0;
+  step.durationMs = (end - start) * 1000.0;
+
+  if (!step.succeeded)
+    atomicExchange(&m_failed, 1);
+
+  // publishes the results above to the dispatching thread
+  atomicExchange(&step.state, SS_DONE);
+}
+
+bool InitGraph::run()
+{
+  m_startTime = getHighResolutionTime();
+  m_failed = 0;
+
+  TaskCounter counter;
+  bool stalled = false;
+
+  while (!m_failed)
+  {
+    uint32 numPending = 0;
+    bool dispatched = false;
+    InitStep* mainThreadStep = 0;
+
+    for (uint32 i = 0; i < m_steps.size(); ++i)
+    {
+      InitStep* step = m_steps[i];
+      if (step->state != SS_PENDING)
+        continue;
+
+      ++numPending;
+      if (!canStart(*step))
+        continue;
+
+      if (step->flags & ISF_MAIN_THREAD)
+      {
+        if (!mainThreadStep)
+          mainThreadStep = step;
+        continue;
+      }
+
+      step->state = SS_RUNNING;
+      dispatched = true;
+      TaskScheduler::submit([this, step]() { executeStep(*step); }, &counter);
+    }
+
+    if (numPending == 0)
+      break;
+
+    // main thread steps take precedence over helping with the queue, they are
+    // usually on the critical path (window, device)
+    if (mainThreadStep)
+    {
+      mainThreadStep->state = SS_RUNNING;
+      executeStep(*mainThreadStep);
+      stalled = false;
+      continue;
+    }
+
+    if (!dispatched && counter.isDone())
+    {
+      // a step may have finished right after the scan, so look once more
+      // before reporting the remaining steps as unreachable
+      if (stalled)
+      {
+        for (uint32 i = 0; i < m_steps.size(); ++i)
+        {
+          if (m_steps[i]->state == SS_PENDING)
+            printf("InitGraph: step '%s' has unresolved dependencies\n", m_steps[i]->name.c_str());
+        }
+
+        atomicExchange(&m_failed, 1);
+        break;
+      }
+
+      stalled = true;
+      continue;
+    }
+
+    stalled = false;
+
+    if (!TaskScheduler::executePendingTask())
+      Sleep(0);
+  }
+
+  // let running steps finish, they might still reference captured state
+  TaskScheduler::wait(counter);
+
+  m_totalTimeMs = (getHighResolutionTime() - m_startTime) * 1000.0;
+
+  return m_failed == 0;
+}
+
+void InitGraph::getTimings(std::vector<InitStepTiming>& timings) const
+{
+  timings.clear();
+  timings.reserve(m_steps.size());
+
+  for (uint32 i = 0; i < m_steps.size(); ++i)
+  {
+    const InitStep* step = m_steps[i];
+
+    InitStepTiming timing;
+    timing.name = step->name;
+    timing.startMs = step->startMs;
+    timing.durationMs = step->durationMs;
+    timing.mainThread = (step->flags & ISF_MAIN_THREAD) != 0;
+    timing.succeeded = step->state == SS_DONE && step->succeeded;
+    timings.push_back(timing);
+  }
+}
+
+void InitGraph::printReport() const
+{
+  double summedMs = 0;
+
+  printf("InitGraph: %d steps\n", (uint32)m_steps.size());
+
+  for (uint32 i = 0; i < m_steps.size(); ++i)
+  {
+    const InitStep* step = m_steps[i];
+    if (step->state != SS_DONE)
+    {
+      printf("  %-24s skipped\n", step->name.c_str());
+      continue;
+    }
+
+    printf("  %-24s start %8.2f ms  duration %8.2f ms  %s%s\n", step->name.c_str(),
+      step->startMs, step->durationMs, (step->flags & ISF_MAIN_THREAD) ? "main" : "worker",
+      step->succeeded ? "" : "  FAILED");
+
+    summedMs += step->durationMs;
+  }
+
+  // summed > total means the graph gained from running steps in parallel
+  printf("  total %.2f ms, summed step time %.2f ms\n", m_totalTimeMs, summedMs);
+}
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include <windows.h>
 #include <cmath>
 
-std::vector<Keys::eKeys> VirtualToKeyMap;
+// virtual key codes are limited to a byte
+static const uint32 NumVirtualKeys = 256;
+Keys::eKeys VirtualToKeyMap[NumVirtualKeys];
 
 InputSystem::InputSystem()
   : m_mousePos(0, 0)
@@ -27,8 +29,6 @@ bool InputSystem::init()
   // initialize virtual key to key map
 #define DEFINE_VIRTUAL_KEY_MAPPING(virtualKeyCode, keyCode) VirtualToKeyMap[(virtualKeyCode)] = (keyCode)
 
-  VirtualToKeyMap.resize(0xffff);
-
   DEFINE_VIRTUAL_KEY_MAPPING(VK_LBUTTON, Keys::LeftMouseButton);
   DEFINE_VIRTUAL_KEY_MAPPING(VK_RBUTTON, Keys::RightMouseButton);
   DEFINE_VIRTUAL_KEY_MAPPING(VK_MBUTTON, Keys::MiddleMouseButton);
@@ -87,8 +87,6 @@ bool InputSystem::init()
   for (uint16 i = 'A'; i < 'Z'; ++i)
     DEFINE_VIRTUAL_KEY_MAPPING(i, (Keys::eKeys)(Keys::A + (i - 'A')));
 
-  VirtualToKeyMap.shrink_to_fit();
-
 #undef DEFINE_VIRTUAL_KEY_MAPPING
 
   POINT cursorPos;
@@ -138,12 +136,18 @@ void InputSystem::tick(float deltaT)
 
 void InputSystem::onKeyDown(uint16 keyCode, bool repeated)
 {
+  if (keyCode >= NumVirtualKeys)
+    return;
+
   m_keyState[VirtualToKeyMap[keyCode]].isPressed = true;
   m_keyState[VirtualToKeyMap[keyCode]].wasPressed = repeated;
 }
 
 void InputSystem::onKeyUp(uint16 keyCode)
 {
+  if (keyCode >= NumVirtualKeys)
+    return;
+
   m_keyState[VirtualToKeyMap[keyCode]].wasPressed = false;
   m_keyState[VirtualToKeyMap[keyCode]].isPressed = false;
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef __FrameClock_h_
+#define __FrameClock_h_
+
+// rolling histogram over the most recent frame times, cheap enough to feed every frame.
+// samples are binned, so percentiles are accurate to the bucket width.
+class FrameTimeHistogram
+{
+public:
+  static const uint32 WindowSize = 512;
+  static const uint32 NumBuckets = 1000;
+  static const float BucketWidthMs;
+
+  FrameTimeHistogram();
+
+  void reset();
+  void addSample(float frameTimeMs);
+
+  // p in [0, 1], e.g. 0.95 for the 95th percentile
+  float getPercentile(float p) const;
+  float getAverage() const;
+  float getMax() const;
+  uint32 getNumSamples() const { return m_numSamples; }
+
+private:
+  static uint32 getBucket(float frameTimeMs);
+
+  float m_samples[WindowSize];
+  uint16 m_buckets[NumBuckets];
+  uint32 m_nextSample;
+  uint32 m_numSamples;
+  double m_sum;
+};
+
+// measures the frame delta with the high resolution timer. game time can be scaled
+// and paused, the unscaled real time keeps running.
+class FrameClock
+{
+public:
+  FrameClock();
+
+  void reset();
+
+  // call once per frame before ticking the systems
+  void tick();
+
+  // scaled and smoothed, 0 while paused
+  float getDeltaTime() const { return m_deltaTime; }
+  // scaled and clamped but not smoothed, summing these doesn't drift from real time
+  float getUnsmoothedDeltaTime() const { return m_unsmoothedDeltaTime; }
+  // measured delta of the last frame, neither scaled nor smoothed
+  float getRealDeltaTime() const { return m_realDeltaTime; }
+
+  // sum of the unsmoothed deltas
+  double getGameTime() const { return m_gameTime; }
+  double getRealTime() const { return m_realTime; }
+  uint64 getFrameIndex() const { return m_frameIndex; }
+
+  void setTimeScale(float scale) { m_timeScale = max(scale, 0.0f); }
+  float getTimeScale() const { return m_timeScale; }
+
+  void setPaused(bool paused) { m_paused = paused; }
+  bool isPaused() const { return m_paused; }
+
+  // weight of the newest frame in the smoothed delta, 1 disables smoothing
+  void setSmoothing(float factor) { m_smoothing = clamp(factor, 0.01f, 1.0f); }
+
+  // longer frames (debugger breaks, loading hitches) are clamped to this
+  void setMaxDeltaTime(float seconds) { m_maxDeltaTime = seconds; }
+
+  const FrameTimeHistogram& getHistogram() const { return m_histogram; }
+
+private:
+  double m_lastTime;
+  double m_realTime;
+  double m_gameTime;
+  float m_realDeltaTime;
+  float m_smoothedDeltaTime;
+  float m_deltaTime;
+  float m_unsmoothedDeltaTime;
+  float m_timeScale;
+  float m_smoothing;
+  float m_maxDeltaTime;
+  uint64 m_frameIndex;
+  bool m_paused;
+  FrameTimeHistogram m_histogram;
+};
+
+#endif // __FrameClock_h_
\ No newline at end of file
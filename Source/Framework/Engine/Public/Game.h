@@ -1,6 +1,8 @@
 #ifndef __Game_h_
 #define __Game_h_
 
+#include "FrameClock.h"
+
 class Game
 {
 public:
@@ -12,11 +14,16 @@ public:
   void run();
 
   WeakPtr<RenderSystem> getRenderSystem() const { return m_renderSystem; }
+  // copying the WeakPtr is not thread safe, worker threads use the raw pointer
+  RenderSystem* getRenderSystemPtr() const { return m_renderSystem.get(); }
   WeakPtr<InputSystem> getInputSystem() const { return m_inputSystem; }
 #if defined (_DEBUG)
   WeakPtr<DebugGeometryRenderer> getDebugGeometryRenderer() const { return m_debugGeomRenderer; }
 #endif // _DEBUG
 
+  FrameClock& getFrameClock() { return m_frameClock; }
+  const FrameClock& getFrameClock() const { return m_frameClock; }
+
   uint32 getViewportWidth() const { return m_viewportWidth; }
   uint32 getViewportHeight() const { return m_viewportHeight; }
 
@@ -25,12 +32,20 @@ protected:
   
   bool createRenderWindow(const InitParams& params);
 
+  // returns the interpolation alpha between the last two simulation steps
+  float tickSimulation(float deltaT);
+
   SharedPtr<RenderSystem> m_renderSystem;
   SharedPtr<InputSystem> m_inputSystem;
 #if defined (_DEBUG)
   SharedPtr<DebugGeometryRenderer> m_debugGeomRenderer;
 #endif // _DEBUG
 
+  FrameClock m_frameClock;
+  float m_fixedTimeStep;
+  uint32 m_maxSubSteps;
+  float m_timeAccumulator;
+
   void* m_windowHandle;
   uint32 m_viewportWidth;
   uint32 m_viewportHeight;
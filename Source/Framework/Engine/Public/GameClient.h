@@ -11,14 +11,16 @@ struct SceneView
 class GameMode
 {
 public:
-  virtual void tick(float time, GameClient& client) = 0;
+  // deltaT is the scaled frame time in seconds, see FrameClock
+  virtual void tick(float deltaT, GameClient& client) = 0;
+  // once per frame before the simulation steps, deltaT is the frame time. the mouse movement
+  // covers the whole frame, so it must not be read from tick, which runs a varying number of
+  // times per frame with fixed stepping
+  virtual void handleUserInput(float deltaT) = 0;
 
   /// this is only temporary for test use, remove this
   virtual void getCurrentView(SceneView& view) = 0;
 
-protected:
-  virtual void handleUserInput() = 0;
-
 private:
 };
 
@@ -28,17 +30,22 @@ public:
   GameClient();
   ~GameClient();
 
+  // runs on a worker thread during startup, only use the device here, not the immediate context
   virtual void initResources() {}
 
-  void tick(float time);
-  void render(float time);
+  void handleUserInput(float deltaT);
+  void tick(float deltaT);
+  // alpha in [0, 1] blends between the last two fixed simulation steps, 1 without fixed stepping
+  void render(float deltaT, float interpolationAlpha = 1.0f);
   void pushGameMode(WeakPtr<GameMode> gameMode);
   void popGameMode();
   void getCurrentView(SceneView& view);
 
 protected:
-  virtual void tickIntern(float time) {}
-  virtual void renderIntern(float time) {}
+  virtual void tickIntern(float deltaT) {}
+  // clients without interpolation keep overriding the single argument version
+  virtual void renderIntern(float deltaT, float interpolationAlpha) { renderIntern(deltaT); }
+  virtual void renderIntern(float deltaT) {}
 
   std::stack<WeakPtr<GameMode>> m_gameModeStack; // FIXME: should hold WeakPtr
   WeakPtr<GameMode> m_currentGameMode;
@@ -0,0 +1,73 @@
+#ifndef __InitGraph_h_
+#define __InitGraph_h_
+
+#include <functional>
+
+typedef std::function<bool()> InitStepFunction;
+
+enum eInitStepFlags
+{
+  ISF_NONE        = 0x000,
+  ISF_MAIN_THREAD = 0x001,  // run on the thread calling InitGraph::run (window, swap chain)
+};
+
+struct InitStepTiming
+{
+  String name;
+  double startMs;
+  double durationMs;
+  bool mainThread;
+  bool succeeded;
+};
+
+// startup steps with declared dependencies. steps without pending dependencies
+// run in parallel on the task scheduler, the timings are kept for a report.
+class InitGraph
+{
+public:
+  InitGraph();
+  ~InitGraph();
+
+  uint32 addStep(const String& name, const InitStepFunction& function, uint32 flags = ISF_NONE);
+  void addDependency(uint32 step, uint32 dependsOn);
+
+  // returns false if any step failed, steps depending on a failed one are skipped
+  bool run();
+
+  double getTotalTimeMs() const { return m_totalTimeMs; }
+  void getTimings(std::vector<InitStepTiming>& timings) const;
+  void printReport() const;
+
+private:
+  InitGraph(const InitGraph&);
+  InitGraph& operator=(const InitGraph&);
+
+  enum eStepState
+  {
+    SS_PENDING,
+    SS_RUNNING,
+    SS_DONE
+  };
+
+  struct InitStep
+  {
+    String name;
+    InitStepFunction function;
+    uint32 flags;
+    std::vector<uint32> dependencies;
+    volatile long state;
+    bool succeeded;
+    double startMs;
+    double durationMs;
+  };
+
+  bool canStart(const InitStep& step) const;
+  void executeStep(InitStep& step);
+
+  std::vector<InitStep*> m_steps;
+  double m_startTime;
+  double m_totalTimeMs;
+  volatile long m_failed;
+};
+
+#endif // __InitGraph_h_
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Core.h"
+#include "AffineTransform.h"
+
+AffineTransform AffineTransform::Identity = AffineTransform(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0);
+
+#if defined (SUPPORT_SIMD_MATH)
+
+AffineTransform inverse(const AffineTransform& t)
+{
+  const __m128 maskXYZ = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+  const __m128 row0 = t.loadRow(0);
+  const __m128 row1 = t.loadRow(1);
+  const __m128 row2 = t.loadRow(2);
+
+  const __m128 r0 = _mm_and_ps(row0, maskXYZ);
+  const __m128 r1 = _mm_and_ps(row1, maskXYZ);
+  const __m128 r2 = _mm_and_ps(row2, maskXYZ);
+
+  // the columns of the adjugate
+  __m128 c0 = simdCross3(r1, r2);
+  __m128 c1 = simdCross3(r2, r0);
+  __m128 c2 = simdCross3(r0, r1);
+
+  // relative to the magnitude, like the Matrix4 inverse
+  const __m128 det = simdDot4(r0, c0);
+  if (!(fabsf(_mm_cvtss_f32(det)) > EPSILON * _mm_cvtss_f32(simdDeterminantBound3(r0, r1, r2))))
+    return AffineTransform::Identity;
+
+  // -adj * translation, becomes the w column after the transpose
+  __m128 c3 = _mm_mul_ps(c0, SIMD_SPLAT(row0, 3));
+  c3 = _mm_add_ps(c3, _mm_mul_ps(c1, SIMD_SPLAT(row1, 3)));
+  c3 = _mm_add_ps(c3, _mm_mul_ps(c2, SIMD_SPLAT(row2, 3)));
+  c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+  const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+  AffineTransform result;
+  result.storeRow(0, _mm_mul_ps(c0, invDet));
+  result.storeRow(1, _mm_mul_ps(c1, invDet));
+  result.storeRow(2, _mm_mul_ps(c2, invDet));
+  return result;
+}
+
+#else
+
+AffineTransform inverse(const AffineTransform& t)
+{
+  const Vector3 r0(t[0], t[1], t[2]);
+  const Vector3 r1(t[4], t[5], t[6]);
+  const Vector3 r2(t[8], t[9], t[10]);
+
+  const Vector3 c0 = cross(r1, r2);
+  const Vector3 c1 = cross(r2, r0);
+  const Vector3 c2 = cross(r0, r1);
+
+  // relative to the magnitude, like the Matrix4 inverse
+  const float det = dot(r0, c0);
+  if (!(fabsf(det) > EPSILON * determinantBound(r0, r1, r2)))
+    return AffineTransform::Identity;
+
+  const float invDet = 1.0f / det;
+  const Vector3 c3 = -(c0 * t[3] + c1 * t[7] + c2 * t[11]);
+
+  return AffineTransform(
+    c0.x * invDet, c1.x * invDet, c2.x * invDet, c3.x * invDet,
+    c0.y * invDet, c1.y * invDet, c2.y * invDet, c3.y * invDet,
+    c0.z * invDet, c1.z * invDet, c2.z * invDet, c3.z * invDet);
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+void makeAffineTransform(AffineTransform& t, const Quaternion& rotation, const Vector3& translation, const Vector3& scale)
+{
+  const Quaternion& q = rotation;
+  const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+  // R * S, the scale goes into the columns
+  t = AffineTransform(
+    (1 - 2 * (yy + zz)) * scale.x,  2 * (xy - wz) * scale.y,        2 * (xz + wy) * scale.z,        translation.x,
+    2 * (xy + wz) * scale.x,        (1 - 2 * (xx + zz)) * scale.y,  2 * (yz - wx) * scale.z,        translation.y,
+    2 * (xz - wy) * scale.x,        2 * (yz + wx) * scale.y,        (1 - 2 * (xx + yy)) * scale.z,  translation.z);
+}
+
+void makeMatrix(Matrix4& mat, const AffineTransform& t)
+{
+  mat = Matrix4(
+    t[0], t[1], t[2], t[3],
+    t[4], t[5], t[6], t[7],
+    t[8], t[9], t[10], t[11],
+    0, 0, 0, 1);
+}
\ No newline at end of file
@@ -0,0 +1,612 @@
+#include "Core.h"
+#include "BatchMath.h"
+
+namespace
+{
+  enum eTransformMode
+  {
+    TM_POINT,
+    TM_VECTOR,
+    TM_PROJECT
+  };
+
+  template<eTransformMode Mode>
+  inline void transformScalar(const Matrix4& m, float x, float y, float z, float* out)
+  {
+    float rx = m[0] * x + m[1] * y + m[2] * z;
+    float ry = m[4] * x + m[5] * y + m[6] * z;
+    float rz = m[8] * x + m[9] * y + m[10] * z;
+
+    if (Mode != TM_VECTOR)
+    {
+      rx += m[3];
+      ry += m[7];
+      rz += m[11];
+    }
+
+    if (Mode == TM_PROJECT)
+    {
+      const float invW = 1.0f / (m[12] * x + m[13] * y + m[14] * z + m[15]);
+      rx *= invW;
+      ry *= invW;
+      rz *= invW;
+    }
+
+    // written last, input and output may alias
+    out[0] = rx;
+    out[1] = ry;
+    out[2] = rz;
+  }
+
+#if defined (SUPPORT_SIMD_MATH)
+
+  // matrix elements broadcast to all lanes
+  struct SimdMatrix4
+  {
+    explicit SimdMatrix4(const Matrix4& mat)
+    {
+      for (int i = 0; i < 16; ++i)
+        m[i] = _mm_set1_ps(mat[i]);
+    }
+
+    __m128 m[16];
+  };
+
+  template<eTransformMode Mode>
+  inline void transform4(const SimdMatrix4& mat, __m128& x, __m128& y, __m128& z)
+  {
+    __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mat.m[0], x), _mm_mul_ps(mat.m[1], y)), _mm_mul_ps(mat.m[2], z));
+    __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mat.m[4], x), _mm_mul_ps(mat.m[5], y)), _mm_mul_ps(mat.m[6], z));
+    __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mat.m[8], x), _mm_mul_ps(mat.m[9], y)), _mm_mul_ps(mat.m[10], z));
+
+    if (Mode != TM_VECTOR)
+    {
+      rx = _mm_add_ps(rx, mat.m[3]);
+      ry = _mm_add_ps(ry, mat.m[7]);
+      rz = _mm_add_ps(rz, mat.m[11]);
+    }
+
+    if (Mode == TM_PROJECT)
+    {
+      __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mat.m[12], x), _mm_mul_ps(mat.m[13], y)), _mm_mul_ps(mat.m[14], z));
+      w = _mm_add_ps(w, mat.m[15]);
+
+      rx = _mm_div_ps(rx, w);
+      ry = _mm_div_ps(ry, w);
+      rz = _mm_div_ps(rz, w);
+    }
+
+    x = rx;
+    y = ry;
+    z = rz;
+  }
+
+  // (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3) <-> (x0 x1 x2 x3) (y0 y1 y2 y3) (z0 z1 z2 z3)
+  inline void deinterleave4(__m128& v0, __m128& v1, __m128& v2)
+  {
+    const __m128 t0 = _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m128 t1 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1));
+    const __m128 t2 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2));
+
+    const __m128 x = _mm_shuffle_ps(v0, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    const __m128 y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    const __m128 z = _mm_shuffle_ps(t2, v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+    v0 = x;
+    v1 = y;
+    v2 = z;
+  }
+
+  inline void interleave4(__m128& x, __m128& y, __m128& z)
+  {
+    const __m128 v0 = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 v1 = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 v2 = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    x = v0;
+    y = v1;
+    z = v2;
+  }
+
+#endif // SUPPORT_SIMD_MATH
+
+#if defined (SUPPORT_AVX_MATH)
+
+  struct SimdMatrix8
+  {
+    explicit SimdMatrix8(const Matrix4& mat)
+    {
+      for (int i = 0; i < 16; ++i)
+        m[i] = _mm256_set1_ps(mat[i]);
+    }
+
+    __m256 m[16];
+  };
+
+  template<eTransformMode Mode>
+  inline void transform8(const SimdMatrix8& mat, __m256& x, __m256& y, __m256& z)
+  {
+    __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mat.m[0], x), _mm256_mul_ps(mat.m[1], y)), _mm256_mul_ps(mat.m[2], z));
+    __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mat.m[4], x), _mm256_mul_ps(mat.m[5], y)), _mm256_mul_ps(mat.m[6], z));
+    __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mat.m[8], x), _mm256_mul_ps(mat.m[9], y)), _mm256_mul_ps(mat.m[10], z));
+
+    if (Mode != TM_VECTOR)
+    {
+      rx = _mm256_add_ps(rx, mat.m[3]);
+      ry = _mm256_add_ps(ry, mat.m[7]);
+      rz = _mm256_add_ps(rz, mat.m[11]);
+    }
+
+    if (Mode == TM_PROJECT)
+    {
+      __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(mat.m[12], x), _mm256_mul_ps(mat.m[13], y)), _mm256_mul_ps(mat.m[14], z));
+      w = _mm256_add_ps(w, mat.m[15]);
+
+      rx = _mm256_div_ps(rx, w);
+      ry = _mm256_div_ps(ry, w);
+      rz = _mm256_div_ps(rz, w);
+    }
+
+    x = rx;
+    y = ry;
+    z = rz;
+  }
+
+  // same shuffles as the sse version, each 128 bit lane holds a group of 4 points
+  inline void deinterleave8(__m256& v0, __m256& v1, __m256& v2)
+  {
+    const __m256 t0 = _mm256_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m256 t1 = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1));
+    const __m256 t2 = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2));
+
+    const __m256 x = _mm256_shuffle_ps(v0, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    const __m256 y = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256 z = _mm256_shuffle_ps(t2, v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+    v0 = x;
+    v1 = y;
+    v2 = z;
+  }
+
+  inline void interleave8(__m256& x, __m256& y, __m256& z)
+  {
+    const __m256 v0 = _mm256_shuffle_ps(_mm256_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 v1 = _mm256_shuffle_ps(_mm256_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 v2 = _mm256_shuffle_ps(_mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    x = v0;
+    y = v1;
+    z = v2;
+  }
+
+  inline __m256 load2x128(const float* low, const float* high)
+  {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+  }
+
+  inline void store2x128(float* low, float* high, const __m256& value)
+  {
+    _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+  }
+
+#endif // SUPPORT_AVX_MATH
+
+  template<eTransformMode Mode>
+  void transformAoS(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count)
+  {
+    const float* src = (const float*)in;
+    float* dst = (float*)out;
+    uint32 i = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+    {
+      const SimdMatrix8 simdMat(mat);
+
+      // points 0-3 go to the low lanes, 4-7 to the high lanes
+      for (; i + 8 <= count; i += 8, src += 24, dst += 24)
+      {
+        __m256 v0 = load2x128(src, src + 12);
+        __m256 v1 = load2x128(src + 4, src + 16);
+        __m256 v2 = load2x128(src + 8, src + 20);
+
+        deinterleave8(v0, v1, v2);
+        transform8<Mode>(simdMat, v0, v1, v2);
+        interleave8(v0, v1, v2);
+
+        store2x128(dst, dst + 12, v0);
+        store2x128(dst + 4, dst + 16, v1);
+        store2x128(dst + 8, dst + 20, v2);
+      }
+    }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+    {
+      const SimdMatrix4 simdMat(mat);
+
+      for (; i + 4 <= count; i += 4, src += 12, dst += 12)
+      {
+        __m128 v0 = _mm_loadu_ps(src);
+        __m128 v1 = _mm_loadu_ps(src + 4);
+        __m128 v2 = _mm_loadu_ps(src + 8);
+
+        deinterleave4(v0, v1, v2);
+        transform4<Mode>(simdMat, v0, v1, v2);
+        interleave4(v0, v1, v2);
+
+        _mm_storeu_ps(dst, v0);
+        _mm_storeu_ps(dst + 4, v1);
+        _mm_storeu_ps(dst + 8, v2);
+      }
+    }
+#endif // SUPPORT_SIMD_MATH
+
+    for (; i < count; ++i, src += 3, dst += 3)
+      transformScalar<Mode>(mat, src[0], src[1], src[2], dst);
+  }
+
+  template<eTransformMode Mode>
+  void transformSoA(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count)
+  {
+    uint32 i = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+    {
+      const SimdMatrix8 simdMat(mat);
+
+      for (; i + 8 <= count; i += 8)
+      {
+        __m256 x = _mm256_loadu_ps(in.x + i);
+        __m256 y = _mm256_loadu_ps(in.y + i);
+        __m256 z = _mm256_loadu_ps(in.z + i);
+
+        transform8<Mode>(simdMat, x, y, z);
+
+        _mm256_storeu_ps(out.x + i, x);
+        _mm256_storeu_ps(out.y + i, y);
+        _mm256_storeu_ps(out.z + i, z);
+      }
+    }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+    {
+      const SimdMatrix4 simdMat(mat);
+
+      for (; i + 4 <= count; i += 4)
+      {
+        __m128 x = _mm_loadu_ps(in.x + i);
+        __m128 y = _mm_loadu_ps(in.y + i);
+        __m128 z = _mm_loadu_ps(in.z + i);
+
+        transform4<Mode>(simdMat, x, y, z);
+
+        _mm_storeu_ps(out.x + i, x);
+        _mm_storeu_ps(out.y + i, y);
+        _mm_storeu_ps(out.z + i, z);
+      }
+    }
+#endif // SUPPORT_SIMD_MATH
+
+    for (; i < count; ++i)
+    {
+      float result[3];
+      transformScalar<Mode>(mat, in.x[i], in.y[i], in.z[i], result);
+      out.x[i] = result[0];
+      out.y[i] = result[1];
+      out.z[i] = result[2];
+    }
+  }
+}
+
+void transformPoints(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count)
+{
+  transformAoS<TM_POINT>(mat, in, out, count);
+}
+
+void transformPoints(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count)
+{
+  transformSoA<TM_POINT>(mat, in, out, count);
+}
+
+void transformVectors(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count)
+{
+  transformAoS<TM_VECTOR>(mat, in, out, count);
+}
+
+void transformVectors(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count)
+{
+  transformSoA<TM_VECTOR>(mat, in, out, count);
+}
+
+void transformAndProject(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count)
+{
+  transformAoS<TM_PROJECT>(mat, in, out, count);
+}
+
+void transformAndProject(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count)
+{
+  transformSoA<TM_PROJECT>(mat, in, out, count);
+}
+
+namespace
+{
+#if defined (SUPPORT_SIMD_MATH)
+
+  template<eNormalizePrecision Precision>
+  inline void normalize4(__m128& x, __m128& y, __m128& z)
+  {
+    const __m128 squaredLength = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+
+    __m128 invLength;
+    if (Precision == NP_EXACT)
+    {
+      invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(squaredLength));
+    }
+    else
+    {
+      invLength = _mm_rsqrt_ps(squaredLength);
+
+      if (Precision == NP_REFINED)
+      {
+        // r' = r * (1.5 - 0.5 * l * r * r)
+        const __m128 halfLength = _mm_mul_ps(squaredLength, _mm_set1_ps(0.5f));
+        const __m128 correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfLength, _mm_mul_ps(invLength, invLength)));
+        invLength = _mm_mul_ps(invLength, correction);
+      }
+    }
+
+    // zero length gives inf or nan, masked to 0 so the result is the zero vector
+    invLength = _mm_and_ps(invLength, _mm_cmpgt_ps(squaredLength, _mm_setzero_ps()));
+
+    x = _mm_mul_ps(x, invLength);
+    y = _mm_mul_ps(y, invLength);
+    z = _mm_mul_ps(z, invLength);
+  }
+
+#endif // SUPPORT_SIMD_MATH
+
+#if defined (SUPPORT_AVX_MATH)
+
+  template<eNormalizePrecision Precision>
+  inline void normalize8(__m256& x, __m256& y, __m256& z)
+  {
+    const __m256 squaredLength = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+
+    __m256 invLength;
+    if (Precision == NP_EXACT)
+    {
+      invLength = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(squaredLength));
+    }
+    else
+    {
+      invLength = _mm256_rsqrt_ps(squaredLength);
+
+      if (Precision == NP_REFINED)
+      {
+        const __m256 halfLength = _mm256_mul_ps(squaredLength, _mm256_set1_ps(0.5f));
+        const __m256 correction = _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(halfLength, _mm256_mul_ps(invLength, invLength)));
+        invLength = _mm256_mul_ps(invLength, correction);
+      }
+    }
+
+    invLength = _mm256_and_ps(invLength, _mm256_cmp_ps(squaredLength, _mm256_setzero_ps(), _CMP_GT_OQ));
+
+    x = _mm256_mul_ps(x, invLength);
+    y = _mm256_mul_ps(y, invLength);
+    z = _mm256_mul_ps(z, invLength);
+  }
+
+#endif // SUPPORT_AVX_MATH
+
+  template<eNormalizePrecision Precision>
+  void normalizeAoS(const Vector3* in, Vector3* out, uint32 count)
+  {
+    const float* src = (const float*)in;
+    float* dst = (float*)out;
+    uint32 i = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+    for (; i + 8 <= count; i += 8, src += 24, dst += 24)
+    {
+      __m256 v0 = load2x128(src, src + 12);
+      __m256 v1 = load2x128(src + 4, src + 16);
+      __m256 v2 = load2x128(src + 8, src + 20);
+
+      deinterleave8(v0, v1, v2);
+      normalize8<Precision>(v0, v1, v2);
+      interleave8(v0, v1, v2);
+
+      store2x128(dst, dst + 12, v0);
+      store2x128(dst + 4, dst + 16, v1);
+      store2x128(dst + 8, dst + 20, v2);
+    }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+    for (; i + 4 <= count; i += 4, src += 12, dst += 12)
+    {
+      __m128 v0 = _mm_loadu_ps(src);
+      __m128 v1 = _mm_loadu_ps(src + 4);
+      __m128 v2 = _mm_loadu_ps(src + 8);
+
+      deinterleave4(v0, v1, v2);
+      normalize4<Precision>(v0, v1, v2);
+      interleave4(v0, v1, v2);
+
+      _mm_storeu_ps(dst, v0);
+      _mm_storeu_ps(dst + 4, v1);
+      _mm_storeu_ps(dst + 8, v2);
+    }
+#endif // SUPPORT_SIMD_MATH
+
+    for (; i < count; ++i)
+      out[i] = normalize(in[i]);
+  }
+
+  template<eNormalizePrecision Precision>
+  void normalizeSoA(const Vector3SoA& in, const Vector3SoA& out, uint32 count)
+  {
+    uint32 i = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+    for (; i + 8 <= count; i += 8)
+    {
+      __m256 x = _mm256_loadu_ps(in.x + i);
+      __m256 y = _mm256_loadu_ps(in.y + i);
+      __m256 z = _mm256_loadu_ps(in.z + i);
+
+      normalize8<Precision>(x, y, z);
+
+      _mm256_storeu_ps(out.x + i, x);
+      _mm256_storeu_ps(out.y + i, y);
+      _mm256_storeu_ps(out.z + i, z);
+    }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 x = _mm_loadu_ps(in.x + i);
+      __m128 y = _mm_loadu_ps(in.y + i);
+      __m128 z = _mm_loadu_ps(in.z + i);
+
+      normalize4<Precision>(x, y, z);
+
+      _mm_storeu_ps(out.x + i, x);
+      _mm_storeu_ps(out.y + i, y);
+      _mm_storeu_ps(out.z + i, z);
+    }
+#endif // SUPPORT_SIMD_MATH
+
+    for (; i < count; ++i)
+    {
+      const Vector3 v = normalize(Vector3(in.x[i], in.y[i], in.z[i]));
+      out.x[i] = v.x;
+      out.y[i] = v.y;
+      out.z[i] = v.z;
+    }
+  }
+
+  // pi / 4 split in three parts for an extended precision range reduction
+  const float SinCosReduce1 = 0.78515625f;
+  const float SinCosReduce2 = 2.4187564849853515625e-4f;
+  const float SinCosReduce3 = 3.77489497744594108e-8f;
+  const float FourOverPi = 1.27323954473516f;
+
+  // minimax polynomials on [-pi / 4, pi / 4]
+  const float SinCoeff0 = -1.9515295891e-4f;
+  const float SinCoeff1 = 8.3321608736e-3f;
+  const float SinCoeff2 = -1.6666654611e-1f;
+  const float CosCoeff0 = 2.443315711809948e-5f;
+  const float CosCoeff1 = -1.388731625493765e-3f;
+  const float CosCoeff2 = 4.166664568298827e-2f;
+
+  void sinCosScalar(float angle, float& sine, float& cosine)
+  {
+    // same steps as the simd version, so all elements get the same precision
+    float x = fabsf(angle);
+    int octant = (int)(x * FourOverPi);
+    octant = (octant + 1) & ~1;
+
+    const float y = (float)octant;
+    x = ((x - y * SinCosReduce1) - y * SinCosReduce2) - y * SinCosReduce3;
+
+    const float z = x * x;
+    const float s = ((SinCoeff0 * z + SinCoeff1) * z + SinCoeff2) * z * x + x;
+    const float c = ((CosCoeff0 * z + CosCoeff1) * z + CosCoeff2) * z * z - 0.5f * z + 1.0f;
+
+    const bool swap = (octant & 2) != 0;
+    sine = swap ? c : s;
+    cosine = swap ? s : c;
+
+    if (((octant & 4) != 0) != (angle < 0.0f))
+      sine = -sine;
+    if (((octant - 2) & 4) == 0)
+      cosine = -cosine;
+  }
+}
+
+void normalizeArray(const Vector3* in, Vector3* out, uint32 count, eNormalizePrecision precision)
+{
+  switch (precision)
+  {
+  case NP_APPROXIMATE: normalizeAoS<NP_APPROXIMATE>(in, out, count); break;
+  case NP_REFINED: normalizeAoS<NP_REFINED>(in, out, count); break;
+  default: normalizeAoS<NP_EXACT>(in, out, count); break;
+  }
+}
+
+void normalizeArray(const Vector3SoA& in, const Vector3SoA& out, uint32 count, eNormalizePrecision precision)
+{
+  switch (precision)
+  {
+  case NP_APPROXIMATE: normalizeSoA<NP_APPROXIMATE>(in, out, count); break;
+  case NP_REFINED: normalizeSoA<NP_REFINED>(in, out, count); break;
+  default: normalizeSoA<NP_EXACT>(in, out, count); break;
+  }
+}
+
+void sinCosArray(const float* angles, float* sines, float* cosines, uint32 count)
+{
+  uint32 i = 0;
+
+  // avx1 has no 256 bit integer instructions for the octant math, so avx builds use this as well
+#if defined (SUPPORT_SIMD_MATH)
+  const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 angle = _mm_loadu_ps(angles + i);
+    const __m128 angleSign = _mm_and_ps(angle, signMask);
+    __m128 x = _mm_andnot_ps(signMask, angle);
+
+    // round the octant up to even, odd octants map to the next zero
+    __m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(FourOverPi)));
+    octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+
+    const __m128 y = _mm_cvtepi32_ps(octant);
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(SinCosReduce1)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(SinCosReduce2)));
+    x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(SinCosReduce3)));
+
+    const __m128 z = _mm_mul_ps(x, x);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SinCoeff0), z), _mm_set1_ps(SinCoeff1));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(SinCoeff2));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CosCoeff0), z), _mm_set1_ps(CosCoeff1));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(CosCoeff2));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+    const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+    __m128 sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+    __m128 cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+    // octant bit 2 moved up to the sign bit
+    const __m128 sineSign = _mm_xor_ps(angleSign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)));
+    const __m128i cosineFlip = _mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4));
+    sine = _mm_xor_ps(sine, sineSign);
+    cosine = _mm_xor_ps(cosine, _mm_castsi128_ps(_mm_slli_epi32(cosineFlip, 29)));
+
+    if (sines)
+      _mm_storeu_ps(sines + i, sine);
+    if (cosines)
+      _mm_storeu_ps(cosines + i, cosine);
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+  {
+    float sine, cosine;
+    sinCosScalar(angles[i], sine, cosine);
+
+    if (sines)
+      sines[i] = sine;
+    if (cosines)
+      cosines[i] = cosine;
+  }
+}
\ No newline at end of file
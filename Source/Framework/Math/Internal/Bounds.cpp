@@ -0,0 +1,318 @@
+#include "Core.h"
+#include "Bounds.h"
+
+void AABB::merge(const Vector3& point)
+{
+  minimum = Vector3(min(minimum.x, point.x), min(minimum.y, point.y), min(minimum.z, point.z));
+  maximum = Vector3(max(maximum.x, point.x), max(maximum.y, point.y), max(maximum.z, point.z));
+}
+
+void AABB::merge(const AABB& box)
+{
+  minimum = Vector3(min(minimum.x, box.minimum.x), min(minimum.y, box.minimum.y), min(minimum.z, box.minimum.z));
+  maximum = Vector3(max(maximum.x, box.maximum.x), max(maximum.y, box.maximum.y), max(maximum.z, box.maximum.z));
+}
+
+bool AABB::contains(const Vector3& point) const
+{
+  return point.x >= minimum.x && point.y >= minimum.y && point.z >= minimum.z &&
+    point.x <= maximum.x && point.y <= maximum.y && point.z <= maximum.z;
+}
+
+void BoundingSphere::merge(const Vector3& point)
+{
+  merge(BoundingSphere(point, 0.0f));
+}
+
+void BoundingSphere::merge(const BoundingSphere& sphere)
+{
+  if (sphere.isEmpty())
+    return;
+
+  if (isEmpty())
+  {
+    *this = sphere;
+    return;
+  }
+
+  const Vector3 offset = sphere.center - center;
+  const float distance = length(offset);
+
+  // one contains the other
+  if (distance + sphere.radius <= radius)
+    return;
+
+  if (distance + radius <= sphere.radius)
+  {
+    *this = sphere;
+    return;
+  }
+
+  const float newRadius = (distance + radius + sphere.radius) * 0.5f;
+  center = center + offset * ((newRadius - radius) / distance);
+  radius = newRadius;
+}
+
+bool BoundingSphere::contains(const Vector3& point) const
+{
+  return squaredLength(point - center) <= radius * radius;
+}
+
+AABB transform(const Matrix4& mat, const AABB& box)
+{
+  if (box.isEmpty())
+    return box;
+
+  // arvo, transformed center plus the extent projected on the absolute matrix
+  const Vector3 center = box.getCenter();
+  const Vector3 extent = box.getExtent();
+
+  const Vector3 newCenter = mat * center;
+  const Vector3 newExtent(
+    fabsf(mat[0]) * extent.x + fabsf(mat[1]) * extent.y + fabsf(mat[2]) * extent.z,
+    fabsf(mat[4]) * extent.x + fabsf(mat[5]) * extent.y + fabsf(mat[6]) * extent.z,
+    fabsf(mat[8]) * extent.x + fabsf(mat[9]) * extent.y + fabsf(mat[10]) * extent.z);
+
+  return AABB(newCenter - newExtent, newCenter + newExtent);
+}
+
+BoundingSphere transform(const Matrix4& mat, const BoundingSphere& sphere)
+{
+  if (sphere.isEmpty())
+    return sphere;
+
+  // non uniform scale grows the radius by the largest axis scale
+  const float scaleX = mat[0] * mat[0] + mat[4] * mat[4] + mat[8] * mat[8];
+  const float scaleY = mat[1] * mat[1] + mat[5] * mat[5] + mat[9] * mat[9];
+  const float scaleZ = mat[2] * mat[2] + mat[6] * mat[6] + mat[10] * mat[10];
+
+  return BoundingSphere(mat * sphere.center, sphere.radius * sqrtf(max(scaleX, max(scaleY, scaleZ))));
+}
+
+bool intersects(const AABB& a, const AABB& b)
+{
+  return a.minimum.x <= b.maximum.x && a.maximum.x >= b.minimum.x &&
+    a.minimum.y <= b.maximum.y && a.maximum.y >= b.minimum.y &&
+    a.minimum.z <= b.maximum.z && a.maximum.z >= b.minimum.z;
+}
+
+bool intersects(const BoundingSphere& a, const BoundingSphere& b)
+{
+  const float radius = a.radius + b.radius;
+  return !a.isEmpty() && !b.isEmpty() && squaredLength(a.center - b.center) <= radius * radius;
+}
+
+bool intersects(const AABB& box, const BoundingSphere& sphere)
+{
+  if (box.isEmpty() || sphere.isEmpty())
+    return false;
+
+  // distance to the closest point of the box
+  const Vector3 closest(
+    clamp(sphere.center.x, box.minimum.x, box.maximum.x),
+    clamp(sphere.center.y, box.minimum.y, box.maximum.y),
+    clamp(sphere.center.z, box.minimum.z, box.maximum.z));
+
+  return squaredLength(closest - sphere.center) <= sphere.radius * sphere.radius;
+}
+
+void computeBounds(AABB& box, const Vector3* points, uint32 count)
+{
+  box = AABB();
+
+  const float* src = (const float*)points;
+  uint32 i = 0;
+
+  // the packed xyz pattern repeats every 4 (12 floats) or 8 points (24 floats), so
+  // each register lane always sees the same component and no shuffles are needed
+  // until the lanes are folded at the end
+  float lanesMin[24];
+  float lanesMax[24];
+  uint32 numLanePoints = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+  if (count >= 8)
+  {
+    __m256 min0 = _mm256_loadu_ps(src);
+    __m256 min1 = _mm256_loadu_ps(src + 8);
+    __m256 min2 = _mm256_loadu_ps(src + 16);
+    __m256 max0 = min0;
+    __m256 max1 = min1;
+    __m256 max2 = min2;
+
+    for (i = 8, src += 24; i + 8 <= count; i += 8, src += 24)
+    {
+      const __m256 v0 = _mm256_loadu_ps(src);
+      const __m256 v1 = _mm256_loadu_ps(src + 8);
+      const __m256 v2 = _mm256_loadu_ps(src + 16);
+
+      min0 = _mm256_min_ps(min0, v0);
+      min1 = _mm256_min_ps(min1, v1);
+      min2 = _mm256_min_ps(min2, v2);
+      max0 = _mm256_max_ps(max0, v0);
+      max1 = _mm256_max_ps(max1, v1);
+      max2 = _mm256_max_ps(max2, v2);
+    }
+
+    _mm256_storeu_ps(lanesMin, min0);
+    _mm256_storeu_ps(lanesMin + 8, min1);
+    _mm256_storeu_ps(lanesMin + 16, min2);
+    _mm256_storeu_ps(lanesMax, max0);
+    _mm256_storeu_ps(lanesMax + 8, max1);
+    _mm256_storeu_ps(lanesMax + 16, max2);
+    numLanePoints = 8;
+  }
+#elif defined (SUPPORT_SIMD_MATH)
+  if (count >= 4)
+  {
+    __m128 min0 = _mm_loadu_ps(src);
+    __m128 min1 = _mm_loadu_ps(src + 4);
+    __m128 min2 = _mm_loadu_ps(src + 8);
+    __m128 max0 = min0;
+    __m128 max1 = min1;
+    __m128 max2 = min2;
+
+    for (i = 4, src += 12; i + 4 <= count; i += 4, src += 12)
+    {
+      const __m128 v0 = _mm_loadu_ps(src);
+      const __m128 v1 = _mm_loadu_ps(src + 4);
+      const __m128 v2 = _mm_loadu_ps(src + 8);
+
+      min0 = _mm_min_ps(min0, v0);
+      min1 = _mm_min_ps(min1, v1);
+      min2 = _mm_min_ps(min2, v2);
+      max0 = _mm_max_ps(max0, v0);
+      max1 = _mm_max_ps(max1, v1);
+      max2 = _mm_max_ps(max2, v2);
+    }
+
+    _mm_storeu_ps(lanesMin, min0);
+    _mm_storeu_ps(lanesMin + 4, min1);
+    _mm_storeu_ps(lanesMin + 8, min2);
+    _mm_storeu_ps(lanesMax, max0);
+    _mm_storeu_ps(lanesMax + 4, max1);
+    _mm_storeu_ps(lanesMax + 8, max2);
+    numLanePoints = 4;
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (uint32 lane = 0; lane < numLanePoints; ++lane)
+  {
+    box.merge(Vector3(lanesMin[lane * 3], lanesMin[lane * 3 + 1], lanesMin[lane * 3 + 2]));
+    box.merge(Vector3(lanesMax[lane * 3], lanesMax[lane * 3 + 1], lanesMax[lane * 3 + 2]));
+  }
+
+  for (; i < count; ++i)
+    box.merge(points[i]);
+}
+
+void computeBoundingSphere(BoundingSphere& sphere, const AABB& box, const Vector3* points, uint32 count)
+{
+  if (box.isEmpty() || count == 0)
+  {
+    sphere = BoundingSphere();
+    return;
+  }
+
+  const Vector3 center = box.getCenter();
+
+  float maxDistance = 0.0f;
+  for (uint32 i = 0; i < count; ++i)
+    maxDistance = max(maxDistance, squaredLength(points[i] - center));
+
+  sphere = BoundingSphere(center, sqrtf(maxDistance));
+}
+
+namespace
+{
+  void computeRange(const float* values, uint32 count, float& minimum, float& maximum)
+  {
+    uint32 i = 0;
+    minimum = FLT_MAX;
+    maximum = -FLT_MAX;
+
+#if defined (SUPPORT_AVX_MATH)
+    if (count >= 8)
+    {
+      __m256 min8 = _mm256_loadu_ps(values);
+      __m256 max8 = min8;
+      for (i = 8; i + 8 <= count; i += 8)
+      {
+        const __m256 v = _mm256_loadu_ps(values + i);
+        min8 = _mm256_min_ps(min8, v);
+        max8 = _mm256_max_ps(max8, v);
+      }
+
+      float lanesMin[8], lanesMax[8];
+      _mm256_storeu_ps(lanesMin, min8);
+      _mm256_storeu_ps(lanesMax, max8);
+      for (uint32 lane = 0; lane < 8; ++lane)
+      {
+        minimum = min(minimum, lanesMin[lane]);
+        maximum = max(maximum, lanesMax[lane]);
+      }
+    }
+#elif defined (SUPPORT_SIMD_MATH)
+    if (count >= 4)
+    {
+      __m128 min4 = _mm_loadu_ps(values);
+      __m128 max4 = min4;
+      for (i = 4; i + 4 <= count; i += 4)
+      {
+        const __m128 v = _mm_loadu_ps(values + i);
+        min4 = _mm_min_ps(min4, v);
+        max4 = _mm_max_ps(max4, v);
+      }
+
+      float lanesMin[4], lanesMax[4];
+      _mm_storeu_ps(lanesMin, min4);
+      _mm_storeu_ps(lanesMax, max4);
+      for (uint32 lane = 0; lane < 4; ++lane)
+      {
+        minimum = min(minimum, lanesMin[lane]);
+        maximum = max(maximum, lanesMax[lane]);
+      }
+    }
+#endif // SUPPORT_SIMD_MATH
+
+    for (; i < count; ++i)
+    {
+      minimum = min(minimum, values[i]);
+      maximum = max(maximum, values[i]);
+    }
+  }
+}
+
+void computeBounds(AABB& box, const Vector3SoA& points, uint32 count)
+{
+  box = AABB();
+
+  if (count == 0)
+    return;
+
+  computeRange(points.x, count, box.minimum.x, box.maximum.x);
+  computeRange(points.y, count, box.minimum.y, box.maximum.y);
+  computeRange(points.z, count, box.minimum.z, box.maximum.z);
+}
+
+void computeBoundingSphere(BoundingSphere& sphere, const AABB& box, const Vector3SoA& points, uint32 count)
+{
+  if (box.isEmpty() || count == 0)
+  {
+    sphere = BoundingSphere();
+    return;
+  }
+
+  const Vector3 center = box.getCenter();
+
+  float maxDistance = 0.0f;
+  for (uint32 i = 0; i < count; ++i)
+  {
+    const float dx = points.x[i] - center.x;
+    const float dy = points.y[i] - center.y;
+    const float dz = points.z[i] - center.z;
+    maxDistance = max(maxDistance, dx * dx + dy * dy + dz * dz);
+  }
+
+  sphere = BoundingSphere(center, sqrtf(maxDistance));
+}
\ No newline at end of file
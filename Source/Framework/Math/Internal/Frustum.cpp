@@ -0,0 +1,257 @@
+#include "Core.h"
+#include "Frustum.h"
+
+void Frustum::setFromMatrix(const Matrix4& viewProj)
+{
+  // gribb/hartmann, combinations of the rows of the clip matrix
+  const Matrix4& m = viewProj;
+  const Vector4 row0(m[0], m[1], m[2], m[3]);
+  const Vector4 row1(m[4], m[5], m[6], m[7]);
+  const Vector4 row2(m[8], m[9], m[10], m[11]);
+  const Vector4 row3(m[12], m[13], m[14], m[15]);
+
+  m_planes[FP_LEFT] = row3 + row0;
+  m_planes[FP_RIGHT] = row3 - row0;
+  m_planes[FP_BOTTOM] = row3 + row1;
+  m_planes[FP_TOP] = row3 - row1;
+  m_planes[FP_NEAR] = row2;
+  m_planes[FP_FAR] = row3 - row2;
+
+  for (uint32 i = 0; i < FP_COUNT; ++i)
+  {
+    Vector4& plane = m_planes[i];
+    const float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    if (length > 0.0f)
+      plane = plane * (1.0f / length);
+  }
+}
+
+bool Frustum::isVisible(const Vector3& center, float radius) const
+{
+  for (uint32 i = 0; i < FP_COUNT; ++i)
+  {
+    const Vector4& plane = m_planes[i];
+    if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+      return false;
+  }
+
+  return true;
+}
+
+bool Frustum::isVisible(const Vector3& boxMin, const Vector3& boxMax) const
+{
+  for (uint32 i = 0; i < FP_COUNT; ++i)
+  {
+    // the corner furthest along the plane normal
+    const Vector4& plane = m_planes[i];
+    const float x = plane.x >= 0.0f ? boxMax.x : boxMin.x;
+    const float y = plane.y >= 0.0f ? boxMax.y : boxMin.y;
+    const float z = plane.z >= 0.0f ? boxMax.z : boxMin.z;
+
+    if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+      return false;
+  }
+
+  return true;
+}
+
+namespace
+{
+  inline void setVisibility(uint32* visibility, uint32 index, uint32 bits)
+  {
+    // the simd loops keep index a multiple of their width, so bits never straddle two words
+    visibility[index >> 5] |= bits << (index & 31);
+  }
+
+#if defined (SUPPORT_SIMD_MATH)
+
+  // plane components broadcast to all lanes
+  struct SimdPlanes4
+  {
+    explicit SimdPlanes4(const Frustum& frustum)
+    {
+      for (uint32 i = 0; i < FP_COUNT; ++i)
+      {
+        const Vector4& plane = frustum.getPlane(i);
+        x[i] = _mm_set1_ps(plane.x);
+        y[i] = _mm_set1_ps(plane.y);
+        z[i] = _mm_set1_ps(plane.z);
+        w[i] = _mm_set1_ps(plane.w);
+        positive[i] = (plane.x >= 0.0f ? 1 : 0) | (plane.y >= 0.0f ? 2 : 0) | (plane.z >= 0.0f ? 4 : 0);
+      }
+    }
+
+    __m128 x[FP_COUNT];
+    __m128 y[FP_COUNT];
+    __m128 z[FP_COUNT];
+    __m128 w[FP_COUNT];
+    uint32 positive[FP_COUNT];
+  };
+
+#endif // SUPPORT_SIMD_MATH
+
+#if defined (SUPPORT_AVX_MATH)
+
+  struct SimdPlanes8
+  {
+    explicit SimdPlanes8(const Frustum& frustum)
+    {
+      for (uint32 i = 0; i < FP_COUNT; ++i)
+      {
+        const Vector4& plane = frustum.getPlane(i);
+        x[i] = _mm256_set1_ps(plane.x);
+        y[i] = _mm256_set1_ps(plane.y);
+        z[i] = _mm256_set1_ps(plane.z);
+        w[i] = _mm256_set1_ps(plane.w);
+        positive[i] = (plane.x >= 0.0f ? 1 : 0) | (plane.y >= 0.0f ? 2 : 0) | (plane.z >= 0.0f ? 4 : 0);
+      }
+    }
+
+    __m256 x[FP_COUNT];
+    __m256 y[FP_COUNT];
+    __m256 z[FP_COUNT];
+    __m256 w[FP_COUNT];
+    uint32 positive[FP_COUNT];
+  };
+
+#endif // SUPPORT_AVX_MATH
+}
+
+void cullSpheres(const Frustum& frustum, const Vector3SoA& centers, const float* radii, uint32 count, uint32* visibility)
+{
+  memset(visibility, 0, ((count + 31) >> 5) * sizeof(uint32));
+
+  uint32 i = 0;
+
+#if defined (SUPPORT_AVX_MATH)
+  {
+    const SimdPlanes8 planes(frustum);
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 x = _mm256_loadu_ps(centers.x + i);
+      const __m256 y = _mm256_loadu_ps(centers.y + i);
+      const __m256 z = _mm256_loadu_ps(centers.z + i);
+      const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+
+      __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+      for (uint32 p = 0; p < FP_COUNT; ++p)
+      {
+        __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes.x[p], x), _mm256_mul_ps(planes.y[p], y));
+        distance = _mm256_add_ps(distance, _mm256_add_ps(_mm256_mul_ps(planes.z[p], z), planes.w[p]));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+      }
+
+      setVisibility(visibility, i, _mm256_movemask_ps(inside));
+    }
+  }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+  {
+    const SimdPlanes4 planes(frustum);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 x = _mm_loadu_ps(centers.x + i);
+      const __m128 y = _mm_loadu_ps(centers.y + i);
+      const __m128 z = _mm_loadu_ps(centers.z + i);
+      const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+
+      __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+      for (uint32 p = 0; p < FP_COUNT; ++p)
+      {
+        __m128 distance = _mm_add_ps(_mm_mul_ps(planes.x[p], x), _mm_mul_ps(planes.y[p], y));
+        distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(planes.z[p], z), planes.w[p]));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+      }
+
+      setVisibility(visibility, i, _mm_movemask_ps(inside));
+    }
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+  {
+    if (frustum.isVisible(Vector3(centers.x[i], centers.y[i], centers.z[i]), radii[i]))
+      setVisibility(visibility, i, 1);
+  }
+}
+
+void cullBoxes(const Frustum& frustum, const Vector3SoA& boxMin, const Vector3SoA& boxMax, uint32 count, uint32* visibility)
+{
+  memset(visibility, 0, ((count + 31) >> 5) * sizeof(uint32));
+
+  uint32 i = 0;
+
+  // the sign of a plane normal is the same for all lanes, so picking the corner
+  // furthest along the normal is a uniform select instead of a per lane blend
+
+#if defined (SUPPORT_AVX_MATH)
+  {
+    const SimdPlanes8 planes(frustum);
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256 minX = _mm256_loadu_ps(boxMin.x + i);
+      const __m256 minY = _mm256_loadu_ps(boxMin.y + i);
+      const __m256 minZ = _mm256_loadu_ps(boxMin.z + i);
+      const __m256 maxX = _mm256_loadu_ps(boxMax.x + i);
+      const __m256 maxY = _mm256_loadu_ps(boxMax.y + i);
+      const __m256 maxZ = _mm256_loadu_ps(boxMax.z + i);
+
+      __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+      for (uint32 p = 0; p < FP_COUNT; ++p)
+      {
+        const uint32 positive = planes.positive[p];
+        const __m256 x = (positive & 1) ? maxX : minX;
+        const __m256 y = (positive & 2) ? maxY : minY;
+        const __m256 z = (positive & 4) ? maxZ : minZ;
+
+        __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes.x[p], x), _mm256_mul_ps(planes.y[p], y));
+        distance = _mm256_add_ps(distance, _mm256_add_ps(_mm256_mul_ps(planes.z[p], z), planes.w[p]));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+      }
+
+      setVisibility(visibility, i, _mm256_movemask_ps(inside));
+    }
+  }
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+  {
+    const SimdPlanes4 planes(frustum);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128 minX = _mm_loadu_ps(boxMin.x + i);
+      const __m128 minY = _mm_loadu_ps(boxMin.y + i);
+      const __m128 minZ = _mm_loadu_ps(boxMin.z + i);
+      const __m128 maxX = _mm_loadu_ps(boxMax.x + i);
+      const __m128 maxY = _mm_loadu_ps(boxMax.y + i);
+      const __m128 maxZ = _mm_loadu_ps(boxMax.z + i);
+
+      __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+      for (uint32 p = 0; p < FP_COUNT; ++p)
+      {
+        const uint32 positive = planes.positive[p];
+        const __m128 x = (positive & 1) ? maxX : minX;
+        const __m128 y = (positive & 2) ? maxY : minY;
+        const __m128 z = (positive & 4) ? maxZ : minZ;
+
+        __m128 distance = _mm_add_ps(_mm_mul_ps(planes.x[p], x), _mm_mul_ps(planes.y[p], y));
+        distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(planes.z[p], z), planes.w[p]));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+      }
+
+      setVisibility(visibility, i, _mm_movemask_ps(inside));
+    }
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+  {
+    if (frustum.isVisible(Vector3(boxMin.x[i], boxMin.y[i], boxMin.z[i]), Vector3(boxMax.x[i], boxMax.y[i], boxMax.z[i])))
+      setVisibility(visibility, i, 1);
+  }
+}
\ No newline at end of file
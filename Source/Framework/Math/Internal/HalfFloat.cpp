@@ -0,0 +1,183 @@
+#include "Core.h"
+#include "HalfFloat.h"
+
+namespace
+{
+  // memcpy instead of pointer casts, the compiler turns it into a register move
+  inline uint32 floatBits(float value)
+  {
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  inline float bitsToFloat(uint32 bits)
+  {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  const uint32 FloatInfinity = 0x7f800000;
+  // smallest float that rounds to a half infinity
+  const uint32 HalfOverflow = (127 + 16) << 23;
+  // smallest float that is a normal half
+  const uint32 HalfMinNormal = (127 - 14) << 23;
+  // adding it aligns the 10 half mantissa bits at the bottom of the float mantissa,
+  // the fpu does the round to nearest even for the subnormals
+  const uint32 SubnormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+  // rebias the exponent (127 -> 15) and add the rounding bias below the half mantissa
+  const uint32 NormalRebias = ((uint32)(15 - 127) << 23) + 0xfff;
+}
+
+uint16 floatToHalf(float value)
+{
+  uint32 bits = floatBits(value);
+  const uint32 sign = bits & 0x80000000;
+  bits ^= sign;
+
+  uint32 result;
+  if (bits >= HalfOverflow)
+  {
+    // nans are quieted
+    result = bits > FloatInfinity ? 0x7e00 : 0x7c00;
+  }
+  else if (bits < HalfMinNormal)
+  {
+    result = floatBits(bitsToFloat(bits) + bitsToFloat(SubnormalMagic)) - SubnormalMagic;
+  }
+  else
+  {
+    // ties go to the even mantissa
+    const uint32 mantissaOdd = (bits >> 13) & 1;
+    result = (bits + NormalRebias + mantissaOdd) >> 13;
+  }
+
+  return (uint16)(result | (sign >> 16));
+}
+
+float halfToFloat(uint16 value)
+{
+  const uint32 ShiftedExponent = 0x7c00 << 13;
+
+  uint32 bits = (value & 0x7fff) << 13;
+  const uint32 exponent = bits & ShiftedExponent;
+  bits += (127 - 15) << 23;
+
+  if (exponent == ShiftedExponent)
+  {
+    // infinity, nan
+    bits += (128 - 16) << 23;
+  }
+  else if (exponent == 0)
+  {
+    // zero, subnormal. renormalized with a float subtract instead of a bit loop
+    bits += 1 << 23;
+    bits = floatBits(bitsToFloat(bits) - bitsToFloat(HalfMinNormal));
+  }
+
+  return bitsToFloat(bits | ((value & 0x8000) << 16));
+}
+
+#if defined (SUPPORT_SIMD_MATH) && !defined (SUPPORT_F16C_MATH)
+
+namespace
+{
+  // the scalar conversion on 4 lanes, both paths are computed and selected by masks
+  inline __m128i floatToHalf4(__m128 value)
+  {
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(0x80000000));
+    const __m128i absBits = _mm_xor_si128(bits, sign);
+
+    const __m128i isNan = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(FloatInfinity));
+    const __m128i isInfNan = _mm_cmpgt_epi32(absBits, _mm_set1_epi32(HalfOverflow - 1));
+    const __m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32(HalfMinNormal), absBits);
+
+    const __m128i infNan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(isNan, _mm_set1_epi32(0x200)));
+
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(SubnormalMagic));
+    const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(absBits), magic)), _mm_castps_si128(magic));
+
+    const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(absBits, 13), _mm_set1_epi32(1));
+    __m128i normal = _mm_add_epi32(absBits, _mm_set1_epi32(NormalRebias));
+    normal = _mm_srli_epi32(_mm_add_epi32(normal, mantissaOdd), 13);
+
+    __m128i result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+    result = _mm_or_si128(_mm_and_si128(isInfNan, infNan), _mm_andnot_si128(isInfNan, result));
+    return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+  }
+
+  // expects the halfs zero extended to 32 bit
+  inline __m128 halfToFloat4(__m128i value)
+  {
+    const __m128i exponentMantissa = _mm_and_si128(value, _mm_set1_epi32(0x7fff));
+    const __m128i sign = _mm_slli_epi32(_mm_xor_si128(value, exponentMantissa), 16);
+
+    // the multiply rebiases the exponent and normalizes the subnormals in one go.
+    // relies on denormals not being flushed (no daz)
+    const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+    const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentMantissa, 13)), magic);
+
+    const __m128i wasInfNan = _mm_cmpgt_epi32(exponentMantissa, _mm_set1_epi32(0x7bff));
+    const __m128i infNanExponent = _mm_and_si128(wasInfNan, _mm_set1_epi32(FloatInfinity));
+
+    return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNanExponent)));
+  }
+
+  // 32 -> 16 bit without signed saturation, sse2 has no unsigned pack
+  inline __m128i packHalfs(__m128i low, __m128i high)
+  {
+    low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+    high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+    return _mm_packs_epi32(low, high);
+  }
+}
+
+#endif // SUPPORT_SIMD_MATH && !SUPPORT_F16C_MATH
+
+void floatToHalf(const float* in, uint16* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_F16C_MATH)
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i halfs = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), 0);
+    _mm_storeu_si128((__m128i*)(out + i), halfs);
+  }
+#elif defined (SUPPORT_SIMD_MATH)
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i low = floatToHalf4(_mm_loadu_ps(in + i));
+    const __m128i high = floatToHalf4(_mm_loadu_ps(in + i + 4));
+    _mm_storeu_si128((__m128i*)(out + i), packHalfs(low, high));
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+    out[i] = floatToHalf(in[i]);
+}
+
+void halfToFloat(const uint16* in, float* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_F16C_MATH)
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i halfs = _mm_loadu_si128((const __m128i*)(in + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(halfs));
+  }
+#elif defined (SUPPORT_SIMD_MATH)
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i halfs = _mm_loadu_si128((const __m128i*)(in + i));
+    _mm_storeu_ps(out + i, halfToFloat4(_mm_unpacklo_epi16(halfs, _mm_setzero_si128())));
+    _mm_storeu_ps(out + i + 4, halfToFloat4(_mm_unpackhi_epi16(halfs, _mm_setzero_si128())));
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+    out[i] = halfToFloat(in[i]);
+}
\ No newline at end of file
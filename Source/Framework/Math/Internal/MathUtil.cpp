@@ -21,6 +21,43 @@ void makeTranslation(Matrix4& mat, float x, float y, float z)
   mat[11] = z;
 }
 
+#if defined (SUPPORT_SIMD_MATH)
+
+namespace
+{
+  // zero for a zero vector like the scalar normalize, instead of nans
+  inline __m128 simdNormalize3(__m128 value)
+  {
+    const __m128 len = simdDot4(value, value);
+    return _mm_and_ps(_mm_cmpgt_ps(len, _mm_setzero_ps()), _mm_div_ps(value, _mm_sqrt_ps(len)));
+  }
+}
+
+void makeLookAt(Matrix4& mat, const Vector3& origin, const Vector3& targetPoint, const Vector3& up)
+{
+  // w = 0 keeps the 4 component dot products equal to the 3d versions. the inputs
+  // are set up in registers, going through memory would stall on the loads
+  const __m128 eye = _mm_set_ps(0.0f, origin.z, origin.y, origin.x);
+  const __m128 target = _mm_set_ps(0.0f, targetPoint.z, targetPoint.y, targetPoint.x);
+  const __m128 upDir = _mm_set_ps(0.0f, up.z, up.y, up.x);
+
+  const __m128 axisZ = simdNormalize3(_mm_sub_ps(target, eye));
+  const __m128 axisX = simdNormalize3(simdCross3(upDir, axisZ));
+
+  const __m128 axisY = simdCross3(axisZ, axisX);
+
+  mat.storeRow(0, axisX);
+  mat.storeRow(1, axisY);
+  mat.storeRow(2, axisZ);
+  mat.storeRow(3, _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+
+  mat[3] = -_mm_cvtss_f32(simdDot4(axisX, eye));
+  mat[7] = -_mm_cvtss_f32(simdDot4(axisY, eye));
+  mat[11] = -_mm_cvtss_f32(simdDot4(axisZ, eye));
+}
+
+#else
+
 void makeLookAt(Matrix4& mat, const Vector3& origin, const Vector3& targetPoint, const Vector3& up)
 {
   Vector3 axisZ = normalize(targetPoint - origin);
@@ -33,6 +70,8 @@ void makeLookAt(Matrix4& mat, const Vector3& origin, const Vector3& targetPoint,
   mat[12] = 0.0f;   mat[13] = 0.0f;   mat[14]  = 0.0f;   mat[15]  = 1.0f;
 }
 
+#endif // SUPPORT_SIMD_MATH
+
 void makeRotateX(Matrix4& mat, float angle)
 {
   float c = cos(angle);
@@ -68,4 +107,277 @@ void setTransform(Matrix4& mat, float x, float y, float z)
   mat[3] = x;
   mat[7] = y;
   mat[11] = z;
-}
\ No newline at end of file
+}
+
+#if defined (SUPPORT_SIMD_MATH)
+
+void transpose(Matrix4& result, const Matrix4& mat)
+{
+  __m128 row0 = mat.loadRow(0);
+  __m128 row1 = mat.loadRow(1);
+  __m128 row2 = mat.loadRow(2);
+  __m128 row3 = mat.loadRow(3);
+
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+  result.storeRow(0, row0);
+  result.storeRow(1, row1);
+  result.storeRow(2, row2);
+  result.storeRow(3, row3);
+}
+
+bool inverse(Matrix4& result, const Matrix4& mat)
+{
+  // cramer's rule on the transposed matrix, the cofactors of pairs of 2x2 sub
+  // determinants are computed four at a time (see intel ap-928)
+  __m128 row0 = mat.loadRow(0);
+  __m128 row1 = mat.loadRow(1);
+  __m128 row2 = mat.loadRow(2);
+  __m128 row3 = mat.loadRow(3);
+
+  // |det| is bounded by the product of the row lengths and by that of the column lengths
+  // (hadamard). relative to the smaller one the determinant of a near singular matrix is
+  // tiny no matter how the matrix is scaled, a translation only grows the column bound
+  const __m128 rowBound = _mm_mul_ps(
+    _mm_mul_ps(simdDot4(row0, row0), simdDot4(row1, row1)),
+    _mm_mul_ps(simdDot4(row2, row2), simdDot4(row3, row3)));
+
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+  const __m128 columnBound = _mm_mul_ps(
+    _mm_mul_ps(simdDot4(row0, row0), simdDot4(row1, row1)),
+    _mm_mul_ps(simdDot4(row2, row2), simdDot4(row3, row3)));
+  const __m128 bound = _mm_sqrt_ps(_mm_min_ps(rowBound, columnBound));
+
+  row1 = _mm_shuffle_ps(row1, row1, 0x4e);
+  row3 = _mm_shuffle_ps(row3, row3, 0x4e);
+
+  __m128 minor0, minor1, minor2, minor3;
+  __m128 tmp;
+
+  tmp = _mm_mul_ps(row2, row3);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  minor0 = _mm_mul_ps(row1, tmp);
+  minor1 = _mm_mul_ps(row0, tmp);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp), minor0);
+  minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor1);
+  minor1 = _mm_shuffle_ps(minor1, minor1, 0x4e);
+
+  tmp = _mm_mul_ps(row1, row2);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor0);
+  minor3 = _mm_mul_ps(row0, tmp);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp));
+  minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor3);
+  minor3 = _mm_shuffle_ps(minor3, minor3, 0x4e);
+
+  tmp = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4e), row3);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  row2 = _mm_shuffle_ps(row2, row2, 0x4e);
+  minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor0);
+  minor2 = _mm_mul_ps(row0, tmp);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp));
+  minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp), minor2);
+  minor2 = _mm_shuffle_ps(minor2, minor2, 0x4e);
+
+  tmp = _mm_mul_ps(row0, row1);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor2);
+  minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp), minor3);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp), minor2);
+  minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp));
+
+  tmp = _mm_mul_ps(row0, row3);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp));
+  minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor2);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp), minor1);
+  minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp));
+
+  tmp = _mm_mul_ps(row0, row2);
+  tmp = _mm_shuffle_ps(tmp, tmp, 0xb1);
+  minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp), minor1);
+  minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp));
+  tmp = _mm_shuffle_ps(tmp, tmp, 0x4e);
+  minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp));
+  minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp), minor3);
+
+  const __m128 det = simdDot4(row0, minor0);
+  if (!(fabsf(_mm_cvtss_f32(det)) > EPSILON * _mm_cvtss_f32(bound)))
+    return false;
+
+  // exact division instead of rcp + newton raphson, the extra latency is small
+  const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+  result.storeRow(0, _mm_mul_ps(minor0, invDet));
+  result.storeRow(1, _mm_mul_ps(minor1, invDet));
+  result.storeRow(2, _mm_mul_ps(minor2, invDet));
+  result.storeRow(3, _mm_mul_ps(minor3, invDet));
+  return true;
+}
+
+void inverseAffine(Matrix4& result, const Matrix4& mat)
+{
+  // same as the AffineTransform inverse, only the last row is written as well
+  const __m128 maskXYZ = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+  const __m128 row0 = mat.loadRow(0);
+  const __m128 row1 = mat.loadRow(1);
+  const __m128 row2 = mat.loadRow(2);
+
+  const __m128 r0 = _mm_and_ps(row0, maskXYZ);
+  const __m128 r1 = _mm_and_ps(row1, maskXYZ);
+  const __m128 r2 = _mm_and_ps(row2, maskXYZ);
+
+  __m128 c0 = simdCross3(r1, r2);
+  __m128 c1 = simdCross3(r2, r0);
+  __m128 c2 = simdCross3(r0, r1);
+
+  const __m128 det = simdDot4(r0, c0);
+  if (!(fabsf(_mm_cvtss_f32(det)) > EPSILON * _mm_cvtss_f32(simdDeterminantBound3(r0, r1, r2))))
+  {
+    result = Matrix4::Identity;
+    return;
+  }
+
+  __m128 c3 = _mm_mul_ps(c0, SIMD_SPLAT(row0, 3));
+  c3 = _mm_add_ps(c3, _mm_mul_ps(c1, SIMD_SPLAT(row1, 3)));
+  c3 = _mm_add_ps(c3, _mm_mul_ps(c2, SIMD_SPLAT(row2, 3)));
+  c3 = _mm_sub_ps(_mm_setzero_ps(), c3);
+
+  _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+  const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+  result.storeRow(0, _mm_mul_ps(c0, invDet));
+  result.storeRow(1, _mm_mul_ps(c1, invDet));
+  result.storeRow(2, _mm_mul_ps(c2, invDet));
+  result.storeRow(3, _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+}
+
+void inverseOrthonormal(Matrix4& result, const Matrix4& mat)
+{
+  const __m128 maskXYZ = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+  const __m128 row0 = mat.loadRow(0);
+  const __m128 row1 = mat.loadRow(1);
+  const __m128 row2 = mat.loadRow(2);
+
+  __m128 r0 = _mm_and_ps(row0, maskXYZ);
+  __m128 r1 = _mm_and_ps(row1, maskXYZ);
+  __m128 r2 = _mm_and_ps(row2, maskXYZ);
+
+  // -R^T * t, ends up in the w column after the transpose
+  __m128 t = _mm_mul_ps(r0, SIMD_SPLAT(row0, 3));
+  t = _mm_add_ps(t, _mm_mul_ps(r1, SIMD_SPLAT(row1, 3)));
+  t = _mm_add_ps(t, _mm_mul_ps(r2, SIMD_SPLAT(row2, 3)));
+  t = _mm_sub_ps(_mm_setzero_ps(), t);
+
+  _MM_TRANSPOSE4_PS(r0, r1, r2, t);
+
+  result.storeRow(0, r0);
+  result.storeRow(1, r1);
+  result.storeRow(2, r2);
+  result.storeRow(3, _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+}
+
+#else
+
+void transpose(Matrix4& result, const Matrix4& mat)
+{
+  const Matrix4 source = mat;
+
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+      result[i * 4 + j] = source[j * 4 + i];
+  }
+}
+
+bool inverse(Matrix4& result, const Matrix4& mat)
+{
+  // cofactor expansion along the 2x2 sub determinants of the upper and lower half
+  const float* m = mat.getPtr();
+
+  const float s0 = m[0] * m[5] - m[4] * m[1];
+  const float s1 = m[0] * m[6] - m[4] * m[2];
+  const float s2 = m[0] * m[7] - m[4] * m[3];
+  const float s3 = m[1] * m[6] - m[5] * m[2];
+  const float s4 = m[1] * m[7] - m[5] * m[3];
+  const float s5 = m[2] * m[7] - m[6] * m[3];
+
+  const float c5 = m[10] * m[15] - m[14] * m[11];
+  const float c4 = m[9] * m[15] - m[13] * m[11];
+  const float c3 = m[9] * m[14] - m[13] * m[10];
+  const float c2 = m[8] * m[15] - m[12] * m[11];
+  const float c1 = m[8] * m[14] - m[12] * m[10];
+  const float c0 = m[8] * m[13] - m[12] * m[9];
+
+  const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+  // same relative threshold as the simd version, against the hadamard bound of |det|
+  float rowBound = 1.0f, columnBound = 1.0f;
+  for (int i = 0; i < 4; ++i)
+  {
+    rowBound *= m[i * 4] * m[i * 4] + m[i * 4 + 1] * m[i * 4 + 1] + m[i * 4 + 2] * m[i * 4 + 2] + m[i * 4 + 3] * m[i * 4 + 3];
+    columnBound *= m[i] * m[i] + m[i + 4] * m[i + 4] + m[i + 8] * m[i + 8] + m[i + 12] * m[i + 12];
+  }
+
+  if (!(fabsf(det) > EPSILON * sqrtf(rowBound < columnBound ? rowBound : columnBound)))
+    return false;
+
+  const float invDet = 1.0f / det;
+
+  result = Matrix4(
+    ( m[5] * c5 - m[6] * c4 + m[7] * c3) * invDet,
+    (-m[1] * c5 + m[2] * c4 - m[3] * c3) * invDet,
+    ( m[13] * s5 - m[14] * s4 + m[15] * s3) * invDet,
+    (-m[9] * s5 + m[10] * s4 - m[11] * s3) * invDet,
+
+    (-m[4] * c5 + m[6] * c2 - m[7] * c1) * invDet,
+    ( m[0] * c5 - m[2] * c2 + m[3] * c1) * invDet,
+    (-m[12] * s5 + m[14] * s2 - m[15] * s1) * invDet,
+    ( m[8] * s5 - m[10] * s2 + m[11] * s1) * invDet,
+
+    ( m[4] * c4 - m[5] * c2 + m[7] * c0) * invDet,
+    (-m[0] * c4 + m[1] * c2 - m[3] * c0) * invDet,
+    ( m[12] * s4 - m[13] * s2 + m[15] * s0) * invDet,
+    (-m[8] * s4 + m[9] * s2 - m[11] * s0) * invDet,
+
+    (-m[4] * c3 + m[5] * c1 - m[6] * c0) * invDet,
+    ( m[0] * c3 - m[1] * c1 + m[2] * c0) * invDet,
+    (-m[12] * s3 + m[13] * s1 - m[14] * s0) * invDet,
+    ( m[8] * s3 - m[9] * s1 + m[10] * s0) * invDet);
+
+  return true;
+}
+
+void inverseAffine(Matrix4& result, const Matrix4& mat)
+{
+  // the upper 3x4 part has the same layout as an AffineTransform
+  makeMatrix(result, inverse(AffineTransform(mat.getPtr())));
+}
+
+void inverseOrthonormal(Matrix4& result, const Matrix4& mat)
+{
+  const Matrix4 source = mat;
+  const Vector3 t(source[3], source[7], source[11]);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    const Vector3 axis(source[i], source[4 + i], source[8 + i]);
+    result[i * 4 + 0] = axis.x;
+    result[i * 4 + 1] = axis.y;
+    result[i * 4 + 2] = axis.z;
+    result[i * 4 + 3] = -dot(axis, t);
+  }
+
+  result[12] = 0.0f; result[13] = 0.0f; result[14] = 0.0f; result[15] = 1.0f;
+}
+
+#endif // SUPPORT_SIMD_MATH
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "Core.h"
+#include "Quaternion.h"
+
+Quaternion Quaternion::Identity = Quaternion(0, 0, 0, 1);
+
+void makeQuaternion(Quaternion& q, const Vector3& axis, float angle)
+{
+  const float s = sin(angle * 0.5f);
+  q = Quaternion(axis.x * s, axis.y * s, axis.z * s, cos(angle * 0.5f));
+}
+
+void makeMatrix(Matrix4& mat, const Quaternion& q)
+{
+  const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+  mat = Matrix4(
+    1 - 2 * (yy + zz),  2 * (xy - wz),      2 * (xz + wy),      0,
+    2 * (xy + wz),      1 - 2 * (xx + zz),  2 * (yz - wx),      0,
+    2 * (xz - wy),      2 * (yz + wx),      1 - 2 * (xx + yy),  0,
+    0,                  0,                  0,                  1);
+}
+
+Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t)
+{
+  // q and -q are the same rotation, take the shorter arc
+  const float sign = dot(a, b) < 0 ? -1.0f : 1.0f;
+  const float ta = 1.0f - t;
+  const float tb = t * sign;
+
+  return normalize(Quaternion(
+    a.x * ta + b.x * tb,
+    a.y * ta + b.y * tb,
+    a.z * ta + b.z * tb,
+    a.w * ta + b.w * tb));
+}
+
+Quaternion slerp(const Quaternion& a, const Quaternion& b, float t)
+{
+  float cosAngle = dot(a, b);
+  float sign = 1.0f;
+  if (cosAngle < 0)
+  {
+    cosAngle = -cosAngle;
+    sign = -1.0f;
+  }
+
+  // sin(angle) gets too small to divide by
+  if (cosAngle > 0.9995f)
+    return nlerp(a, b, t);
+
+  const float angle = acos(cosAngle);
+  const float invSin = 1.0f / sin(angle);
+  const float ta = sin((1.0f - t) * angle) * invSin;
+  const float tb = sin(t * angle) * invSin * sign;
+
+  return Quaternion(
+    a.x * ta + b.x * tb,
+    a.y * ta + b.y * tb,
+    a.z * ta + b.z * tb,
+    a.w * ta + b.w * tb);
+}
\ No newline at end of file
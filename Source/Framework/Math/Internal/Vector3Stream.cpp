@@ -0,0 +1,130 @@
+#include "Core.h"
+#include "Vector3Stream.h"
+
+Vector3Stream::Vector3Stream()
+  : m_x(0)
+  , m_y(0)
+  , m_z(0)
+  , m_size(0)
+  , m_capacity(0)
+{
+}
+
+Vector3Stream::Vector3Stream(uint32 size)
+  : m_x(0)
+  , m_y(0)
+  , m_z(0)
+  , m_size(0)
+  , m_capacity(0)
+{
+  resize(size);
+}
+
+Vector3Stream::Vector3Stream(const Vector3Stream& other)
+  : m_x(0)
+  , m_y(0)
+  , m_z(0)
+  , m_size(0)
+  , m_capacity(0)
+{
+  *this = other;
+}
+
+Vector3Stream::~Vector3Stream()
+{
+  // one block, y and z point into it
+  _aligned_free(m_x);
+}
+
+Vector3Stream& Vector3Stream::operator=(const Vector3Stream& other)
+{
+  if (this != &other)
+  {
+    resize(other.m_size);
+    memcpy(m_x, other.m_x, m_size * sizeof(float));
+    memcpy(m_y, other.m_y, m_size * sizeof(float));
+    memcpy(m_z, other.m_z, m_size * sizeof(float));
+  }
+
+  return *this;
+}
+
+void Vector3Stream::reallocate(uint32 capacity)
+{
+  // the capacity is a multiple of the padding, which keeps all three arrays aligned
+  capacity = (capacity + Padding - 1) & ~(Padding - 1);
+
+  float* block = (float*)_aligned_malloc(capacity * 3 * sizeof(float), 32);
+  memset(block, 0, capacity * 3 * sizeof(float));
+
+  if (m_size > 0)
+  {
+    memcpy(block, m_x, m_size * sizeof(float));
+    memcpy(block + capacity, m_y, m_size * sizeof(float));
+    memcpy(block + capacity * 2, m_z, m_size * sizeof(float));
+  }
+
+  _aligned_free(m_x);
+
+  m_x = block;
+  m_y = block + capacity;
+  m_z = block + capacity * 2;
+  m_capacity = capacity;
+}
+
+void Vector3Stream::reserve(uint32 capacity)
+{
+  if (capacity > m_capacity)
+    reallocate(capacity);
+}
+
+void Vector3Stream::resize(uint32 size)
+{
+  if (size > m_capacity)
+  {
+    reallocate(size);
+  }
+  else if (size < m_size)
+  {
+    // the padding has to stay zero
+    memset(m_x + size, 0, (m_size - size) * sizeof(float));
+    memset(m_y + size, 0, (m_size - size) * sizeof(float));
+    memset(m_z + size, 0, (m_size - size) * sizeof(float));
+  }
+
+  m_size = size;
+}
+
+void Vector3Stream::add(const Vector3& v)
+{
+  if (m_size == m_capacity)
+    reallocate(max(m_capacity * 2, Padding * 4));
+
+  set(m_size++, v);
+}
+
+void Vector3Stream::interleave(void* dest, uint32 stride) const
+{
+  ubyte* dst = (ubyte*)dest;
+  for (uint32 i = 0; i < m_size; ++i, dst += stride)
+  {
+    float* element = (float*)dst;
+    element[0] = m_x[i];
+    element[1] = m_y[i];
+    element[2] = m_z[i];
+  }
+}
+
+void Vector3Stream::deinterleave(const void* src, uint32 stride, uint32 count)
+{
+  resize(count);
+
+  const ubyte* source = (const ubyte*)src;
+  for (uint32 i = 0; i < count; ++i, source += stride)
+  {
+    const float* element = (const float*)source;
+    m_x[i] = element[0];
+    m_y[i] = element[1];
+    m_z[i] = element[2];
+  }
+}
\ No newline at end of file
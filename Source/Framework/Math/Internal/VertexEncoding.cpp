@@ -0,0 +1,501 @@
+#include "Core.h"
+#include "VertexEncoding.h"
+
+#include <cfloat>
+
+namespace
+{
+  const float Snorm16Scale = 32767.0f;
+  const float Unorm8Scale = 255.0f;
+  const float Unorm16Scale = 65535.0f;
+
+  // smallest |w| that still quantizes to a non zero snorm16
+  const float QTangentBias = 1.0f / Snorm16Scale;
+
+  // tangents closer to the normal than this are replaced
+  const float MinTangentLengthSq = 1e-12f;
+
+  inline int roundToInt(float value)
+  {
+#if defined (SUPPORT_SIMD_MATH)
+    // same rounding as the batch kernels, to nearest even
+    return _mm_cvtss_si32(_mm_set_ss(value));
+#else
+    return (int)floorf(value + 0.5f);
+#endif // SUPPORT_SIMD_MATH
+  }
+
+  inline float signNotZero(float value)
+  {
+    return value < 0.0f ? -1.0f : 1.0f;
+  }
+
+  // [-1, 1]^2, the lower hemisphere is folded over the diagonals
+  inline void encodeOctahedral(const Vector3& normal, float& u, float& v)
+  {
+    const float sum = max(fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z), FLT_MIN);
+    const float invSum = 1.0f / sum;
+    u = normal.x * invSum;
+    v = normal.y * invSum;
+
+    if (normal.z < 0.0f)
+    {
+      const float foldedU = (1.0f - fabsf(v)) * signNotZero(u);
+      const float foldedV = (1.0f - fabsf(u)) * signNotZero(v);
+      u = foldedU;
+      v = foldedV;
+    }
+
+    u = clamp(u, -1.0f, 1.0f);
+    v = clamp(v, -1.0f, 1.0f);
+  }
+
+  inline Vector3 decodeOctahedral(float u, float v)
+  {
+    Vector3 normal(u, v, 1.0f - fabsf(u) - fabsf(v));
+    if (normal.z < 0.0f)
+    {
+      normal.x = (1.0f - fabsf(v)) * signNotZero(u);
+      normal.y = (1.0f - fabsf(u)) * signNotZero(v);
+    }
+
+    return normalize(normal);
+  }
+}
+
+void encodeOctahedralSnorm16(const Vector3& normal, short* out)
+{
+  float u, v;
+  encodeOctahedral(normal, u, v);
+  out[0] = (short)roundToInt(u * Snorm16Scale);
+  out[1] = (short)roundToInt(v * Snorm16Scale);
+}
+
+Vector3 decodeOctahedralSnorm16(const short* in)
+{
+  // -32768 maps to -1 as well
+  return decodeOctahedral(max(in[0] / Snorm16Scale, -1.0f), max(in[1] / Snorm16Scale, -1.0f));
+}
+
+void encodeOctahedralUnorm8(const Vector3& normal, uint8* out)
+{
+  float u, v;
+  encodeOctahedral(normal, u, v);
+  out[0] = (uint8)roundToInt((u * 0.5f + 0.5f) * Unorm8Scale);
+  out[1] = (uint8)roundToInt((v * 0.5f + 0.5f) * Unorm8Scale);
+}
+
+Vector3 decodeOctahedralUnorm8(const uint8* in)
+{
+  return decodeOctahedral(in[0] / Unorm8Scale * 2.0f - 1.0f, in[1] / Unorm8Scale * 2.0f - 1.0f);
+}
+
+void makeQTangent(Quaternion& q, const Vector3& tangent, const Vector3& bitangent, const Vector3& normal)
+{
+  // written out per component, the batch version has to produce the same bits
+
+  // gram schmidt, the normal keeps its direction
+  float nx = normal.x, ny = normal.y, nz = normal.z;
+  float length = sqrtf(nx * nx + ny * ny + nz * nz);
+  float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+  nx *= invLength;
+  ny *= invLength;
+  nz *= invLength;
+
+  const float d = tangent.x * nx + tangent.y * ny + tangent.z * nz;
+  float tx = tangent.x - nx * d;
+  float ty = tangent.y - ny * d;
+  float tz = tangent.z - nz * d;
+
+  // missing or degenerate uv mapping, any perpendicular vector will do
+  if (tx * tx + ty * ty + tz * tz < MinTangentLengthSq)
+  {
+    const bool useXY = fabsf(nx) > fabsf(nz);
+    tx = useXY ? -ny : 0.0f;
+    ty = useXY ? nx : -nz;
+    tz = useXY ? 0.0f : ny;
+  }
+
+  length = sqrtf(tx * tx + ty * ty + tz * tz);
+  invLength = length > 0.0f ? 1.0f / length : 0.0f;
+  tx *= invLength;
+  ty *= invLength;
+  tz *= invLength;
+
+  // right handed bitangent, the original one only contributes the handedness
+  const float bx = ny * tz - nz * ty;
+  const float by = nz * tx - nx * tz;
+  const float bz = nx * ty - ny * tx;
+  const bool negative = bx * bitangent.x + by * bitangent.y + bz * bitangent.z < 0.0f;
+
+  // rotation matrix with the columns (t, b, n), the largest component is computed from
+  // the diagonal and the others from the off diagonal elements
+  const float traceW = (tx + by) + nz;
+  const float traceX = (tx - by) - nz;
+  const float traceY = (by - tx) - nz;
+  const float traceZ = (nz - tx) - by;
+  const float maxTrace = max(max(traceW, traceX), max(traceY, traceZ));
+
+  const float c = 0.5f * sqrtf(1.0f + maxTrace);
+  const float r = 0.25f / c;
+
+  const float a = (bz - ny) * r;
+  const float b = (nx - tz) * r;
+  const float e = (ty - bx) * r;
+  const float f = (bx + ty) * r;
+  const float g = (nx + tz) * r;
+  const float h = (ny + bz) * r;
+
+  float x, y, z, w;
+  if (traceW == maxTrace)
+  {
+    x = a; y = b; z = e; w = c;
+  }
+  else if (traceX == maxTrace)
+  {
+    x = c; y = f; z = g; w = a;
+  }
+  else if (traceY == maxTrace)
+  {
+    x = f; y = c; z = h; w = b;
+  }
+  else
+  {
+    x = g; y = h; z = c; w = e;
+  }
+
+  invLength = 1.0f / sqrtf(((x * x + y * y) + z * z) + w * w);
+  x *= invLength;
+  y *= invLength;
+  z *= invLength;
+  w *= invLength;
+
+  // q and -q are the same rotation, the sign is free for the handedness
+  if (w < 0.0f)
+  {
+    x = -x; y = -y; z = -z; w = -w;
+  }
+
+  // the length changes by less than the float precision
+  if (w < QTangentBias)
+    w = QTangentBias;
+
+  if (negative)
+  {
+    x = -x; y = -y; z = -z; w = -w;
+  }
+
+  q = Quaternion(x, y, z, w);
+}
+
+void decodeQTangent(const Quaternion& q, Vector3& tangent, Vector3& bitangent, Vector3& normal)
+{
+  tangent = rotate(q, Vector3(1, 0, 0));
+  normal = rotate(q, Vector3(0, 0, 1));
+  bitangent = cross(normal, tangent) * (q.w < 0.0f ? -1.0f : 1.0f);
+}
+
+void encodeQTangentSnorm16(const Quaternion& q, short* out)
+{
+  out[0] = (short)roundToInt(clamp(q.x, -1.0f, 1.0f) * Snorm16Scale);
+  out[1] = (short)roundToInt(clamp(q.y, -1.0f, 1.0f) * Snorm16Scale);
+  out[2] = (short)roundToInt(clamp(q.z, -1.0f, 1.0f) * Snorm16Scale);
+  out[3] = (short)roundToInt(clamp(q.w, -1.0f, 1.0f) * Snorm16Scale);
+}
+
+Quaternion decodeQTangentSnorm16(const short* in)
+{
+  const Quaternion q(
+    max(in[0] / Snorm16Scale, -1.0f),
+    max(in[1] / Snorm16Scale, -1.0f),
+    max(in[2] / Snorm16Scale, -1.0f),
+    max(in[3] / Snorm16Scale, -1.0f));
+
+  // normalizing keeps the sign of w
+  return normalize(q);
+}
+
+void quantizePosition(const AABB& bounds, const Vector3& position, uint16* out)
+{
+  const Vector3 size = bounds.maximum - bounds.minimum;
+  const float scaleX = size.x > 0.0f ? Unorm16Scale / size.x : 0.0f;
+  const float scaleY = size.y > 0.0f ? Unorm16Scale / size.y : 0.0f;
+  const float scaleZ = size.z > 0.0f ? Unorm16Scale / size.z : 0.0f;
+
+  out[0] = (uint16)roundToInt(clamp((position.x - bounds.minimum.x) * scaleX, 0.0f, Unorm16Scale));
+  out[1] = (uint16)roundToInt(clamp((position.y - bounds.minimum.y) * scaleY, 0.0f, Unorm16Scale));
+  out[2] = (uint16)roundToInt(clamp((position.z - bounds.minimum.z) * scaleZ, 0.0f, Unorm16Scale));
+  out[3] = 0;
+}
+
+Vector3 dequantizePosition(const AABB& bounds, const uint16* in)
+{
+  const Vector3 step = (bounds.maximum - bounds.minimum) / Unorm16Scale;
+  return Vector3(
+    bounds.minimum.x + in[0] * step.x,
+    bounds.minimum.y + in[1] * step.y,
+    bounds.minimum.z + in[2] * step.z);
+}
+
+#if defined (SUPPORT_SIMD_MATH)
+
+namespace
+{
+  struct SimdVector3
+  {
+    SimdVector3(const Vector3SoA& soa, uint32 index)
+      : x(_mm_loadu_ps(soa.x + index))
+      , y(_mm_loadu_ps(soa.y + index))
+      , z(_mm_loadu_ps(soa.z + index))
+    {
+    }
+
+    __m128 x, y, z;
+  };
+
+  inline __m128 select(__m128 mask, __m128 a, __m128 b)
+  {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+
+  inline __m128 dot3(const SimdVector3& a, const SimdVector3& b)
+  {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+  }
+
+  // zero length vectors stay zero
+  inline void normalize3(SimdVector3& v)
+  {
+    const __m128 length = _mm_sqrt_ps(dot3(v, v));
+    const __m128 invLength = _mm_and_ps(_mm_cmpgt_ps(length, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.0f), length));
+    v.x = _mm_mul_ps(v.x, invLength);
+    v.y = _mm_mul_ps(v.y, invLength);
+    v.z = _mm_mul_ps(v.z, invLength);
+  }
+
+  inline __m128 signNotZero4(__m128 value, __m128 signMask)
+  {
+    return _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(value, _mm_setzero_ps()), signMask), _mm_set1_ps(1.0f));
+  }
+
+  inline __m128 clamp4(__m128 value, __m128 minimum, __m128 maximum)
+  {
+    return _mm_min_ps(_mm_max_ps(value, minimum), maximum);
+  }
+
+  inline void encodeOctahedral4(const SimdVector3& normal, __m128& u, __m128& v)
+  {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 absX = _mm_andnot_ps(signMask, normal.x);
+    const __m128 absY = _mm_andnot_ps(signMask, normal.y);
+    const __m128 absZ = _mm_andnot_ps(signMask, normal.z);
+
+    const __m128 sum = _mm_max_ps(_mm_add_ps(_mm_add_ps(absX, absY), absZ), _mm_set1_ps(FLT_MIN));
+    const __m128 invSum = _mm_div_ps(_mm_set1_ps(1.0f), sum);
+    u = _mm_mul_ps(normal.x, invSum);
+    v = _mm_mul_ps(normal.y, invSum);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 foldedU = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, v)), signNotZero4(u, signMask));
+    const __m128 foldedV = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, u)), signNotZero4(v, signMask));
+
+    const __m128 lower = _mm_cmplt_ps(normal.z, _mm_setzero_ps());
+    u = clamp4(select(lower, foldedU, u), _mm_set1_ps(-1.0f), one);
+    v = clamp4(select(lower, foldedV, v), _mm_set1_ps(-1.0f), one);
+  }
+
+  // 4 x (x, y, z, w) in, 16 shorts out with the components of each lane next to each other
+  inline void packShort4x4(const __m128i* components, __m128i& low, __m128i& high)
+  {
+    const __m128i xyLow = _mm_unpacklo_epi32(components[0], components[1]);
+    const __m128i xyHigh = _mm_unpackhi_epi32(components[0], components[1]);
+    const __m128i zwLow = _mm_unpacklo_epi32(components[2], components[3]);
+    const __m128i zwHigh = _mm_unpackhi_epi32(components[2], components[3]);
+
+    low = _mm_packs_epi32(_mm_unpacklo_epi64(xyLow, zwLow), _mm_unpackhi_epi64(xyLow, zwLow));
+    high = _mm_packs_epi32(_mm_unpacklo_epi64(xyHigh, zwHigh), _mm_unpackhi_epi64(xyHigh, zwHigh));
+  }
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+void encodeOctahedralSnorm16(const Vector3SoA& normals, short* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_SIMD_MATH)
+  const __m128 scale = _mm_set1_ps(Snorm16Scale);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 u, v;
+    encodeOctahedral4(SimdVector3(normals, i), u, v);
+
+    const __m128i iu = _mm_cvtps_epi32(_mm_mul_ps(u, scale));
+    const __m128i iv = _mm_cvtps_epi32(_mm_mul_ps(v, scale));
+    _mm_storeu_si128((__m128i*)(out + i * 2), _mm_packs_epi32(_mm_unpacklo_epi32(iu, iv), _mm_unpackhi_epi32(iu, iv)));
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+    encodeOctahedralSnorm16(Vector3(normals.x[i], normals.y[i], normals.z[i]), out + i * 2);
+}
+
+void encodeOctahedralUnorm8(const Vector3SoA& normals, uint8* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_SIMD_MATH)
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 scale = _mm_set1_ps(Unorm8Scale);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 u, v;
+    encodeOctahedral4(SimdVector3(normals, i), u, v);
+
+    const __m128i iu = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(u, half), half), scale));
+    const __m128i iv = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(v, half), half), scale));
+    const __m128i shorts = _mm_packs_epi32(_mm_unpacklo_epi32(iu, iv), _mm_unpackhi_epi32(iu, iv));
+    _mm_storel_epi64((__m128i*)(out + i * 2), _mm_packus_epi16(shorts, shorts));
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+    encodeOctahedralUnorm8(Vector3(normals.x[i], normals.y[i], normals.z[i]), out + i * 2);
+}
+
+void encodeQTangents(const Vector3SoA& tangents, const Vector3SoA& bitangents, const Vector3SoA& normals, short* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_SIMD_MATH)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+
+  for (; i + 4 <= count; i += 4)
+  {
+    // same steps as makeQTangent, branches become selects
+    SimdVector3 n(normals, i);
+    normalize3(n);
+
+    SimdVector3 t(tangents, i);
+    const __m128 d = dot3(t, n);
+    t.x = _mm_sub_ps(t.x, _mm_mul_ps(n.x, d));
+    t.y = _mm_sub_ps(t.y, _mm_mul_ps(n.y, d));
+    t.z = _mm_sub_ps(t.z, _mm_mul_ps(n.z, d));
+
+    const __m128 degenerate = _mm_cmplt_ps(dot3(t, t), _mm_set1_ps(MinTangentLengthSq));
+    const __m128 useXY = _mm_cmpgt_ps(_mm_andnot_ps(signMask, n.x), _mm_andnot_ps(signMask, n.z));
+    t.x = select(degenerate, _mm_and_ps(useXY, _mm_xor_ps(n.y, signMask)), t.x);
+    t.y = select(degenerate, select(useXY, n.x, _mm_xor_ps(n.z, signMask)), t.y);
+    t.z = select(degenerate, _mm_andnot_ps(useXY, n.y), t.z);
+    normalize3(t);
+
+    const __m128 bx = _mm_sub_ps(_mm_mul_ps(n.y, t.z), _mm_mul_ps(n.z, t.y));
+    const __m128 by = _mm_sub_ps(_mm_mul_ps(n.z, t.x), _mm_mul_ps(n.x, t.z));
+    const __m128 bz = _mm_sub_ps(_mm_mul_ps(n.x, t.y), _mm_mul_ps(n.y, t.x));
+
+    const SimdVector3 bitangent(bitangents, i);
+    __m128 handedness = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, bitangent.x), _mm_mul_ps(by, bitangent.y)), _mm_mul_ps(bz, bitangent.z));
+    handedness = _mm_and_ps(_mm_cmplt_ps(handedness, zero), signMask);
+
+    const __m128 traceW = _mm_add_ps(_mm_add_ps(t.x, by), n.z);
+    const __m128 traceX = _mm_sub_ps(_mm_sub_ps(t.x, by), n.z);
+    const __m128 traceY = _mm_sub_ps(_mm_sub_ps(by, t.x), n.z);
+    const __m128 traceZ = _mm_sub_ps(_mm_sub_ps(n.z, t.x), by);
+    const __m128 maxTrace = _mm_max_ps(_mm_max_ps(traceW, traceX), _mm_max_ps(traceY, traceZ));
+
+    const __m128 isW = _mm_cmpeq_ps(traceW, maxTrace);
+    const __m128 isX = _mm_andnot_ps(isW, _mm_cmpeq_ps(traceX, maxTrace));
+    const __m128 isY = _mm_andnot_ps(_mm_or_ps(isW, isX), _mm_cmpeq_ps(traceY, maxTrace));
+
+    const __m128 c = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sqrt_ps(_mm_add_ps(one, maxTrace)));
+    const __m128 r = _mm_div_ps(_mm_set1_ps(0.25f), c);
+
+    const __m128 a = _mm_mul_ps(_mm_sub_ps(bz, n.y), r);
+    const __m128 b = _mm_mul_ps(_mm_sub_ps(n.x, t.z), r);
+    const __m128 e = _mm_mul_ps(_mm_sub_ps(t.y, bx), r);
+    const __m128 f = _mm_mul_ps(_mm_add_ps(bx, t.y), r);
+    const __m128 g = _mm_mul_ps(_mm_add_ps(n.x, t.z), r);
+    const __m128 h = _mm_mul_ps(_mm_add_ps(n.y, bz), r);
+
+    __m128 q[4];
+    q[0] = select(isW, a, select(isX, c, select(isY, f, g)));
+    q[1] = select(isW, b, select(isX, f, select(isY, c, h)));
+    q[2] = select(isW, e, select(isX, g, select(isY, h, c)));
+    q[3] = select(isW, c, select(isX, a, select(isY, b, e)));
+
+    const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(q[0], q[0]), _mm_mul_ps(q[1], q[1])), _mm_mul_ps(q[2], q[2])), _mm_mul_ps(q[3], q[3]));
+    const __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+    const __m128 flip = _mm_and_ps(_mm_cmplt_ps(_mm_mul_ps(q[3], invLength), zero), signMask);
+
+    __m128i quantized[4];
+    for (int k = 0; k < 4; ++k)
+    {
+      q[k] = _mm_xor_ps(_mm_mul_ps(q[k], invLength), flip);
+      if (k == 3)
+        q[k] = _mm_max_ps(q[k], _mm_set1_ps(QTangentBias));
+      q[k] = _mm_xor_ps(q[k], handedness);
+
+      quantized[k] = _mm_cvtps_epi32(_mm_mul_ps(clamp4(q[k], _mm_set1_ps(-1.0f), one), _mm_set1_ps(Snorm16Scale)));
+    }
+
+    __m128i low, high;
+    packShort4x4(quantized, low, high);
+    _mm_storeu_si128((__m128i*)(out + i * 4), low);
+    _mm_storeu_si128((__m128i*)(out + i * 4 + 8), high);
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+  {
+    Quaternion q;
+    makeQTangent(q,
+      Vector3(tangents.x[i], tangents.y[i], tangents.z[i]),
+      Vector3(bitangents.x[i], bitangents.y[i], bitangents.z[i]),
+      Vector3(normals.x[i], normals.y[i], normals.z[i]));
+    encodeQTangentSnorm16(q, out + i * 4);
+  }
+}
+
+void quantizePositions(const AABB& bounds, const Vector3SoA& positions, uint16* out, uint32 count)
+{
+  uint32 i = 0;
+
+#if defined (SUPPORT_SIMD_MATH)
+  const Vector3 size = bounds.maximum - bounds.minimum;
+  const __m128 scaleX = _mm_set1_ps(size.x > 0.0f ? Unorm16Scale / size.x : 0.0f);
+  const __m128 scaleY = _mm_set1_ps(size.y > 0.0f ? Unorm16Scale / size.y : 0.0f);
+  const __m128 scaleZ = _mm_set1_ps(size.z > 0.0f ? Unorm16Scale / size.z : 0.0f);
+  const __m128 minX = _mm_set1_ps(bounds.minimum.x);
+  const __m128 minY = _mm_set1_ps(bounds.minimum.y);
+  const __m128 minZ = _mm_set1_ps(bounds.minimum.z);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 maximum = _mm_set1_ps(Unorm16Scale);
+
+  // sse2 has no unsigned 32 -> 16 bit pack, the values are biased into the signed range
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i unbias = _mm_set1_epi16((short)0x8000);
+
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m128 x = clamp4(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(positions.x + i), minX), scaleX), zero, maximum);
+    const __m128 y = clamp4(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(positions.y + i), minY), scaleY), zero, maximum);
+    const __m128 z = clamp4(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(positions.z + i), minZ), scaleZ), zero, maximum);
+
+    __m128i quantized[4];
+    quantized[0] = _mm_sub_epi32(_mm_cvtps_epi32(x), bias);
+    quantized[1] = _mm_sub_epi32(_mm_cvtps_epi32(y), bias);
+    quantized[2] = _mm_sub_epi32(_mm_cvtps_epi32(z), bias);
+    quantized[3] = _mm_sub_epi32(_mm_setzero_si128(), bias);
+
+    __m128i low, high;
+    packShort4x4(quantized, low, high);
+    _mm_storeu_si128((__m128i*)(out + i * 4), _mm_xor_si128(low, unbias));
+    _mm_storeu_si128((__m128i*)(out + i * 4 + 8), _mm_xor_si128(high, unbias));
+  }
+#endif // SUPPORT_SIMD_MATH
+
+  for (; i < count; ++i)
+    quantizePosition(bounds, Vector3(positions.x[i], positions.y[i], positions.z[i]), out + i * 4);
+}
\ No newline at end of file
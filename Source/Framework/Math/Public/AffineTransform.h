@@ -0,0 +1,124 @@
+#ifndef __AffineTransform_h_
+#define __AffineTransform_h_
+
+#include "Matrix.h"
+#include "Quaternion.h"
+
+// upper 3x4 part of a row major Matrix4, the last row is implicitly (0, 0, 0, 1).
+// the translation lives in the w lane of each row, so every row fits a sse register.
+ALIGN16 class AffineTransform
+{
+public:
+  DECLARE_ALIGNED_ALLOCATOR
+
+  AffineTransform() {}
+  AffineTransform(float m00, float m01, float m02, float m03,
+    float m10, float m11, float m12, float m13,
+    float m20, float m21, float m22, float m23);
+  // takes the first 12 floats, e.g. the upper part of a Matrix4
+  explicit AffineTransform(const float* ptr);
+
+  float& operator[](int index) { return m[index]; }
+  float operator[](int index) const { return m[index]; }
+  const float* getPtr() const { return m; }
+
+  Vector3 getTranslation() const { return Vector3(m[3], m[7], m[11]); }
+  void setTranslation(const Vector3& t) { m[3] = t.x; m[7] = t.y; m[11] = t.z; }
+
+#if defined (SUPPORT_SIMD_MATH)
+  __m128 loadRow(int row) const { return _mm_loadu_ps(m + row * 4); }
+  void storeRow(int row, __m128 value) { _mm_storeu_ps(m + row * 4, value); }
+#endif // SUPPORT_SIMD_MATH
+
+  static AffineTransform Identity;
+
+private:
+  float m[12];
+};
+
+inline AffineTransform::AffineTransform(float m00, float m01, float m02, float m03,
+  float m10, float m11, float m12, float m13,
+  float m20, float m21, float m22, float m23)
+{
+  m[0] = m00; m[1] = m01; m[2] = m02; m[3] = m03;
+  m[4] = m10; m[5] = m11; m[6] = m12; m[7] = m13;
+  m[8] = m20; m[9] = m21; m[10] = m22; m[11] = m23;
+}
+
+inline AffineTransform::AffineTransform(const float* ptr)
+{
+  for (int i = 0; i < 12; ++i)
+    m[i] = ptr[i];
+}
+
+#if defined (SUPPORT_SIMD_MATH)
+
+inline AffineTransform operator*(const AffineTransform& a, const AffineTransform& b)
+{
+  AffineTransform result;
+
+  const __m128 maskW = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  const __m128 b0 = b.loadRow(0);
+  const __m128 b1 = b.loadRow(1);
+  const __m128 b2 = b.loadRow(2);
+
+  // like Matrix4, the implicit last row of b only contributes the translation of a
+  for (int i = 0; i < 3; ++i)
+  {
+    const __m128 row = a.loadRow(i);
+
+    __m128 value = _mm_and_ps(row, maskW);
+    value = _mm_add_ps(value, _mm_mul_ps(SIMD_SPLAT(row, 0), b0));
+    value = _mm_add_ps(value, _mm_mul_ps(SIMD_SPLAT(row, 1), b1));
+    value = _mm_add_ps(value, _mm_mul_ps(SIMD_SPLAT(row, 2), b2));
+
+    result.storeRow(i, value);
+  }
+
+  return result;
+}
+
+#else
+
+inline AffineTransform operator*(const AffineTransform& a, const AffineTransform& b)
+{
+  AffineTransform result;
+
+  for (int i = 0; i < 12; i += 4)
+  {
+    result[i + 0] = a[i] * b[0] + a[i + 1] * b[4] + a[i + 2] * b[8];
+    result[i + 1] = a[i] * b[1] + a[i + 1] * b[5] + a[i + 2] * b[9];
+    result[i + 2] = a[i] * b[2] + a[i + 1] * b[6] + a[i + 2] * b[10];
+    result[i + 3] = a[i] * b[3] + a[i + 1] * b[7] + a[i + 2] * b[11] + a[i + 3];
+  }
+
+  return result;
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+inline Vector3 operator*(const AffineTransform& t, const Vector3& point)
+{
+  return Vector3(
+    t[0] * point.x + t[1] * point.y + t[2] * point.z + t[3],
+    t[4] * point.x + t[5] * point.y + t[6] * point.z + t[7],
+    t[8] * point.x + t[9] * point.y + t[10] * point.z + t[11]);
+}
+
+inline Vector3 transformVector(const AffineTransform& t, const Vector3& v)
+{
+  return Vector3(
+    t[0] * v.x + t[1] * v.y + t[2] * v.z,
+    t[4] * v.x + t[5] * v.y + t[6] * v.z,
+    t[8] * v.x + t[9] * v.y + t[10] * v.z);
+}
+
+// general inverse, scale and shear are allowed. singular or nearly singular (relative to
+// the scale) transforms result in the identity
+AffineTransform inverse(const AffineTransform& t);
+
+// rotation and scale are applied first, then the translation
+void makeAffineTransform(AffineTransform& t, const Quaternion& rotation, const Vector3& translation, const Vector3& scale = Vector3(1, 1, 1));
+void makeMatrix(Matrix4& mat, const AffineTransform& t);
+
+#endif // __AffineTransform_h_
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef __BatchMath_h_
+#define __BatchMath_h_
+
+// structure of arrays view, the arrays don't need to be aligned
+struct Vector3SoA
+{
+  Vector3SoA() : x(0), y(0), z(0) {}
+  Vector3SoA(float* x, float* y, float* z) : x(x), y(y), z(z) {}
+
+  float* x;
+  float* y;
+  float* z;
+};
+
+// batch transforms, processing 4 (sse) or 8 (avx) elements per iteration.
+// input and output may be the same array, partially overlapping ranges are not supported.
+
+// w = 1
+void transformPoints(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count);
+void transformPoints(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count);
+
+// w = 0, the translation is ignored
+void transformVectors(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count);
+void transformVectors(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count);
+
+// w = 1 followed by the perspective divide, there is no clipping against w <= 0
+void transformAndProject(const Matrix4& mat, const Vector3* in, Vector3* out, uint32 count);
+void transformAndProject(const Matrix4& mat, const Vector3SoA& in, const Vector3SoA& out, uint32 count);
+
+enum eNormalizePrecision
+{
+  NP_APPROXIMATE,   // rsqrt estimate, about 12 bits
+  NP_REFINED,       // rsqrt and one newton raphson step, about 22 bits
+  NP_EXACT          // sqrt and divide, same results as normalize()
+};
+
+// zero length vectors become (0, 0, 0)
+void normalizeArray(const Vector3* in, Vector3* out, uint32 count, eNormalizePrecision precision = NP_REFINED);
+void normalizeArray(const Vector3SoA& in, const Vector3SoA& out, uint32 count, eNormalizePrecision precision = NP_REFINED);
+
+// cephes style polynomials, the absolute error stays below 1e-6 for |angle| < 8192.
+// sines or cosines may be 0 if only one of them is needed
+void sinCosArray(const float* angles, float* sines, float* cosines, uint32 count);
+
+#endif // __BatchMath_h_
\ No newline at end of file
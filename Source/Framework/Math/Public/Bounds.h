@@ -0,0 +1,64 @@
+#ifndef __Bounds_h_
+#define __Bounds_h_
+
+#include <float.h>
+
+#include "BatchMath.h"
+
+// axis aligned box, the default box is empty and grows with every merge
+class AABB
+{
+public:
+  AABB() : minimum(FLT_MAX, FLT_MAX, FLT_MAX), maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX) {}
+  AABB(const Vector3& minimum, const Vector3& maximum) : minimum(minimum), maximum(maximum) {}
+
+  bool isEmpty() const { return minimum.x > maximum.x || minimum.y > maximum.y || minimum.z > maximum.z; }
+
+  Vector3 getCenter() const { return (minimum + maximum) * 0.5f; }
+  // half the size along each axis
+  Vector3 getExtent() const { return (maximum - minimum) * 0.5f; }
+
+  void merge(const Vector3& point);
+  void merge(const AABB& box);
+
+  bool contains(const Vector3& point) const;
+
+  Vector3 minimum;
+  Vector3 maximum;
+};
+
+// a negative radius marks an empty sphere
+class BoundingSphere
+{
+public:
+  BoundingSphere() : center(0, 0, 0), radius(-1.0f) {}
+  BoundingSphere(const Vector3& center, float radius) : center(center), radius(radius) {}
+
+  bool isEmpty() const { return radius < 0.0f; }
+
+  // the smallest sphere enclosing both
+  void merge(const Vector3& point);
+  void merge(const BoundingSphere& sphere);
+
+  bool contains(const Vector3& point) const;
+
+  Vector3 center;
+  float radius;
+};
+
+// bounds of the transformed volume, not the tightest fit after rotations
+AABB transform(const Matrix4& mat, const AABB& box);
+BoundingSphere transform(const Matrix4& mat, const BoundingSphere& sphere);
+
+bool intersects(const AABB& a, const AABB& b);
+bool intersects(const BoundingSphere& a, const BoundingSphere& b);
+bool intersects(const AABB& box, const BoundingSphere& sphere);
+
+// min/max reduction over 4 (sse) or 8 (avx) points per iteration
+void computeBounds(AABB& box, const Vector3* points, uint32 count);
+void computeBounds(AABB& box, const Vector3SoA& points, uint32 count);
+// centered on the box, the radius is the largest distance of any point to the center
+void computeBoundingSphere(BoundingSphere& sphere, const AABB& box, const Vector3* points, uint32 count);
+void computeBoundingSphere(BoundingSphere& sphere, const AABB& box, const Vector3SoA& points, uint32 count);
+
+#endif // __Bounds_h_
\ No newline at end of file
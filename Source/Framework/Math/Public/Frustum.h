@@ -0,0 +1,55 @@
+#ifndef __Frustum_h_
+#define __Frustum_h_
+
+#include "BatchMath.h"
+#include "Bounds.h"
+
+enum eFrustumPlane
+{
+  FP_LEFT,
+  FP_RIGHT,
+  FP_BOTTOM,
+  FP_TOP,
+  FP_NEAR,
+  FP_FAR,
+  FP_COUNT
+};
+
+// planes point inwards and are normalized, dot(plane, (p, 1)) is the signed
+// distance of p and positive inside the frustum
+ALIGN16 class Frustum
+{
+public:
+  DECLARE_ALIGNED_ALLOCATOR
+
+  Frustum() {}
+  explicit Frustum(const Matrix4& viewProj) { setFromMatrix(viewProj); }
+
+  // viewProj = proj * view, clip space z in [0, w] as produced by makePerspectiveProjMatrix.
+  // with just the projection the planes end up in view space
+  void setFromMatrix(const Matrix4& viewProj);
+
+  const Vector4& getPlane(uint32 index) const { return m_planes[index]; }
+
+  bool isVisible(const Vector3& center, float radius) const;
+  bool isVisible(const Vector3& boxMin, const Vector3& boxMax) const;
+  bool isVisible(const AABB& box) const { return !box.isEmpty() && isVisible(box.minimum, box.maximum); }
+  bool isVisible(const BoundingSphere& sphere) const { return !sphere.isEmpty() && isVisible(sphere.center, sphere.radius); }
+
+private:
+  Vector4 m_planes[FP_COUNT];
+};
+
+// batch culling, 4 (sse) or 8 (avx) volumes per iteration. visibility receives one bit
+// per volume, (count + 31) / 32 words, bit i % 32 of word i / 32 is set if volume i is
+// at least partially inside. the tests are conservative, volumes close to a frustum
+// corner may be reported visible although they are outside.
+void cullSpheres(const Frustum& frustum, const Vector3SoA& centers, const float* radii, uint32 count, uint32* visibility);
+void cullBoxes(const Frustum& frustum, const Vector3SoA& boxMin, const Vector3SoA& boxMax, uint32 count, uint32* visibility);
+
+inline bool isVisible(const uint32* visibility, uint32 index)
+{
+  return (visibility[index >> 5] & (1u << (index & 31))) != 0;
+}
+
+#endif // __Frustum_h_
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef __HalfFloat_h_
+#define __HalfFloat_h_
+
+// ieee 754 binary16. float to half rounds to nearest even, values out of range become
+// infinity and nans stay nans (the payload isn't preserved).
+uint16 floatToHalf(float value);
+float halfToFloat(uint16 value);
+
+// batch versions, f16c when compiled for avx2, sse2 otherwise. the arrays don't need to be aligned
+void floatToHalf(const float* in, uint16* out, uint32 count);
+void halfToFloat(const uint16* in, float* out, uint32 count);
+
+#endif // __HalfFloat_h_
\ No newline at end of file
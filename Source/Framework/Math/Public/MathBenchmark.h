@@ -0,0 +1,545 @@
+#ifndef __MathBenchmark_h_
+#define __MathBenchmark_h_
+
+#include "Frustum.h"
+#include "HalfFloat.h"
+#include "VertexEncoding.h"
+
+namespace MathBenchmark
+{
+
+#define RUN_BENCHMARK(name, iterations, body) { \
+    const double start = getHighResolutionTime(); \
+    for (uint32 iteration = 0; iteration < (iterations); ++iteration) { body; } \
+    const double seconds = getHighResolutionTime() - start; \
+    printf("%-32s %8.2f ns/op %10.2f Mops/s\n", (name), seconds * 1e9 / (iterations), (iterations) / seconds * 1e-6); }
+
+  // plain scalar versions as baseline for the simd kernels
+  static void ReferenceMultiply(const Matrix4& a, const Matrix4& b, Matrix4& mat)
+  {
+    for (int i = 0; i < 16; i += 4)
+    {
+      for (int j = 0; j < 4; ++j)
+        mat[i + j] = a[i] * b[j] + a[i + 1] * b[4 + j] + a[i + 2] * b[8 + j] + a[i + 3] * b[12 + j];
+    }
+  }
+
+  static void ReferenceTransform(const Matrix4& m, const Vector3& v, Vector3& vec)
+  {
+    vec.x = m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3];
+    vec.y = m[4] * v.x + m[5] * v.y + m[6] * v.z + m[7];
+    vec.z = m[8] * v.x + m[9] * v.y + m[10] * v.z + m[11];
+  }
+
+  static void RunMatrixBenchmarks(uint32 iterations = 10000000)
+  {
+    printf("\nStarting Matrix Benchmarks (%s)...\n",
+#if defined (SUPPORT_AVX_MATH)
+      "avx"
+#elif defined (SUPPORT_SIMD_MATH)
+      "sse"
+#else
+      "scalar"
+#endif
+      );
+
+    // a few different inputs so the results can't be hoisted out of the loops
+    const uint32 NumInputs = 64;
+    Matrix4 matrices[NumInputs];
+    Vector3 points[NumInputs];
+    Vector4 vectors[NumInputs];
+    for (uint32 i = 0; i < NumInputs; ++i)
+    {
+      Matrix4 rotateX, rotateY;
+      makeRotateX(rotateX, i * 0.1f);
+      makeRotateY(rotateY, i * 0.2f);
+      matrices[i] = rotateX * rotateY;
+      setTransform(matrices[i], (float)i, 2.0f * i, -1.0f * i);
+      points[i] = Vector3((float)i, 1.0f - i, 0.5f * i);
+      vectors[i] = Vector4(points[i], 1.0f);
+    }
+
+    Matrix4 matResult = Matrix4::Identity;
+    Vector3 vecResult(0, 0, 0);
+    Vector4 vec4Result(0, 0, 0, 0);
+    float sink = 0.0f;
+
+    RUN_BENCHMARK("Matrix4 * Matrix4 (reference)", iterations, {
+      ReferenceMultiply(matrices[iteration % NumInputs], matrices[(iteration + 1) % NumInputs], matResult);
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("Matrix4 * Matrix4", iterations, {
+      matResult = matrices[iteration % NumInputs] * matrices[(iteration + 1) % NumInputs];
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("Matrix4 * Vector3 (reference)", iterations, {
+      ReferenceTransform(matrices[iteration % NumInputs], points[(iteration + 3) % NumInputs], vecResult);
+      sink += vecResult.x;
+    });
+
+    RUN_BENCHMARK("Matrix4 * Vector3", iterations, {
+      vecResult = matrices[iteration % NumInputs] * points[(iteration + 3) % NumInputs];
+      sink += vecResult.x;
+    });
+
+    RUN_BENCHMARK("Matrix4 * Vector4", iterations, {
+      vec4Result = matrices[iteration % NumInputs] * vectors[(iteration + 3) % NumInputs];
+      sink += vec4Result.x;
+    });
+
+    RUN_BENCHMARK("makeLookAt", iterations, {
+      makeLookAt(matResult, points[iteration % NumInputs], points[(iteration + 5) % NumInputs], Vector3(0, 1, 0));
+      sink += matResult[iteration & 15];
+    });
+
+    printf("(checksum %f)\n", sink);
+  }
+
+  // the specialized versions only hold for their kind of matrix, all inputs are rigid
+  // transforms here so every variant does the same amount of useful work
+  static void RunInverseBenchmarks(uint32 iterations = 10000000)
+  {
+    printf("\nStarting Matrix Inverse Benchmarks...\n");
+
+    const uint32 NumInputs = 64;
+    Matrix4 matrices[NumInputs];
+    for (uint32 i = 0; i < NumInputs; ++i)
+    {
+      Matrix4 rotateX, rotateY;
+      makeRotateX(rotateX, i * 0.1f);
+      makeRotateY(rotateY, i * 0.2f);
+      matrices[i] = rotateX * rotateY;
+      setTransform(matrices[i], (float)i, 2.0f * i, -1.0f * i);
+    }
+
+    Matrix4 matResult = Matrix4::Identity;
+    float sink = 0.0f;
+
+    RUN_BENCHMARK("transpose", iterations, {
+      transpose(matResult, matrices[iteration % NumInputs]);
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("inverse", iterations, {
+      inverse(matResult, matrices[iteration % NumInputs]);
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("inverseAffine", iterations, {
+      inverseAffine(matResult, matrices[iteration % NumInputs]);
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("inverseOrthonormal", iterations, {
+      inverseOrthonormal(matResult, matrices[iteration % NumInputs]);
+      sink += matResult[iteration & 15];
+    });
+
+    printf("(checksum %f)\n", sink);
+  }
+
+  // the quaternion and 3x4 paths against the Matrix4 ones they replace, the camera
+  // variants build the same view matrix from yaw, pitch and position
+  static void RunTransformBenchmarks(uint32 iterations = 10000000)
+  {
+    printf("\nStarting Transform Benchmarks...\n");
+
+    const uint32 NumInputs = 64;
+    Matrix4 matrices[NumInputs];
+    AffineTransform transforms[NumInputs];
+    Quaternion rotations[NumInputs];
+    Vector3 positions[NumInputs];
+    for (uint32 i = 0; i < NumInputs; ++i)
+    {
+      makeQuaternion(rotations[i], normalize(Vector3(1.0f, (float)i, 0.5f * i)), i * 0.1f);
+      positions[i] = Vector3((float)i, 2.0f * i, -1.0f * i);
+      makeAffineTransform(transforms[i], rotations[i], positions[i]);
+      makeMatrix(matrices[i], transforms[i]);
+    }
+
+    Matrix4 matResult = Matrix4::Identity;
+    AffineTransform affineResult = AffineTransform::Identity;
+    Quaternion quatResult = Quaternion::Identity;
+    float sink = 0.0f;
+
+    RUN_BENCHMARK("Quaternion * Quaternion", iterations, {
+      quatResult = rotations[iteration % NumInputs] * rotations[(iteration + 1) % NumInputs];
+      sink += quatResult.x;
+    });
+
+    RUN_BENCHMARK("Matrix4 * Matrix4", iterations, {
+      matResult = matrices[iteration % NumInputs] * matrices[(iteration + 1) % NumInputs];
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("Affine * Affine", iterations, {
+      affineResult = transforms[iteration % NumInputs] * transforms[(iteration + 1) % NumInputs];
+      sink += affineResult[iteration % 12];
+    });
+
+    RUN_BENCHMARK("inverseAffine(Matrix4)", iterations, {
+      inverseAffine(matResult, matrices[iteration % NumInputs]);
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("inverse(AffineTransform)", iterations, {
+      affineResult = inverse(transforms[iteration % NumInputs]);
+      sink += affineResult[iteration % 12];
+    });
+
+    RUN_BENCHMARK("camera (Matrix4)", iterations, {
+      const float pitch = (iteration & 127) * 0.01f;
+      const float yaw = (iteration & 255) * 0.02f;
+      const Vector3& position = positions[iteration % NumInputs];
+
+      Matrix4 rotatePitch;
+      Matrix4 rotateYaw;
+      makeRotateX(rotatePitch, pitch);
+      makeRotateY(rotateYaw, yaw);
+      const Matrix4 orientation = rotatePitch * rotateYaw;
+      const Vector3 forward(orientation[8], orientation[9], orientation[10]);
+      makeLookAt(matResult, position, position + forward, Vector3(0, 1, 0));
+      sink += matResult[iteration & 15];
+    });
+
+    RUN_BENCHMARK("camera (Quaternion)", iterations, {
+      const float pitch = (iteration & 127) * 0.01f;
+      const float yaw = (iteration & 255) * 0.02f;
+      const Vector3& position = positions[iteration % NumInputs];
+
+      Quaternion rotatePitch;
+      Quaternion rotateYaw;
+      makeQuaternion(rotatePitch, Vector3(1, 0, 0), pitch);
+      makeQuaternion(rotateYaw, Vector3(0, 1, 0), yaw);
+      AffineTransform orientation;
+      AffineTransform translation = AffineTransform::Identity;
+      makeAffineTransform(orientation, rotatePitch * rotateYaw, Vector3(0, 0, 0));
+      translation.setTranslation(-position);
+      makeMatrix(matResult, orientation * translation);
+      sink += matResult[iteration & 15];
+    });
+
+    printf("(checksum %f)\n", sink);
+  }
+
+#define RUN_BATCH_BENCHMARK(name, numPoints, repetitions, body) { \
+    const double start = getHighResolutionTime(); \
+    for (uint32 repetition = 0; repetition < (repetitions); ++repetition) { body; } \
+    const double seconds = getHighResolutionTime() - start; \
+    printf("%-32s %8.2f Mpoints/s\n", (name), (double)(numPoints) * (repetitions) / seconds * 1e-6); }
+
+  // single threaded, so the numbers are per core
+  static void RunBatchBenchmarks(uint32 numPoints = 100003, uint32 repetitions = 200)
+  {
+    printf("\nStarting Batch Transform Benchmarks (%d points)...\n", numPoints);
+
+    std::vector<Vector3> points(numPoints);
+    std::vector<Vector3> results(numPoints);
+    std::vector<float> soa(numPoints * 6);
+
+    for (uint32 i = 0; i < numPoints; ++i)
+    {
+      points[i] = Vector3((float)(i % 1000), (float)(i % 77), 1.0f + (float)(i % 13));
+      soa[i] = points[i].x;
+      soa[numPoints + i] = points[i].y;
+      soa[numPoints * 2 + i] = points[i].z;
+    }
+
+    const Vector3SoA soaIn(&soa[0], &soa[numPoints], &soa[numPoints * 2]);
+    const Vector3SoA soaOut(&soa[numPoints * 3], &soa[numPoints * 4], &soa[numPoints * 5]);
+
+    Matrix4 view, proj, viewProj;
+    makeLookAt(view, Vector3(0, 100, -1000), Vector3(0, 0, 0), Vector3(0, 1, 0));
+    makePerspectiveProjMatrix(proj, 60.0f * DEG2RAD, 4.0f / 3.0f, 10.0f, 50000.0f);
+    viewProj = proj * view;
+
+    float sink = 0.0f;
+
+    RUN_BATCH_BENCHMARK("Matrix4 * Vector3 per point", numPoints, repetitions, {
+      for (uint32 i = 0; i < numPoints; ++i)
+        results[i] = view * points[i];
+      sink += results[repetition % numPoints].x;
+    });
+
+    RUN_BATCH_BENCHMARK("transformPoints (AoS)", numPoints, repetitions, {
+      transformPoints(view, &points[0], &results[0], numPoints);
+      sink += results[repetition % numPoints].x;
+    });
+
+    RUN_BATCH_BENCHMARK("transformPoints (SoA)", numPoints, repetitions, {
+      transformPoints(view, soaIn, soaOut, numPoints);
+      sink += soaOut.x[repetition % numPoints];
+    });
+
+    RUN_BATCH_BENCHMARK("transformVectors (AoS)", numPoints, repetitions, {
+      transformVectors(view, &points[0], &results[0], numPoints);
+      sink += results[repetition % numPoints].x;
+    });
+
+    RUN_BATCH_BENCHMARK("transformVectors (SoA)", numPoints, repetitions, {
+      transformVectors(view, soaIn, soaOut, numPoints);
+      sink += soaOut.x[repetition % numPoints];
+    });
+
+    RUN_BATCH_BENCHMARK("transformAndProject (AoS)", numPoints, repetitions, {
+      transformAndProject(viewProj, &points[0], &results[0], numPoints);
+      sink += results[repetition % numPoints].x;
+    });
+
+    RUN_BATCH_BENCHMARK("transformAndProject (SoA)", numPoints, repetitions, {
+      transformAndProject(viewProj, soaIn, soaOut, numPoints);
+      sink += soaOut.x[repetition % numPoints];
+    });
+
+    printf("(checksum %f)\n", sink);
+  }
+
+  static void RunCullingBenchmarks(uint32 numBoxes = 100000, uint32 frames = 200)
+  {
+    printf("\nStarting Frustum Culling Benchmarks (%d boxes)...\n", numBoxes);
+
+    // boxes scattered around the camera, roughly a sixth ends up visible
+    std::vector<float> data(numBoxes * 7);
+    const Vector3SoA boxMin(&data[0], &data[numBoxes], &data[numBoxes * 2]);
+    const Vector3SoA boxMax(&data[numBoxes * 3], &data[numBoxes * 4], &data[numBoxes * 5]);
+    float* radii = &data[numBoxes * 6];
+
+    for (uint32 i = 0; i < numBoxes; ++i)
+    {
+      const float extent = 1.0f + (float)(i % 17);
+      boxMin.x[i] = (float)(i * 7919 % 20000) - 10000.0f;
+      boxMin.y[i] = (float)(i * 104729 % 2000) - 1000.0f;
+      boxMin.z[i] = (float)(i * 15485863 % 20000) - 10000.0f;
+      boxMax.x[i] = boxMin.x[i] + extent;
+      boxMax.y[i] = boxMin.y[i] + extent;
+      boxMax.z[i] = boxMin.z[i] + extent;
+      radii[i] = extent;
+    }
+
+    Matrix4 view, proj;
+    makeLookAt(view, Vector3(0, 100, -1000), Vector3(0, 0, 0), Vector3(0, 1, 0));
+    makePerspectiveProjMatrix(proj, 60.0f * DEG2RAD, 16.0f / 9.0f, 10.0f, 50000.0f);
+    const Frustum frustum(proj * view);
+
+    std::vector<uint32> visibility((numBoxes + 31) / 32);
+    uint32 sink = 0;
+
+    RUN_BATCH_BENCHMARK("Frustum::isVisible per box", numBoxes, frames, {
+      for (uint32 i = 0; i < numBoxes; ++i)
+      {
+        if (frustum.isVisible(Vector3(boxMin.x[i], boxMin.y[i], boxMin.z[i]), Vector3(boxMax.x[i], boxMax.y[i], boxMax.z[i])))
+          ++sink;
+      }
+    });
+
+    RUN_BATCH_BENCHMARK("cullBoxes (SoA)", numBoxes, frames, {
+      cullBoxes(frustum, boxMin, boxMax, numBoxes, &visibility[0]);
+      sink += visibility[repetition % visibility.size()];
+    });
+
+    RUN_BATCH_BENCHMARK("Frustum::isVisible per sphere", numBoxes, frames, {
+      for (uint32 i = 0; i < numBoxes; ++i)
+      {
+        if (frustum.isVisible(Vector3(boxMin.x[i], boxMin.y[i], boxMin.z[i]), radii[i]))
+          ++sink;
+      }
+    });
+
+    RUN_BATCH_BENCHMARK("cullSpheres (SoA)", numBoxes, frames, {
+      cullSpheres(frustum, boxMin, radii, numBoxes, &visibility[0]);
+      sink += visibility[repetition % visibility.size()];
+    });
+
+    uint32 numVisible = 0;
+    cullBoxes(frustum, boxMin, boxMax, numBoxes, &visibility[0]);
+    for (uint32 i = 0; i < numBoxes; ++i)
+      numVisible += isVisible(&visibility[0], i) ? 1 : 0;
+
+    printf("%d visible (checksum %d)\n", numVisible, sink);
+  }
+
+  static void RunHalfFloatBenchmarks(uint32 numValues = 1 << 20, uint32 repetitions = 100)
+  {
+    printf("\nStarting Half Float Benchmarks (%d values)...\n", numValues);
+
+    std::vector<float> floats(numValues);
+    std::vector<uint16> halfs(numValues);
+    for (uint32 i = 0; i < numValues; ++i)
+      floats[i] = ((float)(i % 20000) - 10000.0f) * 0.37f;
+
+    uint32 sink = 0;
+
+    RUN_BATCH_BENCHMARK("floatToHalf per value", numValues, repetitions, {
+      for (uint32 i = 0; i < numValues; ++i)
+        halfs[i] = floatToHalf(floats[i]);
+      sink += halfs[repetition % numValues];
+    });
+
+    RUN_BATCH_BENCHMARK("floatToHalf (array)", numValues, repetitions, {
+      floatToHalf(&floats[0], &halfs[0], numValues);
+      sink += halfs[repetition % numValues];
+    });
+
+    RUN_BATCH_BENCHMARK("halfToFloat per value", numValues, repetitions, {
+      for (uint32 i = 0; i < numValues; ++i)
+        floats[i] = halfToFloat(halfs[i]);
+      sink += (uint32)floats[repetition % numValues];
+    });
+
+    RUN_BATCH_BENCHMARK("halfToFloat (array)", numValues, repetitions, {
+      halfToFloat(&halfs[0], &floats[0], numValues);
+      sink += (uint32)floats[repetition % numValues];
+    });
+
+    printf("(checksum %d)\n", sink);
+  }
+
+  static void RunNormalizeBenchmarks(uint32 numVectors = 100003, uint32 repetitions = 200)
+  {
+    printf("\nStarting Normalize and SinCos Benchmarks (%d elements)...\n", numVectors);
+
+    std::vector<Vector3> vectors(numVectors);
+    std::vector<Vector3> results(numVectors);
+    std::vector<float> soa(numVectors * 3);
+    std::vector<float> sines(numVectors);
+    std::vector<float> cosines(numVectors);
+
+    for (uint32 i = 0; i < numVectors; ++i)
+    {
+      vectors[i] = Vector3((float)(i % 1000) - 500.0f, (float)(i % 77), 1.0f + (float)(i % 13));
+      soa[i] = vectors[i].x;
+      soa[numVectors + i] = vectors[i].y;
+      soa[numVectors * 2 + i] = vectors[i].z;
+    }
+
+    const Vector3SoA soaVectors(&soa[0], &soa[numVectors], &soa[numVectors * 2]);
+    float sink = 0.0f;
+
+    RUN_BATCH_BENCHMARK("normalize per vector", numVectors, repetitions, {
+      for (uint32 i = 0; i < numVectors; ++i)
+        results[i] = normalize(vectors[i]);
+      sink += results[repetition % numVectors].x;
+    });
+
+    RUN_BATCH_BENCHMARK("normalizeArray (AoS, exact)", numVectors, repetitions, {
+      normalizeArray(&vectors[0], &results[0], numVectors, NP_EXACT);
+      sink += results[repetition % numVectors].x;
+    });
+
+    RUN_BATCH_BENCHMARK("normalizeArray (AoS, refined)", numVectors, repetitions, {
+      normalizeArray(&vectors[0], &results[0], numVectors, NP_REFINED);
+      sink += results[repetition % numVectors].x;
+    });
+
+    RUN_BATCH_BENCHMARK("normalizeArray (AoS, approx)", numVectors, repetitions, {
+      normalizeArray(&vectors[0], &results[0], numVectors, NP_APPROXIMATE);
+      sink += results[repetition % numVectors].x;
+    });
+
+    RUN_BATCH_BENCHMARK("normalizeArray (SoA, refined)", numVectors, repetitions, {
+      normalizeArray(soaVectors, soaVectors, numVectors, NP_REFINED);
+      sink += soaVectors.x[repetition % numVectors];
+    });
+
+    RUN_BATCH_BENCHMARK("sinf + cosf per angle", numVectors, repetitions, {
+      for (uint32 i = 0; i < numVectors; ++i)
+      {
+        sines[i] = sinf(soa[i]);
+        cosines[i] = cosf(soa[i]);
+      }
+      sink += sines[repetition % numVectors];
+    });
+
+    RUN_BATCH_BENCHMARK("sinCosArray", numVectors, repetitions, {
+      sinCosArray(&soa[0], &sines[0], &cosines[0], numVectors);
+      sink += sines[repetition % numVectors];
+    });
+
+    printf("(checksum %f)\n", sink);
+  }
+
+  static void RunVertexEncodingBenchmarks(uint32 numVertices = 100003, uint32 repetitions = 100)
+  {
+    printf("\nStarting Vertex Encoding Benchmarks (%d vertices)...\n", numVertices);
+
+    std::vector<float> data(numVertices * 9);
+    for (uint32 i = 0; i < numVertices; ++i)
+    {
+      const Vector3 n = normalize(Vector3((float)(i % 1000) - 500.0f, (float)(i % 77) - 38.0f, (float)(i % 13) - 6.5f));
+      const Vector3 t = normalize(cross(n, Vector3(0.0f, 1.0f, 0.1f)));
+      const Vector3 b = cross(n, t) * ((i & 1) ? 1.0f : -1.0f);
+
+      data[i] = n.x; data[numVertices + i] = n.y; data[numVertices * 2 + i] = n.z;
+      data[numVertices * 3 + i] = t.x; data[numVertices * 4 + i] = t.y; data[numVertices * 5 + i] = t.z;
+      data[numVertices * 6 + i] = b.x; data[numVertices * 7 + i] = b.y; data[numVertices * 8 + i] = b.z;
+    }
+
+    const Vector3SoA normals(&data[0], &data[numVertices], &data[numVertices * 2]);
+    const Vector3SoA tangents(&data[numVertices * 3], &data[numVertices * 4], &data[numVertices * 5]);
+    const Vector3SoA bitangents(&data[numVertices * 6], &data[numVertices * 7], &data[numVertices * 8]);
+
+    // the normals double as positions
+    AABB bounds;
+    computeBounds(bounds, normals, numVertices);
+
+    std::vector<short> shorts(numVertices * 4);
+    std::vector<uint16> positions(numVertices * 4);
+    std::vector<uint8> bytes(numVertices * 2);
+    uint32 sink = 0;
+
+    RUN_BATCH_BENCHMARK("octahedral snorm16 per normal", numVertices, repetitions, {
+      for (uint32 i = 0; i < numVertices; ++i)
+        encodeOctahedralSnorm16(Vector3(normals.x[i], normals.y[i], normals.z[i]), &shorts[i * 2]);
+      sink += shorts[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("encodeOctahedralSnorm16 (SoA)", numVertices, repetitions, {
+      encodeOctahedralSnorm16(normals, &shorts[0], numVertices);
+      sink += shorts[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("encodeOctahedralUnorm8 (SoA)", numVertices, repetitions, {
+      encodeOctahedralUnorm8(normals, &bytes[0], numVertices);
+      sink += bytes[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("qtangent per frame", numVertices, repetitions, {
+      for (uint32 i = 0; i < numVertices; ++i)
+      {
+        Quaternion q;
+        makeQTangent(q,
+          Vector3(tangents.x[i], tangents.y[i], tangents.z[i]),
+          Vector3(bitangents.x[i], bitangents.y[i], bitangents.z[i]),
+          Vector3(normals.x[i], normals.y[i], normals.z[i]));
+        encodeQTangentSnorm16(q, &shorts[i * 4]);
+      }
+      sink += shorts[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("encodeQTangents (SoA)", numVertices, repetitions, {
+      encodeQTangents(tangents, bitangents, normals, &shorts[0], numVertices);
+      sink += shorts[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("quantizePosition per position", numVertices, repetitions, {
+      for (uint32 i = 0; i < numVertices; ++i)
+        quantizePosition(bounds, Vector3(normals.x[i], normals.y[i], normals.z[i]), &positions[i * 4]);
+      sink += positions[repetition % numVertices];
+    });
+
+    RUN_BATCH_BENCHMARK("quantizePositions (SoA)", numVertices, repetitions, {
+      quantizePositions(bounds, normals, &positions[0], numVertices);
+      sink += positions[repetition % numVertices];
+    });
+
+    printf("(checksum %d)\n", sink);
+  }
+
+#undef RUN_BATCH_BENCHMARK
+#undef RUN_BENCHMARK
+
+}
+
+#endif // __MathBenchmark_h_
\ No newline at end of file
@@ -0,0 +1,1110 @@
+#ifndef __MathTest_h_
+#define __MathTest_h_
+
+#include "Frustum.h"
+#include "HalfFloat.h"
+#include "Vector3Stream.h"
+#include "VertexEncoding.h"
+
+namespace MathTest
+{
+
+#define RUN_TEST(test) { \
+    if ((test) == false) \
+      printf("WARNING: " #test " failed...\n"); \
+    else \
+      printf(#test " succeeded...\n"); }
+
+  // gauss jordan with partial pivoting in double precision, used as reference
+  static bool ReferenceInverse(const Matrix4& mat, double* result)
+  {
+    double a[4][8];
+    for (int i = 0; i < 4; ++i)
+    {
+      for (int j = 0; j < 4; ++j)
+      {
+        a[i][j] = mat[i * 4 + j];
+        a[i][4 + j] = i == j ? 1.0 : 0.0;
+      }
+    }
+
+    for (int col = 0; col < 4; ++col)
+    {
+      int pivot = col;
+      for (int row = col + 1; row < 4; ++row)
+      {
+        if (fabs(a[row][col]) > fabs(a[pivot][col]))
+          pivot = row;
+      }
+
+      if (a[pivot][col] == 0.0)
+        return false;
+
+      for (int j = 0; j < 8; ++j)
+        std::swap(a[col][j], a[pivot][j]);
+
+      const double scale = 1.0 / a[col][col];
+      for (int j = 0; j < 8; ++j)
+        a[col][j] *= scale;
+
+      for (int row = 0; row < 4; ++row)
+      {
+        if (row == col)
+          continue;
+
+        const double factor = a[row][col];
+        for (int j = 0; j < 8; ++j)
+          a[row][j] -= factor * a[col][j];
+      }
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+      for (int j = 0; j < 4; ++j)
+        result[i * 4 + j] = a[i][4 + j];
+    }
+
+    return true;
+  }
+
+  // largest element error relative to the largest element of the reference
+  static double RelativeError(const Matrix4& mat, const double* reference)
+  {
+    double maxError = 0.0;
+    double maxElement = 0.0;
+    for (int i = 0; i < 16; ++i)
+    {
+      maxError = std::max(maxError, fabs(mat[i] - reference[i]));
+      maxElement = std::max(maxElement, fabs(reference[i]));
+    }
+
+    return maxElement > 0.0 ? maxError / maxElement : maxError;
+  }
+
+  static float RandomFloat(uint32& seed, float minValue, float maxValue)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return minValue + (maxValue - minValue) * (float)(seed >> 8) / (float)(1 << 24);
+  }
+
+  static void RandomRigidTransform(uint32& seed, Matrix4& mat)
+  {
+    Matrix4 rotateX, rotateY, rotateZ;
+    makeRotateX(rotateX, RandomFloat(seed, -PI, PI));
+    makeRotateY(rotateY, RandomFloat(seed, -PI, PI));
+    makeRotateZ(rotateZ, RandomFloat(seed, -PI, PI));
+
+    mat = rotateX * rotateY * rotateZ;
+    setTransform(mat, RandomFloat(seed, -1000, 1000), RandomFloat(seed, -1000, 1000), RandomFloat(seed, -1000, 1000));
+  }
+
+  static Quaternion RandomRotation(uint32& seed)
+  {
+    Quaternion q;
+    const Vector3 axis = normalize(Vector3(RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1)));
+    makeQuaternion(q, axis, RandomFloat(seed, -PI, PI));
+    return q;
+  }
+
+  // rotation, non uniform scale and translation
+  static void RandomAffineTransform(uint32& seed, AffineTransform& t)
+  {
+    const Vector3 translation(RandomFloat(seed, -1000, 1000), RandomFloat(seed, -1000, 1000), RandomFloat(seed, -1000, 1000));
+    const Vector3 scale(RandomFloat(seed, 0.1f, 10.0f), RandomFloat(seed, 0.1f, 10.0f), RandomFloat(seed, 0.1f, 10.0f));
+    makeAffineTransform(t, RandomRotation(seed), translation, scale);
+  }
+
+  static void TestMatrixInverse(uint32 numMatrices = 10000)
+  {
+    printf("\nStarting Matrix Inverse Tests...\n");
+
+    const double Tolerance = 1e-4;
+    uint32 seed = 12345;
+
+    printf("Test 1 (transpose)\n");
+    {
+      Matrix4 mat, result;
+      for (int i = 0; i < 16; ++i)
+        mat[i] = (float)i;
+
+      transpose(result, mat);
+      bool transposed = true;
+      for (int i = 0; i < 4; ++i)
+      {
+        for (int j = 0; j < 4; ++j)
+          transposed &= result[i * 4 + j] == mat[j * 4 + i];
+      }
+      RUN_TEST(transposed);
+
+      // in place
+      transpose(result, result);
+      RUN_TEST(memcmp(result.getPtr(), mat.getPtr(), sizeof(float) * 16) == 0);
+    }
+
+    printf("\nTest 2 (general inverse)\n");
+    {
+      double reference[16];
+      double maxError = 0.0;
+      bool allInverted = true;
+
+      for (uint32 n = 0; n < numMatrices; ++n)
+      {
+        // diagonally dominant, so the condition number stays reasonable
+        Matrix4 mat;
+        for (int i = 0; i < 16; ++i)
+          mat[i] = RandomFloat(seed, -1.0f, 1.0f);
+        for (int i = 0; i < 4; ++i)
+          mat[i * 5] += mat[i * 5] < 0.0f ? -4.0f : 4.0f;
+
+        Matrix4 result;
+        allInverted &= inverse(result, mat) && ReferenceInverse(mat, reference);
+        maxError = std::max(maxError, RelativeError(result, reference));
+      }
+
+      printf("max relative error %g\n", maxError);
+      RUN_TEST(allInverted);
+      RUN_TEST(maxError < Tolerance);
+
+      // the perspective projection isn't affine, the general inverse has to handle it
+      Matrix4 proj, result;
+      makePerspectiveProjMatrix(proj, 60.0f * DEG2RAD, 16.0f / 9.0f, 1.0f, 1000.0f);
+      RUN_TEST(inverse(result, proj) && ReferenceInverse(proj, reference) && RelativeError(result, reference) < Tolerance);
+
+      // in place
+      Matrix4 inPlace = proj;
+      RUN_TEST(inverse(inPlace, inPlace) && memcmp(inPlace.getPtr(), result.getPtr(), sizeof(float) * 16) == 0);
+    }
+
+    printf("\nTest 3 (singular)\n");
+    {
+      Matrix4 mat = Matrix4::Identity;
+      mat[10] = 0.0f;
+
+      Matrix4 result = Matrix4::Zero;
+      RUN_TEST(inverse(result, mat) == false);
+      RUN_TEST(memcmp(result.getPtr(), Matrix4::Zero.getPtr(), sizeof(float) * 16) == 0);
+
+      // near singular, the determinant isn't exactly zero because of rounding
+      bool allRejected = true;
+      for (uint32 n = 0; n < numMatrices; ++n)
+      {
+        for (int i = 0; i < 12; ++i)
+          mat[i] = RandomFloat(seed, -1.0f, 1.0f);
+        for (int i = 0; i < 4; ++i)
+          mat[12 + i] = mat[i] * 0.3f + mat[4 + i] * 0.7f - mat[8 + i] * 0.1f;
+        allRejected &= inverse(result, mat) == false;
+      }
+      RUN_TEST(allRejected);
+
+      // the threshold is relative, a uniformly scaled down matrix is still invertible
+      mat = Matrix4::Identity;
+      for (int i = 0; i < 16; ++i)
+        mat[i] *= 1e-3f;
+      RUN_TEST(inverse(result, mat) && fabsf(result[0] - 1e3f) < 1e-1f);
+
+      // as is a transform with a large translation
+      mat = Matrix4::Identity;
+      mat[3] = 1e4f;
+      mat[7] = -1e4f;
+      RUN_TEST(inverse(result, mat) && result[3] == -1e4f && result[7] == 1e4f);
+    }
+
+    printf("\nTest 4 (affine inverse)\n");
+    {
+      double reference[16];
+      double maxError = 0.0;
+
+      for (uint32 n = 0; n < numMatrices; ++n)
+      {
+        Matrix4 mat, scale = Matrix4::Identity;
+        RandomRigidTransform(seed, mat);
+        scale[0] = RandomFloat(seed, 0.1f, 10.0f);
+        scale[5] = RandomFloat(seed, 0.1f, 10.0f);
+        scale[10] = RandomFloat(seed, 0.1f, 10.0f);
+        mat = mat * scale;
+
+        Matrix4 result;
+        inverseAffine(result, mat);
+        ReferenceInverse(mat, reference);
+        maxError = std::max(maxError, RelativeError(result, reference));
+      }
+
+      printf("max relative error %g\n", maxError);
+      RUN_TEST(maxError < Tolerance);
+
+      // dependent rows in the 3x3 part result in the identity
+      Matrix4 mat, result;
+      RandomRigidTransform(seed, mat);
+      for (int i = 0; i < 3; ++i)
+        mat[8 + i] = mat[i] * 0.3f - mat[4 + i] * 0.7f;
+      inverseAffine(result, mat);
+      RUN_TEST(memcmp(result.getPtr(), Matrix4::Identity.getPtr(), sizeof(float) * 16) == 0);
+    }
+
+    printf("\nTest 5 (orthonormal inverse)\n");
+    {
+      double reference[16];
+      double maxError = 0.0;
+
+      for (uint32 n = 0; n < numMatrices; ++n)
+      {
+        Matrix4 mat;
+        RandomRigidTransform(seed, mat);
+
+        Matrix4 result;
+        inverseOrthonormal(result, mat);
+        ReferenceInverse(mat, reference);
+        maxError = std::max(maxError, RelativeError(result, reference));
+      }
+
+      printf("max relative error %g\n", maxError);
+      RUN_TEST(maxError < Tolerance);
+
+      // a view matrix times its inverse is the identity
+      Matrix4 view, result;
+      makeLookAt(view, Vector3(10, 20, -30), Vector3(0, 0, 0), Vector3(0, 1, 0));
+      inverseOrthonormal(result, view);
+      ReferenceInverse(Matrix4::Identity, reference);
+      RUN_TEST(RelativeError(view * result, reference) < Tolerance);
+
+      // degenerate views have zero axes like the scalar version, no nans
+      bool finite = true;
+      makeLookAt(view, Vector3(1, 2, 3), Vector3(1, 2, 3), Vector3(0, 1, 0));
+      for (uint32 i = 0; i < 16; ++i)
+        finite &= view[i] == view[i];
+      makeLookAt(view, Vector3(0, 0, 0), Vector3(0, 10, 0), Vector3(0, 1, 0));
+      for (uint32 i = 0; i < 16; ++i)
+        finite &= view[i] == view[i];
+      RUN_TEST(finite);
+    }
+  }
+
+  static void TestTransforms(uint32 numTransforms = 10000)
+  {
+    printf("\nStarting Quaternion and AffineTransform Tests...\n");
+
+    const double Tolerance = 1e-4;
+    uint32 seed = 54321;
+
+    printf("Test 1 (hamilton product)\n");
+    {
+      const Quaternion i(1, 0, 0, 0), j(0, 1, 0, 0), k(0, 0, 1, 0);
+      const Quaternion ij = i * j, ji = j * i, ii = i * i;
+      RUN_TEST(ij.x == 0 && ij.y == 0 && ij.z == 1 && ij.w == 0);
+      RUN_TEST(ji.x == 0 && ji.y == 0 && ji.z == -1 && ji.w == 0);
+      RUN_TEST(ii.x == 0 && ii.y == 0 && ii.z == 0 && ii.w == -1);
+
+      // against the component formula in double precision, and composed like Matrix4
+      double maxError = 0.0;
+      double maxMatrixError = 0.0;
+      double maxRotateError = 0.0;
+      double reference[16];
+      for (uint32 n = 0; n < numTransforms; ++n)
+      {
+        const Quaternion a = RandomRotation(seed);
+        const Quaternion b = RandomRotation(seed);
+        const Quaternion ab = a * b;
+
+        const double x = (double)a.w * b.x + (double)a.x * b.w + (double)a.y * b.z - (double)a.z * b.y;
+        const double y = (double)a.w * b.y - (double)a.x * b.z + (double)a.y * b.w + (double)a.z * b.x;
+        const double z = (double)a.w * b.z + (double)a.x * b.y - (double)a.y * b.x + (double)a.z * b.w;
+        const double w = (double)a.w * b.w - (double)a.x * b.x - (double)a.y * b.y - (double)a.z * b.z;
+        maxError = std::max(maxError, std::max(std::max(fabs(ab.x - x), fabs(ab.y - y)), std::max(fabs(ab.z - z), fabs(ab.w - w))));
+
+        Matrix4 matA, matB, matAB;
+        makeMatrix(matA, a);
+        makeMatrix(matB, b);
+        makeMatrix(matAB, ab);
+        const Matrix4 product = matA * matB;
+        for (int e = 0; e < 16; ++e)
+          reference[e] = product[e];
+        maxMatrixError = std::max(maxMatrixError, RelativeError(matAB, reference));
+
+        const Vector3 v(RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1));
+        const Vector3 rotated = rotate(ab, v);
+        const Vector3 expected = matA * (matB * v);
+        maxRotateError = std::max(maxRotateError, (double)length(rotated - expected));
+      }
+
+      printf("max error %g, matrix %g, rotate %g\n", maxError, maxMatrixError, maxRotateError);
+      RUN_TEST(maxError < 1e-6);
+      RUN_TEST(maxMatrixError < Tolerance && maxRotateError < Tolerance);
+
+      // same rotation as the matrix helpers
+      Quaternion q;
+      Matrix4 fromQuaternion, rotateX;
+      makeQuaternion(q, Vector3(1, 0, 0), 0.7f);
+      makeMatrix(fromQuaternion, q);
+      makeRotateX(rotateX, 0.7f);
+      for (int e = 0; e < 16; ++e)
+        reference[e] = rotateX[e];
+      RUN_TEST(RelativeError(fromQuaternion, reference) < Tolerance);
+    }
+
+    printf("\nTest 2 (interpolation)\n");
+    {
+      bool endpoints = true;
+      bool unitLength = true;
+      bool halfway = true;
+      for (uint32 n = 0; n < numTransforms; ++n)
+      {
+        const Quaternion a = RandomRotation(seed);
+        const Quaternion b = RandomRotation(seed);
+
+        const Quaternion s0 = slerp(a, b, 0.0f);
+        const Quaternion s1 = slerp(a, b, 1.0f);
+        endpoints &= fabs(fabs(dot(s0, a)) - 1.0f) < 1e-4f && fabs(fabs(dot(s1, b)) - 1.0f) < 1e-4f;
+
+        // constant speed, the midpoint is as far from a as from b
+        const Quaternion mid = slerp(a, b, 0.5f);
+        unitLength &= fabs(dot(mid, mid) - 1.0f) < 1e-4f && fabs(dot(nlerp(a, b, 0.3f), nlerp(a, b, 0.3f)) - 1.0f) < 1e-4f;
+        halfway &= fabs(fabs(dot(mid, a)) - fabs(dot(mid, b))) < 1e-4f;
+      }
+      RUN_TEST(endpoints);
+      RUN_TEST(unitLength);
+      RUN_TEST(halfway);
+    }
+
+    printf("\nTest 3 (affine composition)\n");
+    {
+      double reference[16];
+      double maxError = 0.0;
+      double maxPointError = 0.0;
+      for (uint32 n = 0; n < numTransforms; ++n)
+      {
+        AffineTransform a, b;
+        RandomAffineTransform(seed, a);
+        RandomAffineTransform(seed, b);
+
+        // the same as going through Matrix4
+        Matrix4 matA, matB, matAB;
+        makeMatrix(matA, a);
+        makeMatrix(matB, b);
+        makeMatrix(matAB, a * b);
+        const Matrix4 product = matA * matB;
+        for (int e = 0; e < 16; ++e)
+          reference[e] = product[e];
+        maxError = std::max(maxError, RelativeError(matAB, reference));
+
+        const Vector3 p(RandomFloat(seed, -100, 100), RandomFloat(seed, -100, 100), RandomFloat(seed, -100, 100));
+        const Vector3 composed = (a * b) * p;
+        const Vector3 expected = a * (b * p);
+        maxPointError = std::max(maxPointError, (double)length(composed - expected) / std::max(1.0f, length(expected)));
+      }
+
+      printf("max relative error %g, points %g\n", maxError, maxPointError);
+      RUN_TEST(maxError < Tolerance && maxPointError < Tolerance);
+
+      // the identity doesn't change anything
+      AffineTransform t;
+      RandomAffineTransform(seed, t);
+      const AffineTransform left = AffineTransform::Identity * t;
+      const AffineTransform right = t * AffineTransform::Identity;
+      RUN_TEST(memcmp(left.getPtr(), t.getPtr(), sizeof(float) * 12) == 0 && memcmp(right.getPtr(), t.getPtr(), sizeof(float) * 12) == 0);
+    }
+
+    printf("\nTest 4 (affine inverse)\n");
+    {
+      double reference[16];
+      double maxError = 0.0;
+      for (uint32 n = 0; n < numTransforms; ++n)
+      {
+        // with shear, the general inverse has to handle it
+        AffineTransform t;
+        RandomAffineTransform(seed, t);
+        t[1] += RandomFloat(seed, -1, 1);
+        t[6] += RandomFloat(seed, -1, 1);
+
+        Matrix4 mat, result;
+        makeMatrix(mat, t);
+        makeMatrix(result, inverse(t));
+        ReferenceInverse(mat, reference);
+        maxError = std::max(maxError, RelativeError(result, reference));
+      }
+
+      printf("max relative error %g\n", maxError);
+      RUN_TEST(maxError < Tolerance);
+
+      const AffineTransform& identity = AffineTransform::Identity;
+
+      // singular and nearly singular transforms result in the identity
+      AffineTransform t;
+      makeAffineTransform(t, Quaternion::Identity, Vector3(1, 2, 3), Vector3(1, 1, 0));
+      RUN_TEST(memcmp(inverse(t).getPtr(), identity.getPtr(), sizeof(float) * 12) == 0);
+
+      // dependent rows, the determinant is rounding noise
+      bool allRejected = true;
+      for (uint32 n = 0; n < numTransforms; ++n)
+      {
+        RandomAffineTransform(seed, t);
+        for (int i = 0; i < 3; ++i)
+          t[8 + i] = t[i] * 0.3f - t[4 + i] * 0.7f;
+        allRejected &= memcmp(inverse(t).getPtr(), identity.getPtr(), sizeof(float) * 12) == 0;
+      }
+      RUN_TEST(allRejected);
+
+      // the threshold is relative, small and large scales still invert
+      makeAffineTransform(t, RandomRotation(seed), Vector3(1, 2, 3), Vector3(1e-3f, 1e-3f, 1e-3f));
+      Matrix4 mat, result;
+      makeMatrix(mat, t);
+      makeMatrix(result, inverse(t));
+      ReferenceInverse(mat, reference);
+      RUN_TEST(RelativeError(result, reference) < Tolerance);
+
+      makeAffineTransform(t, RandomRotation(seed), Vector3(1e4f, -1e4f, 1e4f), Vector3(1e3f, 1e3f, 1e3f));
+      makeMatrix(mat, t);
+      makeMatrix(result, inverse(t));
+      ReferenceInverse(mat, reference);
+      RUN_TEST(RelativeError(result, reference) < Tolerance);
+    }
+  }
+
+  static void TestFrustumCulling(uint32 numVolumes = 10003)
+  {
+    printf("\nStarting Frustum Culling Tests...\n");
+
+    Matrix4 view, proj;
+    makeLookAt(view, Vector3(0, 100, -1000), Vector3(0, 0, 0), Vector3(0, 1, 0));
+    makePerspectiveProjMatrix(proj, 60.0f * DEG2RAD, 16.0f / 9.0f, 10.0f, 5000.0f);
+    const Frustum frustum(proj * view);
+
+    printf("Test 1 (single volumes)\n");
+    {
+      RUN_TEST(frustum.isVisible(Vector3(0, 0, 0), 1.0f));
+      RUN_TEST(frustum.isVisible(Vector3(0, 100, -1005), 1.0f) == false);
+      RUN_TEST(frustum.isVisible(Vector3(0, 100, -1005), 20.0f));
+      RUN_TEST(frustum.isVisible(Vector3(0, 0, 10000), 100.0f) == false);
+      RUN_TEST(frustum.isVisible(Vector3(-5000, 0, 0), 100.0f) == false);
+      RUN_TEST(frustum.isVisible(Vector3(-10, -10, -10), Vector3(10, 10, 10)));
+      RUN_TEST(frustum.isVisible(Vector3(-10, 200, -1100), Vector3(10, 210, -1010)) == false);
+      RUN_TEST(frustum.isVisible(Vector3(-10000, -10000, 0), Vector3(10000, 10000, 1)));
+    }
+
+    printf("\nTest 2 (batches match the single tests)\n");
+    {
+      std::vector<float> data(numVolumes * 7);
+      const Vector3SoA boxMin(&data[0], &data[numVolumes], &data[numVolumes * 2]);
+      const Vector3SoA boxMax(&data[numVolumes * 3], &data[numVolumes * 4], &data[numVolumes * 5]);
+      float* radii = &data[numVolumes * 6];
+
+      uint32 seed = 4711;
+      for (uint32 i = 0; i < numVolumes; ++i)
+      {
+        boxMin.x[i] = RandomFloat(seed, -4000, 4000);
+        boxMin.y[i] = RandomFloat(seed, -4000, 4000);
+        boxMin.z[i] = RandomFloat(seed, -2000, 6000);
+        boxMax.x[i] = boxMin.x[i] + RandomFloat(seed, 0, 200);
+        boxMax.y[i] = boxMin.y[i] + RandomFloat(seed, 0, 200);
+        boxMax.z[i] = boxMin.z[i] + RandomFloat(seed, 0, 200);
+        radii[i] = RandomFloat(seed, 0, 200);
+      }
+
+      std::vector<uint32> boxVisibility((numVolumes + 31) / 32);
+      std::vector<uint32> sphereVisibility((numVolumes + 31) / 32);
+      cullBoxes(frustum, boxMin, boxMax, numVolumes, &boxVisibility[0]);
+      cullSpheres(frustum, boxMin, radii, numVolumes, &sphereVisibility[0]);
+
+      bool boxesMatch = true;
+      bool spheresMatch = true;
+      uint32 numVisibleBoxes = 0;
+      for (uint32 i = 0; i < numVolumes; ++i)
+      {
+        const Vector3 minCorner(boxMin.x[i], boxMin.y[i], boxMin.z[i]);
+        const Vector3 maxCorner(boxMax.x[i], boxMax.y[i], boxMax.z[i]);
+        boxesMatch &= isVisible(&boxVisibility[0], i) == frustum.isVisible(minCorner, maxCorner);
+        spheresMatch &= isVisible(&sphereVisibility[0], i) == frustum.isVisible(minCorner, radii[i]);
+        numVisibleBoxes += isVisible(&boxVisibility[0], i) ? 1 : 0;
+      }
+
+      // the bits past the last volume stay clear
+      const uint32 lastBits = numVolumes & 31;
+      const bool paddingClear = lastBits == 0 || (boxVisibility.back() >> lastBits) == 0;
+
+      printf("%d of %d boxes visible\n", numVisibleBoxes, numVolumes);
+      RUN_TEST(boxesMatch);
+      RUN_TEST(spheresMatch);
+      RUN_TEST(paddingClear);
+      RUN_TEST(numVisibleBoxes > 0 && numVisibleBoxes < numVolumes);
+    }
+  }
+
+  static void TestBounds(uint32 numPoints = 1003)
+  {
+    printf("\nStarting Bounds Tests...\n");
+
+    printf("Test 1 (merge)\n");
+    {
+      AABB box;
+      RUN_TEST(box.isEmpty());
+
+      box.merge(Vector3(1, 2, 3));
+      RUN_TEST(!box.isEmpty() && box.contains(Vector3(1, 2, 3)));
+
+      box.merge(AABB(Vector3(-1, -1, -1), Vector3(0, 0, 0)));
+      RUN_TEST(equals(box.minimum, Vector3(-1, -1, -1)) && equals(box.maximum, Vector3(1, 2, 3)));
+
+      BoundingSphere sphere;
+      RUN_TEST(sphere.isEmpty());
+
+      sphere.merge(BoundingSphere(Vector3(-2, 0, 0), 1.0f));
+      sphere.merge(BoundingSphere(Vector3(2, 0, 0), 1.0f));
+      RUN_TEST(equals(sphere.center, Vector3(0, 0, 0)) && fabsf(sphere.radius - 3.0f) < 1e-5f);
+
+      // already inside
+      sphere.merge(Vector3(0, 1, 0));
+      RUN_TEST(fabsf(sphere.radius - 3.0f) < 1e-5f);
+    }
+
+    printf("\nTest 2 (intersection)\n");
+    {
+      const AABB box(Vector3(0, 0, 0), Vector3(1, 1, 1));
+      RUN_TEST(intersects(box, AABB(Vector3(0.5f, 0.5f, 0.5f), Vector3(2, 2, 2))));
+      RUN_TEST(intersects(box, AABB(Vector3(1.5f, 0, 0), Vector3(2, 1, 1))) == false);
+      RUN_TEST(intersects(box, BoundingSphere(Vector3(2, 0.5f, 0.5f), 1.1f)));
+      RUN_TEST(intersects(box, BoundingSphere(Vector3(2, 2, 2), 1.1f)) == false);
+      RUN_TEST(intersects(BoundingSphere(Vector3(0, 0, 0), 1), BoundingSphere(Vector3(0, 1.9f, 0), 1)));
+      RUN_TEST(intersects(BoundingSphere(Vector3(0, 0, 0), 1), BoundingSphere(Vector3(0, 2.1f, 0), 1)) == false);
+    }
+
+    printf("\nTest 3 (transform)\n");
+    {
+      Matrix4 rotate;
+      makeRotateY(rotate, HALF_PI);
+      setTransform(rotate, 10, 0, 0);
+
+      const AABB box = transform(rotate, AABB(Vector3(0, 0, 0), Vector3(1, 2, 3)));
+      RUN_TEST(equals(box.minimum, Vector3(10, 0, -1)) && equals(box.maximum, Vector3(13, 2, 0)));
+
+      const BoundingSphere sphere = transform(rotate, BoundingSphere(Vector3(1, 0, 0), 2));
+      RUN_TEST(equals(sphere.center, Vector3(10, 0, -1)) && fabsf(sphere.radius - 2.0f) < 1e-5f);
+    }
+
+    printf("\nTest 4 (point reduction)\n");
+    {
+      std::vector<Vector3> points(numPoints);
+      AABB reference;
+      uint32 seed = 815;
+      for (uint32 i = 0; i < numPoints; ++i)
+      {
+        points[i] = Vector3(RandomFloat(seed, -100, 100), RandomFloat(seed, -10, 10), RandomFloat(seed, 0, 1000));
+        reference.merge(points[i]);
+      }
+
+      // every count covers a different mix of simd iterations and scalar tail
+      bool allMatch = true;
+      for (uint32 count = 1; count <= 19; ++count)
+      {
+        AABB partial, box;
+        for (uint32 i = 0; i < count; ++i)
+          partial.merge(points[i]);
+
+        computeBounds(box, &points[0], count);
+        allMatch &= memcmp(&box, &partial, sizeof(AABB)) == 0;
+      }
+
+      AABB box;
+      computeBounds(box, &points[0], numPoints);
+      allMatch &= memcmp(&box, &reference, sizeof(AABB)) == 0;
+      RUN_TEST(allMatch);
+
+      BoundingSphere sphere;
+      computeBoundingSphere(sphere, box, &points[0], numPoints);
+      bool allInside = true;
+      for (uint32 i = 0; i < numPoints; ++i)
+        allInside &= sphere.contains(points[i]);
+      RUN_TEST(allInside);
+    }
+  }
+
+  static bool IsHalfNan(uint16 value)
+  {
+    return (value & 0x7c00) == 0x7c00 && (value & 0x03ff) != 0;
+  }
+
+  static uint32 FloatBits(float value)
+  {
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  static float FloatFromBits(uint32 bits)
+  {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static void TestHalfFloat()
+  {
+    printf("\nStarting Half Float Tests...\n");
+
+    const uint32 NumHalfs = 65536;
+    std::vector<uint16> halfs(NumHalfs);
+    std::vector<uint16> roundTrip(NumHalfs);
+    std::vector<float> floats(NumHalfs);
+    for (uint32 i = 0; i < NumHalfs; ++i)
+      halfs[i] = (uint16)i;
+
+    printf("Test 1 (all halfs round trip)\n");
+    {
+      halfToFloat(&halfs[0], &floats[0], NumHalfs);
+      floatToHalf(&floats[0], &roundTrip[0], NumHalfs);
+
+      bool batchMatchesScalar = true;
+      bool scalarRoundTrip = true;
+      bool batchRoundTrip = true;
+      for (uint32 i = 0; i < NumHalfs; ++i)
+      {
+        const uint16 half = halfs[i];
+        const uint16 scalar = floatToHalf(halfToFloat(half));
+        if (IsHalfNan(half))
+        {
+          // f16c quiets signaling nans and the payload may get lost, sign and nan have to survive
+          batchMatchesScalar &= floats[i] != floats[i] && (FloatBits(floats[i]) >> 31) == (uint32)(half >> 15);
+          scalarRoundTrip &= IsHalfNan(scalar) && (scalar & 0x8000) == (half & 0x8000);
+          batchRoundTrip &= IsHalfNan(roundTrip[i]) && (roundTrip[i] & 0x8000) == (half & 0x8000);
+        }
+        else
+        {
+          batchMatchesScalar &= FloatBits(floats[i]) == FloatBits(halfToFloat(half));
+          scalarRoundTrip &= scalar == half;
+          batchRoundTrip &= roundTrip[i] == half;
+        }
+      }
+
+      RUN_TEST(batchMatchesScalar);
+      RUN_TEST(scalarRoundTrip);
+      RUN_TEST(batchRoundTrip);
+    }
+
+    printf("\nTest 2 (round to nearest even)\n");
+    {
+      // just below, at and just above the midpoint of every pair of neighbouring finite halfs
+      std::vector<float> probes;
+      std::vector<uint16> expected;
+      for (uint32 half = 0; half < 0x7bff; ++half)
+      {
+        const float low = halfToFloat((uint16)half);
+        const float high = halfToFloat((uint16)(half + 1));
+        const float middle = (low + high) * 0.5f;
+
+        // neighbouring floats, middle is always positive
+        probes.push_back(FloatFromBits(FloatBits(middle) - 1));
+        expected.push_back((uint16)half);
+        probes.push_back(middle);
+        expected.push_back((uint16)((half & 1) ? half + 1 : half));
+        probes.push_back(FloatFromBits(FloatBits(middle) + 1));
+        expected.push_back((uint16)(half + 1));
+      }
+
+      // negative mirror
+      const uint32 numPositive = probes.size();
+      for (uint32 i = 0; i < numPositive; ++i)
+      {
+        probes.push_back(-probes[i]);
+        expected.push_back(expected[i] | 0x8000);
+      }
+
+      std::vector<uint16> results(probes.size());
+      floatToHalf(&probes[0], &results[0], probes.size());
+
+      bool scalarRounding = true;
+      bool batchRounding = true;
+      for (uint32 i = 0; i < probes.size(); ++i)
+      {
+        scalarRounding &= floatToHalf(probes[i]) == expected[i];
+        batchRounding &= results[i] == expected[i];
+      }
+
+      RUN_TEST(scalarRounding);
+      RUN_TEST(batchRounding);
+    }
+
+    printf("\nTest 3 (special values)\n");
+    {
+      const float values[] = { 65504.0f, 65519.0f, 65520.0f, 1e10f, -1e10f, 1e-10f, -0.0f, 5.9604645e-8f };
+      const uint16 halfValues[] = { 0x7bff, 0x7bff, 0x7c00, 0x7c00, 0xfc00, 0x0000, 0x8000, 0x0001 };
+      const uint32 numValues = sizeof(values) / sizeof(values[0]);
+
+      // padded to the simd width so the kernels see the values as well
+      float input[16] = {0};
+      uint16 results[16] = {0};
+      memcpy(input, values, sizeof(values));
+      memcpy(input + 8, values, sizeof(values));
+      floatToHalf(input, results, 16);
+
+      bool allMatch = true;
+      for (uint32 i = 0; i < numValues; ++i)
+        allMatch &= floatToHalf(values[i]) == halfValues[i] && results[i] == halfValues[i] && results[i + 8] == halfValues[i];
+      RUN_TEST(allMatch);
+
+      // too large values used to end up as nan
+      RUN_TEST(IsHalfNan(floatToHalf(1e10f)) == false);
+    }
+  }
+
+  static double NormalizeError(const Vector3& v, const Vector3& result)
+  {
+    const double length = sqrt((double)v.x * v.x + (double)v.y * v.y + (double)v.z * v.z);
+    if (length == 0.0)
+      return fabs(result.x) + fabs(result.y) + fabs(result.z);
+
+    return std::max(fabs(result.x - v.x / length), std::max(fabs(result.y - v.y / length), fabs(result.z - v.z / length)));
+  }
+
+  static void TestBatchNormalize(uint32 numVectors = 10003)
+  {
+    printf("\nStarting Batch Normalize Tests...\n");
+
+    std::vector<Vector3> vectors(numVectors);
+    std::vector<Vector3> results(numVectors);
+    std::vector<float> soa(numVectors * 3);
+    const Vector3SoA soaVectors(&soa[0], &soa[numVectors], &soa[numVectors * 2]);
+
+    uint32 seed = 42;
+    for (uint32 i = 0; i < numVectors; ++i)
+    {
+      // some zero vectors and a wide range of lengths
+      const float scale = (i % 97 == 0) ? 0.0f : powf(10.0f, RandomFloat(seed, -10, 10));
+      vectors[i] = Vector3(RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1)) * scale;
+    }
+
+    const eNormalizePrecision precisions[] = { NP_APPROXIMATE, NP_REFINED, NP_EXACT };
+    const double tolerances[] = { 1e-3, 1e-6, 1e-6 };
+    const char* names[] = { "approximate", "refined", "exact" };
+
+    for (uint32 p = 0; p < 3; ++p)
+    {
+      printf("Test %d (%s)\n", p + 1, names[p]);
+
+      normalizeArray(&vectors[0], &results[0], numVectors, precisions[p]);
+
+      for (uint32 i = 0; i < numVectors; ++i)
+      {
+        soaVectors.x[i] = vectors[i].x;
+        soaVectors.y[i] = vectors[i].y;
+        soaVectors.z[i] = vectors[i].z;
+      }
+      normalizeArray(soaVectors, soaVectors, numVectors, precisions[p]);
+
+      double maxError = 0.0;
+      bool soaMatches = true;
+      bool exactMatches = true;
+      for (uint32 i = 0; i < numVectors; ++i)
+      {
+        maxError = std::max(maxError, NormalizeError(vectors[i], results[i]));
+        soaMatches &= memcmp(&results[i].x, &soaVectors.x[i], sizeof(float)) == 0 &&
+          memcmp(&results[i].y, &soaVectors.y[i], sizeof(float)) == 0 &&
+          memcmp(&results[i].z, &soaVectors.z[i], sizeof(float)) == 0;
+
+        // compared by value, zero vectors may keep the sign of their components
+        const Vector3 reference = normalize(vectors[i]);
+        exactMatches &= reference.x == results[i].x && reference.y == results[i].y && reference.z == results[i].z;
+      }
+
+      printf("max error %g\n", maxError);
+      RUN_TEST(maxError < tolerances[p]);
+      RUN_TEST(soaMatches);
+      if (precisions[p] == NP_EXACT)
+        RUN_TEST(exactMatches);
+    }
+  }
+
+  static void TestSinCos(uint32 numAngles = 100003)
+  {
+    printf("\nStarting SinCos Tests...\n");
+
+    std::vector<float> angles(numAngles);
+    std::vector<float> sines(numAngles);
+    std::vector<float> cosines(numAngles);
+
+    for (uint32 i = 0; i < numAngles; ++i)
+      angles[i] = -1000.0f + 2000.0f * i / numAngles;
+    angles[0] = 0.0f;
+    angles[1] = HALF_PI;
+    angles[2] = -PI;
+
+    sinCosArray(&angles[0], &sines[0], &cosines[0], numAngles);
+
+    double maxError = 0.0;
+    for (uint32 i = 0; i < numAngles; ++i)
+    {
+      maxError = std::max(maxError, fabs(sines[i] - sin((double)angles[i])));
+      maxError = std::max(maxError, fabs(cosines[i] - cos((double)angles[i])));
+    }
+
+    printf("max error %g\n", maxError);
+    RUN_TEST(maxError < 1e-6);
+    RUN_TEST(sines[0] == 0.0f && cosines[0] == 1.0f);
+
+    // one sided output
+    std::vector<float> sinesOnly(numAngles);
+    sinCosArray(&angles[0], &sinesOnly[0], 0, numAngles);
+    RUN_TEST(memcmp(&sinesOnly[0], &sines[0], numAngles * sizeof(float)) == 0);
+  }
+
+  static void TestVector3Stream(uint32 numVectors = 1003)
+  {
+    printf("\nStarting Vector3Stream Tests...\n");
+
+    std::vector<Vector3> vectors(numVectors);
+    uint32 seed = 99;
+    for (uint32 i = 0; i < numVectors; ++i)
+      vectors[i] = Vector3(RandomFloat(seed, -10, 10), RandomFloat(seed, -10, 10), RandomFloat(seed, -10, 10));
+
+    printf("Test 1 (growth and padding)\n");
+    {
+      Vector3Stream stream;
+      for (uint32 i = 0; i < numVectors; ++i)
+        stream.add(vectors[i]);
+
+      bool allMatch = stream.getSize() == numVectors;
+      for (uint32 i = 0; i < numVectors; ++i)
+      {
+        const Vector3 v = stream.get(i);
+        allMatch &= memcmp(&vectors[i], &v, sizeof(Vector3)) == 0;
+      }
+      RUN_TEST(allMatch);
+
+      const bool paddedSize = stream.getPaddedSize() % Vector3Stream::Padding == 0 && stream.getPaddedSize() >= numVectors;
+      RUN_TEST(paddedSize);
+      RUN_TEST(((size_t)stream.getX() & 31) == 0 && ((size_t)stream.getY() & 31) == 0 && ((size_t)stream.getZ() & 31) == 0);
+
+      // shrinking clears the elements that became padding
+      stream.resize(5);
+      bool paddingClear = true;
+      for (uint32 i = stream.getSize(); i < stream.getPaddedSize(); ++i)
+        paddingClear &= stream.getX()[i] == 0.0f && stream.getY()[i] == 0.0f && stream.getZ()[i] == 0.0f;
+      RUN_TEST(paddingClear);
+
+      Vector3Stream copy(stream);
+      RUN_TEST(copy.getSize() == 5 && memcmp(copy.getZ(), stream.getZ(), 5 * sizeof(float)) == 0);
+    }
+
+    printf("\nTest 2 (interleaved layout)\n");
+    {
+      Vector3Stream stream;
+      stream.deinterleave(&vectors[0], sizeof(Vector3), numVectors);
+
+      // a vertex with an extra attribute between the positions
+      const uint32 Stride = 20;
+      std::vector<ubyte> vertices(numVectors * Stride, 0xcd);
+      stream.interleave(&vertices[0], Stride);
+
+      bool allMatch = true;
+      for (uint32 i = 0; i < numVectors; ++i)
+      {
+        allMatch &= memcmp(&vertices[i * Stride], &vectors[i], sizeof(Vector3)) == 0;
+        allMatch &= vertices[i * Stride + sizeof(Vector3)] == 0xcd;
+      }
+      RUN_TEST(allMatch);
+
+      AABB soaBox, aosBox;
+      computeBounds(soaBox, stream.getSoA(), stream.getSize());
+      computeBounds(aosBox, &vectors[0], numVectors);
+      RUN_TEST(memcmp(&soaBox, &aosBox, sizeof(AABB)) == 0);
+    }
+  }
+
+  // in degrees
+  static double AngleBetween(const Vector3& a, const Vector3& b)
+  {
+    const double dotAB = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+    const double lengthA = sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+    const double lengthB = sqrt((double)b.x * b.x + (double)b.y * b.y + (double)b.z * b.z);
+    const double cosAngle = std::min(std::max(dotAB / (lengthA * lengthB), -1.0), 1.0);
+    return acos(cosAngle) * 180.0 / 3.14159265358979323846;
+  }
+
+  static Vector3 RandomNormal(uint32& seed)
+  {
+    Vector3 v;
+    do
+    {
+      v = Vector3(RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1), RandomFloat(seed, -1, 1));
+    } while (squaredLength(v) < 1e-4f || squaredLength(v) > 1.0f);
+
+    return normalize(v);
+  }
+
+  static void TestVertexEncoding(uint32 numVertices = 100003)
+  {
+    printf("\nStarting Vertex Encoding Tests...\n");
+
+    uint32 seed = 2024;
+
+    std::vector<float> normalData(numVertices * 3);
+    std::vector<float> tangentData(numVertices * 3);
+    std::vector<float> bitangentData(numVertices * 3);
+    const Vector3SoA normals(&normalData[0], &normalData[numVertices], &normalData[numVertices * 2]);
+    const Vector3SoA tangents(&tangentData[0], &tangentData[numVertices], &tangentData[numVertices * 2]);
+    const Vector3SoA bitangents(&bitangentData[0], &bitangentData[numVertices], &bitangentData[numVertices * 2]);
+
+    // the axes, the octahedron edges and -0 components first, random directions after that
+    const float special[][3] = {
+      { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 }, { 0, -0.0f, -1 }, { -0.0f, 0, -1 },
+      { 0.7071068f, 0.7071068f, 0 }, { -0.7071068f, 0, -0.7071068f }, { 0, 0.7071068f, -0.7071068f }, { 0.5773503f, -0.5773503f, -0.5773503f } };
+    const uint32 numSpecial = sizeof(special) / sizeof(special[0]);
+
+    for (uint32 i = 0; i < numVertices; ++i)
+    {
+      const Vector3 n = i < numSpecial ? Vector3(special[i][0], special[i][1], special[i][2]) : RandomNormal(seed);
+      const Vector3 t = RandomNormal(seed);
+      // mirrored uv mapping every third vertex
+      const Vector3 b = normalize(cross(n, t)) * ((i % 3 == 0) ? -1.0f : 1.0f) + RandomNormal(seed) * 0.1f;
+
+      normals.x[i] = n.x; normals.y[i] = n.y; normals.z[i] = n.z;
+      tangents.x[i] = t.x; tangents.y[i] = t.y; tangents.z[i] = t.z;
+      bitangents.x[i] = b.x; bitangents.y[i] = b.y; bitangents.z[i] = b.z;
+    }
+
+    printf("Test 1 (octahedral normals)\n");
+    {
+      std::vector<short> snorm(numVertices * 2);
+      std::vector<uint8> unorm(numVertices * 2);
+      encodeOctahedralSnorm16(normals, &snorm[0], numVertices);
+      encodeOctahedralUnorm8(normals, &unorm[0], numVertices);
+
+      double maxSnormError = 0.0;
+      double maxUnormError = 0.0;
+      bool batchMatchesScalar = true;
+      for (uint32 i = 0; i < numVertices; ++i)
+      {
+        const Vector3 n(normals.x[i], normals.y[i], normals.z[i]);
+
+        short scalarSnorm[2];
+        uint8 scalarUnorm[2];
+        encodeOctahedralSnorm16(n, scalarSnorm);
+        encodeOctahedralUnorm8(n, scalarUnorm);
+        batchMatchesScalar &= memcmp(scalarSnorm, &snorm[i * 2], sizeof(scalarSnorm)) == 0;
+        batchMatchesScalar &= memcmp(scalarUnorm, &unorm[i * 2], sizeof(scalarUnorm)) == 0;
+
+        maxSnormError = std::max(maxSnormError, AngleBetween(n, decodeOctahedralSnorm16(&snorm[i * 2])));
+        maxUnormError = std::max(maxUnormError, AngleBetween(n, decodeOctahedralUnorm8(&unorm[i * 2])));
+      }
+
+      printf("max error snorm16x2 %g, unorm8x2 %g degrees\n", maxSnormError, maxUnormError);
+      RUN_TEST(maxSnormError < 0.005);
+      RUN_TEST(maxUnormError < 1.0);
+      RUN_TEST(batchMatchesScalar);
+    }
+
+    printf("\nTest 2 (qtangents)\n");
+    {
+      // 180 degree rotations have w = 0, the handedness still has to survive
+      tangents.x[0] = 1; tangents.y[0] = 0; tangents.z[0] = 0;
+      normals.x[0] = 0; normals.y[0] = 0; normals.z[0] = -1;
+      bitangents.x[0] = 0; bitangents.y[0] = 1; bitangents.z[0] = 0;
+      // tangent parallel to the normal and a missing tangent
+      tangents.x[1] = -2; tangents.y[1] = 0; tangents.z[1] = 0;
+      tangents.x[2] = 0; tangents.y[2] = 0; tangents.z[2] = 0;
+
+      std::vector<short> encoded(numVertices * 4);
+      encodeQTangents(tangents, bitangents, normals, &encoded[0], numVertices);
+
+      double maxFloatError = 0.0;
+      double maxSnormError = 0.0;
+      bool batchMatchesScalar = true;
+      bool handednessKept = true;
+      bool degenerateValid = true;
+      for (uint32 i = 0; i < numVertices; ++i)
+      {
+        const Vector3 n(normals.x[i], normals.y[i], normals.z[i]);
+        const Vector3 t(tangents.x[i], tangents.y[i], tangents.z[i]);
+        const Vector3 b(bitangents.x[i], bitangents.y[i], bitangents.z[i]);
+
+        Quaternion q;
+        makeQTangent(q, t, b, n);
+
+        short scalar[4];
+        encodeQTangentSnorm16(q, scalar);
+        batchMatchesScalar &= memcmp(scalar, &encoded[i * 4], sizeof(scalar)) == 0;
+
+        Vector3 floatT, floatB, floatN;
+        decodeQTangent(q, floatT, floatB, floatN);
+
+        Vector3 snormT, snormB, snormN;
+        decodeQTangent(decodeQTangentSnorm16(&encoded[i * 4]), snormT, snormB, snormN);
+
+        maxFloatError = std::max(maxFloatError, AngleBetween(n, floatN));
+        maxSnormError = std::max(maxSnormError, AngleBetween(n, snormN));
+
+        const bool degenerate = i == 1 || i == 2;
+        if (!degenerate)
+        {
+          // mirrored frames decode to a bitangent pointing the same way as the original
+          handednessKept &= dot(snormB, b) > 0.0f;
+
+          // against the tangent orthonormalized around the normal
+          const Vector3 reference = t - n * dot(n, t);
+          maxFloatError = std::max(maxFloatError, AngleBetween(reference, floatT));
+          maxSnormError = std::max(maxSnormError, AngleBetween(reference, snormT));
+          maxSnormError = std::max(maxSnormError, AngleBetween(floatB, snormB));
+        }
+        else
+        {
+          degenerateValid &= fabsf(dot(snormT, n)) < 1e-3f && fabsf(length(snormT) - 1.0f) < 1e-3f;
+        }
+      }
+
+      // the bias on w alone rotates by up to 2 / 32767 radians
+      printf("max error float %g, snorm16x4 %g degrees\n", maxFloatError, maxSnormError);
+      RUN_TEST(maxFloatError < 0.005);
+      RUN_TEST(maxSnormError < 0.01);
+      RUN_TEST(batchMatchesScalar);
+      RUN_TEST(handednessKept);
+      RUN_TEST(degenerateValid);
+    }
+
+    printf("\nTest 3 (quantized positions)\n");
+    {
+      const AABB bounds(Vector3(-1000.0f, 2.0f, -0.5f), Vector3(250.0f, 3.0f, 0.5f));
+      const Vector3 size = bounds.maximum - bounds.minimum;
+
+      // normals and positions share the storage, the data isn't needed anymore
+      const Vector3SoA& positions = normals;
+      for (uint32 i = 0; i < numVertices; ++i)
+      {
+        positions.x[i] = RandomFloat(seed, bounds.minimum.x, bounds.maximum.x);
+        positions.y[i] = RandomFloat(seed, bounds.minimum.y, bounds.maximum.y);
+        positions.z[i] = RandomFloat(seed, bounds.minimum.z, bounds.maximum.z);
+      }
+      positions.x[0] = bounds.minimum.x; positions.y[0] = bounds.minimum.y; positions.z[0] = bounds.minimum.z;
+      positions.x[1] = bounds.maximum.x; positions.y[1] = bounds.maximum.y; positions.z[1] = bounds.maximum.z;
+
+      std::vector<uint16> quantized(numVertices * 4);
+      quantizePositions(bounds, positions, &quantized[0], numVertices);
+
+      double maxError[3] = { 0.0, 0.0, 0.0 };
+      bool batchMatchesScalar = true;
+      for (uint32 i = 0; i < numVertices; ++i)
+      {
+        const Vector3 p(positions.x[i], positions.y[i], positions.z[i]);
+
+        uint16 scalar[4];
+        quantizePosition(bounds, p, scalar);
+        batchMatchesScalar &= memcmp(scalar, &quantized[i * 4], sizeof(scalar)) == 0;
+
+        const Vector3 decoded = dequantizePosition(bounds, &quantized[i * 4]);
+        maxError[0] = std::max(maxError[0], fabs((double)decoded.x - p.x) / size.x);
+        maxError[1] = std::max(maxError[1], fabs((double)decoded.y - p.y) / size.y);
+        maxError[2] = std::max(maxError[2], fabs((double)decoded.z - p.z) / size.z);
+      }
+
+      // half a step plus some float rounding
+      const double bound = 0.5 / 65535.0 * 1.01;
+      printf("max error relative to the size %g %g %g, bound %g\n", maxError[0], maxError[1], maxError[2], bound);
+      RUN_TEST(maxError[0] < bound && maxError[1] < bound && maxError[2] < bound);
+      RUN_TEST(batchMatchesScalar);
+
+      const uint16 corners[] = { 0, 0, 0, 0, 65535, 65535, 65535, 0 };
+      RUN_TEST(memcmp(&quantized[0], corners, sizeof(corners)) == 0);
+    }
+  }
+
+#undef RUN_TEST
+
+}
+
+#endif // __MathTest_h_
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define __MathUtil_h_
 
 #undef max
+#undef min
 
 static const float PI = 3.14159265f;
 static const float HALF_PI = PI * 0.5f;
@@ -20,12 +21,28 @@ void makeRotateZ(Matrix4& mat, float angle);
 
 void setTransform(Matrix4& mat, float x, float y, float z);
 
+// result may be the same matrix as the input
+void transpose(Matrix4& result, const Matrix4& mat);
+// general inverse (cramer's rule), returns false and leaves result untouched if mat is singular
+// or so close to it (relative to its magnitude) that the inverse would be garbage
+bool inverse(Matrix4& result, const Matrix4& mat);
+// the last row has to be (0, 0, 0, 1), scale and shear are allowed. singular matrices result in the identity
+void inverseAffine(Matrix4& result, const Matrix4& mat);
+// rotation and translation only, the inverse is the transposed rotation
+void inverseOrthonormal(Matrix4& result, const Matrix4& mat);
+
 template<typename T>
 inline T max(const T& a, const T& b)
 {
   return (a > b) ? a : b;
 }
 
+template<typename T>
+inline T min(const T& a, const T& b)
+{
+  return (a < b) ? a : b;
+}
+
 template<typename T>
 inline T clamp(const T& value, const T& min, const T& max)
 {
@@ -51,71 +68,4 @@ inline T clampAngle180(const T& value)
   return value;
 }
 
-
-inline unsigned short convertFloatToHalf(float p_Value)
-{
-  unsigned int Result;
-
-  unsigned int IValue = ((unsigned int *)(&p_Value))[0];
-  unsigned int Sign = (IValue & 0x80000000U) >> 16U;
-  IValue = IValue & 0x7FFFFFFFU;
-
-  if (IValue > 0x47FFEFFFU)
-  {
-    Result = 0x7FFFU;
-  }
-  else
-  {
-    if (IValue < 0x38800000U)
-    {
-      unsigned int Shift = 113U - (IValue >> 23U);
-      IValue = (0x800000U | (IValue & 0x7FFFFFU)) >> Shift;
-    }
-    else
-    {
-      IValue += 0xC8000000U;
-    }
-
-    Result = ((IValue + 0x0FFFU + ((IValue >> 13U) & 1U)) >> 13U)&0x7FFFU; 
-  }
-  return (unsigned short)(Result|Sign);
-}
-
-inline float CryConvertHalfToFloat(unsigned short Value)
-{
-  unsigned int Mantissa;
-  unsigned int Exponent;
-  unsigned int Result;
-
-  Mantissa = (unsigned int)(Value & 0x03FF);
-
-  if ((Value & 0x7C00) != 0)  // The value is normalized
-  {
-    Exponent = (unsigned int)((Value >> 10) & 0x1F);
-  }
-  else if (Mantissa != 0)     // The value is denormalized
-  {
-    // Normalize the value in the resulting float
-    Exponent = 1;
-
-    do
-    {
-      Exponent--;
-      Mantissa <<= 1;
-    } while ((Mantissa & 0x0400) == 0);
-
-    Mantissa &= 0x03FF;
-  }
-  else                        // The value is zero
-  {
-    Exponent = (unsigned int)-112;
-  }
-
-  Result = ((Value & 0x8000) << 16) | // Sign
-    ((Exponent + 112) << 23) | // Exponent
-    (Mantissa << 13);          // Mantissa
-
-  return *(float*)&Result;
-}
-
 #endif // __MathUtil_h_
\ No newline at end of file
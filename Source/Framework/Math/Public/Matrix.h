@@ -1,12 +1,15 @@
 #ifndef __Matrix_h_
 #define __Matrix_h_
 
-class Vector3;
+#include "Vector.h"
 
-class Matrix4
+// row major, vectors are multiplied from the right (column vectors)
+ALIGN16 class Matrix4
 {
 public:
-  Matrix4();
+  DECLARE_ALIGNED_ALLOCATOR
+
+  Matrix4() {}
   Matrix4(float m00, float m01, float m02, float m03,
     float m10, float m11, float m12, float m13,
     float m20, float m21, float m22, float m23,
@@ -18,6 +21,11 @@ public:
   operator float*() { return m; }
   const float* getPtr() const { return m; }
 
+#if defined (SUPPORT_SIMD_MATH)
+  __m128 loadRow(int row) const { return _mm_loadu_ps(m + row * 4); }
+  void storeRow(int row, __m128 value) { _mm_storeu_ps(m + row * 4, value); }
+#endif // SUPPORT_SIMD_MATH
+
   static Matrix4 Zero;
   static Matrix4 Identity;
 
@@ -29,7 +37,144 @@ private:
   };
 };
 
-Matrix4 operator*(const Matrix4 a, const Matrix4& b);
-Vector3 operator*(const Matrix4 m, const Vector3& v);
+inline Matrix4::Matrix4(float m00, float m01, float m02, float m03,
+  float m10, float m11, float m12, float m13,
+  float m20, float m21, float m22, float m23,
+  float m30, float m31, float m32, float m33)
+{
+  m[0] = m00; m[1] = m01; m[2] = m02; m[3] = m03;
+  m[4] = m10; m[5] = m11; m[6] = m12; m[7] = m13;
+  m[8] = m20; m[9] = m21; m[10] = m22; m[11] = m23;
+  m[12] = m30; m[13] = m31; m[14] = m32; m[15] = m33;
+}
+
+inline Matrix4::Matrix4(const float* ptr)
+{
+  for (int i = 0; i < 16; ++i)
+    m[i] = ptr[i];
+}
+
+#if defined (SUPPORT_AVX_MATH)
+
+inline Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 mat;
+
+  // two result rows per register, each row of b is duplicated into both halves
+  const __m256 b0 = _mm256_broadcast_ps((const __m128*)(b.getPtr() + 0));
+  const __m256 b1 = _mm256_broadcast_ps((const __m128*)(b.getPtr() + 4));
+  const __m256 b2 = _mm256_broadcast_ps((const __m128*)(b.getPtr() + 8));
+  const __m256 b3 = _mm256_broadcast_ps((const __m128*)(b.getPtr() + 12));
+
+  for (int i = 0; i < 16; i += 8)
+  {
+    const __m256 rows = _mm256_loadu_ps(a.getPtr() + i);
+
+    __m256 result = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x00), b0);
+    result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0x55), b1));
+    result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xaa), b2));
+    result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, 0xff), b3));
+
+    _mm256_storeu_ps((float*)mat + i, result);
+  }
+
+  return mat;
+}
+
+#elif defined (SUPPORT_SIMD_MATH)
+
+inline Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 mat;
+
+  const __m128 b0 = b.loadRow(0);
+  const __m128 b1 = b.loadRow(1);
+  const __m128 b2 = b.loadRow(2);
+  const __m128 b3 = b.loadRow(3);
+
+  // each result row is a linear combination of the rows of b
+  for (int i = 0; i < 4; ++i)
+  {
+    const __m128 row = a.loadRow(i);
+
+    __m128 result = _mm_mul_ps(SIMD_SPLAT(row, 0), b0);
+    result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(row, 1), b1));
+    result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(row, 2), b2));
+    result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(row, 3), b3));
+
+    mat.storeRow(i, result);
+  }
+
+  return mat;
+}
+
+#else
+
+inline Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+{
+  Matrix4 mat;
+
+  for (int i = 0; i < 16; i += 4)
+  {
+    mat[i + 0] = a[i] * b[0] + a[i + 1] * b[4] + a[i + 2] * b[8] + a[i + 3] * b[12];
+    mat[i + 1] = a[i] * b[1] + a[i + 1] * b[5] + a[i + 2] * b[9] + a[i + 3] * b[13];
+    mat[i + 2] = a[i] * b[2] + a[i + 1] * b[6] + a[i + 2] * b[10] + a[i + 3] * b[14];
+    mat[i + 3] = a[i] * b[3] + a[i + 1] * b[7] + a[i + 2] * b[11] + a[i + 3] * b[15];
+  }
+
+  return mat;
+}
+
+#endif // SUPPORT_AVX_MATH
+
+#if defined (SUPPORT_SIMD_MATH)
+
+inline __m128 simdTransform(const Matrix4& m, __m128 v)
+{
+  const __m128 r0 = _mm_mul_ps(m.loadRow(0), v);
+  const __m128 r1 = _mm_mul_ps(m.loadRow(1), v);
+  const __m128 r2 = _mm_mul_ps(m.loadRow(2), v);
+  const __m128 r3 = _mm_mul_ps(m.loadRow(3), v);
+
+  // four horizontal sums at once, cheaper than a full transpose
+  const __m128 sum01 = _mm_add_ps(_mm_unpacklo_ps(r0, r1), _mm_unpackhi_ps(r0, r1));
+  const __m128 sum23 = _mm_add_ps(_mm_unpacklo_ps(r2, r3), _mm_unpackhi_ps(r2, r3));
+  return _mm_add_ps(_mm_movelh_ps(sum01, sum23), _mm_movehl_ps(sum23, sum01));
+}
+
+inline Vector4 operator*(const Matrix4& m, const Vector4& v)
+{
+  return Vector4(simdTransform(m, v.load()));
+}
+
+// transforms the point (w = 1), there is no perspective divide
+inline Vector3 operator*(const Matrix4& m, const Vector3& v)
+{
+  Vector4 result(simdTransform(m, _mm_set_ps(1.0f, v.z, v.y, v.x)));
+  return Vector3(result.x, result.y, result.z);
+}
+
+#else
+
+inline Vector4 operator*(const Matrix4& m, const Vector4& v)
+{
+  return Vector4(
+    m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3] * v.w,
+    m[4] * v.x + m[5] * v.y + m[6] * v.z + m[7] * v.w,
+    m[8] * v.x + m[9] * v.y + m[10] * v.z + m[11] * v.w,
+    m[12] * v.x + m[13] * v.y + m[14] * v.z + m[15] * v.w);
+}
+
+// transforms the point (w = 1), there is no perspective divide
+inline Vector3 operator*(const Matrix4& m, const Vector3& v)
+{
+  Vector3 vec;
+  vec.x = m[0] * v.x + m[1] * v.y + m[2] * v.z + m[3];
+  vec.y = m[4] * v.x + m[5] * v.y + m[6] * v.z + m[7];
+  vec.z = m[8] * v.x + m[9] * v.y + m[10] * v.z + m[11];
+  return vec;
+}
+
+#endif // SUPPORT_SIMD_MATH
 
 #endif // __Matrix_h_
\ No newline at end of file
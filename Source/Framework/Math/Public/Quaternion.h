@@ -0,0 +1,121 @@
+#ifndef __Quaternion_h_
+#define __Quaternion_h_
+
+#include "Matrix.h"
+
+// unit quaternions represent rotations, a * b rotates by b first (like Matrix4)
+ALIGN16 class Quaternion
+{
+public:
+  DECLARE_ALIGNED_ALLOCATOR
+
+  Quaternion() {}
+  Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+#if defined (SUPPORT_SIMD_MATH)
+  explicit Quaternion(__m128 v) { _mm_storeu_ps(&x, v); }
+  __m128 load() const { return _mm_loadu_ps(&x); }
+#endif // SUPPORT_SIMD_MATH
+
+  static Quaternion Identity;
+
+  float x, y, z, w;
+};
+
+#if defined (SUPPORT_SIMD_MATH)
+
+inline Quaternion operator*(const Quaternion& a, const Quaternion& b)
+{
+  const __m128 qa = a.load();
+  const __m128 qb = b.load();
+
+  const __m128 signsX = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, (int)0x80000000, 0));
+  const __m128 signsY = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, (int)0x80000000, 0, 0));
+  const __m128 signsZ = _mm_castsi128_ps(_mm_set_epi32((int)0x80000000, 0, 0, (int)0x80000000));
+
+  __m128 result = _mm_mul_ps(SIMD_SPLAT(qa, 3), qb);
+
+  // ax * ( bw, -bz,  by, -bx)
+  __m128 term = _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3));
+  result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(qa, 0), _mm_xor_ps(term, signsX)));
+
+  // ay * ( bz,  bw, -bx, -by)
+  term = _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2));
+  result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(qa, 1), _mm_xor_ps(term, signsY)));
+
+  // az * (-by,  bx,  bw, -bz)
+  term = _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1));
+  result = _mm_add_ps(result, _mm_mul_ps(SIMD_SPLAT(qa, 2), _mm_xor_ps(term, signsZ)));
+
+  return Quaternion(result);
+}
+
+inline float dot(const Quaternion& a, const Quaternion& b)
+{
+  return _mm_cvtss_f32(simdDot4(a.load(), b.load()));
+}
+
+inline Quaternion normalize(const Quaternion& q)
+{
+  const __m128 value = q.load();
+  const __m128 len = simdDot4(value, value);
+  if (_mm_cvtss_f32(len) > 0)
+    return Quaternion(_mm_div_ps(value, _mm_sqrt_ps(len)));
+
+  return Quaternion::Identity;
+}
+
+#else
+
+inline Quaternion operator*(const Quaternion& a, const Quaternion& b)
+{
+  return Quaternion(
+    a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+    a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+    a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+    a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+}
+
+inline float dot(const Quaternion& a, const Quaternion& b)
+{
+  return (a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w);
+}
+
+inline Quaternion normalize(const Quaternion& q)
+{
+  float len = dot(q, q);
+  if (len > 0)
+  {
+    len = 1.0f / sqrtf(len);
+    return Quaternion(q.x * len, q.y * len, q.z * len, q.w * len);
+  }
+
+  return Quaternion::Identity;
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+// the inverse for unit quaternions
+inline Quaternion conjugate(const Quaternion& q)
+{
+  return Quaternion(-q.x, -q.y, -q.z, q.w);
+}
+
+inline Vector3 rotate(const Quaternion& q, const Vector3& v)
+{
+  // v + 2w (u x v) + 2 u x (u x v)
+  const Vector3 u(q.x, q.y, q.z);
+  const Vector3 t = cross(u, v) * 2.0f;
+  return v + t * q.w + cross(u, t);
+}
+
+// angle in radians, the axis has to be normalized
+void makeQuaternion(Quaternion& q, const Vector3& axis, float angle);
+void makeMatrix(Matrix4& mat, const Quaternion& q);
+
+// normalized linear interpolation, cheap but not constant speed
+Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t);
+// constant angular speed, falls back to nlerp for nearly equal rotations
+Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
+
+#endif // __Quaternion_h_
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef __Simd_h_
+#define __Simd_h_
+
+#include <malloc.h>
+
+#if defined (SUPPORT_SIMD_MATH)
+# include <xmmintrin.h>
+# include <emmintrin.h>
+# if defined (__AVX__) && !defined (SUPPORT_AVX_MATH)
+#  define SUPPORT_AVX_MATH
+# endif
+# if defined (SUPPORT_AVX_MATH)
+#  include <immintrin.h>
+# endif
+// every avx2 cpu has the half conversion instructions
+# if defined (SUPPORT_AVX_MATH) && (defined (__AVX2__) || defined (__F16C__)) && !defined (SUPPORT_F16C_MATH)
+#  define SUPPORT_F16C_MATH
+# endif
+#endif // SUPPORT_SIMD_MATH
+
+#define ALIGN16 __declspec(align(16))
+
+// heap blocks are only 8 byte aligned on win32. aligned types bring their own
+// operator new, but instances embedded in other heap objects may still be
+// misaligned, that's why the kernels only use unaligned loads and stores.
+#define DECLARE_ALIGNED_ALLOCATOR \
+  static void* operator new(size_t size) { return _aligned_malloc(size, 16); } \
+  static void* operator new[](size_t size) { return _aligned_malloc(size, 16); } \
+  static void operator delete(void* ptr) { _aligned_free(ptr); } \
+  static void operator delete[](void* ptr) { _aligned_free(ptr); }
+
+#if defined (SUPPORT_SIMD_MATH)
+
+#define SIMD_SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE((i), (i), (i), (i)))
+
+// horizontal sum, result in all lanes
+inline __m128 simdHorizontalAdd(__m128 v)
+{
+  __m128 sum = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+inline __m128 simdDot4(__m128 a, __m128 b)
+{
+  return simdHorizontalAdd(_mm_mul_ps(a, b));
+}
+
+// expects w = 0 in both inputs, the result w is 0 as well
+inline __m128 simdCross3(__m128 a, __m128 b)
+{
+  __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+  return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// simd version of determinantBound, rows with w = 0, result in the lowest lane
+inline __m128 simdDeterminantBound3(__m128 r0, __m128 r1, __m128 r2)
+{
+  const __m128 rows = _mm_mul_ss(_mm_mul_ss(simdDot4(r0, r0), simdDot4(r1, r1)), simdDot4(r2, r2));
+  const __m128 columns = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, r0), _mm_mul_ps(r1, r1)), _mm_mul_ps(r2, r2));
+  const __m128 columnProduct = _mm_mul_ss(_mm_mul_ss(columns, SIMD_SPLAT(columns, 1)), SIMD_SPLAT(columns, 2));
+  return _mm_sqrt_ss(_mm_min_ss(rows, columnProduct));
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+#endif // __Simd_h_
\ No newline at end of file
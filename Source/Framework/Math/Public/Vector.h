@@ -1,14 +1,16 @@
 #ifndef __Vector_h_
 #define __Vector_h_
 
+#include "Simd.h"
+
 class Vector3
 {
 public:
-  Vector3();
-  Vector3(float x, float y, float z);
+  Vector3() {}
+  Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
 
-  float& operator[](int index);
-  float operator[](int index) const;
+  float& operator[](int index) { ASSERT(index < 3, "out of range"); return (&x)[index]; }
+  float operator[](int index) const { ASSERT(index < 3, "out of range"); return (&x)[index]; }
 
   float x, y, z;
 };
@@ -16,29 +18,243 @@ public:
 class Vector2
 {
 public:
-  Vector2();
-  Vector2(float x, float y);
+  Vector2() {}
+  Vector2(float x, float y) : x(x), y(y) {}
 
-  float& operator[](int index);
-  float operator[](int index) const;
+  float& operator[](int index) { ASSERT(index < 2, "out of range"); return (&x)[index]; }
+  float operator[](int index) const { ASSERT(index < 2, "out of range"); return (&x)[index]; }
 
   float x, y;
 };
 
-Vector3 operator-(const Vector3& v);
-Vector3 operator+(const Vector3& a, const Vector3& b);
-Vector3 operator-(const Vector3& a, const Vector3& b);
-Vector3 operator*(const Vector3& v, float s);
-Vector3 operator/(const Vector3& v, float s);
+ALIGN16 class Vector4
+{
+public:
+  DECLARE_ALIGNED_ALLOCATOR
+
+  Vector4() {}
+  Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+  Vector4(const Vector3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+#if defined (SUPPORT_SIMD_MATH)
+  explicit Vector4(__m128 v) { _mm_storeu_ps(&x, v); }
+  __m128 load() const { return _mm_loadu_ps(&x); }
+#endif // SUPPORT_SIMD_MATH
+
+  float& operator[](int index) { ASSERT(index < 4, "out of range"); return (&x)[index]; }
+  float operator[](int index) const { ASSERT(index < 4, "out of range"); return (&x)[index]; }
+
+  Vector3 getXYZ() const { return Vector3(x, y, z); }
+
+  float x, y, z, w;
+};
+
+inline Vector3 operator-(const Vector3& v)
+{
+  return Vector3(-v.x, -v.y, -v.z);
+}
+
+inline Vector3 operator+(const Vector3& a, const Vector3& b)
+{
+  return Vector3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+inline Vector3 operator-(const Vector3& a, const Vector3& b)
+{
+  return Vector3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+inline Vector3 operator*(const Vector3& v, float s)
+{
+  return Vector3(v.x * s, v.y * s, v.z * s);
+}
+
+inline Vector3 operator/(const Vector3& v, float s)
+{
+  s = 1 / s;
+  return Vector3(v.x * s, v.y * s, v.z * s);
+}
+
+inline Vector3 abs(const Vector3& v)
+{
+  return Vector3(fabsf(v.x), fabsf(v.y), fabsf(v.z));
+}
+
+inline float dot(const Vector3& a, const Vector3& b)
+{
+  return (a.x*b.x + a.y*b.y + a.z*b.z);
+}
+
+inline Vector3 cross(const Vector3& a, const Vector3& b)
+{
+  return Vector3(
+      a.y * b.z - a.z * b.y,
+      a.z * b.x - a.x * b.z,
+      a.x * b.y - a.y * b.x
+    );
+}
+
+inline Vector3 normalize(const Vector3& v)
+{
+  float len = dot(v, v);
+  if (len > 0)
+  {
+    return v / sqrtf(len);
+  }
+
+  return Vector3(0, 0, 0);
+}
+
+inline float length(const Vector3& v)
+{
+  float len = dot(v, v);
+  if (len > 0)
+    return sqrtf(len);
+
+  return 0.0f;
+}
+
+inline float squaredLength(const Vector3& v)
+{
+  return dot(v, v);
+}
+
+// bounds |det| of the 3x3 matrix with these rows, the smaller of the row and column
+// length products (hadamard). singularity tests relative to it don't depend on the scale
+inline float determinantBound(const Vector3& r0, const Vector3& r1, const Vector3& r2)
+{
+  const float rows = dot(r0, r0) * dot(r1, r1) * dot(r2, r2);
+  const float columns = (r0.x * r0.x + r1.x * r1.x + r2.x * r2.x) *
+    (r0.y * r0.y + r1.y * r1.y + r2.y * r2.y) * (r0.z * r0.z + r1.z * r1.z + r2.z * r2.z);
+  return sqrtf(rows < columns ? rows : columns);
+}
+
+#if defined (SUPPORT_SIMD_MATH)
+
+inline Vector4 operator-(const Vector4& v)
+{
+  return Vector4(_mm_sub_ps(_mm_setzero_ps(), v.load()));
+}
+
+inline Vector4 operator+(const Vector4& a, const Vector4& b)
+{
+  return Vector4(_mm_add_ps(a.load(), b.load()));
+}
 
-Vector3 abs(const Vector3& v);
-float dot(const Vector3& a, const Vector3& b);
-Vector3 cross(const Vector3& a, const Vector3& b);
-Vector3 normalize(const Vector3& v);
-float length(const Vector3& v);
-float squaredLength(const Vector3& v);
+inline Vector4 operator-(const Vector4& a, const Vector4& b)
+{
+  return Vector4(_mm_sub_ps(a.load(), b.load()));
+}
+
+inline Vector4 operator*(const Vector4& a, const Vector4& b)
+{
+  return Vector4(_mm_mul_ps(a.load(), b.load()));
+}
+
+inline Vector4 operator*(const Vector4& v, float s)
+{
+  return Vector4(_mm_mul_ps(v.load(), _mm_set1_ps(s)));
+}
+
+inline Vector4 operator/(const Vector4& v, float s)
+{
+  return Vector4(_mm_mul_ps(v.load(), _mm_set1_ps(1 / s)));
+}
+
+inline float dot(const Vector4& a, const Vector4& b)
+{
+  return _mm_cvtss_f32(simdDot4(a.load(), b.load()));
+}
+
+// cross product of the xyz parts, w of the result is 0
+inline Vector4 cross(const Vector4& a, const Vector4& b)
+{
+  const __m128 maskXYZ = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  return Vector4(simdCross3(_mm_and_ps(a.load(), maskXYZ), _mm_and_ps(b.load(), maskXYZ)));
+}
+
+inline Vector4 normalize(const Vector4& v)
+{
+  __m128 value = v.load();
+  __m128 len = simdDot4(value, value);
+  if (_mm_cvtss_f32(len) > 0)
+    return Vector4(_mm_div_ps(value, _mm_sqrt_ps(len)));
+
+  return Vector4(_mm_setzero_ps());
+}
+
+#else
+
+inline Vector4 operator-(const Vector4& v)
+{
+  return Vector4(-v.x, -v.y, -v.z, -v.w);
+}
+
+inline Vector4 operator+(const Vector4& a, const Vector4& b)
+{
+  return Vector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+}
+
+inline Vector4 operator-(const Vector4& a, const Vector4& b)
+{
+  return Vector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
+}
+
+inline Vector4 operator*(const Vector4& a, const Vector4& b)
+{
+  return Vector4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
+}
+
+inline Vector4 operator*(const Vector4& v, float s)
+{
+  return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
+}
+
+inline Vector4 operator/(const Vector4& v, float s)
+{
+  s = 1 / s;
+  return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
+}
+
+inline float dot(const Vector4& a, const Vector4& b)
+{
+  return (a.x*b.x + a.y*b.y + a.z*b.z + a.w*b.w);
+}
+
+// cross product of the xyz parts, w of the result is 0
+inline Vector4 cross(const Vector4& a, const Vector4& b)
+{
+  return Vector4(
+      a.y * b.z - a.z * b.y,
+      a.z * b.x - a.x * b.z,
+      a.x * b.y - a.y * b.x,
+      0.0f
+    );
+}
+
+inline Vector4 normalize(const Vector4& v)
+{
+  float len = dot(v, v);
+  if (len > 0)
+    return v / sqrtf(len);
+
+  return Vector4(0, 0, 0, 0);
+}
+
+#endif // SUPPORT_SIMD_MATH
+
+inline float length(const Vector4& v)
+{
+  return sqrtf(dot(v, v));
+}
+
+inline float squaredLength(const Vector4& v)
+{
+  return dot(v, v);
+}
 
 bool equals(const Vector3& a, const Vector3& b);
 bool equals(const Vector2& a, const Vector2& b);
+bool equals(const Vector4& a, const Vector4& b);
 
 #endif // __Vector_h_
\ No newline at end of file
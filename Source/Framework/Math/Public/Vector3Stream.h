@@ -0,0 +1,61 @@
+#ifndef __Vector3Stream_h_
+#define __Vector3Stream_h_
+
+#include "BatchMath.h"
+
+// structure of arrays storage for Vector3 data. x, y and z live in separate 32 byte
+// aligned arrays, padded with zeros to a multiple of the simd width, so kernels may
+// process the padded size without a scalar tail.
+class Vector3Stream
+{
+public:
+  static const uint32 Padding = 8;
+
+  Vector3Stream();
+  explicit Vector3Stream(uint32 size);
+  Vector3Stream(const Vector3Stream& other);
+  ~Vector3Stream();
+
+  Vector3Stream& operator=(const Vector3Stream& other);
+
+  // new elements are zero
+  void resize(uint32 size);
+  void reserve(uint32 capacity);
+  void clear() { resize(0); }
+
+  void add(const Vector3& v);
+
+  uint32 getSize() const { return m_size; }
+  uint32 getPaddedSize() const { return (m_size + Padding - 1) & ~(Padding - 1); }
+  bool isEmpty() const { return m_size == 0; }
+
+  Vector3 get(uint32 index) const { return Vector3(m_x[index], m_y[index], m_z[index]); }
+  void set(uint32 index, const Vector3& v) { m_x[index] = v.x; m_y[index] = v.y; m_z[index] = v.z; }
+
+  float* getX() { return m_x; }
+  float* getY() { return m_y; }
+  float* getZ() { return m_z; }
+  const float* getX() const { return m_x; }
+  const float* getY() const { return m_y; }
+  const float* getZ() const { return m_z; }
+
+  // view for the batch kernels. the view has no const version, so a view of a
+  // const stream may only be used as kernel input
+  Vector3SoA getSoA() const { return Vector3SoA(m_x, m_y, m_z); }
+
+  // interleaved layout, stride in bytes between two elements (12 for packed Vector3).
+  // interleave writes the first getSize() elements, deinterleave replaces the content
+  void interleave(void* dest, uint32 stride) const;
+  void deinterleave(const void* src, uint32 stride, uint32 count);
+
+private:
+  void reallocate(uint32 capacity);
+
+  float* m_x;
+  float* m_y;
+  float* m_z;
+  uint32 m_size;
+  uint32 m_capacity;
+};
+
+#endif // __Vector3Stream_h_
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef __VertexEncoding_h_
+#define __VertexEncoding_h_
+
+#include "Bounds.h"
+#include "BatchMath.h"
+
+// compact vertex attribute encodings. the batch versions use sse and produce the same
+// results as the scalar ones, the arrays don't need to be aligned.
+
+// octahedral normals: the unit sphere is projected onto an octahedron and unfolded into
+// [-1, 1]^2. the input has to be normalized, the decoded normal is normalized.
+// snorm16x2 keeps the error below 0.005 degrees, unorm8x2 below 1 degree
+void encodeOctahedralSnorm16(const Vector3& normal, short* out);
+Vector3 decodeOctahedralSnorm16(const short* in);
+void encodeOctahedralUnorm8(const Vector3& normal, uint8* out);
+Vector3 decodeOctahedralUnorm8(const uint8* in);
+
+// 2 components per normal
+void encodeOctahedralSnorm16(const Vector3SoA& normals, short* out, uint32 count);
+void encodeOctahedralUnorm8(const Vector3SoA& normals, uint8* out, uint32 count);
+
+// qtangent: the tangent frame as a single quaternion, the sign of w holds the handedness
+// of the bitangent. the frame is orthonormalized around the normal first, |w| is kept
+// above one snorm16 step so the sign survives the quantization
+void makeQTangent(Quaternion& q, const Vector3& tangent, const Vector3& bitangent, const Vector3& normal);
+void decodeQTangent(const Quaternion& q, Vector3& tangent, Vector3& bitangent, Vector3& normal);
+void encodeQTangentSnorm16(const Quaternion& q, short* out);
+Quaternion decodeQTangentSnorm16(const short* in);
+
+// makeQTangent followed by encodeQTangentSnorm16, 4 components per frame
+void encodeQTangents(const Vector3SoA& tangents, const Vector3SoA& bitangents, const Vector3SoA& normals, short* out, uint32 count);
+
+// positions relative to the bounds as unorm16, 4 components per position with w = 0.
+// the error per axis is at most half a step, (maximum - minimum) / 131070
+void quantizePosition(const AABB& bounds, const Vector3& position, uint16* out);
+Vector3 dequantizePosition(const AABB& bounds, const uint16* in);
+void quantizePositions(const AABB& bounds, const Vector3SoA& positions, uint16* out, uint32 count);
+
+#endif // __VertexEncoding_h_
\ No newline at end of file
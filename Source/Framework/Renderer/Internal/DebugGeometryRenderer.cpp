@@ -6,6 +6,7 @@
 #include "VertexDeclaration.h"
 #include "ShaderDrawBundle.h"
 #include "RenderStates.h"
+#include "TaskScheduler.h"
 
 DebugGeometryRenderer::DebugGeometryRenderer()
   : m_vertexBuffer(0)
@@ -18,6 +19,20 @@ DebugGeometryRenderer::~DebugGeometryRenderer()
   shutdown();
 }
 
+bool DebugGeometryRenderer::compileShaders()
+{
+  bool vsCompiled = false;
+  TaskCounter counter;
+  TaskScheduler::submit([this, &vsCompiled]() {
+    vsCompiled = ShaderCompiler::compile("Data\\Shaders\\debug.hlsl", "vs_main", "vs_5_0", m_vertexShaderCode);
+  }, &counter);
+
+  bool psCompiled = ShaderCompiler::compile("Data\\Shaders\\debug.hlsl", "ps_main", "ps_5_0", m_pixelShaderCode);
+
+  TaskScheduler::wait(counter);
+  return vsCompiled && psCompiled;
+}
+
 void DebugGeometryRenderer::init()
 {
   shutdown();
@@ -30,22 +45,15 @@ void DebugGeometryRenderer::init()
   desc.StructureByteStride = 0;
   desc.Usage = D3D11_USAGE_DYNAMIC;
 
-  WeakPtr<RenderSystem> renderSys = g_Game->getRenderSystem();
-  VALIDATE(renderSys->getDevicePtr()->CreateBuffer(&desc, NULL, &m_vertexBuffer));
+  VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, NULL, &m_vertexBuffer));
+
+  if (!m_vertexShaderCode.getPtr() || !m_pixelShaderCode.getPtr())
+    compileShaders();
 
-  DataBlob buffer;
-  if (ShaderCompiler::compile("Data\\Shaders\\debug.hlsl", "vs_main", "vs_5_0", buffer))
+  if (m_vertexShaderCode.getPtr())
   {
     m_vertexShader = new VertexShader();
-    m_vertexShader->init(buffer);
-
-    /*D3D11_INPUT_ELEMENT_DESC desc[] = 
-    {
-      { "Position", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-      { "Color", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 }
-    };
-
-    VALIDATE(renderSys->getDevicePtr()->CreateInputLayout(desc, 2, buffer.getPtr(), buffer.getSize(), &m_inputLayout));*/
+    m_vertexShader->init(m_vertexShaderCode);
   }
 
   m_vertexDeclaration = new VertexDeclaration();
@@ -57,10 +65,10 @@ void DebugGeometryRenderer::init()
   element = m_vertexDeclaration->add("Color", 0, VEF_COLOR, 0, offset, false);
   offset += VertexDeclaration::sizeOfElementType(element.format);
 
-  if (ShaderCompiler::compile("Data\\Shaders\\debug.hlsl", "ps_main", "ps_5_0", buffer))
+  if (m_pixelShaderCode.getPtr())
   {
     m_pixelShader = new PixelShader();
-    m_pixelShader->init(buffer);
+    m_pixelShader->init(m_pixelShaderCode);
   }
 }
 
@@ -8,6 +8,31 @@
 #include "ShaderDrawBundle.h"
 #include "Shader.h"
 #include "SystemTextures.h"
+#include "Frustum.h"
+#include "Meshlet.h"
+
+namespace
+{
+  // screen space error allowed for a level of detail
+  const float MaxLodPixelError = 1.0f;
+}
+
+MeshChunk::MeshChunk()
+  : streamMask(0)
+  , indexCount(0)
+  , numLods(0)
+  , indexFormat(DXGI_FORMAT_R16_UINT)
+  , indexSize(0)
+  , positionScale(1.0f, 1.0f, 1.0f)
+  , positionBias(0.0f, 0.0f, 0.0f)
+  , indices(0)
+  , numMeshlets(0)
+  , culledIndices(0)
+{
+  memset(strides, 0, sizeof(strides));
+  memset(streams, 0, sizeof(streams));
+  memset(lods, 0, sizeof(lods));
+}
 
 Mesh::Mesh()
 {
@@ -26,12 +51,15 @@ void Mesh::destroy()
     for (uint32 i = 0; i < MAX_VERTEX_STREAMS; ++i)
       SAFE_RELEASE((*it)->streams[i]);
     SAFE_RELEASE((*it)->indices);
+    SAFE_RELEASE((*it)->culledIndices);
     (*it)->streamMask =0;
 
     delete *it;
   }
 
   m_meshChunks.clear();
+  m_bounds = AABB();
+  m_boundingSphere = BoundingSphere();
 }
 
 void Mesh::render(const Matrix4& view, const Matrix4& proj)
@@ -46,13 +74,63 @@ void Mesh::render(const Matrix4& view, const Matrix4& proj)
   SharedPtr<ShaderDrawBundle> shaderDrawBundle = ShaderDrawBundle::createShaderDrawBundle(m_vertexShader, m_pixelShader, m_vertexDeclaration);
   g_Game->getRenderSystem()->setShaderDrawBundle(shaderDrawBundle.get());
 
+  // meshes are rendered without a world transform, so the chunk bounds are world space
+  const Frustum frustum(proj * view);
+
+  // pixels per world unit at a distance of 1, the lod error is measured in pixels
+  const float pixelsPerUnit = proj[5] * g_Game->getViewportHeight() * 0.5f;
+
+  // the meshlet cones are tested against the camera position
+  Matrix4 cameraToWorld;
+  inverseOrthonormal(cameraToWorld, view);
+  const Vector3 cameraPosition = cameraToWorld * Vector3(0.0f, 0.0f, 0.0f);
+
   for (std::vector<MeshChunk*>::iterator it = m_meshChunks.begin();
     it != m_meshChunks.end(); ++it)
   {
     MeshChunk* chunk = *it;
 
-    // material
-    Texture* texture = chunk->m_diffuseMap;
+    if (!frustum.isVisible(chunk->m_bounds))
+      continue;
+
+    // the nearest point of the bounding sphere decides, inside of it the finest level is drawn
+    const float distance = (view * chunk->m_boundingSphere.center).z - chunk->m_boundingSphere.radius;
+    const float maxError = distance > 0.0f ? MaxLodPixelError * distance / pixelsPerUnit : 0.0f;
+    const uint32 lodIndex = selectMeshLod(chunk->lods, chunk->numLods, maxError);
+    const MeshLod& lod = chunk->lods[lodIndex];
+
+    // the visible meshlets of the finest level are gathered into the dynamic index buffer
+    ID3D11Buffer* indexBuffer = chunk->indices;
+    uint32 firstIndex = lod.firstIndex;
+    uint32 numIndices = lod.numIndices;
+    if (lodIndex == 0 && chunk->culledIndices)
+    {
+      D3D11_MAPPED_SUBRESOURCE mapped;
+      if (SUCCEEDED(RENDER_CONTEXT->Map(chunk->culledIndices, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+      {
+        const MeshletArrays meshlets(&chunk->meshlets[0], chunk->numMeshlets);
+        numIndices = cullMeshlets(mapped.pData, &chunk->meshletIndices[0], chunk->indexSize, meshlets, frustum, cameraPosition);
+        RENDER_CONTEXT->Unmap(chunk->culledIndices, 0);
+
+        indexBuffer = chunk->culledIndices;
+        firstIndex = 0;
+      }
+    }
+
+    if (numIndices == 0)
+      continue;
+
+    // shaders reading quantized positions decode them as position * positionScale + positionBias
+    if (m_vertexShader->hasParameter("positionScale"))
+    {
+      m_vertexShader->beginUpdateParameters();
+      m_vertexShader->setParamByName("positionScale", chunk->positionScale.x, chunk->positionScale.y, chunk->positionScale.z);
+      m_vertexShader->setParamByName("positionBias", chunk->positionBias.x, chunk->positionBias.y, chunk->positionBias.z);
+      m_vertexShader->endUpdateParameters();
+    }
+
+    // material, textures still streaming in fall back to the default texture
+    Texture* texture = (Texture*)chunk->m_diffuseMap.get();
     if (!texture)
     {
       texture = SystemTextures::Default.get();
@@ -77,12 +155,12 @@ void Mesh::render(const Matrix4& view, const Matrix4& proj)
 
       buffers[stream] = chunk->streams[stream];
       offsets[stream] = 0;
-      strides[stream] = chunk->vertexSize;
+      strides[stream] = chunk->strides[stream];
     }
 
-    RENDER_CONTEXT->IASetIndexBuffer(chunk->indices, DXGI_FORMAT_R16_UINT, 0);
+    RENDER_CONTEXT->IASetIndexBuffer(indexBuffer, chunk->indexFormat, 0);
     RENDER_CONTEXT->IASetVertexBuffers(0, MAX_VERTEX_STREAMS, buffers, strides, offsets);
-    RENDER_CONTEXT->DrawIndexed(chunk->indexCount, 0, 0);
+    RENDER_CONTEXT->DrawIndexed(numIndices, firstIndex, 0);
   }
 }
 
@@ -102,325 +180,86 @@ void Mesh::initDummyMaterial()
   }
 }
 
-void Mesh::fixTangentData(IntermediateMeshData& data)
+MeshChunk* Mesh::createMeshChunk(const MeshChunkData& data, Mesh& mesh)
 {
-  if (data.uv0.size() == 0)
+  MeshChunk* newChunk = new MeshChunk();
+  newChunk->streamMask = mesh.m_vertexDeclaration->getStreamMask();
+  newChunk->indexCount = data.numIndices;
+  newChunk->numLods = max<uint32>(data.numLods, 1);
+  if (data.numLods)
   {
-    return;
+    memcpy(newChunk->lods, data.lods, data.numLods * sizeof(MeshLod));
   }
-
-  uint32 numTris = data.position.size() / 3;
-  for (uint32 i = 0; i < numTris; ++i)
+  else
   {
-    uint32 idx[3] = {0};
-
-    idx[0] = i*3+0;
-    idx[1] = i*3+1;
-    idx[2] = i*3+2;
-
-    const Vector3& edgeA = data.position[idx[1]] - 
-      data.position[idx[0]];
-
-    const Vector3& edgeB = data.position[idx[2]] - 
-      data.position[idx[0]];
-
-    const Vector2& uv0 = data.uv0[idx[0]];
-    const Vector2& uv1 = data.uv0[idx[1]];
-    const Vector2& uv2 = data.uv0[idx[2]];
-
-    float s1 = uv1.x - uv0.x;
-    float t1 = uv0.y - uv1.y;
-    float s2 = uv2.x - uv0.x;
-    float t2 = uv0.y - uv2.y;
-
-    float det = 1.0f / (s1 * t2 - s2 * t1);
-    if (fabs(det) <= EPSILON)
-    {
-      det = 1.0f;
-    }
-
-    Vector3 tangent = Vector3((t2*edgeA.x - t1*edgeB.x) * det,
-      (t2*edgeA.y - t1*edgeB.y) * det,
-      (t2*edgeA.z - t1*edgeB.z) * det);
-
-    Vector3 bitangent = Vector3((s1*edgeB.x - s2*edgeA.x) * det,
-      (s1*edgeB.y - s2*edgeA.y) * det,
-      (s1*edgeB.z - s2*edgeA.z) * det);
-
-    Vector3 normal = cross(tangent, bitangent);
-
-    normalize(tangent);
-    normalize(bitangent);
-    normalize(normal);
-      
-    Vector3 surfaceNormal = cross(edgeA, edgeB);
-    normalize(surfaceNormal);
-
-    bool needFixTB = dot(surfaceNormal, normal) < 0;
-
-    for (uint32 vertex = 0; vertex < 3; ++vertex)
-    {
-      Vector3 vertexTangent = Vector3(data.tangent[idx[vertex]]);
-      Vector3 vertexBitangent = data.bitangent[idx[vertex]];
-      float handeness = 1.0f;
-
-      if (fabs(squaredLength(vertexTangent)) < EPSILON)
-      {
-        vertexTangent = tangent;
-      }
-      else
-      {
-        if (needFixTB)
-        {
-          if (dot(vertexTangent, tangent) < 0)
-          {
-            vertexTangent = -vertexTangent;
-          }
-          else
-          {
-            handeness = -1.0f;
-          }
-        }
-      }
-
-      // FIXME: handeness
-
-      data.tangent[idx[vertex]] = vertexTangent; 
-    }
+    newChunk->lods[0].numIndices = data.numIndices;
   }
-}
-
-void Mesh::mergeDuplicateVertices(const IntermediateMeshData& source, IntermediateMeshData& data)
-{
-  std::multimap<uint32, int> indexRemapping;
-
-  bool hasNormals = source.normal.size() > 0;
-  bool hasUv0 = source.uv0.size() > 0;
-
-  uint32 duplicateVertices = 0;
-  uint32 numTriangles = source.position.size() / 3;
-
-  for (uint32 i = 0; i < numTriangles; ++i)
+  newChunk->indexFormat = data.indexSize == sizeof(uint32) ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+  newChunk->indexSize = data.indexSize;
+  newChunk->m_bounds = data.bounds;
+  newChunk->m_boundingSphere = data.boundingSphere;
+  for (uint32 i = 0; mesh.m_vertexDeclaration->getElement(i); ++i)
   {
-    for (uint32 j = 0; j < 3; ++j)
-    {
-      uint32 index = i*3+j;
-
-      Vector3 pos = source.position[index];
-
-      uint32 vertexHash = 5381;
-      vertexHash = ((vertexHash << 5) + vertexHash) + *(uint32*)&pos.x;
-      vertexHash = ((vertexHash << 5) + vertexHash) + *(uint32*)&pos.y;
-      vertexHash = ((vertexHash << 5) + vertexHash) + *(uint32*)&pos.z;
-      
-      bool foundMatchingVertex = false;
-      uint32 duplicateIndex = 0;
-
-      for(std::pair<std::multimap<uint32, int>::iterator, std::multimap<uint32, int>::iterator> it = indexRemapping.equal_range(vertexHash);
-        it.first != it.second && !foundMatchingVertex; ++it.first)
-      {
-        foundMatchingVertex = true;
-
-        const int destIndex = data.position.size() - 1;
-
-        duplicateIndex = (it.first)->second;
-        int index = duplicateIndex;
-        foundMatchingVertex &= equals(data.position[index], pos);
-
-        if (hasNormals)
-        {
-          foundMatchingVertex &= equals(data.normal[index], source.normal[index]);
-        }
-
-        if (hasUv0)
-        {
-          foundMatchingVertex &= equals(data.uv0[index], source.uv0[index]);
-        }
-
-        // FIXME: other attributes...
-      }
-
-      if (foundMatchingVertex)
-      {
-        data.indices.push_back(duplicateIndex);
-        duplicateVertices++;
-      }
-      else
-      {
-        data.position.push_back(pos);
-
-        const int destIndex = data.position.size() - 1;
-
-        if (hasNormals)
-        {
-          data.normal.push_back(source.normal[index]);
-        }
-
-        if (hasUv0)
-        {
-          data.uv0.push_back(source.uv0[index]);
-        }
-
-        // FIXME: other attributes...
-
-        data.indices.push_back(destIndex);
-
-        if (!foundMatchingVertex)
-          indexRemapping.insert(std::make_pair(vertexHash, destIndex));
-      }
-    }
+    const VertexElement* element = mesh.m_vertexDeclaration->getElement(i);
+    if (element->semantic == "Position" && element->format == VEF_SHORT4N)
+      getPositionDequantization(data.bounds, newChunk->positionScale, newChunk->positionBias);
   }
-}
-
-MeshChunk* Mesh::createMeshChunk(const IntermediateMeshData& data, Mesh& mesh)
-{
-  MeshChunk* newChunk = new MeshChunk();
-  newChunk->streamMask = 1;
-  newChunk->indexCount = data.indices.size();
 
   mesh.m_meshChunks.push_back(newChunk);
 
-  // vertices
-  bool hasNormal = (data.normal.size() > 0);
-  bool hasTangent = (data.tangent.size() > 0);
-  bool hasBitangent = (data.bitangent.size() > 0);
-  bool hasUv0 = (data.uv0.size() > 0);
-  bool hasUv1 = (data.uv1.size() > 0);
-  bool hasUv2 = (data.uv2.size() > 0);
-
-  // create vertex declaration if not already available
-  if (!mesh.m_vertexDeclaration)
-  {
-    VertexDeclaration* vertexDecl = new VertexDeclaration();
-
-    uint32 offset = 0;
-    const VertexElement& element = vertexDecl->add("Position", 0, VEF_FLOAT3, 0, offset, false);
-    offset += VertexDeclaration::sizeOfElementType(element.format);
-    if (hasNormal)
-    {
-      const VertexElement& element = vertexDecl->add("Normal", 0, VEF_FLOAT3, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-    if (hasTangent)
-    {
-      const VertexElement& element = vertexDecl->add("Tangent", 0, VEF_FLOAT3, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-    if (hasBitangent)
-    {
-      const VertexElement& element = vertexDecl->add("Bitangent", 0, VEF_FLOAT3, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-    if (hasUv0)
-    {
-      const VertexElement& element = vertexDecl->add("Texcoord", 0, VEF_FLOAT2, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-    if (hasUv1)
-    {
-      const VertexElement& element = vertexDecl->add("Texcoord", 1, VEF_FLOAT2, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-    if (hasUv2)
-    {
-      const VertexElement& element = vertexDecl->add("Texcoord", 2, VEF_FLOAT2, 0, offset, false);
-      offset += VertexDeclaration::sizeOfElementType(element.format);
-    }
-
-    mesh.m_vertexDeclaration = vertexDecl;
-  } 
-
-  newChunk->vertexSize = 0;
-  for (uint32 elementIdx = 0; ; ++elementIdx)
-  {
-    const VertexElement* element = mesh.m_vertexDeclaration->getElement(elementIdx);
-    if (!element)
-      break;
-    newChunk->vertexSize += VertexDeclaration::sizeOfElementType(element->format);
-  }
-
-  size_t bufferSize = newChunk->vertexSize * data.position.size();
-  void* buffer = malloc(bufferSize);
-  float* dest = (float*)buffer;
-
-  for (uint32 i = 0; i < data.position.size(); ++i)
-  {
-    *dest++ = data.position[i].x;
-    *dest++ = data.position[i].y;
-    *dest++ = data.position[i].z;
-
-    if (hasNormal)
-    {
-      *dest++ = data.normal[i].x;
-      *dest++ = data.normal[i].y;
-      *dest++ = data.normal[i].z;
-    }
-
-    if (hasTangent)
-    {
-      *dest++ = data.tangent[i].x;
-      *dest++ = data.tangent[i].y;
-      *dest++ = data.tangent[i].z;
-    }
+  // the mesh sphere depends on all chunks, Mesh::create computes it once they're in
+  if (!data.bounds.isEmpty())
+    mesh.m_bounds.merge(newChunk->m_bounds);
 
-    if (hasBitangent)
-    {
-      *dest++ = data.bitangent[i].x;
-      *dest++ = data.bitangent[i].y;
-      *dest++ = data.bitangent[i].z;
-    }
-
-    if (hasUv0)
-    {
-      *dest++ = data.uv0[i].x;
-      *dest++ = data.uv0[i].y;
-    }
-
-    if (hasUv1)
-    {
-      *dest++ = data.uv1[i].x;
-      *dest++ = data.uv1[i].y;
-    }
-
-    if (hasUv2)
-    {
-      *dest++ = data.uv2[i].x;
-      *dest++ = data.uv2[i].y;
-    }
-  }
+  // the data is already in its final layout, cooked or mapped from a file
+  if (data.numVertices == 0 || data.numIndices == 0)
+    return newChunk;
 
+  // a buffer per stream, they lie back to back in the vertex data
   D3D11_BUFFER_DESC desc = {0};
   desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-  desc.ByteWidth = bufferSize;
   desc.Usage = D3D11_USAGE_IMMUTABLE;
 
   D3D11_SUBRESOURCE_DATA initialData = {0};
-  initialData.pSysMem = buffer;
-  VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, &initialData, &newChunk->streams[0]));
-
-  // indices
-  bool use32BitIndices = data.position.size() > 0xffff;
-  bufferSize = data.indices.size() * (use32BitIndices ? sizeof(uint32) : sizeof(uint16));
-  buffer = malloc(bufferSize);
-  if (use32BitIndices)
+  const ubyte* vertices = (const ubyte*)data.vertices;
+  for (uint32 stream = 0; stream < MAX_VERTEX_STREAMS; ++stream)
   {
-    memcpy(buffer, &data.indices[0], sizeof(uint32) * data.indices.size());
-  }
-  else
-  {
-    uint16* dest = (uint16*)buffer;
-    for (uint32 i = 0; i < data.indices.size(); ++i)
-      *dest++ = (uint16)data.indices[i];
+    newChunk->strides[stream] = mesh.m_vertexDeclaration->getStreamStride(stream);
+    if (newChunk->strides[stream] == 0)
+      continue;
+
+    desc.ByteWidth = newChunk->strides[stream] * data.numVertices;
+    initialData.pSysMem = vertices;
+    VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, &initialData, &newChunk->streams[stream]));
+    vertices += desc.ByteWidth;
   }
 
   desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-  desc.ByteWidth = bufferSize;
+  desc.ByteWidth = data.indexSize * data.numIndices;
   desc.Usage = D3D11_USAGE_IMMUTABLE;
 
-  initialData.pSysMem = buffer;
+  initialData.pSysMem = data.indices;
   VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, &initialData, &newChunk->indices));
 
-  free(buffer);
+  // the meshlet ranges index the chunk's indices, only the finest level is kept on the cpu. the
+  // meshlets are rebased onto it
+  if (data.numMeshlets)
+  {
+    const MeshLod& finest = newChunk->lods[0];
+    const ubyte* source = (const ubyte*)data.indices + finest.firstIndex * data.indexSize;
+    newChunk->meshletIndices.assign(source, source + finest.numIndices * data.indexSize);
+
+    newChunk->numMeshlets = data.numMeshlets;
+    newChunk->meshlets.assign((const ubyte*)data.meshlets, (const ubyte*)data.meshlets + data.numMeshlets * MeshletStride);
+    const MeshletArrays meshlets(&newChunk->meshlets[0], newChunk->numMeshlets);
+    for (uint32 m = 0; m < meshlets.numMeshlets; ++m)
+      meshlets.firstIndex[m] -= finest.firstIndex;
+
+    desc.ByteWidth = data.indexSize * finest.numIndices;
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, 0, &newChunk->culledIndices));
+  }
 
   return newChunk;
 }
\ No newline at end of file
@@ -0,0 +1,1063 @@
+#include "Core.h"
+#include "MeshCook.h"
+#include "StringUtils.h"
+#include "TaskScheduler.h"
+#include "HalfFloat.h"
+
+namespace
+{
+  struct materialParameters
+  {
+    String diffuseMap;
+    String normalMap;
+  };
+
+  // welding runs on a single table below this size
+  const uint32 MinParallelWeldVertices = 1 << 16;
+  const uint32 WeldPartitionBits = 6;
+  const uint32 WeldScatterRanges = 16;
+  const uint32 InvalidVertex = 0xffffffff;
+
+  // all float attributes of a vertex, uvs are read with a stride from the Vector2 arrays
+  struct VertexColumns
+  {
+    const float* data[18];
+    uint32 stride[18];
+    uint32 numColumns;
+  };
+
+  // the source of an element written by createVertexDeclaration
+  const Vector3Stream* findVectorAttribute(const IntermediateMeshData& data, const VertexElement& element)
+  {
+    if (element.semantic == "Position")
+      return &data.position;
+    if (element.semantic == "Normal")
+      return &data.normal;
+    if (element.semantic == "Tangent")
+      return &data.tangent;
+    if (element.semantic == "Bitangent")
+      return &data.bitangent;
+
+    return 0;
+  }
+
+  const Array<Vector2>* findTexcoordAttribute(const IntermediateMeshData& data, const VertexElement& element)
+  {
+    const Array<Vector2>* uvs[] = { &data.uv0, &data.uv1, &data.uv2 };
+    if (element.semantic == "Texcoord" && element.semanticIndex < 3)
+      return uvs[element.semanticIndex];
+
+    return 0;
+  }
+
+  // the float components of an element, uvs are read with a stride from the Vector2 arrays
+  struct ElementSource
+  {
+    const float* data[3];
+    uint32 stride;            // in floats
+    uint32 numComponents;
+    // VEF_SHORT4N positions are stored as (value - bias) / scale
+    float scale[3];
+    float bias[3];
+  };
+
+  bool getElementSource(const IntermediateMeshData& data, const VertexElement& element, const AABB& bounds, ElementSource& source)
+  {
+    for (uint32 c = 0; c < 3; ++c)
+    {
+      source.scale[c] = 1.0f;
+      source.bias[c] = 0.0f;
+    }
+
+    const Vector3Stream* vector = findVectorAttribute(data, element);
+    if (vector && !vector->isEmpty())
+    {
+      const Vector3SoA soa = vector->getSoA();
+      source.data[0] = soa.x;
+      source.data[1] = soa.y;
+      source.data[2] = soa.z;
+      source.stride = 1;
+      source.numComponents = 3;
+
+      if (vector == &data.position && element.format == VEF_SHORT4N)
+      {
+        Vector3 scale;
+        Vector3 bias;
+        getPositionDequantization(bounds, scale, bias);
+        memcpy(source.scale, &scale, sizeof(source.scale));
+        memcpy(source.bias, &bias, sizeof(source.bias));
+      }
+      return true;
+    }
+
+    const Array<Vector2>* uvs = findTexcoordAttribute(data, element);
+    if (uvs && !uvs->empty())
+    {
+      source.data[0] = &(*uvs)[0].x;
+      source.data[1] = &(*uvs)[0].y;
+      source.data[2] = 0;
+      source.stride = 2;
+      source.numComponents = 2;
+      return true;
+    }
+
+    return false;
+  }
+
+  uint32 getComponentCount(eVertexElementFormat format)
+  {
+    switch (format)
+    {
+    case VEF_FLOAT1: case VEF_HALF1: return 1;
+    case VEF_FLOAT2: case VEF_HALF2: return 2;
+    case VEF_FLOAT3: return 3;
+    case VEF_FLOAT4: case VEF_HALF4: case VEF_SHORT4N: case VEF_BYTE4N: return 4;
+    }
+
+    ASSERT(false, "format not supported");
+    return 1;
+  }
+
+  // writes a component in the format and returns the value the gpu reads back
+  float packComponent(eVertexElementFormat format, float value, ubyte* dest)
+  {
+    switch (format)
+    {
+    case VEF_HALF1:
+    case VEF_HALF2:
+    case VEF_HALF4:
+      {
+        const uint16 half = floatToHalf(value);
+        memcpy(dest, &half, sizeof(half));
+        return halfToFloat(half);
+      }
+    case VEF_SHORT4N:
+      {
+        const short snorm = (short)floor(clamp(value, -1.0f, 1.0f) * 32767.0f + 0.5f);
+        memcpy(dest, &snorm, sizeof(snorm));
+        return snorm / 32767.0f;
+      }
+    case VEF_BYTE4N:
+      {
+        const signed char snorm = (signed char)floor(clamp(value, -1.0f, 1.0f) * 127.0f + 0.5f);
+        memcpy(dest, &snorm, sizeof(snorm));
+        return snorm / 127.0f;
+      }
+    }
+
+    memcpy(dest, &value, sizeof(value));
+    return value;
+  }
+
+  // packs the element of every vertex, without dest only the error is measured. components
+  // missing in the source are 1, so a position reads as a point. returns the largest distance
+  // of a read back value to the source
+  float packElement(const ElementSource& source, eVertexElementFormat format, uint32 numVertices, ubyte* dest, uint32 stride)
+  {
+    const uint32 numComponents = getComponentCount(format);
+    const uint32 componentSize = VertexDeclaration::sizeOfElementType(format) / numComponents;
+
+    ubyte scratch[sizeof(float)];
+    float maxError = 0.0f;
+    for (uint32 v = 0; v < numVertices; ++v)
+    {
+      float error = 0.0f;
+      for (uint32 c = 0; c < numComponents; ++c)
+      {
+        ubyte* target = dest ? dest + v * stride + c * componentSize : scratch;
+        if (c >= source.numComponents)
+        {
+          packComponent(format, 1.0f, target);
+          continue;
+        }
+
+        const float value = source.data[c][v * source.stride];
+        const float packed = packComponent(format, (value - source.bias[c]) / source.scale[c], target) * source.scale[c] + source.bias[c];
+        error += (packed - value) * (packed - value);
+      }
+
+      maxError = max(maxError, sqrtf(error));
+    }
+
+    return maxError;
+  }
+
+  void getVertexColumns(const IntermediateMeshData& data, VertexColumns& columns)
+  {
+    columns.numColumns = 0;
+
+    const Vector3Stream* vectors[] = { &data.position, &data.normal, &data.tangent, &data.bitangent };
+    for (uint32 attribute = 0; attribute < 4; ++attribute)
+    {
+      if (vectors[attribute]->isEmpty())
+        continue;
+
+      const float* components[] = { vectors[attribute]->getX(), vectors[attribute]->getY(), vectors[attribute]->getZ() };
+      for (uint32 c = 0; c < 3; ++c)
+      {
+        columns.data[columns.numColumns] = components[c];
+        columns.stride[columns.numColumns++] = 1;
+      }
+    }
+
+    const Array<Vector2>* uvs[] = { &data.uv0, &data.uv1, &data.uv2 };
+    for (uint32 set = 0; set < 3; ++set)
+    {
+      if (uvs[set]->empty())
+        continue;
+
+      for (uint32 c = 0; c < 2; ++c)
+      {
+        columns.data[columns.numColumns] = &(*uvs[set])[0].x + c;
+        columns.stride[columns.numColumns++] = 2;
+      }
+    }
+  }
+
+  // bit pattern, except that -0 and 0 are the same
+  inline uint32 packWeldValue(float value)
+  {
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits == 0x80000000 ? 0 : bits;
+  }
+
+  // index of the grid cell, values closer than epsilon may still end up in neighbouring cells
+  inline uint32 quantizeWeldValue(float value, float scale)
+  {
+    return (uint32)(int)floor(clamp(value * scale, -1073741824.0f, 1073741824.0f) + 0.5f);
+  }
+
+  inline uint32 hashWord(uint32 hash, uint32 word)
+  {
+    return (hash ^ word) * 0x01000193;
+  }
+
+  // fnv-1a leaves the upper bits poorly mixed, they select the partition
+  inline uint32 finalizeHash(uint32 hash)
+  {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+  }
+
+  // the key holds one 32 bit word per column, returns its hash
+  inline uint32 packVertex(const VertexColumns& columns, uint32 v, float scale, uint32* key)
+  {
+    uint32 hash = 0x811c9dc5;
+    for (uint32 c = 0; c < columns.numColumns; ++c)
+    {
+      const float value = columns.data[c][v * columns.stride[c]];
+      key[c] = scale > 0.0f ? quantizeWeldValue(value, scale) : packWeldValue(value);
+      hash = hashWord(hash, key[c]);
+    }
+
+    return finalizeHash(hash);
+  }
+
+  inline uint32 getWeldPartition(uint32 hash, uint32 partitionBits)
+  {
+    return partitionBits ? hash >> (32 - partitionBits) : 0;
+  }
+
+  // newmtl, map_Kd and map_bump are all that's used so far
+  bool readMaterialLibrary(const String& fileName, std::map<String, materialParameters>& materials)
+  {
+    DataBlob data1;
+    if (!readRawBlob(fileName, data1))
+      return false;
+
+    const char* curr = (const char*)data1.getPtr();
+    const char* last = curr;
+    const char* end = curr + data1.getSize();
+
+    materialParameters* currMaterial = 0;
+
+    while (true)
+    {
+      // eat whitespaces
+      while (*curr <= ' ' && curr < end)
+        ++curr;
+
+      last = curr;
+
+      // go to next line
+      while (*curr != '\n' && curr < end)
+        ++curr;
+
+      if (!strncmp(last, "newmtl", 6))
+      {
+        const char* nameEnd = curr;
+        while (*nameEnd <= ' ')
+          --nameEnd;
+
+        last += 7;
+        String materialName = String(last, nameEnd-last+1);
+        materials.insert(std::make_pair(materialName, materialParameters()));
+        currMaterial = &materials[materialName];
+      }
+      else if (!strncmp(last, "map_Kd", 6) && currMaterial)
+      {
+        const char* nameEnd = curr;
+        while (*nameEnd <= ' ')
+          --nameEnd;
+
+        last += 7;
+        currMaterial->diffuseMap = String(last, nameEnd-last+1);
+      }
+      else if (!strncmp(last, "map_bump", 8) && currMaterial)
+      {
+        const char* nameEnd = curr;
+        while (*nameEnd <= ' ')
+          --nameEnd;
+
+        last += 9;
+        currMaterial->normalMap = String(last, nameEnd-last+1);
+      }
+
+      ++curr; // jump over \n
+
+      // eof reached
+      if (curr >= end)
+        break;
+
+      last = curr;
+    }
+
+    return true;
+  }
+}
+
+VertexPackingStatistics::VertexPackingStatistics()
+  : sourceVertexSize(0)
+  , vertexSize(0)
+{
+  memset(maxError, 0, sizeof(maxError));
+}
+
+CookedMeshChunk::CookedMeshChunk()
+  : numVertices(0)
+  , numSourceVertices(0)
+  , vertexSize(0)
+  , indexSize(0)
+{
+  memset(&sourceVertexCache, 0, sizeof(sourceVertexCache));
+  memset(&vertexCache, 0, sizeof(vertexCache));
+  memset(&sourceOverdraw, 0, sizeof(sourceOverdraw));
+  memset(&overdraw, 0, sizeof(overdraw));
+}
+
+void CookedMesh::getMeshData(MeshData& data) const
+{
+  data.vertexDeclaration = vertexDeclaration;
+  data.chunks.clear();
+  data.chunks.resize(chunks.size());
+
+  for (uint32 i = 0; i < chunks.size(); ++i)
+  {
+    const CookedMeshChunk& chunk = chunks[i];
+    MeshChunkData& target = data.chunks[i];
+    target.vertices = chunk.vertices.empty() ? 0 : &chunk.vertices[0];
+    target.numVertices = chunk.numVertices;
+    target.vertexSize = chunk.vertexSize;
+    target.indices = chunk.indices.empty() ? 0 : &chunk.indices[0];
+    target.numIndices = chunk.indices.size() / max<uint32>(chunk.indexSize, 1);
+    target.indexSize = chunk.indexSize;
+    target.bounds = chunk.bounds;
+    target.boundingSphere = chunk.boundingSphere;
+    target.numLods = min<uint32>(chunk.lods.size(), MaxMeshLods);
+    if (target.numLods)
+      memcpy(target.lods, &chunk.lods[0], target.numLods * sizeof(MeshLod));
+    target.meshlets = chunk.meshlets.empty() ? 0 : &chunk.meshlets[0];
+    target.numMeshlets = chunk.meshlets.size() / MeshletStride;
+    target.diffuseMap = chunk.diffuseMap;
+    target.bumpMap = chunk.bumpMap;
+  }
+}
+
+void createVertexDeclaration(const IntermediateMeshData& data, VertexDeclaration& declaration, uint32 options)
+{
+  declaration.clear();
+
+  const VertexElement& element = declaration.add("Position", 0, VEF_FLOAT3, 0, 0, false);
+
+  // the other attributes start over in stream 1
+  const uint32 stream = (options & OPT_USE_MULTI_STREAM) ? 1 : 0;
+  uint32 offset = stream ? 0 : VertexDeclaration::sizeOfElementType(element.format);
+  if (!data.normal.isEmpty())
+  {
+    const VertexElement& element = declaration.add("Normal", 0, VEF_FLOAT3, stream, offset, false);
+    offset += VertexDeclaration::sizeOfElementType(element.format);
+  }
+  if (!data.tangent.isEmpty())
+  {
+    const VertexElement& element = declaration.add("Tangent", 0, VEF_FLOAT3, stream, offset, false);
+    offset += VertexDeclaration::sizeOfElementType(element.format);
+  }
+  if (!data.bitangent.isEmpty())
+  {
+    const VertexElement& element = declaration.add("Bitangent", 0, VEF_FLOAT3, stream, offset, false);
+    offset += VertexDeclaration::sizeOfElementType(element.format);
+  }
+
+  const Array<Vector2>* uvs[] = { &data.uv0, &data.uv1, &data.uv2 };
+  for (uint32 set = 0; set < 3; ++set)
+  {
+    if (uvs[set]->empty())
+      continue;
+
+    const VertexElement& element = declaration.add("Texcoord", set, VEF_FLOAT2, stream, offset, false);
+    offset += VertexDeclaration::sizeOfElementType(element.format);
+  }
+}
+
+void selectVertexFormats(const IntermediateMeshData* meshes, uint32 numMeshes, const MeshCookSettings& settings, VertexDeclaration& declaration,
+  VertexPackingStatistics& statistics)
+{
+  statistics = VertexPackingStatistics();
+  statistics.sourceVertexSize = declaration.getVertexSize();
+
+  // the chunk bounds as computed by cookMeshChunk, the position tolerance is relative to the mesh
+  Array<AABB> bounds;
+  bounds.resize(numMeshes);
+  AABB meshBounds;
+  for (uint32 m = 0; m < numMeshes; ++m)
+  {
+    if (meshes[m].position.isEmpty())
+      continue;
+
+    computeBounds(bounds[m], meshes[m].position.getSoA(), meshes[m].position.getSize());
+    meshBounds.merge(bounds[m]);
+  }
+  const float positionTolerance = meshBounds.isEmpty() ? 0.0f : settings.positionTolerance * length(meshBounds.maximum - meshBounds.minimum);
+
+  // smallest first, of equal sizes the one without decoding in the shader
+  const eVertexElementFormat positionFormats[] = { VEF_HALF4, VEF_SHORT4N };
+  const eVertexElementFormat vectorFormats[] = { VEF_BYTE4N, VEF_SHORT4N };
+  const eVertexElementFormat texcoordFormats[] = { VEF_HALF2 };
+
+  VertexDeclaration packed;
+  uint32 offsets[MAX_VERTEX_STREAMS] = { 0 };
+  for (uint32 i = 0; ; ++i)
+  {
+    const VertexElement* element = declaration.getElement(i);
+    if (!element)
+      break;
+
+    const eVertexElementFormat* formats = 0;
+    uint32 numFormats = 0;
+    float tolerance = 0.0f;
+    if (element->semantic == "Position")
+    {
+      formats = positionFormats;
+      numFormats = sizeof(positionFormats) / sizeof(positionFormats[0]);
+      tolerance = positionTolerance;
+    }
+    else if (element->semantic == "Normal" || element->semantic == "Tangent" || element->semantic == "Bitangent")
+    {
+      formats = vectorFormats;
+      numFormats = sizeof(vectorFormats) / sizeof(vectorFormats[0]);
+      tolerance = settings.normalTolerance;
+    }
+    else if (element->semantic == "Texcoord")
+    {
+      formats = texcoordFormats;
+      numFormats = sizeof(texcoordFormats) / sizeof(texcoordFormats[0]);
+      tolerance = settings.texcoordTolerance;
+    }
+
+    VertexElement result = *element;
+    for (uint32 f = 0; f < numFormats; ++f)
+    {
+      result.format = formats[f];
+      float maxError = 0.0f;
+      for (uint32 m = 0; m < numMeshes && maxError <= tolerance; ++m)
+      {
+        ElementSource source;
+        if (getElementSource(meshes[m], result, bounds[m], source))
+          maxError = max(maxError, packElement(source, result.format, meshes[m].position.getSize(), 0, 0));
+      }
+
+      if (maxError <= tolerance)
+      {
+        statistics.maxError[i] = maxError;
+        break;
+      }
+      result.format = element->format;
+    }
+
+    // the elements of a stream stay in order
+    result.byteOffset = offsets[result.stream];
+    offsets[result.stream] += VertexDeclaration::sizeOfElementType(result.format);
+    packed.add(result);
+  }
+
+  declaration = packed;
+  statistics.vertexSize = declaration.getVertexSize();
+}
+
+void cookMeshChunk(const IntermediateMeshData& data, const VertexDeclaration& declaration, CookedMeshChunk& chunk)
+{
+  chunk.numVertices = data.position.getSize();
+
+  // bounds
+  if (!data.position.isEmpty())
+  {
+    computeBounds(chunk.bounds, data.position.getSoA(), data.position.getSize());
+    computeBoundingSphere(chunk.boundingSphere, chunk.bounds, data.position.getSoA(), data.position.getSize());
+  }
+
+  // the streams back to back, see MeshChunkData
+  uint32 streamOffsets[MAX_VERTEX_STREAMS];
+  chunk.vertexSize = 0;
+  for (uint32 stream = 0; stream < MAX_VERTEX_STREAMS; ++stream)
+  {
+    streamOffsets[stream] = chunk.vertexSize * chunk.numVertices;
+    chunk.vertexSize += declaration.getStreamStride(stream);
+  }
+
+  chunk.vertices.clear();
+  chunk.vertices.resize(chunk.vertexSize * chunk.numVertices);
+
+  // one attribute at a time in the order of the vertex declaration
+  for (uint32 elementIdx = 0; !chunk.vertices.empty(); ++elementIdx)
+  {
+    const VertexElement* element = declaration.getElement(elementIdx);
+    if (!element)
+      break;
+
+    ubyte* dest = &chunk.vertices[streamOffsets[element->stream] + element->byteOffset];
+    const uint32 stride = declaration.getStreamStride(element->stream);
+
+    const Vector3Stream* vector = findVectorAttribute(data, *element);
+    if (vector && element->format == VEF_FLOAT3)
+    {
+      vector->interleave(dest, stride);
+      continue;
+    }
+
+    const Array<Vector2>* uvs = findTexcoordAttribute(data, *element);
+    if (uvs && element->format == VEF_FLOAT2)
+    {
+      for (uint32 i = 0; i < uvs->size(); ++i)
+        memcpy(dest + i * stride, &(*uvs)[i], sizeof(Vector2));
+      continue;
+    }
+
+    // formats picked by selectVertexFormats are converted one component at a time
+    ElementSource source;
+    const bool known = getElementSource(data, *element, chunk.bounds, source);
+    ASSERT(known, "unknown vertex element");
+    if (known)
+      packElement(source, element->format, chunk.numVertices, dest, stride);
+  }
+
+  // a single level without lods
+  chunk.lods = data.lods;
+  if (chunk.lods.empty())
+  {
+    MeshLod lod = { 0, (uint32)data.indices.size(), 0.0f };
+    chunk.lods.push_back(lod);
+  }
+  chunk.meshlets = data.meshlets;
+
+  // indices
+  const bool use32BitIndices = chunk.numVertices > 0xffff;
+  chunk.indexSize = use32BitIndices ? sizeof(uint32) : sizeof(uint16);
+  chunk.indices.clear();
+  chunk.indices.resize(data.indices.size() * chunk.indexSize);
+  if (data.indices.empty())
+    return;
+
+  if (use32BitIndices)
+  {
+    memcpy(&chunk.indices[0], &data.indices[0], sizeof(uint32) * data.indices.size());
+  }
+  else
+  {
+    uint16* dest = (uint16*)&chunk.indices[0];
+    for (uint32 i = 0; i < data.indices.size(); ++i)
+      *dest++ = (uint16)data.indices[i];
+  }
+}
+
+void fixTangentData(IntermediateMeshData& data)
+{
+  if (data.uv0.size() == 0)
+  {
+    return;
+  }
+
+  uint32 numTris = data.position.getSize() / 3;
+  for (uint32 i = 0; i < numTris; ++i)
+  {
+    uint32 idx[3] = {0};
+
+    idx[0] = i*3+0;
+    idx[1] = i*3+1;
+    idx[2] = i*3+2;
+
+    const Vector3& edgeA = data.position.get(idx[1]) - 
+      data.position.get(idx[0]);
+
+    const Vector3& edgeB = data.position.get(idx[2]) - 
+      data.position.get(idx[0]);
+
+    const Vector2& uv0 = data.uv0[idx[0]];
+    const Vector2& uv1 = data.uv0[idx[1]];
+    const Vector2& uv2 = data.uv0[idx[2]];
+
+    float s1 = uv1.x - uv0.x;
+    float t1 = uv0.y - uv1.y;
+    float s2 = uv2.x - uv0.x;
+    float t2 = uv0.y - uv2.y;
+
+    float det = 1.0f / (s1 * t2 - s2 * t1);
+    if (fabs(det) <= EPSILON)
+    {
+      det = 1.0f;
+    }
+
+    Vector3 tangent = Vector3((t2*edgeA.x - t1*edgeB.x) * det,
+      (t2*edgeA.y - t1*edgeB.y) * det,
+      (t2*edgeA.z - t1*edgeB.z) * det);
+
+    Vector3 bitangent = Vector3((s1*edgeB.x - s2*edgeA.x) * det,
+      (s1*edgeB.y - s2*edgeA.y) * det,
+      (s1*edgeB.z - s2*edgeA.z) * det);
+
+    Vector3 normal = cross(tangent, bitangent);
+
+    tangent = normalize(tangent);
+    bitangent = normalize(bitangent);
+    normal = normalize(normal);
+      
+    Vector3 surfaceNormal = cross(edgeA, edgeB);
+    surfaceNormal = normalize(surfaceNormal);
+
+    bool needFixTB = dot(surfaceNormal, normal) < 0;
+
+    for (uint32 vertex = 0; vertex < 3; ++vertex)
+    {
+      Vector3 vertexTangent = data.tangent.get(idx[vertex]);
+      Vector3 vertexBitangent = data.bitangent.get(idx[vertex]);
+      float handeness = 1.0f;
+
+      if (fabs(squaredLength(vertexTangent)) < EPSILON)
+      {
+        vertexTangent = tangent;
+      }
+      else
+      {
+        if (needFixTB)
+        {
+          if (dot(vertexTangent, tangent) < 0)
+          {
+            vertexTangent = -vertexTangent;
+          }
+          else
+          {
+            handeness = -1.0f;
+          }
+        }
+      }
+
+      // FIXME: handeness
+
+      data.tangent.set(idx[vertex], vertexTangent);
+    }
+  }
+}
+
+uint32 weldVertices(const IntermediateMeshData& source, IntermediateMeshData& data, float epsilon)
+{
+  const uint32 numVertices = source.position.getSize();
+  const uint32 numIndices = source.indices.empty() ? numVertices : source.indices.size();
+
+  VertexColumns columns;
+  getVertexColumns(source, columns);
+
+  // every vertex is hashed over all its attributes, the keys are packed in the scatter below
+  const uint32 keySize = columns.numColumns;
+  const float scale = epsilon > 0.0f ? 1.0f / epsilon : 0.0f;
+  Array<uint32> hashes;
+  hashes.resize(numVertices);
+  TaskScheduler::parallelFor(numVertices, 4096, [&](uint32 first, uint32 last) {
+    uint32 key[sizeof(columns.data) / sizeof(columns.data[0])];
+    for (uint32 v = first; v < last; ++v)
+      hashes[v] = packVertex(columns, v, scale, key);
+  });
+
+  // the upper hash bits select a partition, the partitions are welded independently. within
+  // a partition the vertices stay in order, so the first occurrence is always the one kept
+  const uint32 partitionBits = numVertices < MinParallelWeldVertices ? 0 : WeldPartitionBits;
+  const uint32 numPartitions = 1 << partitionBits;
+  const uint32 numRanges = partitionBits ? WeldScatterRanges : 1;
+  const uint32 rangeSize = (numVertices + numRanges - 1) / numRanges;
+
+  Array<uint32> partitionStarts;
+  partitionStarts.resize(numRanges * numPartitions + 1, 0);
+  TaskScheduler::parallelFor(numRanges, 1, [&](uint32 first, uint32 last) {
+    for (uint32 range = first; range < last; ++range)
+    {
+      for (uint32 v = range * rangeSize; v < min(numVertices, (range + 1) * rangeSize); ++v)
+        ++partitionStarts[getWeldPartition(hashes[v], partitionBits) * numRanges + range];
+    }
+  });
+
+  // partition major, so every partition is one contiguous block ordered by range
+  uint32 offset = 0;
+  for (uint32 i = 0; i < partitionStarts.size(); ++i)
+  {
+    const uint32 count = partitionStarts[i];
+    partitionStarts[i] = offset;
+    offset += count;
+  }
+
+  // hashes and keys are stored again in partition order, every table only touches its own block
+  Array<uint32> order;
+  Array<uint32> orderedHashes;
+  Array<uint32> keys;
+  order.resize(numVertices);
+  orderedHashes.resize(numVertices);
+  keys.resize(numVertices * keySize);
+  TaskScheduler::parallelFor(numRanges, 1, [&](uint32 first, uint32 last) {
+    for (uint32 range = first; range < last; ++range)
+    {
+      Array<uint32> cursors;
+      cursors.resize(numPartitions);
+      for (uint32 p = 0; p < numPartitions; ++p)
+        cursors[p] = partitionStarts[p * numRanges + range];
+
+      for (uint32 v = range * rangeSize; v < min(numVertices, (range + 1) * rangeSize); ++v)
+      {
+        const uint32 position = cursors[getWeldPartition(hashes[v], partitionBits)]++;
+        order[position] = v;
+        orderedHashes[position] = hashes[v];
+        packVertex(columns, v, scale, &keys[position * keySize]);
+      }
+    }
+  });
+
+  // open addressing with linear probing, at most half full
+  Array<uint32> remap;
+  remap.resize(numVertices);
+  TaskScheduler::parallelFor(numPartitions, 1, [&](uint32 first, uint32 last) {
+    for (uint32 p = first; p < last; ++p)
+    {
+      const uint32 begin = partitionStarts[p * numRanges];
+      const uint32 end = partitionStarts[(p + 1) * numRanges];
+
+      uint32 tableSize = 16;
+      while (tableSize < (end - begin) * 2)
+        tableSize *= 2;
+
+      // pairs of hash and position in the partition order, mismatches don't touch the keys
+      Array<uint32> table;
+      table.resize(tableSize * 2, InvalidVertex);
+
+      for (uint32 i = begin; i < end; ++i)
+      {
+        const uint32 v = order[i];
+        const uint32 hash = orderedHashes[i];
+        for (uint32 slot = hash & (tableSize - 1); ; slot = (slot + 1) & (tableSize - 1))
+        {
+          const uint32 entry = table[slot * 2 + 1];
+          if (entry == InvalidVertex)
+          {
+            table[slot * 2 + 0] = hash;
+            table[slot * 2 + 1] = i;
+            remap[v] = v;
+            break;
+          }
+
+          if (table[slot * 2 + 0] == hash && !memcmp(&keys[entry * keySize], &keys[i * keySize], keySize * sizeof(uint32)))
+          {
+            remap[v] = order[entry];
+            break;
+          }
+        }
+      }
+    }
+  });
+
+  // unique vertices keep their relative order
+  Array<uint32> newIndices;
+  newIndices.resize(numVertices);
+  uint32 numUnique = 0;
+  for (uint32 v = 0; v < numVertices; ++v)
+  {
+    if (remap[v] == v)
+      newIndices[v] = numUnique++;
+  }
+
+  data.position.resize(numUnique);
+  data.normal.resize(source.normal.isEmpty() ? 0 : numUnique);
+  data.tangent.resize(source.tangent.isEmpty() ? 0 : numUnique);
+  data.bitangent.resize(source.bitangent.isEmpty() ? 0 : numUnique);
+  data.uv0.resize(source.uv0.empty() ? 0 : numUnique);
+  data.uv1.resize(source.uv1.empty() ? 0 : numUnique);
+  data.uv2.resize(source.uv2.empty() ? 0 : numUnique);
+  data.indices.resize(numIndices);
+
+  TaskScheduler::parallelFor(numVertices, 4096, [&](uint32 first, uint32 last) {
+    for (uint32 v = first; v < last; ++v)
+    {
+      if (remap[v] != v)
+        continue;
+
+      const uint32 target = newIndices[v];
+      const Vector3Stream* sources[] = { &source.position, &source.normal, &source.tangent, &source.bitangent };
+      Vector3Stream* targets[] = { &data.position, &data.normal, &data.tangent, &data.bitangent };
+      for (uint32 attribute = 0; attribute < 4; ++attribute)
+      {
+        if (!sources[attribute]->isEmpty())
+          targets[attribute]->set(target, sources[attribute]->get(v));
+      }
+
+      const Array<Vector2>* sourceUvs[] = { &source.uv0, &source.uv1, &source.uv2 };
+      Array<Vector2>* targetUvs[] = { &data.uv0, &data.uv1, &data.uv2 };
+      for (uint32 set = 0; set < 3; ++set)
+      {
+        if (!sourceUvs[set]->empty())
+          (*targetUvs[set])[target] = (*sourceUvs[set])[v];
+      }
+    }
+  });
+
+  TaskScheduler::parallelFor(numIndices, 4096, [&](uint32 first, uint32 last) {
+    for (uint32 i = first; i < last; ++i)
+    {
+      const uint32 v = source.indices.empty() ? i : source.indices[i];
+      data.indices[i] = newIndices[remap[v]];
+    }
+  });
+
+  return numUnique;
+}
+
+void generateLods(IntermediateMeshData& data, const MeshCookSettings& settings)
+{
+  const uint32 numIndices = data.indices.size();
+  data.lods.clear();
+  MeshLod finest = { 0, numIndices, 0.0f };
+  data.lods.push_back(finest);
+  if (numIndices == 0)
+    return;
+
+  Array<uint32> indices;
+  indices.resize(numIndices);
+  for (uint32 level = 1; level < min(settings.numLods, MaxMeshLods); ++level)
+  {
+    const MeshLod previous = data.lods.back();
+    const uint32 target = (uint32)(numIndices * settings.lodRatios[level]) / 3 * 3;
+    if (target >= previous.numIndices)
+      continue;
+
+    float error;
+    const uint32 count = simplifyMesh(&indices[0], &data.indices[previous.firstIndex], previous.numIndices, data.position.getSoA(), data.position.getSize(),
+      target, FLT_MAX, true, &error);
+    if (count == 0 || count == previous.numIndices)
+      break;
+
+    // the error is relative to the previous level, the sum bounds the distance to the finest one
+    MeshLod lod = { (uint32)data.indices.size(), count, previous.error + error };
+    data.lods.push_back(lod);
+    data.indices.insert(data.indices.end(), indices.begin(), indices.begin() + count);
+  }
+}
+
+void optimizeMesh(IntermediateMeshData& data, const MeshCookSettings& settings)
+{
+  const uint32 numVertices = data.position.getSize();
+  const uint32 numIndices = data.indices.size();
+  if (numIndices == 0 || !(settings.options & (OPT_OPTIMIZE_FOR_CACHE | OPT_OPTIMIZE_FOR_OVERDRAW | OPT_BUILD_MESHLETS)))
+    return;
+
+  // the levels are drawn on their own
+  const uint32 numLods = max<uint32>(data.lods.size(), 1);
+  for (uint32 lod = 0; lod < numLods; ++lod)
+  {
+    uint32* indices = &data.indices[data.lods.empty() ? 0 : data.lods[lod].firstIndex];
+    const uint32 count = data.lods.empty() ? numIndices : data.lods[lod].numIndices;
+
+    if (settings.options & OPT_OPTIMIZE_FOR_CACHE)
+      optimizeVertexCache(indices, indices, count, numVertices);
+
+    // clusters of the cache optimized order
+    if (settings.options & OPT_OPTIMIZE_FOR_OVERDRAW)
+      optimizeOverdraw(indices, indices, count, data.position.getSoA(), numVertices, settings.overdrawThreshold);
+  }
+
+  // the coarser levels are only drawn far away, culling their meshlets wouldn't pay off
+  data.meshlets.clear();
+  if (settings.options & OPT_BUILD_MESHLETS)
+  {
+    const uint32 first = data.lods.empty() ? 0 : data.lods[0].firstIndex;
+    const uint32 count = data.lods.empty() ? numIndices : data.lods[0].numIndices;
+    buildMeshlets(data.meshlets, &data.indices[first], count, data.position.getSoA(), numVertices);
+
+    // relative to the chunk's indices
+    MeshletArrays meshlets(data.meshlets.empty() ? 0 : &data.meshlets[0], data.meshlets.size() / MeshletStride);
+    for (uint32 m = 0; m < meshlets.numMeshlets; ++m)
+      meshlets.firstIndex[m] += first;
+  }
+
+  // the finest level comes first, the coarser ones reuse a subset of its vertices
+  Array<uint32> remap;
+  remap.resize(numVertices);
+  const uint32 numUsed = optimizeVertexFetchRemap(&remap[0], &data.indices[0], numIndices, numVertices);
+
+  for (uint32 i = 0; i < numIndices; ++i)
+    data.indices[i] = remap[data.indices[i]];
+
+  // every used vertex is overwritten
+  const IntermediateMeshData source = data;
+
+  const Vector3Stream* sources[] = { &source.position, &source.normal, &source.tangent, &source.bitangent };
+  Vector3Stream* targets[] = { &data.position, &data.normal, &data.tangent, &data.bitangent };
+  for (uint32 attribute = 0; attribute < 4; ++attribute)
+  {
+    if (sources[attribute]->isEmpty())
+      continue;
+
+    targets[attribute]->resize(numUsed);
+    for (uint32 v = 0; v < numVertices; ++v)
+    {
+      if (remap[v] != ~0u)
+        targets[attribute]->set(remap[v], sources[attribute]->get(v));
+    }
+  }
+
+  const Array<Vector2>* sourceUvs[] = { &source.uv0, &source.uv1, &source.uv2 };
+  Array<Vector2>* targetUvs[] = { &data.uv0, &data.uv1, &data.uv2 };
+  for (uint32 set = 0; set < 3; ++set)
+  {
+    if (sourceUvs[set]->empty())
+      continue;
+
+    targetUvs[set]->resize(numUsed);
+    for (uint32 v = 0; v < numVertices; ++v)
+    {
+      if (remap[v] != ~0u)
+        (*targetUvs[set])[remap[v]] = (*sourceUvs[set])[v];
+    }
+  }
+}
+
+bool cookObj(const ObjData& obj, const String& path, CookedMesh& mesh, const MeshCookSettings& settings)
+{
+  std::map<String, materialParameters> materials;
+
+  // the material library is small, it's read on this thread
+  if (!obj.materialLib.empty() && !readMaterialLibrary(path + obj.materialLib, materials))
+    return false;
+
+  const bool hasNormal = !obj.normals.empty();
+  const bool hasTexcoords = !obj.texcoords.empty();
+
+  // the groups are independent, vertex extraction, welding and packing run in parallel
+  mesh.chunks.clear();
+  mesh.chunks.resize(obj.groups.size());
+  std::vector<IntermediateMeshData> groupData(obj.groups.size());
+
+  TaskScheduler::parallelFor(obj.groups.size(), 1, [&](uint32 first, uint32 last) {
+    for (uint32 g = first; g < last; ++g)
+    {
+      const ObjGroup& group = obj.groups[g];
+      IntermediateMeshData data;
+
+      // faces are triangulated as fans
+      for (uint32 i = 0, j = 0; i < group.faceSizes.size(); j += group.faceSizes[i++])
+      {
+        for (uint32 k = 2; k < group.faceSizes[i]; ++k)
+        {
+          const ObjVertex* triangle[] = { &group.vertices[j], &group.vertices[j + k - 1], &group.vertices[j + k] };
+
+          for (uint32 v = 0; v < 3; ++v)
+          {
+            // y and z are swapped, as the importer always did
+            const float* position = &obj.positions[triangle[v]->position * 3];
+            data.position.add(Vector3(position[0], position[2], position[1]));
+
+            // faces without a normal or texcoord reference fall back to the first one
+            if (hasNormal)
+            {
+              const int index = max(triangle[v]->normal, 0);
+              data.normal.add(Vector3(obj.normals[index*3+0], obj.normals[index*3+1], obj.normals[index*3+2]));
+            }
+
+            if (hasTexcoords)
+            {
+              const int index = max(triangle[v]->texcoord, 0);
+              data.uv0.push_back(Vector2(obj.texcoords[index*3+0], obj.texcoords[index*3+1]));
+            }
+          }
+        }
+      }
+
+      mesh.chunks[g].numSourceVertices = data.position.getSize();
+      weldVertices(data, groupData[g], settings.weldEpsilon);
+
+      const IntermediateMeshData& welded = groupData[g];
+      const uint32* indices = welded.indices.empty() ? 0 : &welded.indices[0];
+      mesh.chunks[g].sourceVertexCache = analyzeVertexCache(indices, welded.indices.size(), welded.position.getSize());
+      if (settings.options & OPT_OPTIMIZE_FOR_OVERDRAW)
+        mesh.chunks[g].sourceOverdraw = analyzeOverdraw(indices, welded.indices.size(), welded.position.getSoA(), welded.position.getSize());
+
+      if (settings.numLods > 1)
+        generateLods(groupData[g], settings);
+      optimizeMesh(groupData[g], settings);
+    }
+  });
+
+  // all groups have the attributes of the obj
+  const IntermediateMeshData noGroups;
+  createVertexDeclaration(groupData.empty() ? noGroups : groupData[0], mesh.vertexDeclaration, settings.options);
+  mesh.packing = VertexPackingStatistics();
+  mesh.packing.sourceVertexSize = mesh.packing.vertexSize = mesh.vertexDeclaration.getVertexSize();
+  if (settings.options & OPT_16BIT_VERTEX_DATA)
+    selectVertexFormats(groupData.empty() ? 0 : &groupData[0], groupData.size(), settings, mesh.vertexDeclaration, mesh.packing);
+
+  TaskScheduler::parallelFor(obj.groups.size(), 1, [&](uint32 first, uint32 last) {
+    for (uint32 g = first; g < last; ++g)
+    {
+      CookedMeshChunk& chunk = mesh.chunks[g];
+      cookMeshChunk(groupData[g], mesh.vertexDeclaration, chunk);
+
+      // the finest level starts the index list
+      const IntermediateMeshData& data = groupData[g];
+      const uint32* indices = data.indices.empty() ? 0 : &data.indices[0];
+      chunk.vertexCache = analyzeVertexCache(indices, chunk.lods[0].numIndices, data.position.getSize());
+      if (settings.options & OPT_OPTIMIZE_FOR_OVERDRAW)
+        chunk.overdraw = analyzeOverdraw(indices, chunk.lods[0].numIndices, data.position.getSoA(), data.position.getSize());
+
+      std::map<String, materialParameters>::const_iterator matLibIt = materials.find(obj.groups[g].material);
+      if (matLibIt != materials.end())
+      {
+        chunk.diffuseMap = matLibIt->second.diffuseMap;
+        chunk.bumpMap = matLibIt->second.normalMap;
+      }
+    }
+  });
+
+  return true;
+}
+
+bool cookObj(const String& fileName, CookedMesh& mesh, const MeshCookSettings& settings)
+{
+  ObjData obj;
+  {
+    DataBlob data;
+    if (!readRawBlob(fileName, data))
+      return false;
+
+    if (!parseObj((const char*)data.getPtr(), data.getSize(), obj))
+      return false;
+  }
+
+  return cookObj(obj, PathUtils::getPath(fileName, false) + "\\", mesh, settings);
+}
\ No newline at end of file
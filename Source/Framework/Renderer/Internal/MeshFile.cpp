@@ -0,0 +1,232 @@
+#include "Core.h"
+#include "MeshFile.h"
+#include "Meshlet.h"
+
+namespace
+{
+  inline uint32 alignOffset(uint32 offset)
+  {
+    return (offset + MeshFileAlignment - 1) & ~(MeshFileAlignment - 1);
+  }
+
+  // the empty string is always at offset 0
+  uint32 addString(Array<char>& strings, const String& value)
+  {
+    if (value.empty())
+      return 0;
+
+    const uint32 offset = strings.size();
+    strings.insert(strings.end(), value.begin(), value.end());
+    strings.push_back('\0');
+    return offset;
+  }
+
+  // aligned and completely inside the file
+  inline bool isValidBlock(uint32 offset, uint64 size, uint32 fileSize)
+  {
+    return offset % MeshFileAlignment == 0 && offset + size <= fileSize;
+  }
+}
+
+MeshChunkData::MeshChunkData()
+  : vertices(0)
+  , numVertices(0)
+  , vertexSize(0)
+  , indices(0)
+  , numIndices(0)
+  , indexSize(0)
+  , numLods(0)
+  , meshlets(0)
+  , numMeshlets(0)
+{
+  memset(lods, 0, sizeof(lods));
+}
+
+bool writeMeshFile(const String& fileName, const MeshData& mesh)
+{
+  Array<char> strings;
+  strings.push_back('\0');
+
+  Array<MeshFileElement> elements;
+  for (uint32 i = 0; ; ++i)
+  {
+    const VertexElement* element = mesh.vertexDeclaration.getElement(i);
+    if (!element)
+      break;
+
+    MeshFileElement fileElement;
+    fileElement.semantic = addString(strings, element->semantic);
+    fileElement.semanticIndex = element->semanticIndex;
+    fileElement.format = element->format;
+    fileElement.stream = element->stream;
+    fileElement.byteOffset = element->byteOffset;
+    elements.push_back(fileElement);
+  }
+
+  MeshFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = MeshFileMagic;
+  header.version = MeshFileVersion;
+  header.numElements = elements.size();
+  header.elementsOffset = alignOffset(sizeof(header));
+  header.numChunks = mesh.chunks.size();
+  header.chunksOffset = alignOffset(header.elementsOffset + header.numElements * sizeof(MeshFileElement));
+
+  Array<MeshFileChunk> chunks;
+  chunks.resize(mesh.chunks.size());
+  for (uint32 i = 0; i < mesh.chunks.size(); ++i)
+  {
+    const MeshChunkData& source = mesh.chunks[i];
+    MeshFileChunk& chunk = chunks[i];
+    memset(&chunk, 0, sizeof(chunk));
+    chunk.numVertices = source.numVertices;
+    chunk.vertexSize = source.vertexSize;
+    chunk.numIndices = source.numIndices;
+    chunk.indexSize = source.indexSize;
+    chunk.diffuseMap = addString(strings, source.diffuseMap);
+    chunk.bumpMap = addString(strings, source.bumpMap);
+    memcpy(chunk.boundsMin, &source.bounds.minimum, sizeof(chunk.boundsMin));
+    memcpy(chunk.boundsMax, &source.bounds.maximum, sizeof(chunk.boundsMax));
+    memcpy(chunk.sphereCenter, &source.boundingSphere.center, sizeof(chunk.sphereCenter));
+    chunk.sphereRadius = source.boundingSphere.radius;
+
+    chunk.numLods = max<uint32>(source.numLods, 1);
+    if (source.numLods)
+    {
+      memcpy(chunk.lods, source.lods, source.numLods * sizeof(MeshLod));
+    }
+    else
+    {
+      chunk.lods[0].numIndices = source.numIndices;
+    }
+    chunk.numMeshlets = source.numMeshlets;
+  }
+
+  header.stringsOffset = alignOffset(header.chunksOffset + header.numChunks * sizeof(MeshFileChunk));
+  header.stringsSize = strings.size();
+
+  uint32 offset = alignOffset(header.stringsOffset + header.stringsSize);
+  for (uint32 i = 0; i < chunks.size(); ++i)
+  {
+    chunks[i].verticesOffset = offset;
+    offset = alignOffset(offset + chunks[i].numVertices * chunks[i].vertexSize);
+    chunks[i].indicesOffset = offset;
+    offset = alignOffset(offset + chunks[i].numIndices * chunks[i].indexSize);
+    chunks[i].meshletsOffset = offset;
+    offset = alignOffset(offset + chunks[i].numMeshlets * MeshletStride);
+  }
+  header.fileSize = offset;
+
+  // assembled in memory, the padding stays zero
+  Array<ubyte> image;
+  image.resize(header.fileSize, 0);
+  memcpy(&image[0], &header, sizeof(header));
+  if (!elements.empty())
+    memcpy(&image[header.elementsOffset], &elements[0], elements.size() * sizeof(MeshFileElement));
+  if (!chunks.empty())
+    memcpy(&image[header.chunksOffset], &chunks[0], chunks.size() * sizeof(MeshFileChunk));
+  memcpy(&image[header.stringsOffset], &strings[0], strings.size());
+
+  for (uint32 i = 0; i < chunks.size(); ++i)
+  {
+    const MeshChunkData& source = mesh.chunks[i];
+    if (source.numVertices)
+      memcpy(&image[chunks[i].verticesOffset], source.vertices, source.numVertices * source.vertexSize);
+    if (source.numIndices)
+      memcpy(&image[chunks[i].indicesOffset], source.indices, source.numIndices * source.indexSize);
+    if (source.numMeshlets)
+      memcpy(&image[chunks[i].meshletsOffset], source.meshlets, source.numMeshlets * MeshletStride);
+  }
+
+  FILE* fp;
+  fopen_s(&fp, fileName.c_str(), "wb");
+  if (!fp)
+    return false;
+
+  const bool result = fwrite(&image[0], 1, image.size(), fp) == image.size();
+  fclose(fp);
+
+  return result;
+}
+
+bool readMeshFile(const void* image, uint32 size, MeshData& mesh)
+{
+  const ubyte* data = (const ubyte*)image;
+  if (size < sizeof(MeshFileHeader))
+    return false;
+
+  const MeshFileHeader& header = *(const MeshFileHeader*)data;
+  if (header.magic != MeshFileMagic || header.version != MeshFileVersion || header.fileSize != size)
+    return false;
+
+  if (!isValidBlock(header.elementsOffset, (uint64)header.numElements * sizeof(MeshFileElement), size) ||
+    !isValidBlock(header.chunksOffset, (uint64)header.numChunks * sizeof(MeshFileChunk), size) ||
+    !isValidBlock(header.stringsOffset, header.stringsSize, size))
+    return false;
+
+  // every string, including the last one, is terminated
+  const char* strings = (const char*)(data + header.stringsOffset);
+  if (header.stringsSize == 0 || strings[header.stringsSize - 1] != '\0' || header.numElements >= VertexDeclaration::MaxVertexElements)
+    return false;
+
+  mesh.vertexDeclaration.clear();
+  const MeshFileElement* elements = (const MeshFileElement*)(data + header.elementsOffset);
+  for (uint32 i = 0; i < header.numElements; ++i)
+  {
+    const MeshFileElement& element = elements[i];
+    if (element.semantic >= header.stringsSize || element.format >= VEF_MAX || element.stream >= MAX_VERTEX_STREAMS)
+      return false;
+
+    mesh.vertexDeclaration.add(strings + element.semantic, element.semanticIndex, (eVertexElementFormat)element.format, element.stream, element.byteOffset, false);
+  }
+
+  const uint32 vertexSize = mesh.vertexDeclaration.getVertexSize();
+  mesh.chunks.clear();
+  mesh.chunks.resize(header.numChunks);
+  const MeshFileChunk* chunks = (const MeshFileChunk*)(data + header.chunksOffset);
+  for (uint32 i = 0; i < header.numChunks; ++i)
+  {
+    const MeshFileChunk& chunk = chunks[i];
+    if ((chunk.indexSize != sizeof(uint16) && chunk.indexSize != sizeof(uint32)) || chunk.vertexSize != vertexSize ||
+      !isValidBlock(chunk.verticesOffset, (uint64)chunk.numVertices * chunk.vertexSize, size) ||
+      !isValidBlock(chunk.indicesOffset, (uint64)chunk.numIndices * chunk.indexSize, size) ||
+      !isValidBlock(chunk.meshletsOffset, (uint64)chunk.numMeshlets * MeshletStride, size) ||
+      chunk.diffuseMap >= header.stringsSize || chunk.bumpMap >= header.stringsSize ||
+      chunk.numLods == 0 || chunk.numLods > MaxMeshLods)
+      return false;
+
+    for (uint32 lod = 0; lod < chunk.numLods; ++lod)
+    {
+      if ((uint64)chunk.lods[lod].firstIndex + chunk.lods[lod].numIndices > chunk.numIndices)
+        return false;
+    }
+
+    // the meshlets are whole triangles of the finest level
+    const uint32* firstIndex = (const uint32*)(data + chunk.meshletsOffset);
+    const uint32* numIndices = firstIndex + chunk.numMeshlets;
+    for (uint32 m = 0; m < chunk.numMeshlets; ++m)
+    {
+      if (firstIndex[m] < chunk.lods[0].firstIndex || (uint64)firstIndex[m] + numIndices[m] > chunk.lods[0].firstIndex + chunk.lods[0].numIndices ||
+        numIndices[m] % 3 != 0)
+        return false;
+    }
+
+    MeshChunkData& target = mesh.chunks[i];
+    target.vertices = data + chunk.verticesOffset;
+    target.numVertices = chunk.numVertices;
+    target.vertexSize = chunk.vertexSize;
+    target.indices = data + chunk.indicesOffset;
+    target.numIndices = chunk.numIndices;
+    target.indexSize = chunk.indexSize;
+    target.bounds = AABB(Vector3(chunk.boundsMin[0], chunk.boundsMin[1], chunk.boundsMin[2]), Vector3(chunk.boundsMax[0], chunk.boundsMax[1], chunk.boundsMax[2]));
+    target.boundingSphere = BoundingSphere(Vector3(chunk.sphereCenter[0], chunk.sphereCenter[1], chunk.sphereCenter[2]), chunk.sphereRadius);
+    target.diffuseMap = strings + chunk.diffuseMap;
+    target.bumpMap = strings + chunk.bumpMap;
+    target.numLods = chunk.numLods;
+    memcpy(target.lods, chunk.lods, sizeof(target.lods));
+    target.meshlets = chunk.numMeshlets ? data + chunk.meshletsOffset : 0;
+    target.numMeshlets = chunk.numMeshlets;
+  }
+
+  return true;
+}
\ No newline at end of file
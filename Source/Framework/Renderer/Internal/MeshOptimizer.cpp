@@ -0,0 +1,510 @@
+#include "Core.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <float.h>
+
+namespace
+{
+  // forsyth's parameters, the scoring works on a bigger lru cache than the simulation
+  const uint32 ScoringCacheSize = 32;
+  const float CacheDecayPower = 1.5f;
+  const float LastTriangleScore = 0.75f;
+  const float ValenceBoostScale = 2.0f;
+  const float ValenceBoostPower = 0.5f;
+  const uint32 MaxTabulatedValence = 64;
+
+  struct VertexScoreTable
+  {
+    VertexScoreTable()
+    {
+      for (uint32 i = 0; i < ScoringCacheSize; ++i)
+      {
+        // the vertices of the last triangle get a fixed score, so it isn't used again right away
+        const float scale = 1.0f / (ScoringCacheSize - 3);
+        cache[i] = i < 3 ? LastTriangleScore : pow(1.0f - (i - 3) * scale, CacheDecayPower);
+      }
+
+      // vertices with few triangles left are preferred, it avoids leaving lone triangles behind
+      valence[0] = 0.0f;
+      for (uint32 i = 1; i < MaxTabulatedValence; ++i)
+        valence[i] = ValenceBoostScale * pow((float)i, -ValenceBoostPower);
+    }
+
+    float getScore(int cachePosition, uint32 numTriangles) const
+    {
+      if (numTriangles == 0)
+        return -1.0f;
+
+      const float valenceScore = numTriangles < MaxTabulatedValence ? valence[numTriangles] : ValenceBoostScale * pow((float)numTriangles, -ValenceBoostPower);
+      return cachePosition < 0 ? valenceScore : cache[cachePosition] + valenceScore;
+    }
+
+    float cache[ScoringCacheSize];
+    float valence[MaxTabulatedValence];
+  };
+
+  const VertexScoreTable g_vertexScores;
+
+  // fifo cache, a vertex is in the cache if less than cacheSize vertices were transformed
+  // since its own transform
+  class VertexCacheSimulation
+  {
+  public:
+    VertexCacheSimulation(uint32 numVertices, uint32 cacheSize)
+      : m_cacheSize(cacheSize)
+      , m_time(cacheSize + 1)
+    {
+      m_timestamps.resize(numVertices, 0);
+    }
+
+    // returns the number of misses
+    uint32 addTriangle(const uint32* triangle)
+    {
+      const uint32 time = m_time;
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        if (m_time - m_timestamps[triangle[k]] > m_cacheSize)
+          m_timestamps[triangle[k]] = m_time++;
+      }
+      return m_time - time;
+    }
+
+    void clear() { m_time += m_cacheSize + 1; }
+
+  private:
+    Array<uint32> m_timestamps;
+    uint32 m_cacheSize;
+    uint32 m_time;
+  };
+
+  // sub pixel precision of the overdraw rasterizer
+  const int SubPixelBits = 4;
+
+  struct RasterVertex
+  {
+    int x;
+    int y;
+    float z;
+  };
+
+  inline int edgeFunction(const RasterVertex& a, const RasterVertex& b, int x, int y)
+  {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+  }
+
+  // pixels on a shared edge belong to exactly one of the triangles, the edge runs in opposite
+  // directions for them
+  inline bool ownsEdge(const RasterVertex& a, const RasterVertex& b)
+  {
+    return b.y > a.y || (b.y == a.y && b.x < a.x);
+  }
+
+  inline bool isInside(int w, bool owned)
+  {
+    return w > 0 || (w == 0 && owned);
+  }
+
+  // counter clockwise triangle in fixed point screen space, pixel centers are sampled
+  void rasterizeTriangle(const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2, Array<float>& depth, OverdrawStatistics& statistics)
+  {
+    const int half = 1 << (SubPixelBits - 1);
+    const int minX = max(min(v0.x, min(v1.x, v2.x)) >> SubPixelBits, 0);
+    const int minY = max(min(v0.y, min(v1.y, v2.y)) >> SubPixelBits, 0);
+    const int maxX = min(max(v0.x, max(v1.x, v2.x)) >> SubPixelBits, (int)OverdrawViewportSize - 1);
+    const int maxY = min(max(v0.y, max(v1.y, v2.y)) >> SubPixelBits, (int)OverdrawViewportSize - 1);
+
+    const bool owned0 = ownsEdge(v1, v2);
+    const bool owned1 = ownsEdge(v2, v0);
+    const bool owned2 = ownsEdge(v0, v1);
+    const float invArea = 1.0f / edgeFunction(v0, v1, v2.x, v2.y);
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+      const int sampleY = (y << SubPixelBits) + half;
+      for (int x = minX; x <= maxX; ++x)
+      {
+        const int sampleX = (x << SubPixelBits) + half;
+        const int w0 = edgeFunction(v1, v2, sampleX, sampleY);
+        const int w1 = edgeFunction(v2, v0, sampleX, sampleY);
+        const int w2 = edgeFunction(v0, v1, sampleX, sampleY);
+        if (!isInside(w0, owned0) || !isInside(w1, owned1) || !isInside(w2, owned2))
+          continue;
+
+        const float z = (w0 * v0.z + w1 * v1.z + w2 * v2.z) * invArea;
+        float& pixel = depth[y * OverdrawViewportSize + x];
+        if (z < pixel)
+        {
+          statistics.numCovered += pixel == FLT_MAX;
+          ++statistics.numShaded;
+          pixel = z;
+        }
+      }
+    }
+  }
+
+  struct OverdrawCluster
+  {
+    uint32 begin;
+    uint32 end;
+    float sortKey;
+
+    bool operator<(const OverdrawCluster& other) const { return sortKey > other.sortKey; }
+  };
+}
+
+VertexCacheStatistics analyzeVertexCache(const uint32* indices, uint32 numIndices, uint32 numVertices, uint32 cacheSize)
+{
+  // a vertex is in the cache if less than cacheSize vertices were transformed since its own transform
+  Array<uint32> timestamps;
+  timestamps.resize(numVertices, 0);
+
+  const uint32 firstTimestamp = cacheSize + 1;
+  uint32 time = firstTimestamp;
+  uint32 numReferenced = 0;
+  for (uint32 i = 0; i < numIndices; ++i)
+  {
+    const uint32 v = indices[i];
+    if (time - timestamps[v] > cacheSize)
+    {
+      numReferenced += timestamps[v] == 0;
+      timestamps[v] = time++;
+    }
+  }
+
+  VertexCacheStatistics statistics;
+  statistics.numTransformed = time - firstTimestamp;
+  statistics.acmr = numIndices ? (float)statistics.numTransformed / (numIndices / 3) : 0.0f;
+  statistics.atvr = numReferenced ? (float)statistics.numTransformed / numReferenced : 0.0f;
+  return statistics;
+}
+
+void optimizeVertexCache(uint32* result, const uint32* indices, uint32 numIndices, uint32 numVertices)
+{
+  const uint32 numTriangles = numIndices / 3;
+
+  Array<uint32> source;
+  if (result == indices)
+  {
+    source.assign(indices, indices + numIndices);
+    indices = numIndices ? &source[0] : 0;
+  }
+
+  // the triangles of every vertex, the first numLiveTriangles of them aren't emitted yet
+  Array<uint32> numLiveTriangles;
+  Array<uint32> triangleOffsets;
+  Array<uint32> adjacency;
+  numLiveTriangles.resize(numVertices, 0);
+  triangleOffsets.resize(numVertices, 0);
+  adjacency.resize(numTriangles * 3);
+
+  for (uint32 i = 0; i < numTriangles * 3; ++i)
+    ++numLiveTriangles[indices[i]];
+
+  uint32 offset = 0;
+  for (uint32 v = 0; v < numVertices; ++v)
+  {
+    triangleOffsets[v] = offset;
+    offset += numLiveTriangles[v];
+    numLiveTriangles[v] = 0;
+  }
+
+  for (uint32 i = 0; i < numTriangles * 3; ++i)
+  {
+    const uint32 v = indices[i];
+    adjacency[triangleOffsets[v] + numLiveTriangles[v]++] = i / 3;
+  }
+
+  Array<float> vertexScores;
+  Array<float> triangleScores;
+  Array<ubyte> emitted;
+  vertexScores.resize(numVertices);
+  triangleScores.resize(numTriangles);
+  emitted.resize(numTriangles, 0);
+
+  for (uint32 v = 0; v < numVertices; ++v)
+    vertexScores[v] = g_vertexScores.getScore(-1, numLiveTriangles[v]);
+
+  for (uint32 t = 0; t < numTriangles; ++t)
+    triangleScores[t] = vertexScores[indices[t*3+0]] + vertexScores[indices[t*3+1]] + vertexScores[indices[t*3+2]];
+
+  // the emitted triangle is moved to the front, the cache grows by at most 3 vertices per step
+  uint32 cache[ScoringCacheSize + 3];
+  uint32 newCache[ScoringCacheSize + 3];
+  uint32 cacheSize = 0;
+
+  uint32 bestTriangle = ~0u;
+  uint32 nextCandidate = 0;
+  for (uint32 n = 0; n < numTriangles; ++n)
+  {
+    // nothing adjacent to the cache is left, the next triangle in the input order starts over
+    if (bestTriangle == ~0u)
+    {
+      while (emitted[nextCandidate])
+        ++nextCandidate;
+      bestTriangle = nextCandidate;
+    }
+
+    const uint32* triangle = &indices[bestTriangle * 3];
+    result[n*3+0] = triangle[0];
+    result[n*3+1] = triangle[1];
+    result[n*3+2] = triangle[2];
+    emitted[bestTriangle] = 1;
+
+    uint32 newCacheSize = 0;
+    for (uint32 k = 0; k < 3; ++k)
+    {
+      const uint32 v = triangle[k];
+
+      uint32* triangles = &adjacency[triangleOffsets[v]];
+      for (uint32 i = 0; i < numLiveTriangles[v]; ++i)
+      {
+        if (triangles[i] == bestTriangle)
+        {
+          triangles[i] = triangles[--numLiveTriangles[v]];
+          break;
+        }
+      }
+
+      // degenerate triangles reference a vertex more than once
+      if (k == 0 || (k == 1 && v != triangle[0]) || (k == 2 && v != triangle[0] && v != triangle[1]))
+        newCache[newCacheSize++] = v;
+    }
+
+    for (uint32 i = 0; i < cacheSize; ++i)
+    {
+      const uint32 v = cache[i];
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+        newCache[newCacheSize++] = v;
+    }
+
+    // only vertices in the cache and the ones pushed out of it change their score, the
+    // difference is passed on to their remaining triangles
+    for (uint32 i = 0; i < newCacheSize; ++i)
+    {
+      const uint32 v = newCache[i];
+      const float score = g_vertexScores.getScore(i < ScoringCacheSize ? i : -1, numLiveTriangles[v]);
+      const float delta = score - vertexScores[v];
+      if (delta == 0.0f)
+        continue;
+
+      vertexScores[v] = score;
+      const uint32* triangles = &adjacency[triangleOffsets[v]];
+      for (uint32 j = 0; j < numLiveTriangles[v]; ++j)
+        triangleScores[triangles[j]] += delta;
+    }
+
+    // the best triangle is always next to the cache, unless there is none
+    bestTriangle = ~0u;
+    float bestScore = -1.0f;
+    for (uint32 i = 0; i < min(newCacheSize, ScoringCacheSize); ++i)
+    {
+      const uint32 v = newCache[i];
+      const uint32* triangles = &adjacency[triangleOffsets[v]];
+      for (uint32 j = 0; j < numLiveTriangles[v]; ++j)
+      {
+        const uint32 t = triangles[j];
+        if (triangleScores[t] > bestScore)
+        {
+          bestScore = triangleScores[t];
+          bestTriangle = t;
+        }
+      }
+    }
+
+    cacheSize = min(newCacheSize, ScoringCacheSize);
+    memcpy(cache, newCache, cacheSize * sizeof(uint32));
+  }
+}
+
+uint32 optimizeVertexFetchRemap(uint32* remap, const uint32* indices, uint32 numIndices, uint32 numVertices)
+{
+  memset(remap, 0xff, numVertices * sizeof(uint32));
+
+  uint32 numUsed = 0;
+  for (uint32 i = 0; i < numIndices; ++i)
+  {
+    const uint32 v = indices[i];
+    if (remap[v] == ~0u)
+      remap[v] = numUsed++;
+  }
+
+  return numUsed;
+}
+
+void optimizeOverdraw(uint32* result, const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices, float threshold)
+{
+  const uint32 numTriangles = numIndices / 3;
+
+  Array<uint32> source;
+  if (result == indices)
+  {
+    source.assign(indices, indices + numIndices);
+    indices = numIndices ? &source[0] : 0;
+  }
+
+  // the cache optimizer restarts where all vertices of a triangle miss, these are the hard
+  // boundaries. the cache of a cluster is always empty, it may be drawn after any other
+  Array<uint32> misses;
+  misses.resize(numTriangles);
+  Array<uint32> hardBoundaries;
+  {
+    VertexCacheSimulation cache(numVertices, VertexCacheSize);
+    for (uint32 t = 0; t < numTriangles; ++t)
+    {
+      misses[t] = cache.addTriangle(&indices[t * 3]);
+      if (t == 0 || misses[t] == 3)
+        hardBoundaries.push_back(t);
+    }
+    hardBoundaries.push_back(numTriangles);
+  }
+
+  // soft boundaries split a hard cluster wherever the acmr since the last split is low enough
+  Array<OverdrawCluster> clusters;
+  VertexCacheSimulation cache(numVertices, VertexCacheSize);
+  for (uint32 h = 0; h + 1 < hardBoundaries.size(); ++h)
+  {
+    const uint32 begin = hardBoundaries[h];
+    const uint32 end = hardBoundaries[h + 1];
+
+    uint32 clusterMisses = 0;
+    for (uint32 t = begin; t < end; ++t)
+      clusterMisses += misses[t];
+    const float maxAcmr = threshold * clusterMisses / (end - begin);
+
+    cache.clear();
+    uint32 runningMisses = 0;
+    OverdrawCluster cluster;
+    cluster.begin = begin;
+    for (uint32 t = begin; t < end; ++t)
+    {
+      runningMisses += cache.addTriangle(&indices[t * 3]);
+      if (runningMisses <= maxAcmr * (t + 1 - cluster.begin) || t + 1 == end)
+      {
+        cluster.end = t + 1;
+        clusters.push_back(cluster);
+        cluster.begin = t + 1;
+        runningMisses = 0;
+        cache.clear();
+      }
+    }
+  }
+
+  // area weighted centroid and normal of the clusters
+  Vector3 meshCentroid(0.0f, 0.0f, 0.0f);
+  float meshArea = 0.0f;
+  Array<Vector3> centroids;
+  Array<Vector3> normals;
+  centroids.resize(clusters.size());
+  normals.resize(clusters.size());
+
+  for (uint32 c = 0; c < clusters.size(); ++c)
+  {
+    Vector3 centroid(0.0f, 0.0f, 0.0f);
+    Vector3 normal(0.0f, 0.0f, 0.0f);
+    float area = 0.0f;
+    for (uint32 t = clusters[c].begin; t < clusters[c].end; ++t)
+    {
+      const uint32* triangle = &indices[t * 3];
+      const Vector3 p0(positions.x[triangle[0]], positions.y[triangle[0]], positions.z[triangle[0]]);
+      const Vector3 p1(positions.x[triangle[1]], positions.y[triangle[1]], positions.z[triangle[1]]);
+      const Vector3 p2(positions.x[triangle[2]], positions.y[triangle[2]], positions.z[triangle[2]]);
+
+      // twice the area
+      const Vector3 n = cross(p1 - p0, p2 - p0);
+      const float triangleArea = length(n);
+      centroid = centroid + (p0 + p1 + p2) * (triangleArea / 3.0f);
+      normal = normal + n;
+      area += triangleArea;
+    }
+
+    meshCentroid = meshCentroid + centroid;
+    meshArea += area;
+    centroids[c] = area > 0.0f ? centroid / area : centroid;
+    normals[c] = dot(normal, normal) > 0.0f ? normalize(normal) : normal;
+  }
+
+  if (meshArea > 0.0f)
+    meshCentroid = meshCentroid / meshArea;
+
+  // clusters on the outside facing outwards are likely to occlude the rest
+  for (uint32 c = 0; c < clusters.size(); ++c)
+    clusters[c].sortKey = dot(centroids[c] - meshCentroid, normals[c]);
+
+  std::stable_sort(clusters.begin(), clusters.end());
+
+  uint32 n = 0;
+  for (uint32 c = 0; c < clusters.size(); ++c)
+  {
+    for (uint32 i = clusters[c].begin * 3; i < clusters[c].end * 3; ++i)
+      result[n++] = indices[i];
+  }
+}
+
+OverdrawStatistics analyzeOverdraw(const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices)
+{
+  OverdrawStatistics statistics;
+  statistics.numCovered = 0;
+  statistics.numShaded = 0;
+  statistics.overdraw = 0.0f;
+
+  Vector3 minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+  Vector3 maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+  for (uint32 i = 0; i < numIndices; ++i)
+  {
+    const uint32 v = indices[i];
+    const Vector3 position(positions.x[v], positions.y[v], positions.z[v]);
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+      minimum[axis] = min(minimum[axis], position[axis]);
+      maximum[axis] = max(maximum[axis], position[axis]);
+    }
+  }
+
+  Array<float> depth;
+  Array<RasterVertex> vertices;
+  vertices.resize(numVertices);
+
+  // every triangle is front facing in three of the views
+  for (uint32 view = 0; view < 6; ++view)
+  {
+    const uint32 axis = view / 2;
+    const float direction = view & 1 ? -1.0f : 1.0f;
+    const uint32 axisX = (axis + 1) % 3;
+    const uint32 axisY = (axis + 2) % 3;
+
+    const float scale = (float)(OverdrawViewportSize << SubPixelBits);
+    const float scaleX = maximum[axisX] > minimum[axisX] ? scale / (maximum[axisX] - minimum[axisX]) : 0.0f;
+    const float scaleY = maximum[axisY] > minimum[axisY] ? scale / (maximum[axisY] - minimum[axisY]) : 0.0f;
+
+    // unused vertices are converted as well, they are never read
+    for (uint32 v = 0; v < numVertices; ++v)
+    {
+      const float position[] = { positions.x[v], positions.y[v], positions.z[v] };
+      vertices[v].x = (int)((position[axisX] - minimum[axisX]) * scaleX);
+      vertices[v].y = (int)((position[axisY] - minimum[axisY]) * scaleY);
+      vertices[v].z = direction * position[axis];
+    }
+
+    depth.assign(OverdrawViewportSize * OverdrawViewportSize, FLT_MAX);
+    for (uint32 t = 0; t < numIndices / 3; ++t)
+    {
+      const RasterVertex& v0 = vertices[indices[t * 3 + 0]];
+      const RasterVertex& v1 = vertices[indices[t * 3 + 1]];
+      const RasterVertex& v2 = vertices[indices[t * 3 + 2]];
+
+      // looking down the other direction mirrors the projection, so the front faces are
+      // clockwise in one view and counter clockwise in the opposite one
+      const int area = edgeFunction(v0, v1, v2.x, v2.y);
+      if (area * direction >= 0.0f)
+        continue;
+
+      if (area > 0)
+        rasterizeTriangle(v0, v1, v2, depth, statistics);
+      else
+        rasterizeTriangle(v0, v2, v1, depth, statistics);
+    }
+  }
+
+  statistics.overdraw = statistics.numCovered ? (float)statistics.numShaded / statistics.numCovered : 0.0f;
+  return statistics;
+}
\ No newline at end of file
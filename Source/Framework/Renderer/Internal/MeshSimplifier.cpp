@@ -0,0 +1,491 @@
+#include "Core.h"
+#include "MeshSimplifier.h"
+#include <algorithm>
+
+namespace
+{
+  enum eVertexKind
+  {
+    VK_MANIFOLD,  // inside the surface, collapses onto any neighbour
+    VK_BORDER,    // on an open border, only along the border
+    VK_SEAM,      // two vertices with the same position, only along the seam
+    VK_LOCKED     // corners, non-manifold vertices and everything else
+  };
+
+  const uint32 InvalidVertex = ~0u;
+
+  // collapse goal of a pass, collapses with a much higher error than the one at the goal
+  // wait for the next pass, the quadrics have changed by then
+  const float PassErrorBound = 1.5f;
+
+  // border and seam edges get a plane perpendicular to the triangle, it keeps them in place
+  const float EdgeWeight = 2.0f;
+
+  // squared cross product of a triangle without an orientation, on the unit cube
+  const float DegenerateArea = 1e-16f;
+
+  // symmetric 4x4 matrix of the plane equations, the error of a point is p^T A p + 2 b p + c.
+  // the planes are weighted, the error is divided by the sum of the weights so it stays a squared
+  // distance
+  struct Quadric
+  {
+    float a00, a11, a22;
+    float a01, a02, a12;
+    float b0, b1, b2;
+    float c;
+    float weight;
+  };
+
+  void addPlane(Quadric& q, const Vector3& normal, float distance, float weight)
+  {
+    q.a00 += weight * normal.x * normal.x;
+    q.a11 += weight * normal.y * normal.y;
+    q.a22 += weight * normal.z * normal.z;
+    q.a01 += weight * normal.x * normal.y;
+    q.a02 += weight * normal.x * normal.z;
+    q.a12 += weight * normal.y * normal.z;
+    q.b0 += weight * normal.x * distance;
+    q.b1 += weight * normal.y * distance;
+    q.b2 += weight * normal.z * distance;
+    q.c += weight * distance * distance;
+    q.weight += weight;
+  }
+
+  void addQuadric(Quadric& q, const Quadric& other)
+  {
+    q.a00 += other.a00;
+    q.a11 += other.a11;
+    q.a22 += other.a22;
+    q.a01 += other.a01;
+    q.a02 += other.a02;
+    q.a12 += other.a12;
+    q.b0 += other.b0;
+    q.b1 += other.b1;
+    q.b2 += other.b2;
+    q.c += other.c;
+    q.weight += other.weight;
+  }
+
+  float getError(const Quadric& q, const Vector3& p)
+  {
+    const float rx = q.a00 * p.x + q.a01 * p.y + q.a02 * p.z + q.b0;
+    const float ry = q.a01 * p.x + q.a11 * p.y + q.a12 * p.z + q.b1;
+    const float rz = q.a02 * p.x + q.a12 * p.y + q.a22 * p.z + q.b2;
+    const float error = p.x * rx + p.y * ry + p.z * rz + q.b0 * p.x + q.b1 * p.y + q.b2 * p.z + q.c;
+
+    // rounding may push it below zero
+    return q.weight > 0.0f ? max(error, 0.0f) / q.weight : 0.0f;
+  }
+
+  // outgoing half edges of every vertex
+  struct EdgeAdjacency
+  {
+    void build(const uint32* indices, uint32 numIndices, uint32 numVertices, const uint32* remap)
+    {
+      offsets.assign(numVertices + 1, 0);
+      targets.resize(numIndices);
+
+      for (uint32 i = 0; i < numIndices; ++i)
+        ++offsets[remap[indices[i]] + 1];
+      for (uint32 v = 0; v < numVertices; ++v)
+        offsets[v + 1] += offsets[v];
+
+      Array<uint32> cursors(offsets);
+      for (uint32 t = 0; t < numIndices / 3; ++t)
+      {
+        for (uint32 k = 0; k < 3; ++k)
+        {
+          const uint32 a = remap[indices[t * 3 + k]];
+          const uint32 b = remap[indices[t * 3 + (k + 1) % 3]];
+          targets[cursors[a]++] = b;
+        }
+      }
+    }
+
+    bool hasEdge(uint32 a, uint32 b) const
+    {
+      for (uint32 i = offsets[a]; i < offsets[a + 1]; ++i)
+      {
+        if (targets[i] == b)
+          return true;
+      }
+      return false;
+    }
+
+    Array<uint32> offsets;
+    Array<uint32> targets;
+  };
+
+  struct Collapse
+  {
+    uint32 v0;
+    uint32 v1;
+    float error;
+
+    bool operator<(const Collapse& other) const { return error < other.error; }
+  };
+
+  struct PositionLess
+  {
+    PositionLess(const Vector3SoA& positions) : positions(positions) {}
+
+    // by the bits, ties keep the vertex order
+    bool operator()(uint32 a, uint32 b) const
+    {
+      const float pa[] = { positions.x[a], positions.y[a], positions.z[a] };
+      const float pb[] = { positions.x[b], positions.y[b], positions.z[b] };
+      const int order = memcmp(pa, pb, sizeof(pa));
+      return order < 0 || (order == 0 && a < b);
+    }
+
+    const Vector3SoA& positions;
+  };
+
+  // the neighbour of v in a border or seam loop after the collapses of a pass. when the edge to
+  // the neighbour itself collapsed onto v, the loop continues with the neighbour's neighbour
+  inline uint32 remapLoop(const Array<uint32>& loop, const Array<uint32>& collapseRemap, uint32 v)
+  {
+    const uint32 next = loop[v];
+    if (next == InvalidVertex)
+      return next;
+
+    const uint32 target = collapseRemap[next];
+    if (target != v)
+      return target;
+
+    return loop[next] == InvalidVertex ? InvalidVertex : collapseRemap[loop[next]];
+  }
+}
+
+uint32 simplifyMesh(uint32* result, const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices,
+  uint32 targetIndexCount, float maxError, bool lockBorder, float* error)
+{
+  if (result != indices)
+    memcpy(result, indices, numIndices * sizeof(uint32));
+  if (error)
+    *error = 0.0f;
+
+  // vertices with the same position share a representative, the wedges of a position are linked
+  // in a ring
+  Array<uint32> remap;
+  Array<uint32> wedge;
+  remap.resize(numVertices);
+  wedge.resize(numVertices);
+  {
+    Array<uint32> order;
+    order.resize(numVertices);
+    for (uint32 v = 0; v < numVertices; ++v)
+      order[v] = v;
+    std::sort(order.begin(), order.end(), PositionLess(positions));
+
+    for (uint32 i = 0; i < numVertices; )
+    {
+      uint32 end = i + 1;
+      while (end < numVertices && positions.x[order[end]] == positions.x[order[i]] && positions.y[order[end]] == positions.y[order[i]] &&
+        positions.z[order[end]] == positions.z[order[i]])
+        ++end;
+
+      for (uint32 j = i; j < end; ++j)
+      {
+        remap[order[j]] = order[i];
+        wedge[order[j]] = order[j + 1 < end ? j + 1 : i];
+      }
+      i = end;
+    }
+  }
+
+  // the quadrics work on the unit cube, far away meshes would lose too much precision
+  Vector3 minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+  Vector3 maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+  for (uint32 i = 0; i < numIndices; ++i)
+  {
+    const uint32 v = indices[i];
+    minimum = Vector3(min(minimum.x, positions.x[v]), min(minimum.y, positions.y[v]), min(minimum.z, positions.z[v]));
+    maximum = Vector3(max(maximum.x, positions.x[v]), max(maximum.y, positions.y[v]), max(maximum.z, positions.z[v]));
+  }
+
+  const float extent = max(maximum.x - minimum.x, max(maximum.y - minimum.y, maximum.z - minimum.z));
+  const float scale = extent > 0.0f ? 1.0f / extent : 0.0f;
+  Array<Vector3> points;
+  points.resize(numVertices);
+  for (uint32 v = 0; v < numVertices; ++v)
+    points[v] = Vector3(positions.x[v] - minimum.x, positions.y[v] - minimum.y, positions.z[v] - minimum.z) * scale;
+
+  // half edges without an opposite, openOut is the next vertex along the border or seam and
+  // openIn the previous one. more than one makes the vertex a locked one
+  Array<uint32> openOut;
+  Array<uint32> openIn;
+  Array<uint32> numOpenOut;
+  Array<uint32> numOpenIn;
+  openOut.resize(numVertices, InvalidVertex);
+  openIn.resize(numVertices, InvalidVertex);
+  numOpenOut.resize(numVertices, 0);
+  numOpenIn.resize(numVertices, 0);
+  {
+    Array<uint32> identity;
+    identity.resize(numVertices);
+    for (uint32 v = 0; v < numVertices; ++v)
+      identity[v] = v;
+
+    EdgeAdjacency adjacency;
+    adjacency.build(indices, numIndices, numVertices, &identity[0]);
+    for (uint32 i = 0; i < numIndices; ++i)
+    {
+      const uint32 a = indices[i];
+      const uint32 b = indices[i - i % 3 + (i + 1) % 3];
+      if (!adjacency.hasEdge(b, a))
+      {
+        openOut[a] = b;
+        ++numOpenOut[a];
+        openIn[b] = a;
+        ++numOpenIn[b];
+      }
+    }
+  }
+
+  Array<ubyte> kinds;
+  kinds.resize(numVertices, VK_LOCKED);
+  for (uint32 v = 0; v < numVertices; ++v)
+  {
+    if (remap[v] != v)
+      continue;
+
+    ubyte kind = VK_LOCKED;
+    const uint32 w = wedge[v];
+    if (w == v)
+    {
+      if (numOpenOut[v] == 0 && numOpenIn[v] == 0)
+        kind = VK_MANIFOLD;
+      else if (numOpenOut[v] == 1 && numOpenIn[v] == 1 && !lockBorder)
+        kind = VK_BORDER;
+    }
+    else if (wedge[w] == v)
+    {
+      // both sides of the seam continue to the same positions
+      if (numOpenOut[v] == 1 && numOpenIn[v] == 1 && numOpenOut[w] == 1 && numOpenIn[w] == 1 &&
+        remap[openOut[v]] == remap[openIn[w]] && remap[openIn[v]] == remap[openOut[w]])
+        kind = VK_SEAM;
+    }
+
+    for (uint32 u = v; ; u = wedge[u])
+    {
+      kinds[u] = kind;
+      if (wedge[u] == v)
+        break;
+    }
+  }
+
+  // area weighted planes of the triangles and the planes along borders and seams
+  Array<Quadric> quadrics;
+  quadrics.resize(numVertices);
+  memset(&quadrics[0], 0, numVertices * sizeof(Quadric));
+  for (uint32 t = 0; t < numIndices / 3; ++t)
+  {
+    const uint32* triangle = &indices[t * 3];
+    const Vector3& p0 = points[triangle[0]];
+    const Vector3 normal = cross(points[triangle[1]] - p0, points[triangle[2]] - p0);
+    const float area = length(normal);
+    if (area == 0.0f)
+      continue;
+
+    const Vector3 n = normal / area;
+    for (uint32 k = 0; k < 3; ++k)
+      addPlane(quadrics[remap[triangle[k]]], n, -dot(n, p0), area);
+
+    for (uint32 k = 0; k < 3; ++k)
+    {
+      const uint32 a = triangle[k];
+      const uint32 b = triangle[(k + 1) % 3];
+      if (openOut[a] != b || numOpenOut[a] != 1)
+        continue;
+
+      const Vector3 edge = points[b] - points[a];
+      const float edgeLength = length(edge);
+      if (edgeLength == 0.0f)
+        continue;
+
+      const Vector3 edgeNormal = normalize(cross(edge, n));
+      addPlane(quadrics[remap[a]], edgeNormal, -dot(edgeNormal, points[a]), edgeLength * EdgeWeight);
+      addPlane(quadrics[remap[b]], edgeNormal, -dot(edgeNormal, points[a]), edgeLength * EdgeWeight);
+    }
+  }
+
+  EdgeAdjacency positionAdjacency;
+  Array<uint32> triangleOffsets;
+  Array<uint32> vertexTriangles;
+  Array<Collapse> collapses;
+  Array<uint32> collapseRemap;
+  Array<ubyte> collapseLocked;
+  Array<uint32> loopOut;
+  Array<uint32> loopIn;
+  collapseRemap.resize(numVertices);
+  loopOut.resize(numVertices);
+  loopIn.resize(numVertices);
+
+  uint32 count = numIndices;
+  float resultError = 0.0f;
+  const float maxQuadricError = maxError < FLT_MAX ? maxError * scale * maxError * scale : FLT_MAX;
+
+  while (count > targetIndexCount)
+  {
+    positionAdjacency.build(result, count, numVertices, &remap[0]);
+
+    // every edge once, in the direction with the smaller error
+    collapses.clear();
+    for (uint32 i = 0; i < count; ++i)
+    {
+      const uint32 a = result[i];
+      const uint32 b = result[i - i % 3 + (i + 1) % 3];
+      if (remap[a] > remap[b] && positionAdjacency.hasEdge(remap[b], remap[a]))
+        continue;
+
+      Collapse collapse;
+      collapse.error = FLT_MAX;
+      for (uint32 direction = 0; direction < 2; ++direction)
+      {
+        const uint32 v0 = direction ? b : a;
+        const uint32 v1 = direction ? a : b;
+        const uint32 kind = kinds[v0];
+        const bool alongLoop = openOut[v0] == v1 || openIn[v0] == v1;
+        const bool alongSeam = alongLoop && (openOut[wedge[v0]] == wedge[v1] || openIn[wedge[v0]] == wedge[v1]);
+
+        if (kind == VK_LOCKED || (kind == VK_BORDER && (kinds[v1] != VK_BORDER || !alongLoop)) ||
+          (kind == VK_SEAM && (kinds[v1] != VK_SEAM || !alongSeam)))
+          continue;
+
+        const float e = getError(quadrics[remap[v0]], points[v1]);
+        if (e < collapse.error)
+        {
+          collapse.v0 = v0;
+          collapse.v1 = v1;
+          collapse.error = e;
+        }
+      }
+
+      if (collapse.error < FLT_MAX)
+        collapses.push_back(collapse);
+    }
+
+    if (collapses.empty())
+      break;
+
+    std::sort(collapses.begin(), collapses.end());
+
+    // a manifold collapse removes two triangles
+    const uint32 triangleGoal = (count - targetIndexCount) / 3;
+    const uint32 goalIndex = min((uint32)collapses.size() - 1, max(triangleGoal / 2, 1u) - 1);
+    uint32 limitIndex = goalIndex;
+    float passError = collapses[limitIndex].error * PassErrorBound;
+
+    // the triangles of every vertex, for the flip test
+    triangleOffsets.assign(numVertices + 1, 0);
+    vertexTriangles.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+      ++triangleOffsets[result[i] + 1];
+    for (uint32 v = 0; v < numVertices; ++v)
+      triangleOffsets[v + 1] += triangleOffsets[v];
+    {
+      Array<uint32> cursors(triangleOffsets);
+      for (uint32 i = 0; i < count; ++i)
+        vertexTriangles[cursors[result[i]]++] = i / 3;
+    }
+
+    for (uint32 v = 0; v < numVertices; ++v)
+      collapseRemap[v] = v;
+    collapseLocked.assign(numVertices, 0);
+
+    uint32 numRemoved = 0;
+    uint32 numCollapses = 0;
+    for (uint32 c = 0; c < collapses.size() && numRemoved < triangleGoal; ++c)
+    {
+      const Collapse& collapse = collapses[c];
+      if (collapse.error > passError)
+        break;
+      if (collapse.error > maxQuadricError)
+        break;
+
+      const uint32 v0 = collapse.v0;
+      const uint32 v1 = collapse.v1;
+      if (collapseLocked[remap[v0]] || collapseLocked[remap[v1]])
+        continue;
+
+      // no triangle around the moving position may turn around
+      bool flips = false;
+      for (uint32 w = v0; !flips; )
+      {
+        for (uint32 i = triangleOffsets[w]; i < triangleOffsets[w + 1] && !flips; ++i)
+        {
+          const uint32* triangle = &result[vertexTriangles[i] * 3];
+          const uint32 k = triangle[0] == w ? 0 : triangle[1] == w ? 1 : 2;
+          const uint32 a = collapseRemap[triangle[(k + 1) % 3]];
+          const uint32 b = collapseRemap[triangle[(k + 2) % 3]];
+          if (remap[a] == remap[v1] || remap[b] == remap[v1])
+            continue;
+
+          const Vector3 before = cross(points[a] - points[w], points[b] - points[w]);
+          const Vector3 after = cross(points[a] - points[v1], points[b] - points[v1]);
+
+          // slivers have no orientation to lose
+          flips = dot(before, after) <= 0.0f && dot(before, before) > DegenerateArea;
+        }
+
+        w = wedge[w];
+        if (w == v0)
+          break;
+      }
+
+      // a rejected collapse makes room for the next one
+      if (flips)
+      {
+        if (limitIndex + 1 < collapses.size())
+          passError = collapses[++limitIndex].error * PassErrorBound;
+        continue;
+      }
+
+      // the other side of a seam follows
+      collapseRemap[v0] = v1;
+      if (kinds[v0] == VK_SEAM)
+        collapseRemap[wedge[v0]] = wedge[v1];
+
+      addQuadric(quadrics[remap[v1]], quadrics[remap[v0]]);
+      collapseLocked[remap[v0]] = 1;
+      collapseLocked[remap[v1]] = 1;
+
+      numRemoved += kinds[v0] == VK_BORDER ? 1 : 2;
+      resultError = max(resultError, collapse.error);
+      ++numCollapses;
+    }
+
+    if (numCollapses == 0)
+      break;
+
+    loopOut.swap(openOut);
+    loopIn.swap(openIn);
+    for (uint32 v = 0; v < numVertices; ++v)
+    {
+      openOut[v] = remapLoop(loopOut, collapseRemap, v);
+      openIn[v] = remapLoop(loopIn, collapseRemap, v);
+    }
+
+    // triangles collapsed to a line are dropped
+    uint32 newCount = 0;
+    for (uint32 i = 0; i < count; i += 3)
+    {
+      const uint32 a = collapseRemap[result[i + 0]];
+      const uint32 b = collapseRemap[result[i + 1]];
+      const uint32 c = collapseRemap[result[i + 2]];
+      if (remap[a] == remap[b] || remap[a] == remap[c] || remap[b] == remap[c])
+        continue;
+
+      result[newCount++] = a;
+      result[newCount++] = b;
+      result[newCount++] = c;
+    }
+    count = newCount;
+  }
+
+  if (error)
+    *error = sqrt(resultError) * extent;
+
+  return count;
+}
\ No newline at end of file
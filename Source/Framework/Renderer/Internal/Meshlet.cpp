@@ -0,0 +1,281 @@
+#include "Core.h"
+#include "Meshlet.h"
+
+namespace
+{
+  const uint32 NoTriangle = ~0u;
+
+  // cones wider than this can't be culled from any direction worth testing
+  const float MinConeCosine = 0.1f;
+
+  struct MeshletBuilder
+  {
+    MeshletBuilder(const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices)
+      : indices(indices)
+      , numTriangles(numIndices / 3)
+    {
+      // the triangles of every vertex
+      offsets.assign(numVertices + 1, 0);
+      triangles.resize(numIndices);
+      for (uint32 i = 0; i < numIndices; ++i)
+        ++offsets[indices[i] + 1];
+      for (uint32 v = 0; v < numVertices; ++v)
+        offsets[v + 1] += offsets[v];
+
+      Array<uint32> cursors(offsets);
+      for (uint32 i = 0; i < numIndices; ++i)
+        triangles[cursors[indices[i]]++] = i / 3;
+
+      used.assign(numTriangles, 0);
+      live.resize(numVertices);
+      for (uint32 v = 0; v < numVertices; ++v)
+        live[v] = offsets[v + 1] - offsets[v];
+      stamps.assign(numVertices, 0);
+      centroids.resize(numTriangles);
+      for (uint32 t = 0; t < numTriangles; ++t)
+      {
+        Vector3 sum(0.0f, 0.0f, 0.0f);
+        for (uint32 k = 0; k < 3; ++k)
+        {
+          const uint32 v = indices[t * 3 + k];
+          sum = sum + Vector3(positions.x[v], positions.y[v], positions.z[v]);
+        }
+        centroids[t] = sum / 3.0f;
+      }
+    }
+
+    // vertices of t not yet in the meshlet
+    uint32 getNewVertices(uint32 t, uint32 stamp) const
+    {
+      return (stamps[indices[t * 3 + 0]] != stamp) + (stamps[indices[t * 3 + 1]] != stamp) + (stamps[indices[t * 3 + 2]] != stamp);
+    }
+
+    // the free triangle around the vertices that adds the fewest vertices. ties go to the one
+    // whose vertices have the fewest free triangles left, so no islands are left behind, and
+    // then to the one closest to the center of the meshlet
+    uint32 findNeighbour(const uint32* vertices, uint32 count, uint32 stamp, uint32 maxNewVertices, const Vector3& center) const
+    {
+      uint32 best = NoTriangle;
+      uint32 bestNewVertices = 3;
+      uint32 bestLiveTriangles = ~0u;
+      float bestDistance = FLT_MAX;
+      for (uint32 i = 0; i < count; ++i)
+      {
+        for (uint32 j = offsets[vertices[i]]; j < offsets[vertices[i] + 1]; ++j)
+        {
+          const uint32 t = triangles[j];
+          if (used[t])
+            continue;
+
+          const uint32 newVertices = getNewVertices(t, stamp);
+          if (newVertices > maxNewVertices || newVertices > bestNewVertices)
+            continue;
+
+          const uint32 liveTriangles = live[indices[t * 3 + 0]] + live[indices[t * 3 + 1]] + live[indices[t * 3 + 2]];
+          if (newVertices == bestNewVertices && liveTriangles > bestLiveTriangles)
+            continue;
+
+          const Vector3 offset = centroids[t] - center;
+          const float distance = dot(offset, offset);
+          if (newVertices < bestNewVertices || liveTriangles < bestLiveTriangles || distance < bestDistance)
+          {
+            best = t;
+            bestNewVertices = newVertices;
+            bestLiveTriangles = liveTriangles;
+            bestDistance = distance;
+          }
+        }
+      }
+
+      return best;
+    }
+
+    const uint32* indices;
+    uint32 numTriangles;
+    Array<uint32> offsets;
+    Array<uint32> triangles;
+    Array<ubyte> used;
+    Array<uint32> live;           // free triangles of every vertex
+    Array<uint32> stamps;         // meshlet number + 1 of the vertices in the current meshlet
+    Array<Vector3> centroids;
+  };
+
+  void computeBounds(MeshletArrays& meshlets, uint32 m, const uint32* indices, const Vector3SoA& positions)
+  {
+    const uint32 first = meshlets.firstIndex[m];
+    const uint32 count = meshlets.numIndices[m];
+
+    AABB box;
+    Vector3 normalSum(0.0f, 0.0f, 0.0f);
+    for (uint32 i = first; i < first + count; i += 3)
+    {
+      Vector3 p[3];
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        p[k] = Vector3(positions.x[indices[i + k]], positions.y[indices[i + k]], positions.z[indices[i + k]]);
+        box.merge(p[k]);
+      }
+
+      const Vector3 normal = cross(p[1] - p[0], p[2] - p[0]);
+      const float area = length(normal);
+      if (area > 0.0f)
+        normalSum = normalSum + normal / area;
+    }
+
+    const Vector3 center = box.getCenter();
+    float radius = 0.0f;
+    for (uint32 i = first; i < first + count; ++i)
+    {
+      const Vector3 offset = Vector3(positions.x[indices[i]], positions.y[indices[i]], positions.z[indices[i]]) - center;
+      radius = max(radius, dot(offset, offset));
+    }
+
+    meshlets.center.x[m] = center.x;
+    meshlets.center.y[m] = center.y;
+    meshlets.center.z[m] = center.z;
+    meshlets.radius[m] = sqrt(radius);
+
+    // the smallest cosine of a normal to the axis
+    const float axisLength = length(normalSum);
+    const Vector3 axis = axisLength > 0.0f ? normalSum / axisLength : Vector3(0.0f, 0.0f, 0.0f);
+    float minCosine = axisLength > 0.0f ? 1.0f : -1.0f;
+    for (uint32 i = first; i < first + count; i += 3)
+    {
+      const Vector3 p0(positions.x[indices[i]], positions.y[indices[i]], positions.z[indices[i]]);
+      const Vector3 p1(positions.x[indices[i + 1]], positions.y[indices[i + 1]], positions.z[indices[i + 1]]);
+      const Vector3 p2(positions.x[indices[i + 2]], positions.y[indices[i + 2]], positions.z[indices[i + 2]]);
+      const Vector3 normal = cross(p1 - p0, p2 - p0);
+      const float area = length(normal);
+      if (area > 0.0f)
+        minCosine = min(minCosine, dot(axis, normal) / area);
+    }
+
+    meshlets.coneAxis.x[m] = axis.x;
+    meshlets.coneAxis.y[m] = axis.y;
+    meshlets.coneAxis.z[m] = axis.z;
+    meshlets.coneCutoff[m] = minCosine < MinConeCosine ? 1.0f : sqrt(1.0f - minCosine * minCosine);
+  }
+}
+
+MeshletArrays::MeshletArrays(void* block, uint32 numMeshlets)
+  : numMeshlets(numMeshlets)
+{
+  uint32* arrays = (uint32*)block;
+  firstIndex = arrays;
+  numIndices = arrays + numMeshlets;
+  center = Vector3SoA((float*)arrays + numMeshlets * 2, (float*)arrays + numMeshlets * 3, (float*)arrays + numMeshlets * 4);
+  radius = (float*)arrays + numMeshlets * 5;
+  coneAxis = Vector3SoA((float*)arrays + numMeshlets * 6, (float*)arrays + numMeshlets * 7, (float*)arrays + numMeshlets * 8);
+  coneCutoff = (float*)arrays + numMeshlets * 9;
+}
+
+uint32 buildMeshlets(Array<ubyte>& block, uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices,
+  uint32 maxVertices, uint32 maxTriangles)
+{
+  MeshletBuilder builder(indices, numIndices, positions, numVertices);
+
+  Array<uint32> order;
+  Array<uint32> ranges;
+  Array<uint32> vertices;
+  order.reserve(builder.numTriangles);
+  vertices.reserve(maxVertices);
+
+  uint32 seed = 0;
+  for (uint32 stamp = 1; order.size() < builder.numTriangles; ++stamp)
+  {
+    while (builder.used[seed])
+      ++seed;
+
+    const uint32 first = order.size();
+    vertices.clear();
+    Vector3 sum(0.0f, 0.0f, 0.0f);
+
+    // a triangle next to the last one that adds no vertex is taken right away, otherwise all
+    // vertices of the meshlet are searched, so it grows evenly instead of in a thin strip
+    for (uint32 t = seed; t != NoTriangle; )
+    {
+      builder.used[t] = 1;
+      order.push_back(t);
+      sum = sum + builder.centroids[t];
+
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        const uint32 v = indices[t * 3 + k];
+        --builder.live[v];
+        if (builder.stamps[v] != stamp)
+        {
+          builder.stamps[v] = stamp;
+          vertices.push_back(v);
+        }
+      }
+
+      const uint32 numTriangles = order.size() - first;
+      if (numTriangles == maxTriangles)
+        break;
+
+      const Vector3 center = sum / (float)numTriangles;
+      const uint32 maxNewVertices = min<uint32>(maxVertices - vertices.size(), 3);
+      const uint32 last[3] = { indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2] };
+      t = builder.findNeighbour(last, 3, stamp, maxNewVertices, center);
+      if (t == NoTriangle || builder.getNewVertices(t, stamp) > 0)
+      {
+        const uint32 other = builder.findNeighbour(&vertices[0], vertices.size(), stamp, maxNewVertices, center);
+        if (other != NoTriangle)
+          t = other;
+      }
+    }
+
+    ranges.push_back(first);
+  }
+
+  // the triangles in meshlet order
+  Array<uint32> source;
+  source.assign(indices, indices + numIndices);
+  for (uint32 i = 0; i < order.size(); ++i)
+  {
+    for (uint32 k = 0; k < 3; ++k)
+      indices[i * 3 + k] = source[order[i] * 3 + k];
+  }
+
+  const uint32 numMeshlets = ranges.size();
+  block.resize(numMeshlets * MeshletStride);
+  if (numMeshlets == 0)
+    return 0;
+
+  MeshletArrays meshlets(&block[0], numMeshlets);
+  for (uint32 m = 0; m < numMeshlets; ++m)
+  {
+    const uint32 end = m + 1 < numMeshlets ? ranges[m + 1] : order.size();
+    meshlets.firstIndex[m] = ranges[m] * 3;
+    meshlets.numIndices[m] = (end - ranges[m]) * 3;
+    computeBounds(meshlets, m, indices, positions);
+  }
+
+  return numMeshlets;
+}
+
+uint32 cullMeshlets(void* result, const void* indices, uint32 indexSize, const MeshletArrays& meshlets, const Frustum& frustum,
+  const Vector3& cameraPosition)
+{
+  Array<uint32> visibility;
+  visibility.resize((meshlets.numMeshlets + 31) / 32);
+  cullSpheres(frustum, meshlets.center, meshlets.radius, meshlets.numMeshlets, visibility.empty() ? 0 : &visibility[0]);
+
+  // back facing if the camera is behind every triangle, seen from anywhere in the sphere
+  uint32 count = 0;
+  for (uint32 m = 0; m < meshlets.numMeshlets; ++m)
+  {
+    if (!isVisible(&visibility[0], m))
+      continue;
+
+    const Vector3 offset(meshlets.center.x[m] - cameraPosition.x, meshlets.center.y[m] - cameraPosition.y, meshlets.center.z[m] - cameraPosition.z);
+    const Vector3 axis(meshlets.coneAxis.x[m], meshlets.coneAxis.y[m], meshlets.coneAxis.z[m]);
+    if (dot(offset, axis) >= meshlets.coneCutoff[m] * length(offset) + meshlets.radius[m])
+      continue;
+
+    memcpy((ubyte*)result + count * indexSize, (const ubyte*)indices + meshlets.firstIndex[m] * indexSize, meshlets.numIndices[m] * indexSize);
+    count += meshlets.numIndices[m];
+  }
+
+  return count;
+}
\ No newline at end of file
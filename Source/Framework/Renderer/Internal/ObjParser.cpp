@@ -0,0 +1,427 @@
+#include "Core.h"
+#include "ObjParser.h"
+#include "NumberParser.h"
+#include "TaskScheduler.h"
+#include "Threading.h"
+
+namespace
+{
+  // smaller chunks don't pay for the task overhead
+  const uint32 MinChunkSize = 1 << 20;
+
+  struct ObjMaterialSwitch
+  {
+    String material;
+    uint32 firstFace;
+    uint32 firstVertex;
+  };
+
+  // parse results of one chunk. absolute indices are final right away, relative (negative)
+  // ones are resolved against the attributes of the chunk and fixed up during stitching
+  struct ObjChunk
+  {
+    ObjChunk() : begin(0), end(0), valid(true) {}
+
+    const char* begin;
+    const char* end;
+
+    Array<float> positions;
+    Array<float> normals;
+    Array<float> texcoords;
+    Array<ObjVertex> vertices;
+    Array<uint32> faceSizes;
+    // the faces before the first switch continue the material of the previous chunk
+    Array<ObjMaterialSwitch> materialSwitches;
+    // vertex * 3 + attribute (position, texcoord, normal)
+    Array<uint32> relativeIndices;
+    String materialLib;
+    bool valid;
+  };
+
+  // faces of one chunk going to one group
+  struct ObjGroupRange
+  {
+    uint32 group;
+    uint32 chunk;
+    uint32 firstFace, endFace;
+    uint32 firstVertex, endVertex;
+  };
+
+  inline bool isSpace(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r';
+  }
+
+  inline const char* skipSpaces(const char* p, const char* end)
+  {
+    while (p < end && isSpace(*p))
+      ++p;
+    return p;
+  }
+
+  inline bool startsWith(const char* p, const char* end, const char* keyword, uint32 length)
+  {
+    return (uint32)(end - p) > length && !strncmp(p, keyword, length) && isSpace(p[length]);
+  }
+
+  String readName(const char* p, const char* end)
+  {
+    p = skipSpaces(p, end);
+    while (end > p && isSpace(end[-1]))
+      --end;
+    return String(p, end);
+  }
+
+  // missing or malformed values are 0, the rest of the token is skipped
+  float readFloat(const char*& p, const char* end)
+  {
+    float value = 0.0f;
+    p = parseFloat(skipSpaces(p, end), end, value);
+    while (p < end && !isSpace(*p))
+      ++p;
+
+    return value;
+  }
+
+  // obj indices start at 1, 0 is returned for a missing index
+  int readIndex(const char*& p, const char* end)
+  {
+    int value = 0;
+    p = parseInt(p, end, value);
+    return value;
+  }
+
+  inline int resolveIndex(ObjChunk& chunk, int index, uint32 localCount, uint32 slot)
+  {
+    if (index > 0)
+      return index - 1;
+
+    if (index < 0)
+    {
+      chunk.relativeIndices.push_back(slot);
+      return (int)localCount + index;
+    }
+
+    return -1;
+  }
+
+  void parseVector(const char* p, const char* end, Array<float>& target)
+  {
+    const float x = readFloat(p, end);
+    const float y = readFloat(p, end);
+    const float z = readFloat(p, end);
+    target.push_back(x);
+    target.push_back(y);
+    target.push_back(z);
+  }
+
+  void parseFace(ObjChunk& chunk, const char* p, const char* end)
+  {
+    const uint32 firstVertex = chunk.vertices.size();
+    const uint32 firstRelativeIndex = chunk.relativeIndices.size();
+
+    // v, v/vt, v//vn or v/vt/vn
+    while (true)
+    {
+      p = skipSpaces(p, end);
+      if (p == end)
+        break;
+
+      const int position = readIndex(p, end);
+      int texcoord = 0;
+      int normal = 0;
+      if (p < end && *p == '/')
+      {
+        ++p;
+        if (p < end && *p != '/')
+          texcoord = readIndex(p, end);
+
+        if (p < end && *p == '/')
+        {
+          ++p;
+          normal = readIndex(p, end);
+        }
+      }
+
+      if (position == 0)
+      {
+        chunk.valid = false;
+        return;
+      }
+
+      const uint32 slot = chunk.vertices.size() * 3;
+
+      ObjVertex vertex;
+      vertex.position = resolveIndex(chunk, position, chunk.positions.size() / 3, slot);
+      vertex.texcoord = resolveIndex(chunk, texcoord, chunk.texcoords.size() / 3, slot + 1);
+      vertex.normal = resolveIndex(chunk, normal, chunk.normals.size() / 3, slot + 2);
+      chunk.vertices.push_back(vertex);
+
+      while (p < end && !isSpace(*p))
+        ++p;
+    }
+
+    // points and lines aren't rendered
+    const uint32 faceSize = chunk.vertices.size() - firstVertex;
+    if (faceSize < 3)
+    {
+      chunk.vertices.resize(firstVertex);
+      chunk.relativeIndices.resize(firstRelativeIndex);
+      return;
+    }
+
+    chunk.faceSizes.push_back(faceSize);
+  }
+
+  void parseLine(ObjChunk& chunk, const char* line, const char* end)
+  {
+    if (end - line < 2)
+      return;
+
+    if (line[0] == 'v')
+    {
+      if (isSpace(line[1]))
+        parseVector(line + 1, end, chunk.positions);
+      else if (line[1] == 't')
+        parseVector(line + 2, end, chunk.texcoords);
+      else if (line[1] == 'n')
+        parseVector(line + 2, end, chunk.normals);
+    }
+    else if (line[0] == 'f' && isSpace(line[1]))
+    {
+      parseFace(chunk, line + 1, end);
+    }
+    else if (startsWith(line, end, "usemtl", 6))
+    {
+      ObjMaterialSwitch materialSwitch;
+      materialSwitch.material = readName(line + 6, end);
+      materialSwitch.firstFace = chunk.faceSizes.size();
+      materialSwitch.firstVertex = chunk.vertices.size();
+      chunk.materialSwitches.push_back(materialSwitch);
+    }
+    else if (startsWith(line, end, "mtllib", 6) && chunk.materialLib.empty())
+    {
+      chunk.materialLib = readName(line + 6, end);
+    }
+  }
+
+  void parseChunk(ObjChunk& chunk)
+  {
+    const char* curr = chunk.begin;
+    while (curr < chunk.end && chunk.valid)
+    {
+      const char* lineEnd = (const char*)memchr(curr, '\n', chunk.end - curr);
+      if (!lineEnd)
+        lineEnd = chunk.end;
+
+      parseLine(chunk, skipSpaces(curr, lineEnd), lineEnd);
+      curr = lineEnd + 1;
+    }
+  }
+
+  void appendAttributes(Array<float>& source, Array<float>& dest, uint32 offset)
+  {
+    if (!source.empty())
+      memcpy(&dest[offset * 3], &source[0], source.size() * sizeof(float));
+
+    // the chunk copy isn't needed anymore
+    Array<float>().swap(source);
+  }
+
+  void addGroupRange(Array<ObjGroupRange>& ranges, uint32 group, uint32 chunk,
+    uint32 firstFace, uint32 endFace, uint32 firstVertex, uint32 endVertex)
+  {
+    if (firstFace == endFace)
+      return;
+
+    ObjGroupRange range;
+    range.group = group;
+    range.chunk = chunk;
+    range.firstFace = firstFace;
+    range.endFace = endFace;
+    range.firstVertex = firstVertex;
+    range.endVertex = endVertex;
+    ranges.push_back(range);
+  }
+}
+
+bool parseObj(const char* text, uint32 size, ObjData& data, uint32 numChunks)
+{
+  data.materialLib.clear();
+  data.positions.clear();
+  data.normals.clear();
+  data.texcoords.clear();
+  data.groups.clear();
+
+  if (numChunks == 0)
+    numChunks = min(size / MinChunkSize, (TaskScheduler::getNumWorkers() + 1) * 4);
+  numChunks = max<uint32>(numChunks, 1);
+
+  // split at line boundaries, a chunk may end up empty for very long lines
+  std::vector<ObjChunk> chunks(numChunks);
+  const char* end = text + size;
+  const char* begin = text;
+  for (uint32 i = 0; i < numChunks; ++i)
+  {
+    const char* split = end;
+    if (i + 1 < numChunks)
+    {
+      split = max(text + (uint64)size * (i + 1) / numChunks, begin);
+      const char* lineEnd = (const char*)memchr(split, '\n', end - split);
+      split = lineEnd ? lineEnd + 1 : end;
+    }
+
+    chunks[i].begin = begin;
+    chunks[i].end = split;
+    begin = split;
+  }
+
+  TaskScheduler::parallelFor(numChunks, 1, [&chunks](uint32 first, uint32 last) {
+    for (uint32 i = first; i < last; ++i)
+      parseChunk(chunks[i]);
+  });
+
+  // prefix sums of the attribute counts are the offsets of the chunks in the stitched arrays
+  std::vector<uint32> positionOffsets(numChunks);
+  std::vector<uint32> normalOffsets(numChunks);
+  std::vector<uint32> texcoordOffsets(numChunks);
+  uint32 numPositions = 0;
+  uint32 numNormals = 0;
+  uint32 numTexcoords = 0;
+  uint32 numMaterialSwitches = 0;
+
+  for (uint32 i = 0; i < numChunks; ++i)
+  {
+    const ObjChunk& chunk = chunks[i];
+    if (!chunk.valid)
+      return false;
+
+    positionOffsets[i] = numPositions;
+    normalOffsets[i] = numNormals;
+    texcoordOffsets[i] = numTexcoords;
+    numPositions += chunk.positions.size() / 3;
+    numNormals += chunk.normals.size() / 3;
+    numTexcoords += chunk.texcoords.size() / 3;
+    numMaterialSwitches += chunk.materialSwitches.size();
+
+    if (data.materialLib.empty())
+      data.materialLib = chunk.materialLib;
+  }
+
+  data.positions.resize(numPositions * 3);
+  data.normals.resize(numNormals * 3);
+  data.texcoords.resize(numTexcoords * 3);
+
+  // copy the attributes, fix up the relative indices and validate in parallel
+  volatile long failed = 0;
+  TaskScheduler::parallelFor(numChunks, 1, [&](uint32 first, uint32 last) {
+    for (uint32 i = first; i < last; ++i)
+    {
+      ObjChunk& chunk = chunks[i];
+      appendAttributes(chunk.positions, data.positions, positionOffsets[i]);
+      appendAttributes(chunk.normals, data.normals, normalOffsets[i]);
+      appendAttributes(chunk.texcoords, data.texcoords, texcoordOffsets[i]);
+
+      if (chunk.vertices.empty())
+        continue;
+
+      int* indices = &chunk.vertices[0].position;
+      const uint32 offsets[] = { positionOffsets[i], texcoordOffsets[i], normalOffsets[i] };
+      for (uint32 j = 0; j < chunk.relativeIndices.size(); ++j)
+      {
+        const uint32 slot = chunk.relativeIndices[j];
+        indices[slot] += offsets[slot % 3];
+      }
+
+      // -1 (not referenced) wraps around as well, the position is always referenced
+      bool valid = true;
+      for (uint32 j = 0; j < chunk.vertices.size(); ++j)
+      {
+        const ObjVertex& vertex = chunk.vertices[j];
+        valid &= (uint32)vertex.position < numPositions;
+        valid &= vertex.texcoord == -1 || (uint32)vertex.texcoord < numTexcoords;
+        valid &= vertex.normal == -1 || (uint32)vertex.normal < numNormals;
+      }
+
+      if (!valid)
+        atomicExchange(&failed, 1);
+    }
+  });
+
+  if (failed)
+    return false;
+
+  // group 0 collects the faces before the first usemtl, every usemtl starts a new group
+  // even if the material was used before
+  Array<ObjGroupRange> ranges;
+  data.groups.resize(numMaterialSwitches + 1);
+  uint32 group = 0;
+
+  for (uint32 i = 0; i < numChunks; ++i)
+  {
+    const ObjChunk& chunk = chunks[i];
+    uint32 face = 0;
+    uint32 vertex = 0;
+
+    for (uint32 j = 0; j < chunk.materialSwitches.size(); ++j)
+    {
+      const ObjMaterialSwitch& materialSwitch = chunk.materialSwitches[j];
+      addGroupRange(ranges, group, i, face, materialSwitch.firstFace, vertex, materialSwitch.firstVertex);
+
+      data.groups[++group].material = materialSwitch.material;
+      face = materialSwitch.firstFace;
+      vertex = materialSwitch.firstVertex;
+    }
+
+    addGroupRange(ranges, group, i, face, chunk.faceSizes.size(), vertex, chunk.vertices.size());
+  }
+
+  // sized up front, a group may span many chunks
+  std::vector<uint32> groupVertices(data.groups.size(), 0);
+  std::vector<uint32> groupFaces(data.groups.size(), 0);
+  for (uint32 i = 0; i < ranges.size(); ++i)
+  {
+    groupVertices[ranges[i].group] += ranges[i].endVertex - ranges[i].firstVertex;
+    groupFaces[ranges[i].group] += ranges[i].endFace - ranges[i].firstFace;
+  }
+
+  for (uint32 i = 0; i < data.groups.size(); ++i)
+  {
+    data.groups[i].vertices.reserve(groupVertices[i]);
+    data.groups[i].faceSizes.reserve(groupFaces[i]);
+  }
+
+  for (uint32 i = 0; i < ranges.size(); ++i)
+  {
+    const ObjGroupRange& range = ranges[i];
+    const ObjChunk& chunk = chunks[range.chunk];
+    ObjGroup& target = data.groups[range.group];
+
+    target.vertices.insert(target.vertices.end(),
+      chunk.vertices.begin() + range.firstVertex, chunk.vertices.begin() + range.endVertex);
+    target.faceSizes.insert(target.faceSizes.end(),
+      chunk.faceSizes.begin() + range.firstFace, chunk.faceSizes.begin() + range.endFace);
+  }
+
+  // drop the empty groups, swapped member wise to avoid copying the arrays
+  uint32 numGroups = 0;
+  for (uint32 i = 0; i < data.groups.size(); ++i)
+  {
+    if (data.groups[i].faceSizes.empty())
+      continue;
+
+    if (i != numGroups)
+    {
+      ObjGroup& target = data.groups[numGroups];
+      target.material.swap(data.groups[i].material);
+      target.vertices.swap(data.groups[i].vertices);
+      target.faceSizes.swap(data.groups[i].faceSizes);
+    }
+
+    ++numGroups;
+  }
+
+  data.groups.resize(numGroups);
+
+  return true;
+}
\ No newline at end of file
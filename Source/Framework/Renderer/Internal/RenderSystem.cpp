@@ -155,6 +155,7 @@ RenderSystem::RenderSystem()
   , m_backBufferDSV(0)
   , m_backBufferRTV(0)
   , m_isFullScreen(false)
+  , m_syncInterval(1)
   , m_stateCache(0)
 {
 }
@@ -251,6 +252,8 @@ bool RenderSystem::init(void* windowHandle, const InitParams& params)
       VALIDATE(factory->CreateSwapChain(m_device, &sd, &m_swapChain));
     }
 
+    m_syncInterval = params.vsync ? 1 : 0;
+
     if (params.fullscreen)
     {
       m_isFullScreen = SUCCEEDED(m_swapChain->SetFullscreenState(TRUE, output));
@@ -380,7 +383,7 @@ void RenderSystem::beginFrame()
 
 void RenderSystem::endFrame()
 {
-  m_swapChain->Present(1, 0);
+  m_swapChain->Present(m_syncInterval, 0);
 }
 
 void RenderSystem::beginRenderTargetSetup()
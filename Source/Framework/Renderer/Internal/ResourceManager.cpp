@@ -2,39 +2,357 @@
 #include "ResourceManager.h"
 #include "StringUtils.h"
 #include "Hash.h"
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+namespace
+{
+  // orders resource accesses for the lru eviction
+  volatile long s_accessClock = 0;
+
+  struct EvictionCandidate
+  {
+    long lastAccess;
+    uint32 hash;
+    String name;
+
+    bool operator<(const EvictionCandidate& other) const
+    {
+      return lastAccess < other.lastAccess;
+    }
+  };
+}
+
+ResourceHandle::ResourceHandle()
+  : m_entry(0)
+{
+}
+
+ResourceHandle::ResourceHandle(ResourceEntry* entry)
+  : m_entry(entry)
+{
+  if (m_entry)
+    atomicIncrement(&m_entry->refs);
+}
+
+ResourceHandle::ResourceHandle(const ResourceHandle& other)
+  : m_entry(other.m_entry)
+{
+  if (m_entry)
+    atomicIncrement(&m_entry->refs);
+}
+
+ResourceHandle::~ResourceHandle()
+{
+  release();
+}
+
+ResourceHandle& ResourceHandle::operator=(const ResourceHandle& other)
+{
+  if (m_entry != other.m_entry)
+  {
+    if (other.m_entry)
+      atomicIncrement(&other.m_entry->refs);
+
+    release();
+    m_entry = other.m_entry;
+  }
+
+  return *this;
+}
+
+void ResourceHandle::release()
+{
+  if (m_entry)
+  {
+    // stamp before dropping the reference, the entry may be evicted right after
+    m_entry->lastAccess = atomicIncrement(&s_accessClock);
+
+    // the manager is gone, the last handle frees the entry
+    if (atomicDecrement(&m_entry->refs) == ResourceEntry::Orphaned)
+    {
+      delete m_entry->resource;
+      delete m_entry;
+    }
+    m_entry = 0;
+  }
+}
+
+Resource* ResourceHandle::wait() const
+{
+  if (!m_entry)
+    return 0;
+
+  while (m_entry->state == RS_LOADING)
+  {
+    // the load might still be queued, so help out instead of blocking a worker
+    if (!TaskScheduler::executePendingTask())
+      m_entry->loaded.wait(1);
+  }
+
+  return m_entry->state == RS_READY ? m_entry->resource : 0;
+}
 
 ResourceManager::ResourceManager()
+  : m_memoryBudget(0)
+  , m_cpuBytesResident(0)
+  , m_gpuBytesResident(0)
+  , m_numResident(0)
+  , m_hits(0)
+  , m_misses(0)
+  , m_evictions(0)
+  , m_shuttingDown(0)
 {
 }
 
 ResourceManager::~ResourceManager()
 {
+  // normally done by the derived manager already, see shutdown
+  shutdown();
+
+  for (uint32 i = 0; i < NumShards; ++i)
+  {
+    ScopedLock lock(m_shards[i].lock);
+
+    for (ResourceTable::iterator it = m_shards[i].resources.begin();
+      it != m_shards[i].resources.end(); ++it)
+    {
+      // entries still referenced by handles are orphaned, the last handle frees them
+      if (atomicAdd(&it->second->refs, ResourceEntry::Orphaned) == ResourceEntry::Orphaned)
+        evictEntry(it->second);
+    }
+
+    m_shards[i].resources.clear();
+  }
 }
 
-Resource* ResourceManager::load(const String& fileName)
+void ResourceManager::shutdown()
 {
-  Resource* result = 0;
-  String name = PathUtils::getPath(fileName, true);
+  atomicExchange(&m_shuttingDown, 1);
+
+  // load tasks still reference their entries, let them finish first. not locked
+  // while waiting, a finishing load trims to the budget which locks the shards
+  for (uint32 i = 0; i < NumShards; ++i)
+  {
+    for (;;)
+    {
+      ResourceEntry* loading = 0;
+      {
+        ScopedLock lock(m_shards[i].lock);
+
+        for (ResourceTable::iterator it = m_shards[i].resources.begin();
+          it != m_shards[i].resources.end() && !loading; ++it)
+        {
+          if (it->second->state == RS_LOADING)
+            loading = it->second;
+        }
+      }
+
+      if (!loading)
+        break;
+
+      while (loading->state == RS_LOADING)
+      {
+        if (!TaskScheduler::executePendingTask())
+          loading->loaded.wait(1);
+      }
+    }
+  }
+}
+
+ResourceHandle ResourceManager::load(const String& fileName)
+{
+  String name = PathUtils::normalize(fileName);
   uint32 resourceHash = crc32Hash((const ubyte*)name.c_str(), name.length());
-  
-  ResourceTable::iterator it = m_resources.find(resourceHash);
-  if (it == m_resources.end())
+
+  Shard& shard = m_shards[resourceHash % NumShards];
+  ResourceEntry* entry = 0;
+  ResourceHandle handle;
+
   {
-    result = createResource(fileName);
-    m_resources.insert(std::make_pair(resourceHash, result));
+    ScopedLock lock(shard.lock);
+
+    ResourceTable::iterator it = shard.resources.find(name);
+    if (it != shard.resources.end())
+    {
+      atomicIncrement(&m_hits);
+      it->second->lastAccess = atomicIncrement(&s_accessClock);
+      return ResourceHandle(it->second);
+    }
+
+    atomicIncrement(&m_misses);
+
+    entry = new ResourceEntry(name, resourceHash);
+    entry->lastAccess = atomicIncrement(&s_accessClock);
+    shard.resources.insert(std::make_pair(name, entry));
+
+    // take the reference while locked, eviction checks it under the same lock
+    handle = ResourceHandle(entry);
   }
-  else
+
+  // only the first request issues the load, later ones join on the entry
+  TaskScheduler::submit([this, entry, fileName]() { loadEntry(entry, fileName); });
+
+  return handle;
+}
+
+void ResourceManager::loadEntry(ResourceEntry* entry, const String& fileName)
+{
+  Resource* resource = m_shuttingDown ? 0 : createResource(fileName);
+  if (resource)
   {
-    result = it->second;
+    entry->cpuMemorySize = resource->getCpuMemorySize();
+    entry->gpuMemorySize = resource->getGpuMemorySize();
+
+    {
+      ScopedLock lock(m_residencyLock);
+      m_cpuBytesResident += entry->cpuMemorySize;
+      m_gpuBytesResident += entry->gpuMemorySize;
+      ++m_numResident;
+    }
+
+    // the entry is still loading and won't be picked for eviction
+    trimToBudget();
   }
 
-  return result;
+  // publishing the state is the last access, after that the entry and the manager
+  // may go away. the event is manual reset, waiters simply poll the state again
+  entry->resource = resource;
+  entry->loaded.signal();
+  atomicExchange(&entry->state, resource ? RS_READY : RS_FAILED);
+}
+
+bool ResourceManager::evictEntry(ResourceEntry* entry)
+{
+  const bool wasResident = entry->resource != 0;
+  if (wasResident)
+  {
+    ScopedLock lock(m_residencyLock);
+    m_cpuBytesResident -= entry->cpuMemorySize;
+    m_gpuBytesResident -= entry->gpuMemorySize;
+    --m_numResident;
+  }
+
+  delete entry->resource;
+  delete entry;
+
+  return wasResident;
+}
+
+void ResourceManager::evict(uint64 targetBytes, bool allUnreferenced)
+{
+  std::vector<EvictionCandidate> candidates;
+
+  for (uint32 i = 0; i < NumShards; ++i)
+  {
+    ScopedLock lock(m_shards[i].lock);
+
+    for (ResourceTable::iterator it = m_shards[i].resources.begin();
+      it != m_shards[i].resources.end(); ++it)
+    {
+      const ResourceEntry* entry = it->second;
+      if (entry->refs == 0 && entry->state != RS_LOADING)
+      {
+        EvictionCandidate candidate;
+        candidate.lastAccess = entry->lastAccess;
+        candidate.hash = entry->hash;
+        candidate.name = entry->name;
+        candidates.push_back(candidate);
+      }
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+
+  for (uint32 i = 0; i < candidates.size(); ++i)
+  {
+    if (!allUnreferenced)
+    {
+      ScopedLock lock(m_residencyLock);
+      if (m_cpuBytesResident + m_gpuBytesResident <= targetBytes)
+        break;
+    }
+
+    Shard& shard = m_shards[candidates[i].hash % NumShards];
+    ScopedLock lock(shard.lock);
+
+    ResourceTable::iterator it = shard.resources.find(candidates[i].name);
+    if (it == shard.resources.end())
+      continue;
+
+    // might have been requested again since collecting the candidates
+    ResourceEntry* entry = it->second;
+    if (entry->refs != 0 || entry->state == RS_LOADING)
+      continue;
+
+    shard.resources.erase(it);
+    if (evictEntry(entry))
+      atomicIncrement(&m_evictions);
+  }
 }
 
 void ResourceManager::unload(Resource* resource)
 {
+  for (uint32 i = 0; i < NumShards; ++i)
+  {
+    ScopedLock lock(m_shards[i].lock);
+
+    for (ResourceTable::iterator it = m_shards[i].resources.begin();
+      it != m_shards[i].resources.end(); ++it)
+    {
+      ResourceEntry* entry = it->second;
+      if (entry->resource != resource)
+        continue;
+
+      // still referenced, the last handle going away makes it evictable
+      if (entry->refs == 0)
+      {
+        m_shards[i].resources.erase(it);
+        evictEntry(entry);
+      }
+      return;
+    }
+  }
 }
 
 void ResourceManager::unloadAll()
 {
+  evict(0, true);
+}
+
+void ResourceManager::setMemoryBudget(uint64 bytes)
+{
+  m_memoryBudget = bytes;
+  trimToBudget();
+}
+
+void ResourceManager::trimToBudget()
+{
+  const uint64 budget = m_memoryBudget;
+  if (budget == 0)
+    return;
+
+  {
+    ScopedLock lock(m_residencyLock);
+    if (m_cpuBytesResident + m_gpuBytesResident <= budget)
+      return;
+  }
+
+  evict(budget, false);
+}
+
+ResourceManagerStats ResourceManager::getStats() const
+{
+  ResourceManagerStats stats;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.evictions = m_evictions;
+
+  ScopedLock lock(m_residencyLock);
+  stats.numResident = m_numResident;
+  stats.cpuBytesResident = m_cpuBytesResident;
+  stats.gpuBytesResident = m_gpuBytesResident;
+
+  return stats;
 }
\ No newline at end of file
@@ -188,6 +188,18 @@ void Shader::setParamByName(const String& name, const float* value, uint32 size)
   memcpy(ptr, value, size);
 }
 
+bool Shader::hasParameter(const String& name) const
+{
+  for (ShaderParameterArray::const_iterator it = m_parameters.begin();
+    it != m_parameters.end(); ++it)
+  {
+    if (it->name == name)
+      return true;
+  }
+
+  return false;
+}
+
 void Shader::allocateCBuffer(uint32 index, uint32 size)
 {
   ASSERT(index < MAX_CONSTANT_BUFFERS, "index out of range");
@@ -204,8 +216,7 @@ void Shader::allocateCBuffer(uint32 index, uint32 size)
     desc.StructureByteStride = 0;
     desc.Usage = D3D11_USAGE_DYNAMIC;
 
-    WeakPtr<RenderSystem> renderSys = g_Game->getRenderSystem();
-    VALIDATE(renderSys->getDevicePtr()->CreateBuffer(&desc, NULL, &m_cbuffers[index].buffer));
+    VALIDATE(RENDER_DEVICE->CreateBuffer(&desc, NULL, &m_cbuffers[index].buffer));
 
     m_cbuffers[index].backingStore = (ubyte*)malloc(size);
     m_cbuffers[index].size = size;
@@ -262,8 +273,7 @@ VertexShader::~VertexShader()
 
 bool VertexShader::createShaderResource(const void* byteCode, uint32 byteCodeLen)
 {
-  WeakPtr<RenderSystem> renderSys = g_Game->getRenderSystem();
-  VALIDATE(renderSys->getDevicePtr()->CreateVertexShader(byteCode, byteCodeLen, NULL, &m_resource));
+  VALIDATE(RENDER_DEVICE->CreateVertexShader(byteCode, byteCodeLen, NULL, &m_resource));
 
   if (byteCode)
   {
@@ -285,7 +295,6 @@ PixelShader::~PixelShader()
 
 bool PixelShader::createShaderResource(const void* byteCode, uint32 byteCodeLen)
 {
-  WeakPtr<RenderSystem> renderSys = g_Game->getRenderSystem();
-  VALIDATE(renderSys->getDevicePtr()->CreatePixelShader(byteCode, byteCodeLen, NULL, &m_resource));
+  VALIDATE(RENDER_DEVICE->CreatePixelShader(byteCode, byteCodeLen, NULL, &m_resource));
   return true;
 }
\ No newline at end of file
@@ -90,8 +90,9 @@ SharedPtr<ShaderDrawBundle> ShaderDrawBundle::createShaderDrawBundle(SharedPtr<V
     case VEF_HALF4: format = DXGI_FORMAT_R16G16B16A16_FLOAT; break;
     case VEF_SHORT2: format = DXGI_FORMAT_R16G16_UINT; break;
     case VEF_SHORT4: format = DXGI_FORMAT_R16G16B16A16_UINT; break;
-    case VEF_SHORT4N: format = DXGI_FORMAT_R16G16B16A16_UNORM; break;
+    case VEF_SHORT4N: format = DXGI_FORMAT_R16G16B16A16_SNORM; break;
     case VEF_COLOR: format = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+    case VEF_BYTE4N: format = DXGI_FORMAT_R8G8B8A8_SNORM; break;
     }
 
     desc.Format = format;
@@ -40,13 +40,13 @@ struct tgaHeader
 Texture::Texture()
   : m_resource(0)
   , m_defaultSRV(0)
+  , m_gpuMemorySize(0)
 {
 }
 
 Texture::~Texture()
 {
-  SAFE_RELEASE(m_resource);
-  SAFE_RELEASE(m_defaultSRV);
+  unload();
 }
 
 bool Texture::load(const String& fileName)
@@ -65,6 +65,20 @@ bool Texture::load(const String& fileName)
 
 void Texture::unload()
 {
+  SAFE_RELEASE(m_defaultSRV);
+  SAFE_RELEASE(m_resource);
+  m_gpuMemorySize = 0;
+}
+
+uint32 Texture::getCpuMemorySize() const
+{
+  // pixel data is not kept around after upload
+  return sizeof(Texture);
+}
+
+uint32 Texture::getGpuMemorySize() const
+{
+  return m_gpuMemorySize;
 }
 
 void Texture::create(const TextureCreationInfo& info)
@@ -126,6 +140,7 @@ void Texture::create(const TextureCreationInfo& info)
     }
 
     m_resource = resource;
+    m_gpuMemorySize = desc.Width * desc.Height * desc.ArraySize * calcPitchForFormat(desc.Format);
 
     if (!isStaging)
     {
@@ -244,6 +259,8 @@ bool Texture::loadTarga(const DataBlob& data)
   ID3D11Texture2D* resource;
   VALIDATE(RENDER_DEVICE->CreateTexture2D(&desc, &subresourceData, &resource));
 
+  free(imageData);
+
   CD3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
   srvDesc.Texture2D.MipLevels = 1;
   srvDesc.Texture2D.MostDetailedMip = 0;
@@ -253,10 +270,16 @@ bool Texture::loadTarga(const DataBlob& data)
   VALIDATE(RENDER_DEVICE->CreateShaderResourceView(resource, &srvDesc, &m_defaultSRV));
 
   m_resource = resource;
+  m_gpuMemorySize = desc.Width * desc.Height * sizeof(uint32);
 
   return true;
 }
 
+TextureManager::~TextureManager()
+{
+  shutdown();
+}
+
 Resource* TextureManager::createResource(const String& fileName)
 {
   Texture* texture = new Texture();
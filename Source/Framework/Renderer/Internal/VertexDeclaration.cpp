@@ -50,6 +50,36 @@ const VertexElement* VertexDeclaration::getElement(uint32 index) const
   return 0;
 }
 
+uint32 VertexDeclaration::getStreamStride(uint32 stream) const
+{
+  uint32 stride = 0;
+  for (uint32 i = 0; i < m_numElements; ++i)
+  {
+    if (m_elements[i].stream == stream)
+      stride = max(stride, m_elements[i].byteOffset + sizeOfElementType(m_elements[i].format));
+  }
+
+  return stride;
+}
+
+uint32 VertexDeclaration::getVertexSize() const
+{
+  uint32 size = 0;
+  for (uint32 stream = 0; stream < MAX_VERTEX_STREAMS; ++stream)
+    size += getStreamStride(stream);
+
+  return size;
+}
+
+uint32 VertexDeclaration::getStreamMask() const
+{
+  uint32 mask = 0;
+  for (uint32 i = 0; i < m_numElements; ++i)
+    mask |= 1 << m_elements[i].stream;
+
+  return mask;
+}
+
 uint32 VertexDeclaration::sizeOfElementType(eVertexElementFormat format)
 {
   switch (format)
@@ -70,6 +100,8 @@ uint32 VertexDeclaration::sizeOfElementType(eVertexElementFormat format)
   case VEF_SHORT4N: return sizeof(short)*4;
   // special formats
   case VEF_COLOR: return sizeof(uint32);
+  // 8 bit integer formats
+  case VEF_BYTE4N: return sizeof(char)*4;
   }
 
   return 0;
@@ -9,6 +9,8 @@ public:
   DebugGeometryRenderer();
   ~DebugGeometryRenderer();
 
+  // compiling doesn't need the device, so this may run before/parallel to the render system init
+  bool compileShaders();
   void init();
   void shutdown();
   void prepareDebugRendering();
@@ -30,6 +32,8 @@ private:
   ID3D11InputLayout* m_inputLayout;
   DebugVertex* m_mappedMemory;
   DebugVertex* m_nextVertex;
+  DataBlob m_vertexShaderCode;
+  DataBlob m_pixelShaderCode;
   SharedPtr<VertexShader> m_vertexShader;
   SharedPtr<PixelShader> m_pixelShader;
   SharedPtr<VertexDeclaration> m_vertexDeclaration;
@@ -4,19 +4,26 @@
 #include "RenderSystemPrerequisites.h"
 
 #include "VertexDeclaration.h"
+#include "ResourceManager.h"
+#include "Bounds.h"
+#include "Vector3Stream.h"
+#include "MeshFile.h"
 
-#define MAX_VERTEX_STREAMS 5
-
+// the vector attributes are kept as structure of arrays for the batch kernels
 struct IntermediateMeshData
 {
-  Array<Vector3> position;
-  Array<Vector3> normal;
-  Array<Vector3> tangent;
-  Array<Vector3> bitangent;
+  Vector3Stream position;
+  Vector3Stream normal;
+  Vector3Stream tangent;
+  Vector3Stream bitangent;
   Array<Vector2> uv0;
   Array<Vector2> uv1;
   Array<Vector2> uv2;
   Array<uint32> indices;
+  // ranges of indices, finest first. empty for a single level
+  Array<MeshLod> lods;
+  // meshlets of the finest level, see buildMeshlets
+  Array<ubyte> meshlets;
 };
 
 enum eMeshOptions
@@ -26,10 +33,12 @@ enum eMeshOptions
   OPT_CREATE_TANGENTS      = 0x002,  // auto-create tangent vectors
   OPT_FIX_TANGENT_FRAME    = 0x004,  // fix tangent frame on mirror edges
   OPT_OPTIMIZE_FOR_CACHE   = 0x008,  // optimize data for vertex cache
+  OPT_OPTIMIZE_FOR_OVERDRAW = 0x080, // sort triangle clusters to reduce overdraw
+  OPT_BUILD_MESHLETS       = 0x100,  // split the finest level into meshlets for cpu culling
 
   // vertex layout options
   OPT_USE_MULTI_STREAM     = 0x010,  // split vertex attributes in multiple streams
-  OPT_16BIT_VERTEX_DATA    = 0x020,  // use half for pos, normal, ...
+  OPT_16BIT_VERTEX_DATA    = 0x020,  // 16 and 8 bit formats within the tolerances, see selectVertexFormats
   OPT_32BIT_INDEX_DATA     = 0x040,  // use 32-bit indices
 };
 
@@ -38,15 +47,36 @@ class MeshChunk
   friend class Mesh;
 
 public:
+  MeshChunk();
+
+  const AABB& getBounds() const { return m_bounds; }
+  const BoundingSphere& getBoundingSphere() const { return m_boundingSphere; }
+
 private:
   uint32 streamMask;
   uint32 indexCount;
-  uint32 vertexSize;
+  uint32 numLods;
+  MeshLod lods[MaxMeshLods];
+  DXGI_FORMAT indexFormat;
+  uint32 indexSize;
+  uint32 strides[MAX_VERTEX_STREAMS];
+  // VEF_SHORT4N positions are relative to the chunk bounds, identity otherwise
+  Vector3 positionScale;
+  Vector3 positionBias;
   ID3D11Buffer* streams[MAX_VERTEX_STREAMS];
   ID3D11Buffer* indices;
+  // the finest level is culled per meshlet and drawn from a dynamic buffer, the meshlet data and
+  // its indices are kept on the cpu
+  uint32 numMeshlets;
+  Array<ubyte> meshlets;
+  Array<ubyte> meshletIndices;
+  ID3D11Buffer* culledIndices;
+  // object space, computed from the positions when the chunk is created
+  AABB m_bounds;
+  BoundingSphere m_boundingSphere;
   //-->
-  Texture* m_diffuseMap;
-  Texture* m_bumpMap;
+  ResourceHandle m_diffuseMap;
+  ResourceHandle m_bumpMap;
   //<--
 };
 
@@ -61,16 +91,26 @@ public:
 
   void initDummyMaterial();
 
+  // union of all chunk bounds
+  const AABB& getBounds() const { return m_bounds; }
+  const BoundingSphere& getBoundingSphere() const { return m_boundingSphere; }
+
+  // cooks the obj at load time, see MeshCook.h
   static bool loadFromObj(const String& filename, Mesh& mesh);
+  // cooked mesh, the vertex and index data is uploaded straight from the mapped file
+  static bool loadFromFile(const String& filename, Mesh& mesh);
   static bool createSphere(float radius, uint32 segments, Mesh& mesh);
 
+  // texture references of the chunks are relative to path
+  static bool create(const MeshData& data, const String& path, Mesh& mesh);
+
 private:
-  static void fixTangentData(IntermediateMeshData& data);
-  static void mergeDuplicateVertices(const IntermediateMeshData& source, IntermediateMeshData& data);
-  static MeshChunk* createMeshChunk(const IntermediateMeshData& data, Mesh& mesh);
+  static MeshChunk* createMeshChunk(const MeshChunkData& data, Mesh& mesh);
 
   // mesh parts
   Array<MeshChunk*> m_meshChunks;
+  AABB m_bounds;
+  BoundingSphere m_boundingSphere;
   // vertex declaration
   SharedPtr<VertexDeclaration> m_vertexDeclaration;
 
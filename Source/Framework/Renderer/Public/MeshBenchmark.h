@@ -0,0 +1,332 @@
+#ifndef __MeshBenchmark_h_
+#define __MeshBenchmark_h_
+
+#include "ObjParser.h"
+#include "MeshCook.h"
+#include "MeshTest.h"
+#include "TaskScheduler.h"
+
+namespace MeshBenchmark
+{
+
+  // parses the file (or a generated grid if no file is given) with one chunk per thread,
+  // needs an initialized task scheduler to scale
+  static void RunObjParserBenchmarks(const String& fileName = String(), uint32 syntheticSize = 1000, uint32 repetitions = 3)
+  {
+    String text;
+    if (fileName.empty() || !readAllFile(fileName, text))
+      text = MeshTest::GenerateObj(syntheticSize);
+
+    const double megaBytes = text.size() / (1024.0 * 1024.0);
+    const uint32 maxThreads = TaskScheduler::getNumWorkers() + 1;
+    printf("\nStarting Obj Parser Benchmarks (%.1f MB, up to %d threads)...\n", megaBytes, maxThreads);
+
+    double singleThreaded = 0.0;
+    uint32 sink = 0;
+
+    // 1, 2, 4, ... and the maximum
+    for (uint32 numThreads = 1; ; numThreads = min(numThreads * 2, maxThreads))
+    {
+      // best of, the first run also pays for page faults of the output arrays
+      double best = 1e10;
+      for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+      {
+        ObjData data;
+        const double start = getHighResolutionTime();
+        parseObj(text.c_str(), text.size(), data, numThreads);
+        best = min(best, getHighResolutionTime() - start);
+        sink += data.groups.size();
+      }
+
+      if (numThreads == 1)
+        singleThreaded = best;
+
+      printf("%2d threads %10.2f MB/s %6.2fx\n", numThreads, megaBytes / best, singleThreaded / best);
+
+      if (numThreads == maxThreads)
+        break;
+    }
+
+    printf("(checksum %d)\n", sink);
+  }
+
+  // reads one byte per page, as the upload would
+  static uint32 TouchPages(const MeshData& data)
+  {
+    uint32 sum = 0;
+    for (uint32 i = 0; i < data.chunks.size(); ++i)
+    {
+      const MeshChunkData& chunk = data.chunks[i];
+      for (uint32 offset = 0; offset < chunk.numVertices * chunk.vertexSize; offset += 4096)
+        sum += ((const ubyte*)chunk.vertices)[offset];
+      for (uint32 offset = 0; offset < chunk.numIndices * chunk.indexSize; offset += 4096)
+        sum += ((const ubyte*)chunk.indices)[offset];
+    }
+
+    return sum;
+  }
+
+  // the cpu side of loadFromObj (parsing and cooking) against loadFromFile on the cooked
+  // result, with the file mapped or read at once. materials are left out, the file cache is warm
+  static void RunMeshLoadBenchmarks(const String& fileName = String(), uint32 syntheticSize = 500, uint32 repetitions = 3)
+  {
+    String text;
+    if (fileName.empty() || !readAllFile(fileName, text))
+      text = MeshTest::GenerateObj(syntheticSize);
+
+    const char* cookedFileName = "benchmark.fmesh";
+    printf("\nStarting Mesh Load Benchmarks (%.1f MB obj)...\n", text.size() / (1024.0 * 1024.0));
+
+    double best[3] = { 1e10, 1e10, 1e10 };
+    uint32 sink = 0;
+
+    CookedMesh cooked;
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      const double start = getHighResolutionTime();
+      ObjData obj;
+      parseObj(text.c_str(), text.size(), obj);
+      obj.materialLib.clear();
+      cookObj(obj, String(), cooked);
+      best[0] = min(best[0], getHighResolutionTime() - start);
+    }
+
+    MeshData data;
+    cooked.getMeshData(data);
+    if (!writeMeshFile(cookedFileName, data))
+    {
+      printf("WARNING: can't write %s\n", cookedFileName);
+      return;
+    }
+
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      double start = getHighResolutionTime();
+      {
+        MappedFile file;
+        MeshData loaded;
+        if (file.open(cookedFileName) && readMeshFile(file.getPtr(), file.getSize(), loaded))
+          sink += TouchPages(loaded);
+      }
+      best[1] = min(best[1], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      {
+        DataBlob blob;
+        MeshData loaded;
+        if (readRawBlob(cookedFileName, blob) && readMeshFile(blob.getPtr(), blob.getSize(), loaded))
+          sink += TouchPages(loaded);
+      }
+      best[2] = min(best[2], getHighResolutionTime() - start);
+    }
+
+    DataBlob blob;
+    readRawBlob(cookedFileName, blob);
+    remove(cookedFileName);
+
+    printf("obj parse and cook  %10.2f ms\n", best[0] * 1000.0);
+    printf("fmesh mapped        %10.2f ms %8.1fx (%.1f MB)\n", best[1] * 1000.0, best[0] / best[1], blob.getSize() / (1024.0 * 1024.0));
+    printf("fmesh read          %10.2f ms %8.1fx\n", best[2] * 1000.0, best[0] / best[2]);
+    printf("(checksum %d)\n", sink);
+  }
+
+
+  // welds a triangle soup of 2 * size^2 triangles, the default is about a million. the
+  // reference is the map based welder of the tests
+  static void RunWeldBenchmarks(uint32 size = 710, uint32 repetitions = 3)
+  {
+    IntermediateMeshData source;
+    MeshTest::GenerateTriangleSoup(size, source);
+
+    const uint32 numVertices = source.position.getSize();
+    printf("\nStarting Vertex Welding Benchmarks (%d triangles, %d threads)...\n", numVertices / 3, TaskScheduler::getNumWorkers() + 1);
+
+    double best[3] = { 1e10, 1e10, 1e10 };
+    uint32 numUnique[3] = { 0, 0, 0 };
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      IntermediateMeshData data[3];
+
+      double start = getHighResolutionTime();
+      numUnique[0] = weldVertices(source, data[0]);
+      best[0] = min(best[0], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      numUnique[1] = weldVertices(source, data[1], 0.0001f);
+      best[1] = min(best[1], getHighResolutionTime() - start);
+
+      // slow, once is enough
+      if (repetition == 0)
+      {
+        start = getHighResolutionTime();
+        numUnique[2] = MeshTest::ReferenceWeld(source, data[2]);
+        best[2] = getHighResolutionTime() - start;
+      }
+    }
+
+    const char* names[] = { "hash weld", "hash weld epsilon", "map weld" };
+    for (uint32 i = 0; i < 3; ++i)
+      printf("%-18s %10.2f ms %8.2f Mverts/s %6.2f:1 %6.2fx\n", names[i], best[i] * 1000.0, numVertices / best[i] / 1000000.0, (float)numVertices / numUnique[i], best[2] / best[i]);
+  }
+
+
+  // forsyth on a grid of 2 * size^2 triangles in random order, the default is about a million
+  static void RunVertexCacheBenchmarks(uint32 size = 710, uint32 repetitions = 3)
+  {
+    IntermediateMeshData soup;
+    IntermediateMeshData data;
+    MeshTest::GenerateTriangleSoup(size, soup);
+    weldVertices(soup, data);
+    MeshTest::ShuffleTriangles(data.indices);
+
+    const uint32 numIndices = data.indices.size();
+    const uint32 numVertices = data.position.getSize();
+    printf("\nStarting Vertex Cache Benchmarks (%d triangles)...\n", numIndices / 3);
+
+    Array<uint32> indices;
+    indices.resize(numIndices);
+    Array<uint32> remap;
+    remap.resize(numVertices);
+
+    double best[2] = { 1e10, 1e10 };
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      double start = getHighResolutionTime();
+      optimizeVertexCache(&indices[0], &data.indices[0], numIndices, numVertices);
+      best[0] = min(best[0], getHighResolutionTime() - start);
+
+      start = getHighResolutionTime();
+      optimizeVertexFetchRemap(&remap[0], &indices[0], numIndices, numVertices);
+      best[1] = min(best[1], getHighResolutionTime() - start);
+    }
+
+    const VertexCacheStatistics before = analyzeVertexCache(&data.indices[0], numIndices, numVertices);
+    const VertexCacheStatistics after = analyzeVertexCache(&indices[0], numIndices, numVertices);
+
+    printf("vertex cache  %10.2f ms %8.2f Mtris/s\n", best[0] * 1000.0, numIndices / 3 / best[0] / 1000000.0);
+    printf("vertex fetch  %10.2f ms %8.2f Mtris/s\n", best[1] * 1000.0, numIndices / 3 / best[1] / 1000000.0);
+    printf("acmr %6.3f -> %6.3f, atvr %6.3f -> %6.3f (fifo %d)\n", before.acmr, after.acmr, before.atvr, after.atvr, VertexCacheSize);
+  }
+
+
+  // concentric spheres drawn inside out after the vertex cache optimization, the overdraw
+  // optimizer with a few thresholds
+  static void RunOverdrawBenchmarks(uint32 numSpheres = 8, uint32 segments = 128, uint32 repetitions = 3)
+  {
+    IntermediateMeshData data;
+    MeshTest::GenerateSpheres(numSpheres, segments, data);
+
+    const uint32 numIndices = data.indices.size();
+    const uint32 numVertices = data.position.getSize();
+    optimizeVertexCache(&data.indices[0], &data.indices[0], numIndices, numVertices);
+    printf("\nStarting Overdraw Benchmarks (%d triangles)...\n", numIndices / 3);
+
+    const OverdrawStatistics overdraw = analyzeOverdraw(&data.indices[0], numIndices, data.position.getSoA(), numVertices);
+    const VertexCacheStatistics cache = analyzeVertexCache(&data.indices[0], numIndices, numVertices);
+    printf("cache only                        overdraw %6.3f acmr %6.3f\n", overdraw.overdraw, cache.acmr);
+
+    Array<uint32> indices;
+    indices.resize(numIndices);
+    const float thresholds[] = { 1.0f, 1.05f, 1.2f, 1.5f };
+    for (uint32 i = 0; i < sizeof(thresholds) / sizeof(thresholds[0]); ++i)
+    {
+      double best = 1e10;
+      for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+      {
+        const double start = getHighResolutionTime();
+        optimizeOverdraw(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, thresholds[i]);
+        best = min(best, getHighResolutionTime() - start);
+      }
+
+      const OverdrawStatistics optimizedOverdraw = analyzeOverdraw(&indices[0], numIndices, data.position.getSoA(), numVertices);
+      const VertexCacheStatistics optimizedCache = analyzeVertexCache(&indices[0], numIndices, numVertices);
+      printf("threshold %4.2f %10.2f ms       overdraw %6.3f acmr %6.3f\n", thresholds[i], best * 1000.0, optimizedOverdraw.overdraw, optimizedCache.acmr);
+    }
+
+    const double start = getHighResolutionTime();
+    analyzeOverdraw(&data.indices[0], numIndices, data.position.getSoA(), numVertices);
+    printf("analyzeOverdraw %10.2f ms\n", (getHighResolutionTime() - start) * 1000.0);
+  }
+
+  // one simplification per level from the full sphere, the seams and poles are kept
+  static void RunSimplifierBenchmarks(uint32 segments = 400, uint32 repetitions = 3)
+  {
+    IntermediateMeshData data;
+    MeshTest::GenerateSpheres(1, segments, data);
+
+    const uint32 numIndices = data.indices.size();
+    const uint32 numVertices = data.position.getSize();
+    printf("\nStarting Simplifier Benchmarks (%d triangles)...\n", numIndices / 3);
+
+    Array<uint32> indices;
+    indices.resize(numIndices);
+    const float ratios[] = { 0.5f, 0.25f, 0.1f, 0.01f };
+    for (uint32 i = 0; i < sizeof(ratios) / sizeof(ratios[0]); ++i)
+    {
+      const uint32 target = (uint32)(numIndices * ratios[i]) / 3 * 3;
+      uint32 count = 0;
+      float error = 0.0f;
+      double best = 1e10;
+      for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+      {
+        const double start = getHighResolutionTime();
+        count = simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, target, FLT_MAX, true, &error);
+        best = min(best, getHighResolutionTime() - start);
+      }
+
+      printf("ratio %5.2f %10.2f ms %8d triangles error %f\n", ratios[i], best * 1000.0, count / 3, error);
+    }
+  }
+
+  static void RunMeshletBenchmarks(uint32 segments = 400, uint32 repetitions = 3)
+  {
+    IntermediateMeshData data;
+    MeshTest::GenerateSpheres(1, segments, data);
+
+    const uint32 numIndices = data.indices.size();
+    printf("\nStarting Meshlet Benchmarks (%d triangles)...\n", numIndices / 3);
+
+    Array<ubyte> block;
+    uint32 numMeshlets = 0;
+    double best = 1e10;
+    for (uint32 repetition = 0; repetition < repetitions; ++repetition)
+    {
+      IntermediateMeshData partitioned = data;
+      const double start = getHighResolutionTime();
+      numMeshlets = buildMeshlets(block, &partitioned.indices[0], numIndices, partitioned.position.getSoA(), partitioned.position.getSize());
+      best = min(best, getHighResolutionTime() - start);
+      if (repetition + 1 == repetitions)
+        data.indices = partitioned.indices;
+    }
+    printf("build %10.2f ms %8d meshlets\n", best * 1000.0, numMeshlets);
+
+    // the sphere from outside, from the inside where every triangle faces away, and from its surface
+    Matrix4 proj;
+    makePerspectiveProjMatrix(proj, PI / 4.0f, 1.0f, 0.1f, 100.0f);
+    const MeshletArrays meshlets(&block[0], numMeshlets);
+    Array<uint32> culled;
+    culled.resize(numIndices);
+    const float distances[] = { 10.0f, 0.0f, 1.0f };
+    for (uint32 i = 0; i < sizeof(distances) / sizeof(distances[0]); ++i)
+    {
+      Matrix4 view;
+      const Vector3 cameraPosition(0.0f, 0.0f, -distances[i]);
+      makeLookAt(view, cameraPosition, Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+      const Frustum frustum(proj * view);
+
+      uint32 count = 0;
+      best = 1e10;
+      for (uint32 repetition = 0; repetition < repetitions * 10; ++repetition)
+      {
+        const double start = getHighResolutionTime();
+        count = cullMeshlets(&culled[0], &data.indices[0], sizeof(uint32), meshlets, frustum, cameraPosition);
+        best = min(best, getHighResolutionTime() - start);
+      }
+
+      printf("cull distance %5.2f %10.3f ms %8d of %d triangles\n", distances[i], best * 1000.0, count / 3, numIndices / 3);
+    }
+  }
+
+}
+
+#endif // __MeshBenchmark_h_
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef __MeshCook_h_
+#define __MeshCook_h_
+
+#include "Mesh.h"
+#include "MeshFile.h"
+#include "ObjParser.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+
+// cpu side mesh processing, shared by the loaders and the MeshCooker tool. nothing in here
+// needs a render device
+
+struct MeshCookSettings
+{
+  MeshCookSettings()
+    : options(OPT_OPTIMIZE_FOR_CACHE)
+    , weldEpsilon(0.0f)
+    , overdrawThreshold(1.05f)
+    , numLods(1)
+    , positionTolerance(0.0001f)
+    , normalTolerance(0.01f)
+    , texcoordTolerance(1.0f / 2048.0f)
+  {
+    for (uint32 lod = 0; lod < MaxMeshLods; ++lod)
+      lodRatios[lod] = 1.0f / (1 << lod);
+  }
+
+  uint32 options;             // eMeshOptions
+
+  // vertices whose attributes all fall into the same epsilon grid cell are welded, 0 welds
+  // exact duplicates only
+  float weldEpsilon;
+  // acmr loss allowed by OPT_OPTIMIZE_FOR_OVERDRAW, see optimizeOverdraw
+  float overdrawThreshold;
+  // levels of detail per chunk, each with the given share of the chunk's triangles
+  uint32 numLods;
+  float lodRatios[MaxMeshLods];
+  // largest errors allowed by OPT_16BIT_VERTEX_DATA. positions relative to the diagonal of the
+  // mesh bounds, normals, tangents and bitangents as distance to the source vector and
+  // texcoords in uv units
+  float positionTolerance;
+  float normalTolerance;
+  float texcoordTolerance;
+};
+
+// bytes per vertex before and after OPT_16BIT_VERTEX_DATA and the largest error of every
+// element of the vertex declaration, positions in object space
+struct VertexPackingStatistics
+{
+  VertexPackingStatistics();
+
+  uint32 sourceVertexSize;
+  uint32 vertexSize;
+  float maxError[VertexDeclaration::MaxVertexElements];
+};
+
+struct CookedMeshChunk
+{
+  CookedMeshChunk();
+
+  Array<ubyte> vertices;
+  Array<ubyte> indices;
+  Array<MeshLod> lods;
+  Array<ubyte> meshlets;      // MeshletArrays block of the finest level
+  uint32 numVertices;
+  uint32 numSourceVertices;   // before welding
+  uint32 vertexSize;          // all streams
+  uint32 indexSize;
+  AABB bounds;
+  BoundingSphere boundingSphere;
+  String diffuseMap;
+  String bumpMap;
+  // the welded triangles in file order and the final order of the finest level
+  VertexCacheStatistics sourceVertexCache;
+  VertexCacheStatistics vertexCache;
+  // only with OPT_OPTIMIZE_FOR_OVERDRAW, it takes a while
+  OverdrawStatistics sourceOverdraw;
+  OverdrawStatistics overdraw;
+};
+
+struct CookedMesh
+{
+  VertexDeclaration vertexDeclaration;
+  Array<CookedMeshChunk> chunks;
+  VertexPackingStatistics packing;
+
+  // the chunks point into this mesh
+  void getMeshData(MeshData& data) const;
+};
+
+// float attributes in the order position, normal, tangent, bitangent and the texture
+// coordinates, interleaved in stream 0. with OPT_USE_MULTI_STREAM the positions get stream 0 to
+// themselves and the other attributes are interleaved in stream 1, so position only passes fetch
+// 12 bytes per vertex
+void createVertexDeclaration(const IntermediateMeshData& data, VertexDeclaration& declaration, uint32 options = 0);
+// picks the smallest format of every element that stays within the tolerances of the settings
+// for all meshes and lays the streams out again. positions become VEF_HALF4 or VEF_SHORT4N
+// relative to the chunk bounds, see getPositionDequantization, normals, tangents and bitangents
+// VEF_BYTE4N or VEF_SHORT4N and texcoords VEF_HALF2. elements that don't fit stay floats
+void selectVertexFormats(const IntermediateMeshData* meshes, uint32 numMeshes, const MeshCookSettings& settings, VertexDeclaration& declaration,
+  VertexPackingStatistics& statistics);
+// packs the vertices as described by the declaration, picks the index size and computes the bounds
+void cookMeshChunk(const IntermediateMeshData& data, const VertexDeclaration& declaration, CookedMeshChunk& chunk);
+
+void fixTangentData(IntermediateMeshData& data);
+// merges vertices that are equal in all attributes, an empty index list of the source is the
+// identity. the first occurrence is kept and the order of the unique vertices is preserved,
+// returns their count. expected linear time, large meshes are split by hash and welded in parallel
+uint32 weldVertices(const IntermediateMeshData& source, IntermediateMeshData& data, float epsilon = 0.0f);
+// appends the coarser levels of detail to the index list, each simplified from the previous one.
+// the chunk border is locked, neighbouring chunks keep matching. stops early when a level can't
+// be reduced any further
+void generateLods(IntermediateMeshData& data, const MeshCookSettings& settings);
+// reorders the triangles of every level for the post transform cache and overdraw as requested
+// by the options, splits the finest level into meshlets with OPT_BUILD_MESHLETS and puts the
+// vertices in order of their first use, unused vertices are removed
+void optimizeMesh(IntermediateMeshData& data, const MeshCookSettings& settings);
+
+// one chunk per material group, the material library is read relative to path
+bool cookObj(const ObjData& obj, const String& path, CookedMesh& mesh, const MeshCookSettings& settings = MeshCookSettings());
+bool cookObj(const String& fileName, CookedMesh& mesh, const MeshCookSettings& settings = MeshCookSettings());
+
+#endif // __MeshCook_h_
\ No newline at end of file
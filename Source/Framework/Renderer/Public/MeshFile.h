@@ -0,0 +1,126 @@
+#ifndef __MeshFile_h_
+#define __MeshFile_h_
+
+#include "VertexDeclaration.h"
+#include "Bounds.h"
+
+// cooked meshes (.fmesh) as written by the MeshCooker tool. the file starts with the header,
+// followed by the vertex elements, the chunk table, the string table and the vertex, index and
+// meshlet data of every chunk. all blocks start 16 byte aligned, offsets are relative to the start of
+// the file, so the data of a mapped file can be handed to the gpu as is
+const uint32 MeshFileMagic = 0x48534d46; // "FMSH"
+const uint32 MeshFileVersion = 5;
+const uint32 MeshFileAlignment = 16;
+const uint32 MaxMeshLods = 4;
+
+// a level of detail is a range of the chunk's index list, the levels share the vertices. the
+// finest level comes first, error is the object space deviation from it
+struct MeshLod
+{
+  uint32 firstIndex;
+  uint32 numIndices;
+  float error;
+};
+
+// the coarsest level whose error stays below maxError
+inline uint32 selectMeshLod(const MeshLod* lods, uint32 numLods, float maxError)
+{
+  uint32 lod = 0;
+  while (lod + 1 < numLods && lods[lod + 1].error <= maxError)
+    ++lod;
+  return lod;
+}
+
+// VEF_SHORT4N positions are relative to the chunk bounds, decoded as value * scale + bias. flat
+// boxes get a tiny scale instead of 0, the positions are divided by it
+inline void getPositionDequantization(const AABB& bounds, Vector3& scale, Vector3& bias)
+{
+  bias = bounds.getCenter();
+  scale = bounds.getExtent();
+  scale.x = max(scale.x, FLT_MIN);
+  scale.y = max(scale.y, FLT_MIN);
+  scale.z = max(scale.z, FLT_MIN);
+}
+
+struct MeshFileHeader
+{
+  uint32 magic;
+  uint32 version;
+  uint32 fileSize;
+  uint32 numElements;
+  uint32 elementsOffset;
+  uint32 numChunks;
+  uint32 chunksOffset;
+  uint32 stringsOffset;
+  uint32 stringsSize;
+  uint32 reserved[3];
+};
+
+struct MeshFileElement
+{
+  uint32 semantic;        // string table offset
+  uint32 semanticIndex;
+  uint32 format;          // eVertexElementFormat
+  uint32 stream;
+  uint32 byteOffset;
+};
+
+struct MeshFileChunk
+{
+  uint32 numVertices;
+  uint32 vertexSize;
+  uint32 verticesOffset;
+  uint32 numIndices;
+  uint32 indexSize;       // 2 or 4
+  uint32 indicesOffset;
+  uint32 diffuseMap;      // string table offsets, 0 is the empty string
+  uint32 bumpMap;
+  float boundsMin[3];
+  float boundsMax[3];
+  float sphereCenter[3];
+  float sphereRadius;
+  uint32 numLods;
+  MeshLod lods[MaxMeshLods];  // index ranges relative to the chunk's indices
+  uint32 numMeshlets;         // of the finest level, see Meshlet.h
+  uint32 meshletsOffset;
+};
+
+// a chunk in the final gpu layout. the data isn't owned, it points into a cooked mesh or a
+// mapped file
+struct MeshChunkData
+{
+  MeshChunkData();
+
+  // the streams of the vertex declaration back to back in stream order, numVertices times the
+  // stream's stride each. vertexSize is the sum of the strides
+  const void* vertices;
+  uint32 numVertices;
+  uint32 vertexSize;
+  const void* indices;
+  uint32 numIndices;
+  uint32 indexSize;
+  AABB bounds;
+  BoundingSphere boundingSphere;
+  // no levels stand for a single one with all indices
+  uint32 numLods;
+  MeshLod lods[MaxMeshLods];
+  // MeshletArrays block, no meshlets draw the finest level as a whole
+  const void* meshlets;
+  uint32 numMeshlets;
+  // relative to the mesh file
+  String diffuseMap;
+  String bumpMap;
+};
+
+struct MeshData
+{
+  VertexDeclaration vertexDeclaration;
+  Array<MeshChunkData> chunks;
+};
+
+bool writeMeshFile(const String& fileName, const MeshData& mesh);
+
+// validates the image and points the chunks into it, the image has to outlive them
+bool readMeshFile(const void* image, uint32 size, MeshData& mesh);
+
+#endif // __MeshFile_h_
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef __MeshOptimizer_h_
+#define __MeshOptimizer_h_
+
+#include "BatchMath.h"
+
+// reordering of triangle lists for the gpu. the functions only look at the indices, the
+// vertices are referenced by index in [0, numVertices). cross(p1 - p0, p2 - p0) points to
+// the front side of a triangle
+
+// the post transform cache is simulated as a fifo, which is closer to current hardware than lru
+const uint32 VertexCacheSize = 16;
+
+struct VertexCacheStatistics
+{
+  uint32 numTransformed;  // cache misses
+  float acmr;             // transformed vertices per triangle, 0.5 is the optimum for a regular grid
+  float atvr;             // transformed vertices per referenced vertex, 1 is optimal
+};
+
+VertexCacheStatistics analyzeVertexCache(const uint32* indices, uint32 numIndices, uint32 numVertices, uint32 cacheSize = VertexCacheSize);
+
+// tom forsyth's linear speed vertex cache optimization. the triangles keep their winding,
+// result may be the same array as indices
+void optimizeVertexCache(uint32* result, const uint32* indices, uint32 numIndices, uint32 numVertices);
+
+// numbers the vertices in order of their first use, so the vertex fetch is mostly linear.
+// unused vertices are mapped to ~0, returns the number of used vertices
+uint32 optimizeVertexFetchRemap(uint32* remap, const uint32* indices, uint32 numIndices, uint32 numVertices);
+
+// splits the cache optimized triangles into clusters and sorts them by their view independent
+// occlusion potential, clusters facing away from the center are drawn first. a cluster ends as
+// soon as its acmr with an empty cache is within threshold times the acmr of the input, so 1.05
+// costs about 5% of the cache efficiency. positions are only read
+void optimizeOverdraw(uint32* result, const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices, float threshold = 1.05f);
+
+// resolution of every view, the mesh bounds are stretched to fill it
+const uint32 OverdrawViewportSize = 256;
+
+struct OverdrawStatistics
+{
+  uint32 numCovered;      // pixels
+  uint32 numShaded;       // pixels passing the depth test
+  float overdraw;         // shaded per covered pixel, 1 is optimal
+};
+
+// rasterizes the front faces of the mesh from the 6 axis directions with a depth test in draw order
+OverdrawStatistics analyzeOverdraw(const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices);
+
+#endif // __MeshOptimizer_h_
\ No newline at end of file
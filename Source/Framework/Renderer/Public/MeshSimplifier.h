@@ -0,0 +1,18 @@
+#ifndef __MeshSimplifier_h_
+#define __MeshSimplifier_h_
+
+#include "BatchMath.h"
+#include <float.h>
+
+// quadric error metric edge collapse (garland and heckbert). vertices are only moved onto other
+// vertices, so the result references a subset of the input and shares its vertex data.
+// vertices with the same position but different attributes form a seam, they are only collapsed
+// along the seam and all of them at once. vertices on an open border are locked, so the border
+// of a chunk keeps matching its neighbours, unless lockBorder is false, then they are only
+// collapsed along the border. result has to hold numIndices and may be the same array as
+// indices, returns the number of indices written. the collapses stop at targetIndexCount or
+// maxError, error receives the largest error of a collapse, in object space
+uint32 simplifyMesh(uint32* result, const uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices,
+  uint32 targetIndexCount, float maxError = FLT_MAX, bool lockBorder = true, float* error = 0);
+
+#endif // __MeshSimplifier_h_
\ No newline at end of file
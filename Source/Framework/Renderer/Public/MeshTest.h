@@ -0,0 +1,1126 @@
+#ifndef __MeshTest_h_
+#define __MeshTest_h_
+
+#include "ObjParser.h"
+#include "MeshCook.h"
+#include "HalfFloat.h"
+#include <algorithm>
+#include <set>
+
+namespace MeshTest
+{
+
+#define RUN_TEST(test) { \
+    if ((test) == false) \
+      printf("WARNING: " #test " failed...\n"); \
+    else \
+      printf(#test " succeeded...\n"); }
+
+  // a grid with all face formats, relative indices, material switches every few hundred
+  // faces and windows line endings on every other line
+  static String GenerateObj(uint32 size)
+  {
+    String text = "# generated\nmtllib test.mtl\n";
+    char line[256];
+
+    for (uint32 y = 0; y <= size; ++y)
+    {
+      for (uint32 x = 0; x <= size; ++x)
+      {
+        sprintf_s(line, "v %f %f %f%s\n", x * 0.5f, (x ^ y) * 0.01f, y * -0.25f, (x & 1) ? "\r" : "");
+        text += line;
+        sprintf_s(line, "vt %f %f\n", x / (float)size, y / (float)size);
+        text += line;
+        sprintf_s(line, "vn 0 1 %d\n", (int)(x % 3));
+        text += line;
+      }
+    }
+
+    const uint32 rowSize = size + 1;
+    uint32 face = 0;
+    for (uint32 y = 0; y < size; ++y)
+    {
+      for (uint32 x = 0; x < size; ++x, ++face)
+      {
+        if (face % 500 == 499)
+        {
+          sprintf_s(line, "usemtl material%d\n", face % 3);
+          text += line;
+        }
+
+        const uint32 a = y * rowSize + x + 1;
+        const uint32 b = a + 1;
+        const uint32 c = a + rowSize + 1;
+        const uint32 d = a + rowSize;
+
+        switch (face % 5)
+        {
+        case 0: sprintf_s(line, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d); break;
+        case 1: sprintf_s(line, "f %d//%d %d//%d %d//%d\n", a, a, b, b, c, c); break;
+        case 2: sprintf_s(line, "f %d/%d %d/%d %d/%d\r\n", a, a, c, c, d, d); break;
+        case 3: sprintf_s(line, "f\t%d %d  %d %d %d\n", a, b, c, d, a); break;
+        // relative to the last vertex, which is the very last one of the grid
+        default:
+          {
+            const int last = (int)(rowSize * rowSize) + 1;
+            sprintf_s(line, "  f %d/%d/%d %d/%d/%d %d/%d/%d\n", (int)a - last, (int)a - last, (int)a - last,
+              (int)b - last, (int)b - last, (int)b - last, (int)c - last, (int)c - last, (int)c - last);
+          }
+        }
+
+        text += line;
+      }
+    }
+
+    // the last line isn't terminated
+    text += "f 1 2 3";
+    return text;
+  }
+
+  static bool Equals(const ObjData& a, const ObjData& b)
+  {
+    bool equal = a.materialLib == b.materialLib && a.groups.size() == b.groups.size();
+    equal &= a.positions == b.positions && a.normals == b.normals && a.texcoords == b.texcoords;
+
+    for (uint32 i = 0; equal && i < a.groups.size(); ++i)
+    {
+      const ObjGroup& groupA = a.groups[i];
+      const ObjGroup& groupB = b.groups[i];
+      equal &= groupA.material == groupB.material && groupA.faceSizes == groupB.faceSizes;
+      equal &= groupA.vertices.size() == groupB.vertices.size() &&
+        (groupA.vertices.empty() || memcmp(&groupA.vertices[0], &groupB.vertices[0], groupA.vertices.size() * sizeof(ObjVertex)) == 0);
+    }
+
+    return equal;
+  }
+
+  static void TestObjParser(uint32 size = 120)
+  {
+    printf("\nStarting Obj Parser Tests...\n");
+
+    const String text = GenerateObj(size);
+
+    printf("Test 1 (single chunk)\n");
+    ObjData reference;
+    {
+      RUN_TEST(parseObj(text.c_str(), text.size(), reference, 1));
+      RUN_TEST(reference.materialLib == "test.mtl");
+      RUN_TEST(reference.positions.size() == (size + 1) * (size + 1) * 3);
+      RUN_TEST(reference.texcoords.size() == reference.positions.size() && reference.normals.size() == reference.positions.size());
+
+      // the faces before the first usemtl end up in an unnamed group
+      const uint32 numFaces = size * size + 1;
+      uint32 parsedFaces = 0;
+      for (uint32 i = 0; i < reference.groups.size(); ++i)
+        parsedFaces += reference.groups[i].faceSizes.size();
+      RUN_TEST(parsedFaces == numFaces);
+      RUN_TEST(reference.groups.size() == size * size / 500 + 1 && reference.groups[0].material.empty());
+      RUN_TEST(reference.groups[1].material == "material1");
+
+      // relative indices resolve to the same vertices as absolute ones
+      const ObjGroup& group = reference.groups[0];
+      RUN_TEST(group.faceSizes[3] == 5 && group.faceSizes[4] == 3);
+      RUN_TEST(group.vertices[4 + 3 + 3 + 5].position == 4 && group.vertices[4 + 3 + 3 + 5].normal == 4);
+      RUN_TEST(group.vertices[4].texcoord == -1 && group.vertices[4].normal == 1);
+    }
+
+    printf("\nTest 2 (chunked)\n");
+    {
+      // chunk boundaries fall between material switches and in the middle of relative faces
+      const uint32 chunkCounts[] = { 2, 3, 7, 16, 61, 1000 };
+      bool allEqual = true;
+      for (uint32 i = 0; i < sizeof(chunkCounts) / sizeof(chunkCounts[0]); ++i)
+      {
+        ObjData data;
+        allEqual &= parseObj(text.c_str(), text.size(), data, chunkCounts[i]) && Equals(data, reference);
+      }
+      RUN_TEST(allEqual);
+    }
+
+    printf("\nTest 3 (invalid references)\n");
+    {
+      ObjData data;
+      const char* outOfRange = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n";
+      const char* relativeOutOfRange = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -1 -2 -4\n";
+      const char* zeroIndex = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n";
+      const char* missingNormal = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1//1 2//1 3//1\n";
+      RUN_TEST(parseObj(outOfRange, strlen(outOfRange), data, 2) == false);
+      RUN_TEST(parseObj(relativeOutOfRange, strlen(relativeOutOfRange), data, 2) == false);
+      RUN_TEST(parseObj(zeroIndex, strlen(zeroIndex), data, 2) == false);
+      RUN_TEST(parseObj(missingNormal, strlen(missingNormal), data, 2) == false);
+      RUN_TEST(parseObj("", 0, data) && data.groups.empty());
+    }
+  }
+
+  static bool Equals(const MeshData& a, const MeshData& b)
+  {
+    bool equal = a.chunks.size() == b.chunks.size();
+    for (uint32 i = 0; equal; ++i)
+    {
+      const VertexElement* elementA = a.vertexDeclaration.getElement(i);
+      const VertexElement* elementB = b.vertexDeclaration.getElement(i);
+      if (!elementA || !elementB)
+      {
+        equal &= elementA == elementB;
+        break;
+      }
+
+      equal &= elementA->semantic == elementB->semantic && elementA->semanticIndex == elementB->semanticIndex &&
+        elementA->format == elementB->format && elementA->stream == elementB->stream && elementA->byteOffset == elementB->byteOffset;
+    }
+
+    for (uint32 i = 0; equal && i < a.chunks.size(); ++i)
+    {
+      const MeshChunkData& chunkA = a.chunks[i];
+      const MeshChunkData& chunkB = b.chunks[i];
+      equal &= chunkA.numVertices == chunkB.numVertices && chunkA.vertexSize == chunkB.vertexSize;
+      equal &= chunkA.numIndices == chunkB.numIndices && chunkA.indexSize == chunkB.indexSize;
+      equal &= chunkA.diffuseMap == chunkB.diffuseMap && chunkA.bumpMap == chunkB.bumpMap;
+      equal &= memcmp(&chunkA.bounds, &chunkB.bounds, sizeof(AABB)) == 0 && memcmp(&chunkA.boundingSphere, &chunkB.boundingSphere, sizeof(BoundingSphere)) == 0;
+      equal &= chunkA.numLods == chunkB.numLods && memcmp(chunkA.lods, chunkB.lods, chunkA.numLods * sizeof(MeshLod)) == 0;
+      equal &= memcmp(chunkA.vertices, chunkB.vertices, chunkA.numVertices * chunkA.vertexSize) == 0;
+      equal &= memcmp(chunkA.indices, chunkB.indices, chunkA.numIndices * chunkA.indexSize) == 0;
+      equal &= chunkA.numMeshlets == chunkB.numMeshlets && memcmp(chunkA.meshlets, chunkB.meshlets, chunkA.numMeshlets * MeshletStride) == 0;
+    }
+
+    return equal;
+  }
+
+  static void TestMeshFile(uint32 size = 60)
+  {
+    printf("\nStarting Mesh File Tests...\n");
+
+    // there is no material library on disk
+    const String text = GenerateObj(size);
+    ObjData obj;
+    parseObj(text.c_str(), text.size(), obj);
+    obj.materialLib.clear();
+
+    const char* fileName = "test.fmesh";
+    CookedMesh cooked;
+    MeshData source;
+    MeshCookSettings settings;
+    settings.options |= OPT_BUILD_MESHLETS;
+    settings.numLods = 3;
+
+    printf("Test 1 (cook)\n");
+    {
+      RUN_TEST(cookObj(obj, String(), cooked, settings));
+      RUN_TEST(cooked.chunks.size() == obj.groups.size());
+
+      cooked.chunks[1].diffuseMap = "diffuse.dds";
+      cooked.chunks[1].bumpMap = "normal.dds";
+      cooked.getMeshData(source);
+
+      // position, normal and texcoord
+      RUN_TEST(source.chunks[0].vertexSize == 32 && source.chunks[0].indexSize == sizeof(uint16));
+
+      bool validIndices = true;
+      for (uint32 i = 0; i < source.chunks.size(); ++i)
+      {
+        const MeshChunkData& chunk = source.chunks[i];
+        validIndices &= chunk.numIndices > 0 && chunk.numIndices % 3 == 0 && !chunk.bounds.isEmpty();
+        // the seams of the grid keep most chunks at a single level
+        validIndices &= chunk.numLods >= 1 && chunk.numLods <= 3 && chunk.lods[0].firstIndex == 0;
+        validIndices &= chunk.lods[chunk.numLods - 1].firstIndex + chunk.lods[chunk.numLods - 1].numIndices == chunk.numIndices;
+        for (uint32 j = 0; j < chunk.numIndices; ++j)
+          validIndices &= ((const uint16*)chunk.indices)[j] < chunk.numVertices;
+
+        // the meshlets cover the finest level
+        const MeshletArrays meshlets((void*)chunk.meshlets, chunk.numMeshlets);
+        uint32 covered = 0;
+        for (uint32 m = 0; m < meshlets.numMeshlets; ++m)
+        {
+          validIndices &= meshlets.firstIndex[m] == covered;
+          covered += meshlets.numIndices[m];
+        }
+        validIndices &= chunk.numMeshlets > 0 && covered == chunk.lods[0].numIndices;
+      }
+      RUN_TEST(validIndices);
+    }
+
+    printf("\nTest 2 (round trip)\n");
+    {
+      RUN_TEST(writeMeshFile(fileName, source));
+
+      MappedFile file;
+      MeshData loaded;
+      RUN_TEST(file.open(fileName) && readMeshFile(file.getPtr(), file.getSize(), loaded));
+      RUN_TEST(Equals(loaded, source));
+
+      bool aligned = loaded.chunks.size() == source.chunks.size();
+      for (uint32 i = 0; aligned && i < loaded.chunks.size(); ++i)
+      {
+        aligned &= ((const ubyte*)loaded.chunks[i].vertices - (const ubyte*)file.getPtr()) % MeshFileAlignment == 0;
+        aligned &= ((const ubyte*)loaded.chunks[i].indices - (const ubyte*)file.getPtr()) % MeshFileAlignment == 0;
+        aligned &= ((const ubyte*)loaded.chunks[i].meshlets - (const ubyte*)file.getPtr()) % MeshFileAlignment == 0;
+      }
+      RUN_TEST(aligned);
+    }
+
+    printf("\nTest 3 (invalid files)\n");
+    {
+      DataBlob data;
+      MeshData loaded;
+      RUN_TEST(readRawBlob(fileName, data));
+
+      MeshFileHeader* header = (MeshFileHeader*)data.getPtr();
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize() - 1, loaded) == false);
+
+      header->version = MeshFileVersion + 1;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      header->version = MeshFileVersion;
+
+      MeshFileChunk* chunk = (MeshFileChunk*)((ubyte*)data.getPtr() + header->chunksOffset);
+      chunk->numIndices = header->fileSize;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      chunk->numIndices = source.chunks[0].numIndices;
+      chunk->indicesOffset += 2;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      chunk->indicesOffset -= 2;
+      chunk->lods[0].numIndices = chunk->numIndices + 3;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      chunk->lods[0].numIndices = source.chunks[0].lods[0].numIndices;
+      chunk->numLods = 0;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      chunk->numLods = source.chunks[0].numLods;
+      uint32* meshletIndices = (uint32*)((ubyte*)data.getPtr() + chunk->meshletsOffset) + chunk->numMeshlets;
+      meshletIndices[0] += chunk->lods[0].numIndices;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      meshletIndices[0] -= chunk->lods[0].numIndices;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) && Equals(loaded, source));
+
+      MeshFileElement* elements = (MeshFileElement*)((ubyte*)data.getPtr() + header->elementsOffset);
+      elements[1].stream = MAX_VERTEX_STREAMS;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+      elements[1].stream = 0;
+      chunk->vertexSize += 4;
+      RUN_TEST(readMeshFile(data.getPtr(), data.getSize(), loaded) == false);
+    }
+
+    printf("\nTest 4 (multiple streams)\n");
+    {
+      CookedMesh multiStream;
+      MeshData split;
+      settings.options |= OPT_USE_MULTI_STREAM;
+      RUN_TEST(cookObj(obj, String(), multiStream, settings));
+      multiStream.getMeshData(split);
+
+      // the positions on their own, the other attributes start over in stream 1
+      const VertexDeclaration& declaration = split.vertexDeclaration;
+      RUN_TEST(declaration.getStreamMask() == 3 && declaration.getStreamStride(0) == 12 && declaration.getStreamStride(1) == 20);
+      RUN_TEST(declaration.getElement(0)->stream == 0 && declaration.getElement(1)->stream == 1 && declaration.getElement(1)->byteOffset == 0);
+
+      // the same vertices, split at the end of the position
+      bool sameVertices = split.chunks.size() == source.chunks.size();
+      for (uint32 i = 0; sameVertices && i < split.chunks.size(); ++i)
+      {
+        const MeshChunkData& chunk = split.chunks[i];
+        sameVertices &= chunk.numVertices == source.chunks[i].numVertices && chunk.vertexSize == source.chunks[i].vertexSize;
+        const ubyte* positions = (const ubyte*)chunk.vertices;
+        const ubyte* attributes = positions + chunk.numVertices * 12;
+        const ubyte* interleaved = (const ubyte*)source.chunks[i].vertices;
+        for (uint32 v = 0; sameVertices && v < chunk.numVertices; ++v)
+        {
+          sameVertices &= memcmp(positions + v * 12, interleaved + v * 32, 12) == 0;
+          sameVertices &= memcmp(attributes + v * 20, interleaved + v * 32 + 12, 20) == 0;
+        }
+      }
+      RUN_TEST(sameVertices);
+
+      MappedFile file;
+      MeshData loaded;
+      RUN_TEST(writeMeshFile(fileName, split));
+      RUN_TEST(file.open(fileName) && readMeshFile(file.getPtr(), file.getSize(), loaded) && Equals(loaded, split));
+    }
+
+    remove(fileName);
+  }
+
+
+  // unindexed triangles of a size x size grid, every inner vertex is repeated up to six times.
+  // the normal and texcoord are continuous, so the welded grid has (size + 1)^2 vertices
+  static void GenerateTriangleSoup(uint32 size, IntermediateMeshData& data)
+  {
+    const uint32 corners[] = { 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1 };
+    for (uint32 y = 0; y < size; ++y)
+    {
+      for (uint32 x = 0; x < size; ++x)
+      {
+        for (uint32 i = 0; i < 6; ++i)
+        {
+          const float u = (float)(x + corners[i * 2 + 0]) / size;
+          const float v = (float)(y + corners[i * 2 + 1]) / size;
+          data.position.add(Vector3(u * 10.0f, sin(u * 6.0f) * cos(v * 6.0f), v * 10.0f));
+          data.normal.add(Vector3(u, 1.0f, v));
+          data.uv0.push_back(Vector2(u, v));
+        }
+      }
+    }
+  }
+
+  // the straightforward welder, one sorted map entry per unique vertex. bitwise like
+  // weldVertices, but without the special case for -0
+  static uint32 ReferenceWeld(const IntermediateMeshData& source, IntermediateMeshData& data)
+  {
+    std::map<std::vector<uint32>, uint32> vertices;
+    std::vector<uint32> key;
+    data.indices.clear();
+
+    for (uint32 v = 0; v < source.position.getSize(); ++v)
+    {
+      const Vector3 position = source.position.get(v);
+      const Vector3 normal = source.normal.isEmpty() ? Vector3(0.0f, 0.0f, 0.0f) : source.normal.get(v);
+      const Vector2 uv = source.uv0.empty() ? Vector2(0.0f, 0.0f) : source.uv0[v];
+      const float values[] = { position.x, position.y, position.z, normal.x, normal.y, normal.z, uv.x, uv.y };
+
+      key.resize(sizeof(values) / sizeof(values[0]));
+      memcpy(&key[0], values, sizeof(values));
+
+      std::map<std::vector<uint32>, uint32>::const_iterator it = vertices.find(key);
+      if (it == vertices.end())
+      {
+        it = vertices.insert(std::make_pair(key, (uint32)vertices.size())).first;
+        data.position.add(position);
+        if (!source.normal.isEmpty())
+          data.normal.add(normal);
+        if (!source.uv0.empty())
+          data.uv0.push_back(uv);
+      }
+      data.indices.push_back(it->second);
+    }
+
+    return vertices.size();
+  }
+
+  static bool Equals(const Vector3& a, const Vector3& b)
+  {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+  }
+
+  static bool Equals(const IntermediateMeshData& a, const IntermediateMeshData& b)
+  {
+    bool equal = a.position.getSize() == b.position.getSize() && a.normal.getSize() == b.normal.getSize() && a.uv0.size() == b.uv0.size() && a.indices == b.indices;
+    for (uint32 v = 0; equal && v < a.position.getSize(); ++v)
+    {
+      equal &= Equals(a.position.get(v), b.position.get(v));
+      if (!a.normal.isEmpty())
+        equal &= Equals(a.normal.get(v), b.normal.get(v));
+      if (!a.uv0.empty())
+        equal &= a.uv0[v].x == b.uv0[v].x && a.uv0[v].y == b.uv0[v].y;
+    }
+
+    return equal;
+  }
+
+  static void TestVertexWelding(uint32 size = 120)
+  {
+    printf("\nStarting Vertex Welding Tests...\n");
+
+    printf("Test 1 (duplicates)\n");
+    {
+      // two triangles sharing an edge
+      IntermediateMeshData source;
+      const float quad[] = { 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1 };
+      for (uint32 i = 0; i < 6; ++i)
+      {
+        source.position.add(Vector3(quad[i * 2], 0.0f, quad[i * 2 + 1]));
+        source.normal.add(Vector3(0.0f, 1.0f, 0.0f));
+        source.uv0.push_back(Vector2(quad[i * 2], quad[i * 2 + 1]));
+      }
+
+      IntermediateMeshData data;
+      RUN_TEST(weldVertices(source, data) == 4 && data.position.getSize() == 4 && data.normal.getSize() == 4 && data.uv0.size() == 4);
+
+      const uint32 expected[] = { 0, 1, 2, 0, 2, 3 };
+      RUN_TEST(data.indices.size() == 6 && memcmp(&data.indices[0], expected, sizeof(expected)) == 0);
+      RUN_TEST(Equals(data.position.get(3), Vector3(0.0f, 0.0f, 1.0f)) && data.uv0[3].y == 1.0f);
+
+      // welding again changes nothing, the existing indices are remapped
+      IntermediateMeshData welded;
+      RUN_TEST(weldVertices(data, welded) == 4 && welded.indices == data.indices);
+
+      // the same position with another normal or texcoord is a different vertex
+      source.normal.set(3, Vector3(0.0f, -1.0f, 0.0f));
+      source.uv0[4] = Vector2(1.0f, 0.5f);
+      RUN_TEST(weldVertices(source, data) == 6);
+
+      // -0 and 0 compare equal
+      source.normal.set(3, Vector3(-0.0f, 1.0f, -0.0f));
+      source.uv0[3] = Vector2(-0.0f, -0.0f);
+      source.uv0[4] = Vector2(1.0f, 1.0f);
+      RUN_TEST(weldVertices(source, data) == 4 && memcmp(&data.indices[0], expected, sizeof(expected)) == 0);
+    }
+
+    printf("\nTest 2 (epsilon)\n");
+    {
+      IntermediateMeshData source;
+      source.position.add(Vector3(1.0f, 2.0f, 3.0f));
+      source.position.add(Vector3(1.0001f, 2.0f, 2.9999f));
+      source.position.add(Vector3(1.01f, 2.0f, 3.0f));
+
+      IntermediateMeshData data;
+      RUN_TEST(weldVertices(source, data) == 3);
+      RUN_TEST(weldVertices(source, data, 0.001f) == 2 && data.indices[1] == 0 && Equals(data.position.get(0), Vector3(1.0f, 2.0f, 3.0f)));
+      RUN_TEST(weldVertices(source, data, 0.1f) == 1);
+    }
+
+    printf("\nTest 3 (large)\n");
+    {
+      // big enough to be partitioned
+      IntermediateMeshData source;
+      GenerateTriangleSoup(size, source);
+
+      IntermediateMeshData data;
+      IntermediateMeshData reference;
+      RUN_TEST(weldVertices(source, data) == (size + 1) * (size + 1));
+      RUN_TEST(ReferenceWeld(source, reference) == (size + 1) * (size + 1));
+      RUN_TEST(Equals(data, reference));
+    }
+  }
+
+
+  // random triangle order, the winding is kept
+  static void ShuffleTriangles(Array<uint32>& indices, uint32 seed = 12345)
+  {
+    for (uint32 t = indices.size() / 3; t > 1; --t)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      const uint32 other = (seed >> 8) % t;
+      for (uint32 k = 0; k < 3; ++k)
+        std::swap(indices[(t - 1) * 3 + k], indices[other * 3 + k]);
+    }
+  }
+
+  // the triangles as sorted list of position triples, each rotated to start with its smallest
+  // position. independent of the triangle and vertex order, but not of the winding
+  static std::vector<std::vector<float> > GetTriangles(const IntermediateMeshData& data)
+  {
+    std::vector<std::vector<float> > triangles(data.indices.size() / 3);
+    for (uint32 t = 0; t < triangles.size(); ++t)
+    {
+      std::vector<float> corners[3];
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        const Vector3 position = data.position.get(data.indices[t * 3 + k]);
+        const float values[] = { position.x, position.y, position.z };
+        corners[k].assign(values, values + 3);
+      }
+
+      const uint32 first = corners[1] < corners[0] ? (corners[2] < corners[1] ? 2 : 1) : (corners[2] < corners[0] ? 2 : 0);
+      for (uint32 k = 0; k < 3; ++k)
+        triangles[t].insert(triangles[t].end(), corners[(first + k) % 3].begin(), corners[(first + k) % 3].end());
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+  }
+
+  static void TestVertexCacheOptimizer(uint32 size = 100)
+  {
+    printf("\nStarting Vertex Cache Optimizer Tests...\n");
+
+    printf("Test 1 (statistics)\n");
+    {
+      const uint32 indices[] = { 0, 1, 2, 2, 1, 3, 0, 1, 2, 4, 5, 6 };
+      VertexCacheStatistics statistics = analyzeVertexCache(indices, 12, 8);
+      RUN_TEST(statistics.numTransformed == 7 && statistics.acmr == 7.0f / 4.0f && statistics.atvr == 1.0f);
+
+      // a cache of 3 vertices has lost vertex 0 after the second triangle
+      statistics = analyzeVertexCache(indices, 12, 8, 3);
+      RUN_TEST(statistics.numTransformed == 10 && statistics.atvr == 10.0f / 7.0f);
+
+      statistics = analyzeVertexCache(indices, 0, 8);
+      RUN_TEST(statistics.numTransformed == 0 && statistics.acmr == 0.0f && statistics.atvr == 0.0f);
+    }
+
+    printf("\nTest 2 (triangle order)\n");
+    {
+      IntermediateMeshData soup;
+      IntermediateMeshData data;
+      GenerateTriangleSoup(size, soup);
+      weldVertices(soup, data);
+      ShuffleTriangles(data.indices);
+
+      const uint32 numVertices = data.position.getSize();
+      const VertexCacheStatistics shuffled = analyzeVertexCache(&data.indices[0], data.indices.size(), numVertices);
+
+      Array<uint32> indices;
+      indices.resize(data.indices.size());
+      optimizeVertexCache(&indices[0], &data.indices[0], data.indices.size(), numVertices);
+      const VertexCacheStatistics optimized = analyzeVertexCache(&indices[0], indices.size(), numVertices);
+      printf("acmr %.3f -> %.3f, atvr %.3f -> %.3f\n", shuffled.acmr, optimized.acmr, shuffled.atvr, optimized.atvr);
+      RUN_TEST(shuffled.acmr > 2.5f && optimized.acmr < 0.8f && optimized.atvr < 1.4f);
+
+      // the same triangles with the same winding
+      IntermediateMeshData reordered = data;
+      reordered.indices = indices;
+      RUN_TEST(GetTriangles(reordered) == GetTriangles(data));
+
+      // in place gives the same result
+      Array<uint32> inPlace = data.indices;
+      optimizeVertexCache(&inPlace[0], &inPlace[0], inPlace.size(), numVertices);
+      RUN_TEST(inPlace == indices);
+
+      // degenerate triangles and unused vertices
+      const uint32 degenerate[] = { 0, 0, 1, 2, 3, 2, 5, 5, 5, 0, 1, 2 };
+      uint32 result[12];
+      optimizeVertexCache(result, degenerate, 12, 8);
+
+      uint32 triangles[2][4];
+      for (uint32 t = 0; t < 4; ++t)
+      {
+        triangles[0][t] = degenerate[t * 3] * 64 + degenerate[t * 3 + 1] * 8 + degenerate[t * 3 + 2];
+        triangles[1][t] = result[t * 3] * 64 + result[t * 3 + 1] * 8 + result[t * 3 + 2];
+      }
+      std::sort(triangles[0], triangles[0] + 4);
+      std::sort(triangles[1], triangles[1] + 4);
+      RUN_TEST(memcmp(triangles[0], triangles[1], sizeof(triangles[0])) == 0 && analyzeVertexCache(result, 12, 8).numTransformed == 5);
+    }
+
+    printf("\nTest 3 (vertex order)\n");
+    {
+      IntermediateMeshData soup;
+      IntermediateMeshData data;
+      GenerateTriangleSoup(size, soup);
+      weldVertices(soup, data);
+      ShuffleTriangles(data.indices);
+
+      // an unused vertex at the end
+      data.position.add(Vector3(1.0f, 2.0f, 3.0f));
+      data.normal.add(Vector3(0.0f, 1.0f, 0.0f));
+      data.uv0.push_back(Vector2(0.0f, 0.0f));
+
+      IntermediateMeshData optimized = data;
+      optimizeMesh(optimized, MeshCookSettings());
+      RUN_TEST(optimized.position.getSize() == data.position.getSize() - 1 && optimized.normal.getSize() == optimized.position.getSize() && optimized.uv0.size() == optimized.position.getSize());
+      RUN_TEST(GetTriangles(optimized) == GetTriangles(data));
+
+      // every vertex is one after the highest one used before
+      bool firstUse = true;
+      uint32 numUsed = 0;
+      for (uint32 i = 0; i < optimized.indices.size(); ++i)
+      {
+        firstUse &= optimized.indices[i] <= numUsed;
+        numUsed = max(numUsed, optimized.indices[i] + 1);
+      }
+      RUN_TEST(firstUse);
+
+      // the texcoords moved with the positions, the grid maps them to the xz plane
+      bool attributes = true;
+      for (uint32 v = 0; v < optimized.position.getSize(); ++v)
+        attributes &= optimized.position.get(v).x == optimized.uv0[v].x * 10.0f && optimized.normal.get(v).z == optimized.uv0[v].y;
+      RUN_TEST(attributes);
+    }
+  }
+
+
+  // concentric spheres facing outwards, the innermost first. drawn in this order every pixel
+  // is shaded once per sphere
+  static void GenerateSpheres(uint32 numSpheres, uint32 segments, IntermediateMeshData& data)
+  {
+    for (uint32 s = 0; s < numSpheres; ++s)
+    {
+      const uint32 first = data.position.getSize();
+      for (uint32 i = 0; i <= segments; ++i)
+      {
+        for (uint32 j = 0; j <= segments; ++j)
+        {
+          const float theta = HALF_PI - PI * i / segments;
+          const float phi = TWO_PI * j / segments;
+          data.position.add(Vector3(cos(theta) * cos(phi), sin(theta), cos(theta) * sin(phi)) * (s + 1.0f));
+        }
+      }
+
+      for (uint32 i = 0; i < segments; ++i)
+      {
+        for (uint32 j = 0; j < segments; ++j)
+        {
+          const uint32 topLeft = first + j + i * (segments + 1);
+          const uint32 bottomLeft = topLeft + segments + 1;
+          const uint32 quad[] = { topLeft, topLeft + 1, bottomLeft, topLeft + 1, bottomLeft + 1, bottomLeft };
+          data.indices.insert(data.indices.end(), quad, quad + 6);
+        }
+      }
+    }
+  }
+
+  static void TestOverdrawOptimizer(uint32 segments = 32)
+  {
+    printf("\nStarting Overdraw Optimizer Tests...\n");
+
+    printf("Test 1 (statistics)\n");
+    {
+      // two quads facing up, y = 1 covers y = 0 seen from above. the back faces are culled and
+      // the edge of the triangles isn't shaded twice
+      IntermediateMeshData data;
+      for (uint32 y = 0; y < 2; ++y)
+      {
+        data.position.add(Vector3(0.0f, (float)y, 0.0f));
+        data.position.add(Vector3(0.0f, (float)y, 1.0f));
+        data.position.add(Vector3(1.0f, (float)y, 0.0f));
+        data.position.add(Vector3(1.0f, (float)y, 1.0f));
+      }
+
+      const uint32 frontToBack[] = { 4, 5, 6, 6, 5, 7, 0, 1, 2, 2, 1, 3 };
+      const uint32 backToFront[] = { 0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7 };
+      const uint32 numPixels = OverdrawViewportSize * OverdrawViewportSize;
+
+      OverdrawStatistics statistics = analyzeOverdraw(frontToBack, 12, data.position.getSoA(), 8);
+      RUN_TEST(statistics.numCovered == numPixels && statistics.numShaded == numPixels && statistics.overdraw == 1.0f);
+
+      statistics = analyzeOverdraw(backToFront, 12, data.position.getSoA(), 8);
+      RUN_TEST(statistics.numCovered == numPixels && statistics.numShaded == numPixels * 2 && statistics.overdraw == 2.0f);
+
+      statistics = analyzeOverdraw(backToFront, 0, data.position.getSoA(), 8);
+      RUN_TEST(statistics.numCovered == 0 && statistics.overdraw == 0.0f);
+    }
+
+    printf("\nTest 2 (cluster order)\n");
+    {
+      IntermediateMeshData data;
+      GenerateSpheres(4, segments, data);
+
+      const uint32 numIndices = data.indices.size();
+      const uint32 numVertices = data.position.getSize();
+      optimizeVertexCache(&data.indices[0], &data.indices[0], numIndices, numVertices);
+
+      IntermediateMeshData optimized = data;
+      optimizeOverdraw(&optimized.indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices);
+
+      const OverdrawStatistics before = analyzeOverdraw(&data.indices[0], numIndices, data.position.getSoA(), numVertices);
+      const OverdrawStatistics after = analyzeOverdraw(&optimized.indices[0], numIndices, optimized.position.getSoA(), numVertices);
+      const VertexCacheStatistics cacheBefore = analyzeVertexCache(&data.indices[0], numIndices, numVertices);
+      const VertexCacheStatistics cacheAfter = analyzeVertexCache(&optimized.indices[0], numIndices, numVertices);
+      printf("overdraw %.3f -> %.3f, acmr %.3f -> %.3f\n", before.overdraw, after.overdraw, cacheBefore.acmr, cacheAfter.acmr);
+
+      RUN_TEST(before.numCovered == after.numCovered && before.overdraw > 1.5f && after.overdraw < 1.1f);
+      RUN_TEST(cacheAfter.acmr < cacheBefore.acmr * 1.1f);
+      RUN_TEST(GetTriangles(optimized) == GetTriangles(data));
+
+      // a threshold below 1 can't be met, every hard cluster stays in one piece
+      Array<uint32> indices;
+      indices.resize(numIndices);
+      optimizeOverdraw(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, 0.5f);
+      RUN_TEST(analyzeVertexCache(&indices[0], numIndices, numVertices).numTransformed == cacheBefore.numTransformed);
+    }
+  }
+
+
+  // directed edges without an opposite, by position. triangles with two equal positions don't count
+  static std::vector<std::vector<float> > GetOpenEdges(const uint32* indices, uint32 numIndices, const IntermediateMeshData& data)
+  {
+    std::map<std::vector<float>, int> edges;
+    for (uint32 t = 0; t < numIndices / 3; ++t)
+    {
+      std::vector<float> corners[3];
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        const Vector3 position = data.position.get(indices[t * 3 + k]);
+        const float values[] = { position.x, position.y, position.z };
+        corners[k].assign(values, values + 3);
+      }
+      if (corners[0] == corners[1] || corners[0] == corners[2] || corners[1] == corners[2])
+        continue;
+
+      for (uint32 k = 0; k < 3; ++k)
+      {
+        std::vector<float> edge = corners[k];
+        edge.insert(edge.end(), corners[(k + 1) % 3].begin(), corners[(k + 1) % 3].end());
+        ++edges[edge];
+
+        std::vector<float> opposite = corners[(k + 1) % 3];
+        opposite.insert(opposite.end(), corners[k].begin(), corners[k].end());
+        --edges[opposite];
+      }
+    }
+
+    std::vector<std::vector<float> > open;
+    for (std::map<std::vector<float>, int>::const_iterator it = edges.begin(); it != edges.end(); ++it)
+    {
+      if (it->second > 0)
+        open.push_back(it->first);
+    }
+    return open;
+  }
+
+  static void TestMeshSimplifier(uint32 segments = 48)
+  {
+    printf("\nStarting Mesh Simplifier Tests...\n");
+
+    printf("Test 1 (closed mesh with a texture seam)\n");
+    {
+      // the first and last column of the sphere share their positions, the poles are fans of
+      // slivers, open but locked
+      IntermediateMeshData data;
+      GenerateSpheres(1, segments, data);
+      for (uint32 row = 0; row <= segments; ++row)
+        data.position.set(row * (segments + 1) + segments, data.position.get(row * (segments + 1)));
+      const uint32 numIndices = data.indices.size();
+      const uint32 numVertices = data.position.getSize();
+      const std::vector<std::vector<float> > poles = GetOpenEdges(&data.indices[0], numIndices, data);
+
+      Array<uint32> indices;
+      indices.resize(numIndices);
+      float previousError = 0.0f;
+      bool reduced = true;
+      bool monotonic = true;
+      bool closed = true;
+      bool seam = true;
+      for (uint32 level = 1; level <= 3; ++level)
+      {
+        const uint32 target = (numIndices >> level) / 3 * 3;
+        float error;
+        const uint32 count = simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, target, FLT_MAX, true, &error);
+        printf("%u -> %u indices, error %f\n", numIndices, count, error);
+
+        reduced &= count <= target && count > 0;
+        monotonic &= error > previousError;
+        closed &= GetOpenEdges(&indices[0], count, data) == poles;
+        previousError = error;
+
+        // both sides of the seam keep the same vertices
+        std::set<std::vector<float> > sides[2];
+        for (uint32 i = 0; i < count; ++i)
+        {
+          const uint32 row = indices[i] / (segments + 1);
+          const uint32 column = indices[i] % (segments + 1);
+          if (row == 0 || row == segments || (column != 0 && column != segments))
+            continue;
+
+          const Vector3 position = data.position.get(indices[i]);
+          const float values[] = { position.x, position.y, position.z };
+          sides[column != 0].insert(std::vector<float>(values, values + 3));
+        }
+        seam &= !sides[0].empty() && sides[0] == sides[1];
+      }
+      RUN_TEST(reduced);
+      RUN_TEST(monotonic);
+      RUN_TEST(closed);
+      RUN_TEST(seam);
+
+      // the error bound wins over the target
+      float error;
+      const uint32 target = numIndices / 8 / 3 * 3;
+      simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, target, FLT_MAX, true, &error);
+      float boundedError;
+      const uint32 count = simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, target, error * 0.5f, true, &boundedError);
+      RUN_TEST(count > target && count < numIndices && boundedError <= error * 0.5f);
+
+      Array<uint32> inPlace = data.indices;
+      simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, target);
+      RUN_TEST(simplifyMesh(&inPlace[0], &inPlace[0], numIndices, data.position.getSoA(), numVertices, target) <= target);
+      RUN_TEST(memcmp(&inPlace[0], &indices[0], target * sizeof(uint32)) == 0);
+    }
+
+    printf("\nTest 2 (open border)\n");
+    {
+      IntermediateMeshData source;
+      IntermediateMeshData data;
+      GenerateTriangleSoup(32, source);
+      weldVertices(source, data);
+      const uint32 numIndices = data.indices.size();
+      const uint32 numVertices = data.position.getSize();
+      const std::vector<std::vector<float> > border = GetOpenEdges(&data.indices[0], numIndices, data);
+
+      // the border of a chunk has to match its neighbours
+      Array<uint32> indices;
+      indices.resize(numIndices);
+      uint32 count = simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, numIndices / 4);
+      RUN_TEST(count < numIndices / 2 && GetOpenEdges(&indices[0], count, data) == border);
+
+      // unlocked the border is simplified too, but stays on the outline of the grid
+      count = simplifyMesh(&indices[0], &data.indices[0], numIndices, data.position.getSoA(), numVertices, numIndices / 4, FLT_MAX, false);
+      const std::vector<std::vector<float> > simplifiedBorder = GetOpenEdges(&indices[0], count, data);
+      bool outline = simplifiedBorder.size() < border.size();
+      for (uint32 i = 0; i < simplifiedBorder.size(); ++i)
+      {
+        for (uint32 k = 0; k < 6; k += 3)
+        {
+          const float x = simplifiedBorder[i][k + 0];
+          const float z = simplifiedBorder[i][k + 2];
+          outline &= x == 0.0f || x == 10.0f || z == 0.0f || z == 10.0f;
+        }
+      }
+      RUN_TEST(count <= numIndices / 4 && outline);
+    }
+
+    printf("\nTest 3 (levels of detail)\n");
+    {
+      IntermediateMeshData data;
+      GenerateSpheres(2, segments, data);
+      const IntermediateMeshData source = data;
+
+      MeshCookSettings settings;
+      settings.numLods = MaxMeshLods;
+      generateLods(data, settings);
+      RUN_TEST(data.lods.size() == MaxMeshLods && data.lods[0].numIndices == source.indices.size());
+
+      bool chained = true;
+      for (uint32 lod = 1; lod < data.lods.size(); ++lod)
+      {
+        chained &= data.lods[lod].firstIndex == data.lods[lod - 1].firstIndex + data.lods[lod - 1].numIndices;
+        chained &= data.lods[lod].numIndices <= (uint32)(source.indices.size() * settings.lodRatios[lod]) && data.lods[lod].error > data.lods[lod - 1].error;
+      }
+      RUN_TEST(chained && data.lods.back().firstIndex + data.lods.back().numIndices == data.indices.size());
+
+      // the levels are optimized on their own and share the vertices
+      optimizeMesh(data, settings);
+      IntermediateMeshData finest = data;
+      finest.indices.resize(data.lods[0].numIndices);
+      RUN_TEST(GetTriangles(finest) == GetTriangles(source) && data.position.getSize() == source.position.getSize());
+
+      const MeshLod lods[] = { { 0, 300, 0.0f }, { 300, 200, 0.1f }, { 500, 100, 0.4f } };
+      RUN_TEST(selectMeshLod(lods, 3, 0.0f) == 0 && selectMeshLod(lods, 3, 0.2f) == 1 && selectMeshLod(lods, 3, 1.0f) == 2 && selectMeshLod(lods, 1, 1.0f) == 0);
+    }
+  }
+
+  static void TestMeshlets(uint32 size = 64, uint32 segments = 64)
+  {
+    printf("\nStarting Meshlet Tests...\n");
+
+    printf("Test 1 (partitioning)\n");
+    {
+      IntermediateMeshData source;
+      IntermediateMeshData data;
+      GenerateTriangleSoup(size, source);
+      weldVertices(source, data);
+      optimizeVertexCache(&data.indices[0], &data.indices[0], data.indices.size(), data.position.getSize());
+
+      IntermediateMeshData partitioned = data;
+      Array<ubyte> block;
+      const uint32 numMeshlets = buildMeshlets(block, &partitioned.indices[0], partitioned.indices.size(), partitioned.position.getSoA(), partitioned.position.getSize());
+      MeshletArrays meshlets(&block[0], numMeshlets);
+      printf("%d triangles in %d meshlets\n", data.indices.size() / 3, numMeshlets);
+
+      RUN_TEST(block.size() == numMeshlets * MeshletStride && numMeshlets >= data.indices.size() / 3 / MaxMeshletTriangles);
+      RUN_TEST(GetTriangles(partitioned) == GetTriangles(data));
+
+      // back to back ranges within the limits, the bounds contain their triangles
+      bool ranges = true;
+      bool limits = true;
+      bool spheres = true;
+      bool cones = true;
+      uint32 numTriangles = 0;
+      for (uint32 m = 0; m < numMeshlets; ++m)
+      {
+        ranges &= meshlets.firstIndex[m] == numTriangles * 3 && meshlets.numIndices[m] % 3 == 0 && meshlets.numIndices[m] > 0;
+        numTriangles += meshlets.numIndices[m] / 3;
+
+        std::set<uint32> vertices(&partitioned.indices[meshlets.firstIndex[m]], &partitioned.indices[meshlets.firstIndex[m]] + meshlets.numIndices[m]);
+        limits &= vertices.size() <= MaxMeshletVertices && meshlets.numIndices[m] <= MaxMeshletTriangles * 3;
+
+        const Vector3 center(meshlets.center.x[m], meshlets.center.y[m], meshlets.center.z[m]);
+        const Vector3 axis(meshlets.coneAxis.x[m], meshlets.coneAxis.y[m], meshlets.coneAxis.z[m]);
+        const float minCosine = sqrt(1.0f - meshlets.coneCutoff[m] * meshlets.coneCutoff[m]);
+        for (uint32 i = meshlets.firstIndex[m]; i < meshlets.firstIndex[m] + meshlets.numIndices[m]; i += 3)
+        {
+          const Vector3 p0 = partitioned.position.get(partitioned.indices[i]);
+          const Vector3 p1 = partitioned.position.get(partitioned.indices[i + 1]);
+          const Vector3 p2 = partitioned.position.get(partitioned.indices[i + 2]);
+          spheres &= length(p0 - center) <= meshlets.radius[m] * 1.0001f && length(p1 - center) <= meshlets.radius[m] * 1.0001f &&
+            length(p2 - center) <= meshlets.radius[m] * 1.0001f;
+          cones &= dot(axis, normalize(cross(p1 - p0, p2 - p0))) >= minCosine - 0.0001f;
+        }
+      }
+      RUN_TEST(ranges && numTriangles * 3 == data.indices.size());
+      RUN_TEST(limits);
+      RUN_TEST(spheres && cones);
+
+      // close to the vertex to triangle ratio of a meshlet, without islands of a few triangles
+      const VertexCacheStatistics before = analyzeVertexCache(&data.indices[0], data.indices.size(), data.position.getSize());
+      const VertexCacheStatistics after = analyzeVertexCache(&partitioned.indices[0], partitioned.indices.size(), partitioned.position.getSize());
+      printf("acmr %.3f -> %.3f\n", before.acmr, after.acmr);
+      RUN_TEST(after.acmr < 0.9f && numMeshlets < data.indices.size() / 3 / 88);
+    }
+
+    printf("\nTest 2 (culling)\n");
+    {
+      IntermediateMeshData data;
+      GenerateSpheres(1, segments, data);
+      Array<ubyte> block;
+      const uint32 numMeshlets = buildMeshlets(block, &data.indices[0], data.indices.size(), data.position.getSoA(), data.position.getSize());
+      MeshletArrays meshlets(&block[0], numMeshlets);
+
+      Matrix4 view;
+      Matrix4 proj;
+      const Vector3 cameraPosition(0.0f, 0.0f, -10.0f);
+      makeLookAt(view, cameraPosition, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+      makePerspectiveProjMatrix(proj, PI / 4.0f, 1.0f, 0.1f, 100.0f);
+      const Frustum frustum(proj * view);
+
+      Array<uint32> culled;
+      culled.resize(data.indices.size());
+      const uint32 count = cullMeshlets(&culled[0], &data.indices[0], sizeof(uint32), meshlets, frustum, cameraPosition);
+
+      // every triangle facing the camera survives
+      uint32 numFrontFaces = 0;
+      uint32 numCulledFrontFaces = 0;
+      const uint32* lists[] = { &data.indices[0], &culled[0] };
+      const uint32 counts[] = { data.indices.size(), count };
+      for (uint32 list = 0; list < 2; ++list)
+      {
+        for (uint32 i = 0; i < counts[list]; i += 3)
+        {
+          const Vector3 p0 = data.position.get(lists[list][i]);
+          const Vector3 normal = cross(data.position.get(lists[list][i + 1]) - p0, data.position.get(lists[list][i + 2]) - p0);
+          if (dot(normal, cameraPosition - p0) > 0.0f)
+            ++(list ? numCulledFrontFaces : numFrontFaces);
+        }
+      }
+      printf("%d of %d indices visible\n", count, data.indices.size());
+      RUN_TEST(numCulledFrontFaces == numFrontFaces && count < data.indices.size() * 3 / 4);
+
+      // 16 bit indices are copied as they are
+      Array<uint16> shortIndices;
+      shortIndices.assign(data.indices.begin(), data.indices.end());
+      Array<uint16> shortCulled;
+      shortCulled.resize(shortIndices.size());
+      RUN_TEST(cullMeshlets(&shortCulled[0], &shortIndices[0], sizeof(uint16), meshlets, frustum, cameraPosition) == count);
+      RUN_TEST(std::equal(culled.begin(), culled.begin() + count, shortCulled.begin()));
+
+      // looking away
+      makeLookAt(view, cameraPosition, Vector3(0.0f, 0.0f, -20.0f), Vector3(0.0f, 1.0f, 0.0f));
+      RUN_TEST(cullMeshlets(&culled[0], &data.indices[0], sizeof(uint32), meshlets, Frustum(proj * view), cameraPosition) == 0);
+    }
+  }
+
+  // the unit sphere of GenerateSpheres with normals and texcoords, moved by offset
+  static void GenerateSphereVertices(uint32 segments, const Vector3& offset, IntermediateMeshData& data)
+  {
+    GenerateSpheres(1, segments, data);
+    for (uint32 v = 0; v < data.position.getSize(); ++v)
+    {
+      const Vector3 position = data.position.get(v);
+      data.normal.add(position);
+      data.uv0.push_back(Vector2(position.x * 0.5f + 0.5f, position.y * 0.5f + 0.5f));
+      data.position.set(v, position + offset);
+    }
+  }
+
+  // a component as read by the gpu
+  static float UnpackComponent(eVertexElementFormat format, const ubyte* data, uint32 component)
+  {
+    switch (format)
+    {
+    case VEF_HALF2:
+    case VEF_HALF4: return halfToFloat(((const uint16*)data)[component]);
+    case VEF_SHORT4N: return max(((const short*)data)[component] / 32767.0f, -1.0f);
+    case VEF_BYTE4N: return max(((const signed char*)data)[component] / 127.0f, -1.0f);
+    }
+
+    return ((const float*)data)[component];
+  }
+
+  static void TestVertexPacking(uint32 segments = 32)
+  {
+    printf("\nStarting Vertex Packing Tests...\n");
+
+    printf("Test 1 (formats)\n");
+    {
+      IntermediateMeshData data;
+      GenerateSphereVertices(segments, Vector3(0.0f, 0.0f, 0.0f), data);
+      MeshCookSettings settings;
+      VertexDeclaration declaration;
+      VertexPackingStatistics statistics;
+      createVertexDeclaration(data, declaration);
+      selectVertexFormats(&data, 1, settings, declaration, statistics);
+      printf("%d -> %d bytes per vertex, errors %f %f %f\n", statistics.sourceVertexSize, statistics.vertexSize,
+        statistics.maxError[0], statistics.maxError[1], statistics.maxError[2]);
+
+      // around the origin half floats are precise enough, the elements move closer together
+      RUN_TEST(declaration.getElement(0)->format == VEF_HALF4 && declaration.getElement(1)->format == VEF_BYTE4N &&
+        declaration.getElement(2)->format == VEF_HALF2);
+      RUN_TEST(statistics.sourceVertexSize == 32 && statistics.vertexSize == 16 && declaration.getElement(2)->byteOffset == 12);
+      RUN_TEST(statistics.maxError[0] <= settings.positionTolerance * length(Vector3(2.0f, 2.0f, 2.0f)) &&
+        statistics.maxError[1] <= settings.normalTolerance && statistics.maxError[2] <= settings.texcoordTolerance);
+
+      // far away from it the positions are stored relative to the bounds
+      IntermediateMeshData offset;
+      GenerateSphereVertices(segments, Vector3(1000.0f, 0.0f, 0.0f), offset);
+      createVertexDeclaration(offset, declaration);
+      selectVertexFormats(&offset, 1, settings, declaration, statistics);
+      RUN_TEST(declaration.getElement(0)->format == VEF_SHORT4N && statistics.vertexSize == 16);
+
+      // and without any tolerance everything stays as it is
+      settings.positionTolerance = settings.normalTolerance = settings.texcoordTolerance = 0.0f;
+      createVertexDeclaration(data, declaration);
+      selectVertexFormats(&data, 1, settings, declaration, statistics);
+      RUN_TEST(declaration.getElement(0)->format == VEF_FLOAT3 && declaration.getElement(1)->format == VEF_FLOAT3 &&
+        declaration.getElement(2)->format == VEF_FLOAT2);
+      RUN_TEST(statistics.vertexSize == 32 && statistics.maxError[0] == 0.0f);
+    }
+
+    printf("\nTest 2 (packing)\n");
+    {
+      IntermediateMeshData data;
+      GenerateSphereVertices(segments, Vector3(1000.0f, 0.0f, 0.0f), data);
+      MeshCookSettings settings;
+      VertexDeclaration declaration;
+      VertexPackingStatistics statistics;
+      createVertexDeclaration(data, declaration, OPT_USE_MULTI_STREAM);
+      selectVertexFormats(&data, 1, settings, declaration, statistics);
+
+      CookedMeshChunk chunk;
+      cookMeshChunk(data, declaration, chunk);
+      RUN_TEST(chunk.vertexSize == 16 && declaration.getStreamStride(0) == 8 && declaration.getStreamStride(1) == 8);
+
+      // the errors read back match the statistics
+      Vector3 scale;
+      Vector3 bias;
+      getPositionDequantization(chunk.bounds, scale, bias);
+      const ubyte* positions = &chunk.vertices[0];
+      const ubyte* attributes = positions + chunk.numVertices * 8;
+      float errors[3] = { 0.0f, 0.0f, 0.0f };
+      for (uint32 v = 0; v < chunk.numVertices; ++v)
+      {
+        const ubyte* position = positions + v * 8;
+        const ubyte* normal = attributes + v * 8;
+        const Vector3 packedPosition(UnpackComponent(VEF_SHORT4N, position, 0) * scale.x + bias.x, UnpackComponent(VEF_SHORT4N, position, 1) * scale.y + bias.y,
+          UnpackComponent(VEF_SHORT4N, position, 2) * scale.z + bias.z);
+        const Vector3 packedNormal(UnpackComponent(VEF_BYTE4N, normal, 0), UnpackComponent(VEF_BYTE4N, normal, 1), UnpackComponent(VEF_BYTE4N, normal, 2));
+        const float du = UnpackComponent(VEF_HALF2, normal + 4, 0) - data.uv0[v].x;
+        const float dv = UnpackComponent(VEF_HALF2, normal + 4, 1) - data.uv0[v].y;
+
+        errors[0] = max(errors[0], length(packedPosition - data.position.get(v)));
+        errors[1] = max(errors[1], length(packedNormal - data.normal.get(v)));
+        errors[2] = max(errors[2], sqrtf(du * du + dv * dv));
+      }
+      printf("errors %f %f %f\n", errors[0], errors[1], errors[2]);
+
+      bool matching = true;
+      for (uint32 i = 0; i < 3; ++i)
+        matching &= errors[i] > 0.0f && fabs(errors[i] - statistics.maxError[i]) <= statistics.maxError[i] * 0.001f;
+      RUN_TEST(matching);
+    }
+
+    printf("\nTest 3 (mesh file)\n");
+    {
+      const String text = GenerateObj(16);
+      ObjData obj;
+      parseObj(text.c_str(), text.size(), obj);
+      obj.materialLib.clear();
+
+      CookedMesh cooked;
+      MeshData source;
+      MeshCookSettings settings;
+      settings.options |= OPT_16BIT_VERTEX_DATA;
+      RUN_TEST(cookObj(obj, String(), cooked, settings));
+      cooked.getMeshData(source);
+      RUN_TEST(cooked.packing.vertexSize < cooked.packing.sourceVertexSize && source.chunks[0].vertexSize == cooked.packing.vertexSize);
+
+      const char* fileName = "test.fmesh";
+      MappedFile file;
+      MeshData loaded;
+      RUN_TEST(writeMeshFile(fileName, source));
+      RUN_TEST(file.open(fileName) && readMeshFile(file.getPtr(), file.getSize(), loaded) && Equals(loaded, source));
+      file.close();
+      remove(fileName);
+    }
+  }
+
+#undef RUN_TEST
+
+}
+
+#endif // __MeshTest_h_
\ No newline at end of file
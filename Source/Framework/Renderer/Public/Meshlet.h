@@ -0,0 +1,42 @@
+#ifndef __Meshlet_h_
+#define __Meshlet_h_
+
+#include "Frustum.h"
+
+// meshlets are small clusters of a triangle list, culled one by one on the cpu. they are
+// contiguous ranges of the index list, the visible ones are gathered into a compacted list
+const uint32 MaxMeshletVertices = 64;
+const uint32 MaxMeshletTriangles = 124;
+
+// the per meshlet data as structure of arrays. the arrays lie back to back in a single block of
+// numMeshlets * MeshletStride bytes, in the order of the members below, so the block can be
+// written to and mapped from a mesh file as is
+const uint32 MeshletStride = 10 * sizeof(uint32);
+
+struct MeshletArrays
+{
+  MeshletArrays(void* block, uint32 numMeshlets);
+
+  uint32 numMeshlets;
+  uint32* firstIndex;         // range of the index list
+  uint32* numIndices;
+  Vector3SoA center;          // bounding sphere
+  float* radius;
+  Vector3SoA coneAxis;        // average normal
+  float* coneCutoff;          // sine of the largest angle to the axis, 1 if the cone is too wide
+};
+
+// splits the triangles into meshlets of at most maxVertices vertices and maxTriangles triangles,
+// grown from the first free triangle over shared vertices. the triangles are reordered in place
+// so every meshlet is a contiguous range, their order is kept as far as possible. block is
+// resized to hold the meshlet data, returns the number of meshlets
+uint32 buildMeshlets(Array<ubyte>& block, uint32* indices, uint32 numIndices, const Vector3SoA& positions, uint32 numVertices,
+  uint32 maxVertices = MaxMeshletVertices, uint32 maxTriangles = MaxMeshletTriangles);
+
+// copies the indices of the meshlets that intersect the frustum and face the camera to result,
+// in meshlet order. indices and result have indexSize bytes per index, result has to hold all
+// of them. returns the number of indices written
+uint32 cullMeshlets(void* result, const void* indices, uint32 indexSize, const MeshletArrays& meshlets, const Frustum& frustum,
+  const Vector3& cameraPosition);
+
+#endif // __Meshlet_h_
\ No newline at end of file
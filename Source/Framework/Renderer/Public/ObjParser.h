@@ -0,0 +1,34 @@
+#ifndef __ObjParser_h_
+#define __ObjParser_h_
+
+// 0 based indices into the attribute arrays of ObjData, -1 if the face doesn't reference one
+struct ObjVertex
+{
+  int position;
+  int texcoord;
+  int normal;
+};
+
+// the faces between two usemtl statements
+struct ObjGroup
+{
+  String material;            // empty for faces before the first usemtl
+  Array<ObjVertex> vertices;
+  Array<uint32> faceSizes;    // vertices per face, polygons aren't triangulated yet
+};
+
+struct ObjData
+{
+  String materialLib;
+  Array<float> positions;     // 3 floats per attribute, as written in the file
+  Array<float> normals;
+  Array<float> texcoords;
+  Array<ObjGroup> groups;     // in file order, empty groups are dropped
+};
+
+// the text is split at line boundaries into chunks which are parsed in parallel on the
+// task scheduler and stitched afterwards. numChunks = 0 picks a count from the number of
+// workers and the size. returns false for references to undefined vertices
+bool parseObj(const char* text, uint32 size, ObjData& data, uint32 numChunks = 0);
+
+#endif // __ObjParser_h_
\ No newline at end of file
@@ -63,6 +63,7 @@ private:
   ID3D11RenderTargetView* m_backBufferRTV;
 
   bool m_isFullScreen;
+  uint32 m_syncInterval;
 
   //// pipeline state
   SharedPtr<RenderTarget> m_boundRenderTargets[MAX_RENDER_TARGETS];
@@ -127,6 +127,8 @@ enum eVertexElementFormat
   VEF_SHORT4N,
   // special formats
   VEF_COLOR,
+  // 8 bit integer formats, after the others so the values of cooked meshes stay the same
+  VEF_BYTE4N,
 
   VEF_MAX
 };
@@ -4,8 +4,14 @@
 class Resource
 {
 public:
+  virtual ~Resource() {}
+
   virtual bool load(const String& fileName) = 0;
   virtual void unload() = 0;
+
+  // memory accounting, used by the resource managers for eviction
+  virtual uint32 getCpuMemorySize() const = 0;
+  virtual uint32 getGpuMemorySize() const = 0;
 };
 
 #endif // __Resource_h_
\ No newline at end of file
@@ -2,17 +2,108 @@
 #define __ResourceManager_h_
 
 #include "Resource.h"
+#include "Threading.h"
 
+enum eResourceState
+{
+  RS_LOADING,
+  RS_READY,
+  RS_FAILED
+};
+
+// shared by all requests for the same resource, owned by the manager
+struct ResourceEntry
+{
+  ResourceEntry(const String& name, uint32 hash)
+    : name(name)
+    , hash(hash)
+    , resource(0)
+    , state(RS_LOADING)
+    , refs(0)
+    , lastAccess(0)
+    , cpuMemorySize(0)
+    , gpuMemorySize(0)
+  {
+  }
+
+  String name;
+  uint32 hash;
+  Resource* resource;
+  volatile long state;
+  Event loaded;
+
+  // set in refs once the manager is destroyed while handles are left
+  static const long Orphaned = 0x40000000;
+
+  // residency, entries without handles are subject to eviction
+  volatile long refs;
+  volatile long lastAccess;
+  uint32 cpuMemorySize;
+  uint32 gpuMemorySize;
+};
+
+// keeps the resource resident as long as any handle references it
+class ResourceHandle
+{
+public:
+  ResourceHandle();
+  explicit ResourceHandle(ResourceEntry* entry);
+  ResourceHandle(const ResourceHandle& other);
+  ~ResourceHandle();
+
+  ResourceHandle& operator=(const ResourceHandle& other);
+
+  bool isValid() const { return m_entry != 0; }
+  bool isReady() const { return m_entry && m_entry->state == RS_READY; }
+  bool hasFailed() const { return !m_entry || m_entry->state == RS_FAILED; }
+
+  // returns 0 as long as the resource is not ready
+  Resource* get() const { return isReady() ? m_entry->resource : 0; }
+
+  // blocks until loading finished, returns 0 if loading failed
+  Resource* wait() const;
+
+  void release();
+
+private:
+  ResourceEntry* m_entry;
+};
+
+struct ResourceManagerStats
+{
+  uint32 hits;
+  uint32 misses;
+  uint32 evictions;
+  uint32 numResident;
+  uint64 cpuBytesResident;
+  uint64 gpuBytesResident;
+};
+
+// resources are loaded asynchronously on the task scheduler. load may be called
+// from any thread, concurrent requests for the same file join a single load.
+// unreferenced resources stay cached until the memory budget forces them out,
+// least recently used first.
 class ResourceManager
 {
 public:
   ResourceManager();
-  ~ResourceManager();
+  virtual ~ResourceManager();
+
+  // finishes the pending loads, later ones fail. derived managers call it in their
+  // destructor, queued loads would call createResource on a destroyed object otherwise
+  void shutdown();
 
-  Resource* load(const String& fileName);
+  ResourceHandle load(const String& fileName);
   void unload(Resource* resource);
   void unloadAll();
 
+  // cpu + gpu bytes, 0 disables eviction
+  void setMemoryBudget(uint64 bytes);
+  uint64 getMemoryBudget() const { return m_memoryBudget; }
+  void trimToBudget();
+
+  ResourceManagerStats getStats() const;
+
 protected:
   virtual Resource* createResource(const String& fileName) = 0;
 
@@ -20,8 +111,35 @@ private:
   ResourceManager(const ResourceManager&);
   ResourceManager& operator=(const ResourceManager&);
 
-  typedef std::hash_map<uint32, Resource*> ResourceTable;
-  ResourceTable m_resources;
+  void loadEntry(ResourceEntry* entry, const String& fileName);
+  bool evictEntry(ResourceEntry* entry);
+  void evict(uint64 targetBytes, bool allUnreferenced);
+
+  static const uint32 NumShards = 16;
+
+  // keyed by the normalized name, the hash only picks the shard so colliding names stay apart
+  typedef std::hash_map<String, ResourceEntry*> ResourceTable;
+
+  struct Shard
+  {
+    CriticalSection lock;
+    ResourceTable resources;
+  };
+
+  Shard m_shards[NumShards];
+
+  // residency accounting
+  mutable CriticalSection m_residencyLock;
+  uint64 m_memoryBudget;
+  uint64 m_cpuBytesResident;
+  uint64 m_gpuBytesResident;
+  uint32 m_numResident;
+  volatile long m_hits;
+  volatile long m_misses;
+  volatile long m_evictions;
+
+  // set by shutdown, loads that haven't started yet fail without calling createResource
+  volatile long m_shuttingDown;
 };
 
 #endif // __ResourceManager_h_
\ No newline at end of file
@@ -0,0 +1,193 @@
+#ifndef __ResourceManagerTest_h_
+#define __ResourceManagerTest_h_
+
+#include "ResourceManager.h"
+#include "TaskScheduler.h"
+#include "StringUtils.h"
+
+namespace ResourceManagerTest
+{
+
+#define RUN_TEST(test) { \
+    if ((test) == false) \
+      printf("WARNING: " #test " failed...\n"); \
+    else \
+      printf(#test " succeeded...\n"); }
+
+  static const uint32 ResourceSize = 1000;
+  static volatile long s_numAlive = 0;
+
+  // cpu and gpu size are fixed, counts its instances to catch leaks and double frees
+  class TestResource : public Resource
+  {
+  public:
+    TestResource() { atomicIncrement(&s_numAlive); }
+    virtual ~TestResource() { atomicDecrement(&s_numAlive); }
+
+    virtual bool load(const String& fileName) { return true; }
+    virtual void unload() {}
+
+    virtual uint32 getCpuMemorySize() const { return ResourceSize; }
+    virtual uint32 getGpuMemorySize() const { return ResourceSize; }
+  };
+
+  // files ending in .missing fail to load
+  class TestManager : public ResourceManager
+  {
+  public:
+    TestManager() : m_numCreated(0) {}
+    virtual ~TestManager() { shutdown(); }
+
+    long getNumCreated() const { return m_numCreated; }
+
+  protected:
+    virtual Resource* createResource(const String& fileName)
+    {
+      atomicIncrement(&m_numCreated);
+
+      // slow enough for concurrent requests to pile up on the loading entry
+      Sleep(1);
+
+      if (StringUtils::endsWith(fileName, ".missing"))
+        return 0;
+
+      return new TestResource();
+    }
+
+  private:
+    volatile long m_numCreated;
+  };
+
+  static void TestResourceManager(uint32 numWorkers = 4, uint32 numRequests = 256)
+  {
+    printf("\nStarting Resource Manager Tests...\n");
+
+    TaskScheduler::init(numWorkers);
+    const long numAlive = s_numAlive;
+
+    printf("Test 1 (concurrent loads)\n");
+    {
+      TestManager manager;
+
+      // different spellings of the same path share the entry
+      Array<ResourceHandle> handles;
+      handles.resize(numRequests);
+      TaskScheduler::parallelFor(numRequests, 1, [&](uint32 begin, uint32 end) {
+        for (uint32 i = begin; i < end; ++i)
+          handles[i] = manager.load(i & 1 ? "Data/Textures/Test.tga" : "data\\textures\\test.TGA");
+      });
+
+      bool allSame = true;
+      for (uint32 i = 0; i < numRequests; ++i)
+        allSame &= handles[i].wait() != 0 && handles[i].get() == handles[0].get();
+
+      const ResourceManagerStats stats = manager.getStats();
+      RUN_TEST(allSame);
+      RUN_TEST(manager.getNumCreated() == 1 && s_numAlive == numAlive + 1);
+      RUN_TEST(stats.misses == 1 && stats.hits == numRequests - 1);
+      RUN_TEST(stats.numResident == 1 && stats.cpuBytesResident == ResourceSize && stats.gpuBytesResident == ResourceSize);
+
+      ResourceHandle missing = manager.load("Data/Textures/Test.missing");
+      RUN_TEST(missing.wait() == 0 && missing.hasFailed() && manager.getStats().numResident == 1);
+    }
+    RUN_TEST(s_numAlive == numAlive);
+
+    printf("\nTest 2 (references)\n");
+    {
+      TestManager manager;
+
+      ResourceHandle handle = manager.load("a.tga");
+      Resource* resource = handle.wait();
+      ResourceHandle copy = handle;
+
+      // referenced resources are neither unloaded nor evicted
+      manager.unload(resource);
+      manager.unloadAll();
+      RUN_TEST(handle.get() == resource && s_numAlive == numAlive + 1);
+
+      handle.release();
+      manager.unloadAll();
+      RUN_TEST(!handle.isValid() && copy.get() == resource && s_numAlive == numAlive + 1);
+
+      copy.release();
+      manager.unloadAll();
+      const ResourceManagerStats stats = manager.getStats();
+      RUN_TEST(s_numAlive == numAlive && stats.numResident == 0 && stats.evictions == 1);
+      RUN_TEST(stats.cpuBytesResident == 0 && stats.gpuBytesResident == 0);
+
+      // gone from the cache, loading again creates a new one
+      handle = manager.load("a.tga");
+      RUN_TEST(handle.wait() != 0 && manager.getNumCreated() == 2);
+    }
+    RUN_TEST(s_numAlive == numAlive);
+
+    printf("\nTest 3 (lru eviction)\n");
+    {
+      TestManager manager;
+      manager.setMemoryBudget(3 * 2 * ResourceSize);
+
+      // r0 stays referenced, the others are released after loading, oldest first
+      ResourceHandle kept = manager.load("r0");
+      kept.wait();
+      for (uint32 i = 1; i < 5; ++i)
+      {
+        ResourceHandle handle = manager.load("r" + StringUtils::toString(i));
+        handle.wait();
+      }
+
+      // loading r3 and r4 pushed out r1 and r2
+      ResourceManagerStats stats = manager.getStats();
+      RUN_TEST(stats.numResident == 3 && stats.evictions == 2);
+      RUN_TEST(stats.cpuBytesResident + stats.gpuBytesResident <= manager.getMemoryBudget());
+
+      // touching r3 makes r4 the least recently used
+      manager.load("r3").wait();
+      manager.load("r1").wait();
+      RUN_TEST(manager.getNumCreated() == 6 && manager.getStats().evictions == 3);
+
+      const long numCreated = manager.getNumCreated();
+      manager.load("r3").wait();
+      manager.load("r1").wait();
+      RUN_TEST(manager.getNumCreated() == numCreated);
+      manager.load("r4").wait();
+      RUN_TEST(manager.getNumCreated() == numCreated + 1);
+
+      // never evicted while referenced, even if it is the oldest
+      RUN_TEST(kept.get() != 0 && manager.getStats().numResident == 3);
+
+      // no budget, nothing is evicted
+      manager.setMemoryBudget(0);
+      manager.load("r5").wait();
+      manager.load("r6").wait();
+      RUN_TEST(manager.getStats().numResident == 5);
+    }
+    RUN_TEST(s_numAlive == numAlive);
+
+    printf("\nTest 4 (shutdown)\n");
+    {
+      TestManager* manager = new TestManager();
+
+      // queued loads are finished or dropped, handles outliving the manager stay valid
+      ResourceHandle kept = manager->load("kept");
+      kept.wait();
+      for (uint32 i = 0; i < numRequests; ++i)
+        manager->load("queued" + StringUtils::toString(i));
+      delete manager;
+
+      RUN_TEST(kept.isReady() && kept.get() != 0 && s_numAlive == numAlive + 1);
+
+      ResourceHandle copy = kept;
+      kept.release();
+      RUN_TEST(copy.get() != 0 && s_numAlive == numAlive + 1);
+      copy.release();
+      RUN_TEST(s_numAlive == numAlive);
+    }
+
+    TaskScheduler::shutdown();
+  }
+
+#undef RUN_TEST
+
+}
+
+#endif // __ResourceManagerTest_h_
\ No newline at end of file
@@ -46,6 +46,7 @@ public:
   void setParamByName(const String& name, float value1, float value2, float value3);
   void setParamByName(const String& name, float value1, float value2, float value3, float value4);
   void setParamByName(const String& name, const float* value, uint32 size);
+  bool hasParameter(const String& name) const;
   void beginUpdateParameters();
   void endUpdateParameters();
   uint32 queryBuffersArray(ID3D11Buffer* const*& m_buffersToBind) const;
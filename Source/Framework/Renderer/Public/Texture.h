@@ -53,6 +53,8 @@ public:
   ~Texture();
   virtual bool load(const String& fileName);
   virtual void unload();
+  virtual uint32 getCpuMemorySize() const;
+  virtual uint32 getGpuMemorySize() const;
   void create(const TextureCreationInfo& info);
 
   ID3D11Texture2D* getTexture2DPtr() const { return (ID3D11Texture2D*)m_resource; }
@@ -63,10 +65,14 @@ private:
 
   ID3D11Resource* m_resource;
   ID3D11ShaderResourceView* m_defaultSRV;
+  uint32 m_gpuMemorySize;
 };
 
 class TextureManager : public ResourceManager
 {
+public:
+  virtual ~TextureManager();
+
 protected:
   virtual Resource* createResource(const String& fileName);
 };
@@ -3,6 +3,8 @@
 
 #include "RenderSystemPrerequisites.h"
 
+#define MAX_VERTEX_STREAMS 5
+
 struct VertexElement
 {
   String semantic;
@@ -26,6 +28,12 @@ public:
   const VertexElement& add(const String semantic, uint32 semanticIndex, eVertexElementFormat format, uint32 stream, uint32 byteOffset, bool usePerInstance);
 
   const VertexElement* getElement(uint32 index) const;
+  // bytes per vertex of a stream, up to the end of its last element
+  uint32 getStreamStride(uint32 stream) const;
+  // bytes per vertex over all streams
+  uint32 getVertexSize() const;
+  // bit n is set if an element reads from stream n
+  uint32 getStreamMask() const;
 
   static uint32 sizeOfElementType(eVertexElementFormat format);
 
@@ -0,0 +1,9 @@
+@echo off
+
+cd ../../Data/Meshes
+
+for /r %%F in (*.obj) do (
+  "..\..\Binaries\Build\Win32\Release\MeshCooker.exe" "%%~dpnxF"
+)
+
+pause
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "Core.h"
+#include "MeshCook.h"
+#include "StringUtils.h"
+#include "TaskScheduler.h"
+
+// converts obj files into cooked meshes (.fmesh), see MeshFile.h. without an output name the
+// mesh is written next to the input. -weld also merges vertices closer than the epsilon,
+// -nocache keeps the triangles in file order and -overdraw sorts them to reduce overdraw,
+// trading in up to threshold times the acmr (1.05 is a good start). -lods adds simplified levels
+// of detail with half the triangles of the previous one, up to MaxMeshLods in total. -meshlets
+// splits the finest level into meshlets, culled on the cpu at draw time. -multistream moves the
+// positions to a stream of their own and -16bit packs the attributes into 16 and 8 bit formats
+// within the default tolerances of MeshCookSettings
+//   MeshCooker [-weld <epsilon>] [-nocache] [-overdraw <threshold>] [-lods <count>] [-meshlets] [-multistream] [-16bit] <input.obj> [output.fmesh]
+int main(int argc, char* argv[])
+{
+  MeshCookSettings settings;
+  int first = 1;
+  for (; first < argc && argv[first][0] == '-'; ++first)
+  {
+    if (!strcmp(argv[first], "-weld") && first + 1 < argc)
+      settings.weldEpsilon = (float)atof(argv[++first]);
+    else if (!strcmp(argv[first], "-nocache"))
+      settings.options &= ~OPT_OPTIMIZE_FOR_CACHE;
+    else if (!strcmp(argv[first], "-overdraw") && first + 1 < argc)
+    {
+      settings.options |= OPT_OPTIMIZE_FOR_OVERDRAW;
+      settings.overdrawThreshold = (float)atof(argv[++first]);
+    }
+    else if (!strcmp(argv[first], "-lods") && first + 1 < argc)
+      settings.numLods = clamp<uint32>(atoi(argv[++first]), 1, MaxMeshLods);
+    else if (!strcmp(argv[first], "-meshlets"))
+      settings.options |= OPT_BUILD_MESHLETS;
+    else if (!strcmp(argv[first], "-multistream"))
+      settings.options |= OPT_USE_MULTI_STREAM;
+    else if (!strcmp(argv[first], "-16bit"))
+      settings.options |= OPT_16BIT_VERTEX_DATA;
+    else
+      break;
+  }
+
+  if (argc - first < 1 || argc - first > 2)
+  {
+    printf("usage: MeshCooker [-weld <epsilon>] [-nocache] [-overdraw <threshold>] [-lods <count>] [-meshlets] [-multistream] [-16bit] <input.obj> [output.fmesh]\n");
+    return 1;
+  }
+
+  const String input = argv[first];
+  String output = argc - first > 1 ? argv[first + 1] : String();
+  if (output.empty())
+  {
+    const String path = PathUtils::getPath(input, false);
+    output = (path.empty() ? String() : path + "\\") + PathUtils::getFilename(input, true) + ".fmesh";
+  }
+
+  TaskScheduler::init();
+
+  const double start = getHighResolutionTime();
+  CookedMesh mesh;
+  MeshData data;
+  const bool cooked = cookObj(input, mesh, settings);
+  if (cooked)
+    mesh.getMeshData(data);
+  const bool written = cooked && writeMeshFile(output, data);
+  const double duration = getHighResolutionTime() - start;
+
+  TaskScheduler::shutdown();
+
+  if (!cooked)
+  {
+    printf("ERROR: can't cook %s\n", input.c_str());
+    return 1;
+  }
+
+  if (!written)
+  {
+    printf("ERROR: can't write %s\n", output.c_str());
+    return 1;
+  }
+
+  uint32 numVertices = 0;
+  uint32 numSourceVertices = 0;
+  uint32 numTriangles = 0;
+  uint32 numTransformed[2] = { 0, 0 };
+  uint32 numShaded[2] = { 0, 0 };
+  uint32 numCovered = 0;
+  uint32 numMeshlets = 0;
+  // chunks that couldn't be simplified any further count with their coarsest level
+  uint32 numLodTriangles[MaxMeshLods] = { 0 };
+  float lodErrors[MaxMeshLods] = { 0.0f };
+  for (uint32 i = 0; i < data.chunks.size(); ++i)
+  {
+    const MeshChunkData& chunk = data.chunks[i];
+    numVertices += chunk.numVertices;
+    numSourceVertices += mesh.chunks[i].numSourceVertices;
+    numTriangles += chunk.lods[0].numIndices / 3;
+    for (uint32 lod = 0; lod < settings.numLods; ++lod)
+    {
+      const MeshLod& level = chunk.lods[min(lod, chunk.numLods - 1)];
+      numLodTriangles[lod] += level.numIndices / 3;
+      lodErrors[lod] = max(lodErrors[lod], level.error);
+    }
+    numTransformed[0] += mesh.chunks[i].sourceVertexCache.numTransformed;
+    numTransformed[1] += mesh.chunks[i].vertexCache.numTransformed;
+    numShaded[0] += mesh.chunks[i].sourceOverdraw.numShaded;
+    numShaded[1] += mesh.chunks[i].overdraw.numShaded;
+    numCovered += mesh.chunks[i].overdraw.numCovered;
+    numMeshlets += chunk.numMeshlets;
+  }
+
+  printf("%s: %d chunks, %d vertices, %d triangles (%.2f s)\n", output.c_str(), data.chunks.size(), numVertices, numTriangles, duration);
+  printf("welded %d of %d vertices (%.2f:1)\n", numSourceVertices - numVertices, numSourceVertices, numVertices ? (float)numSourceVertices / numVertices : 0.0f);
+  if (numTriangles)
+  {
+    printf("acmr %.3f -> %.3f, atvr %.3f -> %.3f\n", (float)numTransformed[0] / numTriangles, (float)numTransformed[1] / numTriangles,
+      (float)numTransformed[0] / numVertices, (float)numTransformed[1] / numVertices);
+  }
+  if (numCovered)
+    printf("overdraw %.3f -> %.3f\n", (float)numShaded[0] / numCovered, (float)numShaded[1] / numCovered);
+  for (uint32 lod = 1; lod < settings.numLods; ++lod)
+    printf("lod %d: %d triangles, error %f\n", lod, numLodTriangles[lod], lodErrors[lod]);
+  if (numMeshlets)
+    printf("%d meshlets, %.1f triangles each\n", numMeshlets, (float)numTriangles / numMeshlets);
+
+  if (settings.options & OPT_16BIT_VERTEX_DATA)
+  {
+    printf("vertex size %d -> %d bytes\n", mesh.packing.sourceVertexSize, mesh.packing.vertexSize);
+    for (uint32 i = 0; data.vertexDeclaration.getElement(i); ++i)
+    {
+      const VertexElement* element = data.vertexDeclaration.getElement(i);
+      printf("  %s%d: %d bytes, error %f\n", element->semantic.c_str(), element->semanticIndex,
+        VertexDeclaration::sizeOfElementType(element->format), mesh.packing.maxError[i]);
+    }
+  }
+  return 0;
+}
\ No newline at end of file